@@ -44,9 +44,10 @@ Feature: Basic trip planning
             | la    |
 
 
+        # the tour cbalkjihgfedc, the exact solver reports it starting at l
         When I plan a trip I should get
             | waypoints               | trips         |
-            | a,b,c,d,e,f,g,h,i,j,k,l | cbalkjihgfedc |
+            | a,b,c,d,e,f,g,h,i,j,k,l | lkjihgfedcbal |
 
     Scenario: Testbot - Trip planning with multiple scc
         Given the node map
@@ -80,7 +81,7 @@ Feature: Basic trip planning
 
         When I plan a trip I should get
             | waypoints                       | trips              |
-            | a,b,c,d,e,f,g,h,i,j,k,l,m,n,o,p | cbalkjihgfedc,ponm |
+            | a,b,c,d,e,f,g,h,i,j,k,l,m,n,o,p | lkjihgfedcbal,ponm |
 
 
 
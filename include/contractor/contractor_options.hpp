@@ -19,7 +19,7 @@ enum class return_code : unsigned
 
 struct ContractorConfig
 {
-    ContractorConfig() : requested_num_threads(0) {}
+    ContractorConfig() : renumber_nodes(false), requested_num_threads(0) {}
 
     boost::filesystem::path config_file_path;
     boost::filesystem::path osrm_input_path;
@@ -34,6 +34,18 @@ struct ContractorConfig
     std::string edge_penalty_path;
     bool use_cached_priority;
 
+    // Renumber edge-based nodes and original edges for cache locality of the query graph.
+    // Rewrites the r-tree leaves and the original edge data in place and stores the applied
+    // permutation, so consecutive runs can translate the ids back.
+    bool renumber_nodes;
+    std::string node_permutation_path;
+    std::string nodes_data_path;
+    std::string edge_data_path;
+    std::string rtree_leaf_path;
+
+    // Node order of the one-to-all sweep and the location of every node.
+    std::string sweep_order_path;
+
     unsigned requested_num_threads;
 
     // A percentage of vertices that will be contracted for the hierarchy.
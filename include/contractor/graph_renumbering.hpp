@@ -0,0 +1,105 @@
+#ifndef GRAPH_RENUMBERING_HPP
+#define GRAPH_RENUMBERING_HPP
+
+#include "contractor/query_edge.hpp"
+#include "extractor/edge_based_node.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/typedefs.hpp"
+
+#include "osrm/coordinate.hpp"
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+// Maps edge-based node ids and original edge ids as written by osrm-extract to the ids used in
+// the renumbered dataset. Empty id vectors denote the identity.
+struct GraphPermutation
+{
+    std::vector<NodeID> new_node_ids;
+    std::vector<EdgeID> new_edge_ids;
+
+    // Number of edge-based nodes of the graph the permutation was computed for and checksums of
+    // the files that were rewritten in place. If they do not match anymore osrm-extract was run
+    // again or the files were replaced, and the files are in extraction order. Unlike
+    // modification times they survive copies, restores and clock skews.
+    std::uint64_t number_of_nodes = 0;
+    std::uint32_t leaf_file_checksum = 0;
+    std::uint32_t edge_data_file_checksum = 0;
+
+    bool IsIdentity() const { return new_node_ids.empty() && new_edge_ids.empty(); }
+};
+
+// Returns the identity if there is no permutation or if it does not describe the current files
+// of a graph with the given number of nodes.
+GraphPermutation ReadGraphPermutation(const boost::filesystem::path &permutation_path,
+                                      const boost::filesystem::path &leaf_path,
+                                      const boost::filesystem::path &edge_data_path,
+                                      const std::size_t number_of_nodes);
+
+// Has to be called after the files were rewritten, their checksums are stored.
+void WriteGraphPermutation(const boost::filesystem::path &permutation_path,
+                           const boost::filesystem::path &leaf_path,
+                           const boost::filesystem::path &edge_data_path,
+                           const std::size_t number_of_nodes,
+                           GraphPermutation &permutation);
+
+// CRC32 of the contents of a file.
+std::uint32_t ComputeFileChecksum(const boost::filesystem::path &path);
+
+// Calls the visitor with every segment stored in the r-tree leaves and the centroid of the
+// segment. The node ids of the segments are the ones currently stored in the leaves.
+void VisitSegmentCentroids(
+    const boost::filesystem::path &leaf_path,
+    const boost::filesystem::path &nodes_path,
+    const std::function<void(const extractor::EdgeBasedNode &, const util::FixedPointCoordinate &)>
+        &visitor);
+
+// Computes a hilbert value for every edge-based node (in extraction ids) from the centroids of
+// its segments stored in the r-tree leaves.
+std::vector<std::uint64_t>
+ComputeNodeHilbertValues(const boost::filesystem::path &leaf_path,
+                         const boost::filesystem::path &nodes_path,
+                         const std::size_t number_of_nodes,
+                         const GraphPermutation &current_permutation);
+
+// Orders nodes top-down by contraction level band and along the hilbert curve inside each band.
+// Core nodes form the topmost band. Returns the new id of every node.
+std::vector<NodeID> ComputeNodeOrder(const std::vector<float> &node_levels,
+                                     const std::vector<bool> &is_core_node,
+                                     const std::vector<std::uint64_t> &hilbert_values);
+
+void RenumberContractedGraph(const std::vector<NodeID> &new_node_ids,
+                             util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+                             std::vector<bool> &is_core_node);
+
+// Orders original edges by their first use in the sorted contracted edge list, so that
+// unpacking neighbouring edges touches neighbouring original edge data. Updates the ids of all
+// original (non-shortcut) edges and returns the new id of every original edge.
+std::vector<EdgeID>
+RenumberOriginalEdges(const std::size_t number_of_original_edges,
+                      util::DeallocatingVector<QueryEdge> &contracted_edge_list);
+
+std::size_t ReadNumberOfOriginalEdges(const boost::filesystem::path &edge_data_path);
+
+// Translates the ids stored in the r-tree leaves and the order of the original edge data
+// from current_permutation to next_permutation.
+void RenumberRTreeLeaves(const boost::filesystem::path &leaf_path,
+                         const GraphPermutation &current_permutation,
+                         const GraphPermutation &next_permutation);
+
+void RenumberOriginalEdgeData(const boost::filesystem::path &edge_data_path,
+                              const GraphPermutation &current_permutation,
+                              const GraphPermutation &next_permutation);
+}
+}
+
+#endif // GRAPH_RENUMBERING_HPP
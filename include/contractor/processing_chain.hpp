@@ -46,8 +46,15 @@ class Prepare
                        std::vector<bool> &is_core_node,
                        std::vector<float> &node_levels) const;
     void WriteCoreNodeMarker(std::vector<bool> &&is_core_node) const;
-    void WriteNodeLevels(std::vector<float> &&node_levels) const;
+    void WriteNodeLevels(const std::vector<float> &node_levels) const;
     void ReadNodeLevels(std::vector<float> &contraction_order) const;
+    void RenumberGraph(const unsigned max_edge_id,
+                       const std::vector<float> &node_levels,
+                       util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+                       std::vector<bool> &is_core_node) const;
+    void WriteSweepOrder(const unsigned max_edge_id,
+                         const util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+                         const std::vector<bool> &is_core_node) const;
     std::size_t
     WriteContractedGraph(unsigned number_of_edge_based_nodes,
                          const util::DeallocatingVector<QueryEdge> &contracted_edge_list);
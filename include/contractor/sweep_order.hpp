@@ -0,0 +1,47 @@
+#ifndef SWEEP_ORDER_HPP
+#define SWEEP_ORDER_HPP
+
+#include "contractor/query_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/typedefs.hpp"
+
+#include "osrm/coordinate.hpp"
+
+#include <boost/filesystem/path.hpp>
+
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+// Order in which the downward sweep of a one-to-all search (PHAST) visits the nodes of the
+// contracted graph. Every edge of the query graph is stored at its lower endpoint, so nodes are
+// grouped into levels without edges between nodes of the same level and the levels are listed
+// from the top of the hierarchy down. A node only depends on nodes of earlier levels, thus all
+// nodes of one level can be swept in parallel.
+struct SweepOrder
+{
+    std::vector<NodeID> nodes;
+    // level i covers [level_offsets[i], level_offsets[i + 1]) of nodes
+    std::vector<unsigned> level_offsets;
+};
+
+// Returns an empty order if the edges do not form a hierarchy, i.e. if the graph has a core.
+SweepOrder ComputeSweepOrder(const std::size_t number_of_nodes,
+                             const util::DeallocatingVector<QueryEdge> &contracted_edge_list);
+
+// Location of every edge-based node, taken from one of its segments in the r-tree leaves.
+std::vector<util::FixedPointCoordinate>
+ComputeNodeLocations(const boost::filesystem::path &leaf_path,
+                     const boost::filesystem::path &nodes_path,
+                     const std::size_t number_of_nodes);
+
+void WriteSweepOrder(const boost::filesystem::path &sweep_order_path,
+                     const SweepOrder &sweep_order,
+                     const std::vector<util::FixedPointCoordinate> &node_locations);
+}
+}
+
+#endif // SWEEP_ORDER_HPP
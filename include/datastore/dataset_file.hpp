@@ -0,0 +1,60 @@
+#ifndef DATASET_FILE_HPP
+#define DATASET_FILE_HPP
+
+#include "engine/datafacade/shared_datatype.hpp"
+#include "util/fingerprint.hpp"
+
+#include <cstdint>
+
+#include <algorithm>
+
+namespace osrm
+{
+namespace datastore
+{
+
+// A dataset in one file, written by osrm-pack. The file starts with this header, the blocks
+// follow at DATASET_DATA_OFFSET and are laid out exactly as in shared memory, so that the file
+// can be mapped into memory and used without any parsing.
+struct DatasetFileHeader
+{
+    // increase the version whenever the layout of the blocks changes
+    static const constexpr std::uint32_t CURRENT_VERSION = 1;
+
+    char magic[8];
+    std::uint32_t version;
+    util::FingerPrint fingerprint;
+    engine::datafacade::SharedDataLayout layout;
+
+    static DatasetFileHeader Make(const engine::datafacade::SharedDataLayout &layout)
+    {
+        DatasetFileHeader header;
+        std::copy(MAGIC(), MAGIC() + sizeof(header.magic), header.magic);
+        header.version = CURRENT_VERSION;
+        header.fingerprint = util::FingerPrint::GetValid();
+        header.layout = layout;
+        return header;
+    }
+
+    bool IsDataset() const { return std::equal(magic, magic + sizeof(magic), MAGIC()); }
+
+    // the structs of the blocks are only laid out the same by the same build
+    bool IsCompatible() const
+    {
+        const auto valid = util::FingerPrint::GetValid();
+        return version == CURRENT_VERSION && fingerprint.TestGraphUtil(valid) &&
+               fingerprint.TestRTree(valid) && fingerprint.TestQueryObjects(valid);
+    }
+
+  private:
+    static const char *MAGIC() { return "OSRMDSET"; }
+};
+
+// Blocks start at a page boundary of the file.
+const constexpr std::uint64_t DATASET_DATA_OFFSET = 4096;
+
+static_assert(sizeof(DatasetFileHeader) <= DATASET_DATA_OFFSET, "dataset header is too large");
+}
+}
+
+#endif // DATASET_FILE_HPP
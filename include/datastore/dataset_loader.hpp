@@ -0,0 +1,37 @@
+#ifndef DATASET_LOADER_HPP
+#define DATASET_LOADER_HPP
+
+#include "engine/datafacade/shared_datatype.hpp"
+
+#include <boost/filesystem/path.hpp>
+
+#include <string>
+#include <unordered_map>
+
+namespace osrm
+{
+namespace datastore
+{
+
+using DatasetPaths = std::unordered_map<std::string, boost::filesystem::path>;
+
+// Checks that all files of a dataset are given, the paths are named like the options of
+// osrm-datastore.
+void CheckDatasetPaths(const DatasetPaths &paths);
+
+// Reads the number of entries of every block from the files of the dataset. The leaves of the
+// r-tree are only copied into the dataset if embed_leaves is set, otherwise they are read from
+// the .fileIndex file on demand. If table_only is set the blocks that are only read to describe
+// routes are left empty.
+engine::datafacade::SharedDataLayout LoadDatasetLayout(const DatasetPaths &paths,
+                                                       const bool embed_leaves,
+                                                       const bool table_only = false);
+
+// Reads all blocks of the dataset into memory that is laid out as described by the layout.
+void LoadDatasetData(const DatasetPaths &paths,
+                     engine::datafacade::SharedDataLayout &layout,
+                     char *memory);
+}
+}
+
+#endif // DATASET_LOADER_HPP
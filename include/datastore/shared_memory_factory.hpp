@@ -1,6 +1,7 @@
 #ifndef SHARED_MEMORY_FACTORY_HPP
 #define SHARED_MEMORY_FACTORY_HPP
 
+#include "util/huge_pages.hpp"
 #include "util/osrm_exception.hpp"
 #include "util/simple_logger.hpp"
 
@@ -75,6 +76,9 @@ class SharedMemory
   public:
     void *Ptr() const { return region.get_address(); }
 
+    // true if the segment was created with SHM_HUGETLB
+    bool IsOnHugePages() const { return on_huge_pages; }
+
     SharedMemory() = delete;
     SharedMemory(const SharedMemory &) = delete;
 
@@ -83,8 +87,9 @@ class SharedMemory
                  const IdentifierT id,
                  const uint64_t size = 0,
                  bool read_write = false,
-                 bool remove_prev = true)
-        : key(lock_file.string().c_str(), id)
+                 bool remove_prev = true,
+                 bool huge_pages = false)
+        : key(lock_file.string().c_str(), id), on_huge_pages(false)
     {
         if (0 == size)
         { // read_only
@@ -101,6 +106,23 @@ class SharedMemory
             {
                 Remove(key);
             }
+#if defined(__linux__) && defined(SHM_HUGETLB)
+            if (huge_pages)
+            {
+                // the size of a huge page segment has to be a multiple of the huge page size, the
+                // segment is then opened like any other one below
+                const uint64_t huge_size = (size + util::HugePages::HUGE_PAGE_SIZE - 1) /
+                                           util::HugePages::HUGE_PAGE_SIZE *
+                                           util::HugePages::HUGE_PAGE_SIZE;
+                on_huge_pages =
+                    -1 != shmget(key.get_key(), huge_size, IPC_CREAT | SHM_HUGETLB | 0644);
+                if (!on_huge_pages)
+                {
+                    util::SimpleLogger().Write(logWARNING)
+                        << "could not allocate shared memory on huge pages, using regular pages";
+                }
+            }
+#endif
             shm = boost::interprocess::xsi_shared_memory(boost::interprocess::open_or_create, key,
                                                          size);
 #ifdef __linux__
@@ -181,6 +203,7 @@ class SharedMemory
     boost::interprocess::xsi_shared_memory shm;
     boost::interprocess::mapped_region region;
     shm_remove remover;
+    bool on_huge_pages;
 };
 #else
 // Windows - specific code
@@ -220,11 +243,15 @@ class SharedMemory
   public:
     void *Ptr() const { return region.get_address(); }
 
+    // huge pages are not supported for shared memory on Windows
+    bool IsOnHugePages() const { return false; }
+
     SharedMemory(const boost::filesystem::path &lock_file,
                  const int id,
                  const uint64_t size = 0,
                  bool read_write = false,
-                 bool remove_prev = true)
+                 bool remove_prev = true,
+                 bool /* huge_pages */ = false)
     {
         sprintf(key, "%s.%d", "osrm.lock", id);
         if (0 == size)
@@ -326,7 +353,8 @@ template <class LockFileT = OSRMLockFile> class SharedMemoryFactory_tmpl
     static SharedMemory *Get(const IdentifierT &id,
                              const uint64_t size = 0,
                              bool read_write = false,
-                             bool remove_prev = true)
+                             bool remove_prev = true,
+                             bool huge_pages = false)
     {
         try
         {
@@ -343,7 +371,7 @@ template <class LockFileT = OSRMLockFile> class SharedMemoryFactory_tmpl
                     ofs.close();
                 }
             }
-            return new SharedMemory(lock_file(), id, size, read_write, remove_prev);
+            return new SharedMemory(lock_file(), id, size, read_write, remove_prev, huge_pages);
         }
         catch (const boost::interprocess::interprocess_exception &e)
         {
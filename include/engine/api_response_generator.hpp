@@ -122,45 +122,63 @@ void ApiResponseGenerator<DataFacadeT>::DescribeRoute(const RouteParameters &con
 
     if (raw_route.has_alternative())
     {
-        Segments alternate_segment_list(raw_route, EXTRACT_ALTERNATIVE, config.zoom_level,
-                                        ALLOW_SIMPLIFICATION, facade);
-
-        // Alternative Route Summaries are stored in an array to (down the line) allow multiple
-        // alternatives
         util::json::Array json_alternate_route_summary_array;
-        json_alternate_route_summary_array.values.emplace_back(
-            SummarizeRoute(raw_route, alternate_segment_list));
-        json_result.values["alternative_summaries"] = json_alternate_route_summary_array;
-        json_result.values["alternative_indices"] = ListViaIndices(alternate_segment_list);
+        util::json::Array json_alternate_geometries_array;
+        util::json::Array json_alternate_annotations_array;
+        util::json::Array json_alternate_names_array;
+        auto path_segments = BuildRouteSegments(segment_list);
+        for (const auto alternative_index :
+             util::irange<std::size_t>(0, raw_route.alternative_path_lengths.size()))
+        {
+            Segments alternate_segment_list(raw_route, EXTRACT_ALTERNATIVE, config.zoom_level,
+                                            ALLOW_SIMPLIFICATION, facade, alternative_index);
+
+            json_alternate_route_summary_array.values.emplace_back(
+                SummarizeRoute(raw_route, alternate_segment_list));
+            // kept as a flat array of the first alternative for compatibility
+            if (alternative_index == 0)
+            {
+                json_result.values["alternative_indices"] =
+                    ListViaIndices(alternate_segment_list);
+            }
+
+            if (config.geometry)
+            {
+                json_alternate_geometries_array.values.emplace_back(
+                    GetGeometry(config.compression, alternate_segment_list));
+            }
+
+            if (config.print_instructions)
+            {
+                json_alternate_annotations_array.values.emplace_back(
+                    guidance::AnnotateRoute(alternate_segment_list.Get(), facade));
+            }
+
+            // generate names for both the main path and the alternative route, the names of
+            // the main path are the ones that distinguish it from the first alternative
+            auto alternate_segments = BuildRouteSegments(alternate_segment_list);
+            auto alternative_route_names =
+                extractRouteNames(path_segments, alternate_segments, facade);
+            if (alternative_index == 0)
+            {
+                route_names = alternative_route_names;
+            }
+
+            util::json::Array json_alternate_names;
+            json_alternate_names.values.push_back(alternative_route_names.alternative_path_name_1);
+            json_alternate_names.values.push_back(alternative_route_names.alternative_path_name_2);
+            json_alternate_names_array.values.emplace_back(std::move(json_alternate_names));
+        }
 
+        json_result.values["alternative_summaries"] = json_alternate_route_summary_array;
         if (config.geometry)
         {
-            auto alternate_geometry_string =
-                GetGeometry(config.compression, alternate_segment_list);
-            util::json::Array json_alternate_geometries_array;
-            json_alternate_geometries_array.values.emplace_back(
-                std::move(alternate_geometry_string));
             json_result.values["alternative_geometries"] = json_alternate_geometries_array;
         }
-
         if (config.print_instructions)
         {
-            util::json::Array json_alternate_annotations_array;
-            json_alternate_annotations_array.values.emplace_back(
-                guidance::AnnotateRoute(alternate_segment_list.Get(), facade));
             json_result.values["alternative_instructions"] = json_alternate_annotations_array;
         }
-
-        // generate names for both the main path and the alternative route
-        auto path_segments = BuildRouteSegments(segment_list);
-        auto alternate_segments = BuildRouteSegments(alternate_segment_list);
-        route_names = extractRouteNames(path_segments, alternate_segments, facade);
-
-        util::json::Array json_alternate_names_array;
-        util::json::Array json_alternate_names;
-        json_alternate_names.values.push_back(route_names.alternative_path_name_1);
-        json_alternate_names.values.push_back(route_names.alternative_path_name_2);
-        json_alternate_names_array.values.emplace_back(std::move(json_alternate_names));
         json_result.values["alternative_names"] = json_alternate_names_array;
         json_result.values["found_alternative"] = util::json::True();
     }
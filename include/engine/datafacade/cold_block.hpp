@@ -0,0 +1,124 @@
+#ifndef COLD_BLOCK_HPP
+#define COLD_BLOCK_HPP
+
+#include "util/osrm_exception.hpp"
+#include "util/residency.hpp"
+#include "util/simple_logger.hpp"
+#include "util/timing_util.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+// How the data that is only read to describe a route is loaded: street names, the annotations of
+// the original edges and the geometries. A distance table never reads them.
+enum class ColdDataLoading
+{
+    // at startup, like all other data
+    Eager,
+    // by the first query that reads them, that query waits for the load
+    Lazy,
+    // never, only the services that do not describe routes are available
+    Skip
+};
+
+struct ColdBlockStatistics
+{
+    std::string name;
+    bool loaded;
+    // bytes the block takes and how many of them are in RAM right now
+    std::size_t size;
+    std::size_t resident;
+    // 0 if the block was loaded with the rest of the data
+    double load_time_ms;
+};
+
+// Loads one block of cold data at most once, depending on the mode in the constructor or on
+// first use. Checking whether the block is loaded costs one atomic load.
+class ColdBlock
+{
+  public:
+    ColdBlock(std::string name, const ColdDataLoading loading, std::function<void()> loader)
+        : name(std::move(name)), loading(loading), loader(std::move(loader)), loaded(false),
+          load_time_ms(0)
+    {
+        if (loading == ColdDataLoading::Eager)
+        {
+            util::SimpleLogger().Write() << "loading " << this->name;
+            this->loader();
+            loaded.store(true, std::memory_order_release);
+        }
+    }
+
+    ColdBlock(const ColdBlock &) = delete;
+
+    // has to be called before the data of the block is read
+    inline void Require() const
+    {
+        if (!loaded.load(std::memory_order_acquire))
+        {
+            LoadOnce();
+        }
+    }
+
+    bool IsLoaded() const { return loaded.load(std::memory_order_acquire); }
+
+    // the memory of the block is given by the facade, that knows where the data lives
+    ColdBlockStatistics
+    GetStatistics(const std::vector<std::pair<const void *, std::size_t>> &memory) const
+    {
+        // the load time is written before loaded is set and must not be read while loading
+        const bool is_loaded = loaded.load(std::memory_order_acquire);
+        ColdBlockStatistics statistics{name, is_loaded, 0, 0, is_loaded ? load_time_ms : 0.};
+        for (const auto &range : memory)
+        {
+            statistics.size += range.second;
+            statistics.resident += util::GetResidentBytes(range.first, range.second);
+        }
+        return statistics;
+    }
+
+  private:
+    void LoadOnce() const
+    {
+        if (loading == ColdDataLoading::Skip)
+        {
+            throw util::exception(name + " are not loaded in table-only mode");
+        }
+
+        std::call_once(once, [this]
+                       {
+                           TIMER_START(load_block);
+                           loader();
+                           TIMER_STOP(load_block);
+                           load_time_ms = TIMER_MSEC(load_block);
+                           util::SimpleLogger().Write() << "loaded " << name << " on first use in "
+                                                        << load_time_ms << "ms";
+                           loaded.store(true, std::memory_order_release);
+                       });
+    }
+
+    const std::string name;
+    const ColdDataLoading loading;
+    const std::function<void()> loader;
+    mutable std::once_flag once;
+    mutable std::atomic<bool> loaded;
+    // only valid once loaded is set
+    mutable double load_time_ms;
+};
+}
+}
+}
+
+#endif // COLD_BLOCK_HPP
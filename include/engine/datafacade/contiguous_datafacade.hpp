@@ -0,0 +1,629 @@
+#ifndef CONTIGUOUS_DATAFACADE_HPP
+#define CONTIGUOUS_DATAFACADE_HPP
+
+// implements all data access to a dataset that is laid out in one block of memory
+
+#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/datafacade/shared_datatype.hpp"
+
+#include "engine/geospatial_query.hpp"
+#include "util/range_table.hpp"
+#include "util/static_graph.hpp"
+#include "util/static_rtree.hpp"
+#include "util/huge_pages.hpp"
+#include "util/make_unique.hpp"
+#include "util/residency.hpp"
+#include "util/simple_logger.hpp"
+
+#include <boost/thread.hpp>
+
+#include <algorithm>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+// Serves the data in memory that is laid out as described by a SharedDataLayout, without
+// copying it. Derived facades provide the memory, in shared memory or mapped from a file.
+template <class EdgeDataT> class ContiguousDataFacade : public BaseDataFacade<EdgeDataT>
+{
+  public:
+    // the routing algorithms are instantiated on the concrete facade and use these
+    using EdgeData = EdgeDataT;
+    using RTreeLeaf = typename BaseDataFacade<EdgeDataT>::RTreeLeaf;
+
+  private:
+    using super = BaseDataFacade<EdgeData>;
+    using QueryGraph = util::StaticGraph<EdgeData, true>;
+    using GraphNode = typename QueryGraph::NodeArrayEntry;
+    using GraphEdge = typename QueryGraph::EdgeArrayEntry;
+    using NameIndexBlock = typename util::RangeTable<16, true>::BlockT;
+    using InputEdge = typename QueryGraph::InputEdge;
+    using SharedRTree =
+        util::StaticRTree<RTreeLeaf, util::ShM<util::FixedPointCoordinate, true>::vector, true>;
+    using SharedGeospatialQuery = GeospatialQuery<SharedRTree>;
+    using TimeStampedRTreePair = std::pair<unsigned, std::shared_ptr<SharedRTree>>;
+    using RTreeNode = typename SharedRTree::TreeNode;
+
+    SharedDataLayout *data_layout;
+    char *shared_memory;
+    // identifies the data, the r-tree of each thread is rebuilt when it changes
+    unsigned CURRENT_TIMESTAMP;
+
+    unsigned m_check_sum;
+    std::unique_ptr<QueryGraph> m_query_graph;
+    std::string m_timestamp;
+
+    std::shared_ptr<util::ShM<util::FixedPointCoordinate, true>::vector> m_coordinate_list;
+    util::ShM<NodeID, true>::vector m_via_node_list;
+    util::ShM<unsigned, true>::vector m_name_ID_list;
+    util::ShM<extractor::TurnInstruction, true>::vector m_turn_instruction_list;
+    util::ShM<extractor::TravelMode, true>::vector m_travel_mode_list;
+    util::ShM<char, true>::vector m_names_char_list;
+    util::ShM<unsigned, true>::vector m_name_begin_indices;
+    util::ShM<bool, true>::vector m_edge_is_compressed;
+    util::ShM<unsigned, true>::vector m_geometry_indices;
+    util::ShM<unsigned, true>::vector m_geometry_list;
+    util::ShM<bool, true>::vector m_is_core_node;
+    util::ShM<NodeID, true>::vector m_sweep_order;
+    util::ShM<unsigned, true>::vector m_sweep_level_offsets;
+    util::ShM<util::FixedPointCoordinate, true>::vector m_node_locations;
+
+    boost::thread_specific_ptr<std::pair<unsigned, std::shared_ptr<SharedRTree>>> m_static_rtree;
+    boost::thread_specific_ptr<SharedGeospatialQuery> m_geospatial_query;
+    boost::filesystem::path file_index_path;
+
+    std::shared_ptr<util::RangeTable<16, true>> m_name_table;
+
+    void LoadChecksum()
+    {
+        m_check_sum =
+            *data_layout->GetBlockPtr<unsigned>(shared_memory, SharedDataLayout::HSGR_CHECKSUM);
+        util::SimpleLogger().Write() << "set checksum: " << m_check_sum;
+    }
+
+    void LoadTimestamp()
+    {
+        char *timestamp_ptr =
+            data_layout->GetBlockPtr<char>(shared_memory, SharedDataLayout::TIMESTAMP);
+        m_timestamp.resize(data_layout->GetBlockSize(SharedDataLayout::TIMESTAMP));
+        std::copy(timestamp_ptr,
+                  timestamp_ptr + data_layout->GetBlockSize(SharedDataLayout::TIMESTAMP),
+                  m_timestamp.begin());
+    }
+
+    void LoadRTree()
+    {
+        BOOST_ASSERT_MSG(!m_coordinate_list->empty(), "coordinates must be loaded before r-tree");
+
+        RTreeNode *tree_ptr =
+            data_layout->GetBlockPtr<RTreeNode>(shared_memory, SharedDataLayout::R_SEARCH_TREE);
+        const auto number_of_tree_nodes = data_layout->num_entries[SharedDataLayout::R_SEARCH_TREE];
+        if (data_layout->num_entries[SharedDataLayout::R_SEARCH_TREE_LEAVES] > 0)
+        {
+            const char *leaves_ptr = data_layout->GetBlockPtr<char>(
+                shared_memory, SharedDataLayout::R_SEARCH_TREE_LEAVES);
+            m_static_rtree.reset(new TimeStampedRTreePair(
+                CURRENT_TIMESTAMP, util::make_unique<SharedRTree>(tree_ptr, number_of_tree_nodes,
+                                                                  leaves_ptr, m_coordinate_list)));
+        }
+        else
+        {
+            m_static_rtree.reset(new TimeStampedRTreePair(
+                CURRENT_TIMESTAMP,
+                util::make_unique<SharedRTree>(tree_ptr, number_of_tree_nodes, file_index_path,
+                                               m_coordinate_list)));
+        }
+        m_static_rtree->second->SetLeafReadStatistics(&super::GetLeafReadStatistics());
+        m_geospatial_query.reset(new SharedGeospatialQuery(
+            *m_static_rtree->second, m_coordinate_list, &super::GetSnappingCache(), m_check_sum));
+    }
+
+    void LoadGraph()
+    {
+        GraphNode *graph_nodes_ptr =
+            data_layout->GetBlockPtr<GraphNode>(shared_memory, SharedDataLayout::GRAPH_NODE_LIST);
+
+        GraphEdge *graph_edges_ptr =
+            data_layout->GetBlockPtr<GraphEdge>(shared_memory, SharedDataLayout::GRAPH_EDGE_LIST);
+
+        typename util::ShM<GraphNode, true>::vector node_list(
+            graph_nodes_ptr, data_layout->num_entries[SharedDataLayout::GRAPH_NODE_LIST]);
+        typename util::ShM<GraphEdge, true>::vector edge_list(
+            graph_edges_ptr, data_layout->num_entries[SharedDataLayout::GRAPH_EDGE_LIST]);
+        m_query_graph.reset(new QueryGraph(node_list, edge_list));
+    }
+
+    void LoadCoordinates()
+    {
+        util::FixedPointCoordinate *coordinate_list_ptr =
+            data_layout->GetBlockPtr<util::FixedPointCoordinate>(shared_memory,
+                                                                 SharedDataLayout::COORDINATE_LIST);
+        m_coordinate_list = util::make_unique<util::ShM<util::FixedPointCoordinate, true>::vector>(
+            coordinate_list_ptr, data_layout->num_entries[SharedDataLayout::COORDINATE_LIST]);
+    }
+
+    void LoadEdgeInformation()
+    {
+        extractor::TravelMode *travel_mode_list_ptr =
+            data_layout->GetBlockPtr<extractor::TravelMode>(shared_memory,
+                                                            SharedDataLayout::TRAVEL_MODE);
+        typename util::ShM<extractor::TravelMode, true>::vector travel_mode_list(
+            travel_mode_list_ptr, data_layout->num_entries[SharedDataLayout::TRAVEL_MODE]);
+        m_travel_mode_list.swap(travel_mode_list);
+
+        extractor::TurnInstruction *turn_instruction_list_ptr =
+            data_layout->GetBlockPtr<extractor::TurnInstruction>(
+                shared_memory, SharedDataLayout::TURN_INSTRUCTION);
+        typename util::ShM<extractor::TurnInstruction, true>::vector turn_instruction_list(
+            turn_instruction_list_ptr,
+            data_layout->num_entries[SharedDataLayout::TURN_INSTRUCTION]);
+        m_turn_instruction_list.swap(turn_instruction_list);
+
+        unsigned *name_id_list_ptr =
+            data_layout->GetBlockPtr<unsigned>(shared_memory, SharedDataLayout::NAME_ID_LIST);
+        typename util::ShM<unsigned, true>::vector name_id_list(
+            name_id_list_ptr, data_layout->num_entries[SharedDataLayout::NAME_ID_LIST]);
+        m_name_ID_list.swap(name_id_list);
+    }
+
+    void LoadViaNodeList()
+    {
+        NodeID *via_node_list_ptr =
+            data_layout->GetBlockPtr<NodeID>(shared_memory, SharedDataLayout::VIA_NODE_LIST);
+        typename util::ShM<NodeID, true>::vector via_node_list(
+            via_node_list_ptr, data_layout->num_entries[SharedDataLayout::VIA_NODE_LIST]);
+        m_via_node_list.swap(via_node_list);
+    }
+
+    void LoadNames()
+    {
+        unsigned *offsets_ptr =
+            data_layout->GetBlockPtr<unsigned>(shared_memory, SharedDataLayout::NAME_OFFSETS);
+        NameIndexBlock *blocks_ptr =
+            data_layout->GetBlockPtr<NameIndexBlock>(shared_memory, SharedDataLayout::NAME_BLOCKS);
+        typename util::ShM<unsigned, true>::vector name_offsets(
+            offsets_ptr, data_layout->num_entries[SharedDataLayout::NAME_OFFSETS]);
+        typename util::ShM<NameIndexBlock, true>::vector name_blocks(
+            blocks_ptr, data_layout->num_entries[SharedDataLayout::NAME_BLOCKS]);
+
+        char *names_list_ptr =
+            data_layout->GetBlockPtr<char>(shared_memory, SharedDataLayout::NAME_CHAR_LIST);
+        typename util::ShM<char, true>::vector names_char_list(
+            names_list_ptr, data_layout->num_entries[SharedDataLayout::NAME_CHAR_LIST]);
+        m_name_table = util::make_unique<util::RangeTable<16, true>>(
+            name_offsets, name_blocks, static_cast<unsigned>(names_char_list.size()));
+
+        m_names_char_list.swap(names_char_list);
+    }
+
+    void LoadCoreInformation()
+    {
+        if (data_layout->num_entries[SharedDataLayout::CORE_MARKER] <= 0)
+        {
+            return;
+        }
+
+        unsigned *core_marker_ptr =
+            data_layout->GetBlockPtr<unsigned>(shared_memory, SharedDataLayout::CORE_MARKER);
+        typename util::ShM<bool, true>::vector is_core_node(
+            core_marker_ptr, data_layout->num_entries[SharedDataLayout::CORE_MARKER]);
+        m_is_core_node.swap(is_core_node);
+    }
+
+    void LoadSweepOrder()
+    {
+        NodeID *sweep_order_ptr =
+            data_layout->GetBlockPtr<NodeID>(shared_memory, SharedDataLayout::SWEEP_ORDER);
+        typename util::ShM<NodeID, true>::vector sweep_order(
+            sweep_order_ptr, data_layout->num_entries[SharedDataLayout::SWEEP_ORDER]);
+        m_sweep_order.swap(sweep_order);
+
+        unsigned *sweep_level_offsets_ptr = data_layout->GetBlockPtr<unsigned>(
+            shared_memory, SharedDataLayout::SWEEP_LEVEL_OFFSETS);
+        typename util::ShM<unsigned, true>::vector sweep_level_offsets(
+            sweep_level_offsets_ptr,
+            data_layout->num_entries[SharedDataLayout::SWEEP_LEVEL_OFFSETS]);
+        m_sweep_level_offsets.swap(sweep_level_offsets);
+
+        util::FixedPointCoordinate *node_locations_ptr =
+            data_layout->GetBlockPtr<util::FixedPointCoordinate>(shared_memory,
+                                                                 SharedDataLayout::NODE_LOCATIONS);
+        typename util::ShM<util::FixedPointCoordinate, true>::vector node_locations(
+            node_locations_ptr, data_layout->num_entries[SharedDataLayout::NODE_LOCATIONS]);
+        m_node_locations.swap(node_locations);
+    }
+
+    void LoadGeometries()
+    {
+        unsigned *geometries_compressed_ptr = data_layout->GetBlockPtr<unsigned>(
+            shared_memory, SharedDataLayout::GEOMETRIES_INDICATORS);
+        typename util::ShM<bool, true>::vector edge_is_compressed(
+            geometries_compressed_ptr,
+            data_layout->num_entries[SharedDataLayout::GEOMETRIES_INDICATORS]);
+        m_edge_is_compressed.swap(edge_is_compressed);
+
+        unsigned *geometries_index_ptr =
+            data_layout->GetBlockPtr<unsigned>(shared_memory, SharedDataLayout::GEOMETRIES_INDEX);
+        typename util::ShM<unsigned, true>::vector geometry_begin_indices(
+            geometries_index_ptr, data_layout->num_entries[SharedDataLayout::GEOMETRIES_INDEX]);
+        m_geometry_indices.swap(geometry_begin_indices);
+
+        unsigned *geometries_list_ptr =
+            data_layout->GetBlockPtr<unsigned>(shared_memory, SharedDataLayout::GEOMETRIES_LIST);
+        typename util::ShM<unsigned, true>::vector geometry_list(
+            geometries_list_ptr, data_layout->num_entries[SharedDataLayout::GEOMETRIES_LIST]);
+        m_geometry_list.swap(geometry_list);
+    }
+
+    // the previous data may have had them
+    void ClearColdData()
+    {
+        util::ShM<NodeID, true>::vector().swap(m_via_node_list);
+        util::ShM<unsigned, true>::vector().swap(m_name_ID_list);
+        util::ShM<extractor::TurnInstruction, true>::vector().swap(m_turn_instruction_list);
+        util::ShM<extractor::TravelMode, true>::vector().swap(m_travel_mode_list);
+        util::ShM<char, true>::vector().swap(m_names_char_list);
+        util::ShM<bool, true>::vector().swap(m_edge_is_compressed);
+        util::ShM<unsigned, true>::vector().swap(m_geometry_indices);
+        util::ShM<unsigned, true>::vector().swap(m_geometry_list);
+        m_name_table.reset();
+    }
+
+    // a running server may be switched to a dataset without them
+    inline void RequireColdData() const
+    {
+        if (!data_layout->HasColdBlocks())
+        {
+            throw util::exception("names, edge annotations and geometries are not in the dataset");
+        }
+    }
+
+  protected:
+    ContiguousDataFacade() : data_layout(nullptr), shared_memory(nullptr), CURRENT_TIMESTAMP(0) {}
+
+    // Serves the data of the given memory from now on. The timestamp has to differ from the one
+    // of the previous data.
+    // The blocks that queries access at random. Shared memory that was not allocated on huge
+    // pages and mapped files can still be collapsed into transparent huge pages.
+    void AdviseHugePages()
+    {
+        const std::pair<SharedDataLayout::BlockID, const char *> random_access_blocks[] = {
+            {SharedDataLayout::GRAPH_NODE_LIST, "graph nodes"},
+            {SharedDataLayout::GRAPH_EDGE_LIST, "graph edges"},
+            {SharedDataLayout::COORDINATE_LIST, "coordinates"},
+            {SharedDataLayout::R_SEARCH_TREE, "r-tree"},
+            {SharedDataLayout::VIA_NODE_LIST, "via nodes"},
+            {SharedDataLayout::NAME_ID_LIST, "name ids"},
+            {SharedDataLayout::GEOMETRIES_INDEX, "geometry index"},
+            {SharedDataLayout::GEOMETRIES_LIST, "geometries"}};
+        for (const auto &block : random_access_blocks)
+        {
+            const auto size = data_layout->GetBlockSize(block.first);
+            const auto *block_memory = shared_memory + data_layout->GetBlockOffset(block.first);
+            const bool advised = util::HugePages::Advise(block_memory, size);
+            util::HugePages::Report(block.second, block_memory, size, advised);
+        }
+    }
+
+    void LoadData(SharedDataLayout *layout, char *memory, const unsigned timestamp)
+    {
+        data_layout = layout;
+        shared_memory = memory;
+        CURRENT_TIMESTAMP = timestamp;
+
+        const char *file_index_ptr =
+            data_layout->GetBlockPtr<char>(shared_memory, SharedDataLayout::FILE_INDEX_PATH);
+        file_index_path = boost::filesystem::path(file_index_ptr);
+        if (data_layout->num_entries[SharedDataLayout::R_SEARCH_TREE_LEAVES] == 0 &&
+            !boost::filesystem::exists(file_index_path))
+        {
+            util::SimpleLogger().Write(logDEBUG) << "Leaf file name " << file_index_path.string();
+            throw util::exception("Could not load leaf index file. "
+                                  "Is any data loaded into shared memory?");
+        }
+
+        LoadGraph();
+        LoadChecksum();
+        LoadCoordinates();
+        LoadTimestamp();
+        LoadCoreInformation();
+        LoadSweepOrder();
+        // the data stays mapped, pages of blocks that no query reads are never faulted in
+        if (data_layout->HasColdBlocks())
+        {
+            LoadEdgeInformation();
+            LoadGeometries();
+            LoadViaNodeList();
+            LoadNames();
+        }
+        else
+        {
+            util::SimpleLogger().Write() << "dataset has no names, edge annotations and "
+                                            "geometries, only distance tables are served";
+            ClearColdData();
+        }
+
+        if (util::HugePages::IsEnabled())
+        {
+            AdviseHugePages();
+        }
+
+        // The caches are bound to the dataset checksum and drop the shortcuts and segments of
+        // the previous dataset by themselves. Clearing them here would free entries that queries
+        // on the previous dataset still use.
+
+        data_layout->PrintInformation();
+
+        util::SimpleLogger().Write() << "number of geometries: " << m_coordinate_list->size();
+        for (unsigned i = 0; i < m_coordinate_list->size(); ++i)
+        {
+            if (!GetCoordinateOfNode(i).IsValid())
+            {
+                util::SimpleLogger().Write() << "coordinate " << i << " not valid";
+            }
+        }
+    }
+
+  public:
+    virtual ~ContiguousDataFacade() {}
+
+    // search graph access
+    unsigned GetNumberOfNodes() const override final { return m_query_graph->GetNumberOfNodes(); }
+
+    unsigned GetNumberOfEdges() const override final { return m_query_graph->GetNumberOfEdges(); }
+
+    unsigned GetOutDegree(const NodeID n) const override final
+    {
+        return m_query_graph->GetOutDegree(n);
+    }
+
+    NodeID GetTarget(const EdgeID e) const override final { return m_query_graph->GetTarget(e); }
+
+    EdgeDataT GetEdgeData(const EdgeID e) const override final
+    {
+        return m_query_graph->GetEdgeData(e);
+    }
+
+    EdgeID BeginEdges(const NodeID n) const override final { return m_query_graph->BeginEdges(n); }
+
+    EdgeID EndEdges(const NodeID n) const override final { return m_query_graph->EndEdges(n); }
+
+    EdgeRange GetAdjacentEdgeRange(const NodeID node) const override final
+    {
+        return m_query_graph->GetAdjacentEdgeRange(node);
+    };
+
+    // searches for a specific edge
+    EdgeID FindEdge(const NodeID from, const NodeID to) const override final
+    {
+        return m_query_graph->FindEdge(from, to);
+    }
+
+    EdgeID FindEdgeInEitherDirection(const NodeID from, const NodeID to) const override final
+    {
+        return m_query_graph->FindEdgeInEitherDirection(from, to);
+    }
+
+    EdgeID
+    FindEdgeIndicateIfReverse(const NodeID from, const NodeID to, bool &result) const override final
+    {
+        return m_query_graph->FindEdgeIndicateIfReverse(from, to, result);
+    }
+
+    // node and edge information access
+    util::FixedPointCoordinate GetCoordinateOfNode(const NodeID id) const override final
+    {
+        return m_coordinate_list->at(id);
+    };
+
+    virtual bool EdgeIsCompressed(const unsigned id) const override final
+    {
+        RequireColdData();
+        return m_edge_is_compressed.at(id);
+    }
+
+    virtual void GetUncompressedGeometry(const unsigned id,
+                                         std::vector<unsigned> &result_nodes) const override final
+    {
+        RequireColdData();
+        const unsigned begin = m_geometry_indices.at(id);
+        const unsigned end = m_geometry_indices.at(id + 1);
+
+        result_nodes.clear();
+        result_nodes.insert(result_nodes.begin(), m_geometry_list.begin() + begin,
+                            m_geometry_list.begin() + end);
+    }
+
+    virtual unsigned GetGeometryIndexForEdgeID(const unsigned id) const override final
+    {
+        RequireColdData();
+        return m_via_node_list.at(id);
+    }
+
+    extractor::TurnInstruction GetTurnInstructionForEdgeID(const unsigned id) const override final
+    {
+        RequireColdData();
+        return m_turn_instruction_list.at(id);
+    }
+
+    extractor::TravelMode GetTravelModeForEdgeID(const unsigned id) const override final
+    {
+        RequireColdData();
+        return m_travel_mode_list.at(id);
+    }
+
+    std::vector<PhantomNodeWithDistance>
+    NearestPhantomNodesInRange(const util::FixedPointCoordinate &input_coordinate,
+                               const float max_distance,
+                               const int bearing = 0,
+                               const int bearing_range = 180) override final
+    {
+        if (!m_static_rtree.get() || CURRENT_TIMESTAMP != m_static_rtree->first)
+        {
+            LoadRTree();
+            BOOST_ASSERT(m_geospatial_query.get());
+        }
+
+        return m_geospatial_query->NearestPhantomNodesInRange(input_coordinate, max_distance,
+                                                              bearing, bearing_range);
+    }
+
+    std::vector<PhantomNodeWithDistance>
+    NearestPhantomNodes(const util::FixedPointCoordinate &input_coordinate,
+                        const unsigned max_results,
+                        const int bearing = 0,
+                        const int bearing_range = 180) override final
+    {
+        if (!m_static_rtree.get() || CURRENT_TIMESTAMP != m_static_rtree->first)
+        {
+            LoadRTree();
+            BOOST_ASSERT(m_geospatial_query.get());
+        }
+
+        return m_geospatial_query->NearestPhantomNodes(input_coordinate, max_results, bearing,
+                                                       bearing_range);
+    }
+
+    std::pair<PhantomNode, PhantomNode> NearestPhantomNodeWithAlternativeFromBigComponent(
+        const util::FixedPointCoordinate &input_coordinate,
+        const int bearing = 0,
+        const int bearing_range = 180) override final
+    {
+        if (!m_static_rtree.get() || CURRENT_TIMESTAMP != m_static_rtree->first)
+        {
+            LoadRTree();
+            BOOST_ASSERT(m_geospatial_query.get());
+        }
+
+        return m_geospatial_query->NearestPhantomNodeWithAlternativeFromBigComponent(
+            input_coordinate, bearing, bearing_range);
+    }
+
+    unsigned GetCheckSum() const override final { return m_check_sum; }
+
+    unsigned GetNameIndexFromEdgeID(const unsigned id) const override final
+    {
+        RequireColdData();
+        return m_name_ID_list.at(id);
+    };
+
+    std::string get_name_for_id(const unsigned name_id) const override final
+    {
+        if (std::numeric_limits<unsigned>::max() == name_id)
+        {
+            return "";
+        }
+        RequireColdData();
+        auto range = m_name_table->GetRange(name_id);
+
+        std::string result;
+        result.reserve(range.size());
+        if (range.begin() != range.end())
+        {
+            result.resize(range.back() - range.front() + 1);
+            std::copy(m_names_char_list.begin() + range.front(),
+                      m_names_char_list.begin() + range.back() + 1, result.begin());
+        }
+        return result;
+    }
+
+    bool IsCoreNode(const NodeID id) const override final
+    {
+        if (m_is_core_node.size() > 0)
+        {
+            return m_is_core_node.at(id);
+        }
+
+        return false;
+    }
+
+    virtual std::size_t GetCoreSize() const override final { return m_is_core_node.size(); }
+
+    std::string GetTimestamp() const override final { return m_timestamp; }
+
+    unsigned GetNumberOfSweepLevels() const override final
+    {
+        return m_sweep_level_offsets.empty() ? 0 : m_sweep_level_offsets.size() - 1;
+    }
+
+    util::range<unsigned> GetSweepLevel(const unsigned level) const override final
+    {
+        BOOST_ASSERT(level + 1 < m_sweep_level_offsets.size());
+        return util::irange(m_sweep_level_offsets[level], m_sweep_level_offsets[level + 1]);
+    }
+
+    NodeID GetSweepNode(const unsigned position) const override final
+    {
+        return m_sweep_order[position];
+    }
+
+    util::FixedPointCoordinate GetLocationOfEdgeBasedNode(const NodeID id) const override final
+    {
+        return m_node_locations.at(id);
+    }
+
+    bool HasColdData() const override final { return data_layout->HasColdBlocks(); }
+
+    std::vector<ColdBlockStatistics> GetColdBlockStatistics() const override final
+    {
+        const auto block_statistics =
+            [this](const char *name, std::initializer_list<SharedDataLayout::BlockID> blocks)
+        {
+            ColdBlockStatistics statistics{name, data_layout->HasColdBlocks(), 0, 0, 0};
+            for (const auto bid : blocks)
+            {
+                const auto size = data_layout->GetBlockSize(bid);
+                statistics.size += size;
+                statistics.resident += util::GetResidentBytes(
+                    shared_memory + data_layout->GetBlockOffset(bid), size);
+            }
+            return statistics;
+        };
+
+        return {block_statistics("edge annotations",
+                                 {SharedDataLayout::VIA_NODE_LIST, SharedDataLayout::NAME_ID_LIST,
+                                  SharedDataLayout::TURN_INSTRUCTION, SharedDataLayout::TRAVEL_MODE,
+                                  SharedDataLayout::GEOMETRIES_INDICATORS}),
+                block_statistics("geometries", {SharedDataLayout::GEOMETRIES_INDEX,
+                                                SharedDataLayout::GEOMETRIES_LIST}),
+                block_statistics("street names",
+                                 {SharedDataLayout::NAME_OFFSETS, SharedDataLayout::NAME_BLOCKS,
+                                  SharedDataLayout::NAME_CHAR_LIST})};
+    }
+
+    std::vector<util::MemoryBlock> GetMemoryBlocks() const override final
+    {
+        std::vector<util::MemoryBlock> blocks;
+        for (auto i = 0; i < SharedDataLayout::NUM_BLOCKS; ++i)
+        {
+            const auto bid = static_cast<SharedDataLayout::BlockID>(i);
+            blocks.push_back({SharedDataLayout::GetBlockName(bid),
+                              shared_memory + data_layout->GetBlockOffset(bid),
+                              data_layout->GetBlockSize(bid)});
+        }
+        return blocks;
+    }
+
+    boost::filesystem::path GetLeafFilePath() const override final
+    {
+        if (data_layout->num_entries[SharedDataLayout::R_SEARCH_TREE_LEAVES] > 0)
+        {
+            return {};
+        }
+        return file_index_path;
+    }
+};
+}
+}
+}
+
+#endif // CONTIGUOUS_DATAFACADE_HPP
@@ -5,16 +5,23 @@
 
 #include "extractor/edge_based_node.hpp"
 #include "extractor/external_memory_node.hpp"
+#include "engine/datafacade/cold_block.hpp"
 #include "engine/phantom_node.hpp"
+#include "engine/shortcut_unpacking_cache.hpp"
+#include "engine/snapping_cache.hpp"
 #include "extractor/turn_instructions.hpp"
 #include "util/integer_range.hpp"
 #include "util/osrm_exception.hpp"
+#include "util/residency.hpp"
+#include "util/static_rtree.hpp"
 #include "util/string_util.hpp"
 #include "util/typedefs.hpp"
 
 #include "osrm/coordinate.hpp"
 
 #include <string>
+#include <vector>
+#include <boost/filesystem/path.hpp>
 #include <boost/optional.hpp>
 
 namespace osrm
@@ -43,7 +50,8 @@ template <class EdgeDataT> class BaseDataFacade
 
     virtual NodeID GetTarget(const EdgeID e) const = 0;
 
-    virtual const EdgeDataT &GetEdgeData(const EdgeID e) const = 0;
+    // by value, a packed graph has no EdgeDataT in memory to refer to
+    virtual EdgeDataT GetEdgeData(const EdgeID e) const = 0;
 
     virtual EdgeID BeginEdges(const NodeID n) const = 0;
 
@@ -101,6 +109,60 @@ template <class EdgeDataT> class BaseDataFacade
     virtual std::size_t GetCoreSize() const = 0;
 
     virtual std::string GetTimestamp() const = 0;
+
+    // Nodes in the order of the one-to-all sweep, grouped into levels from the top of the
+    // hierarchy down. There are no levels if the graph has a core.
+    virtual unsigned GetNumberOfSweepLevels() const = 0;
+
+    // positions of the nodes of a level in the sweep order
+    virtual util::range<unsigned> GetSweepLevel(const unsigned level) const = 0;
+
+    virtual NodeID GetSweepNode(const unsigned position) const = 0;
+
+    virtual util::FixedPointCoordinate GetLocationOfEdgeBasedNode(const NodeID id) const = 0;
+
+    // False if the names, edge annotations and geometries were left out, then only the services
+    // that do not describe routes can be answered.
+    virtual bool HasColdData() const = 0;
+
+    // size and residency of the data that is only read to describe routes
+    virtual std::vector<ColdBlockStatistics> GetColdBlockStatistics() const = 0;
+
+    // every block of loaded data, to report how much of it is in RAM or to page it in
+    virtual std::vector<util::MemoryBlock> GetMemoryBlocks() const = 0;
+
+    // the file the leaves of the r-tree are read from, empty if the leaves are in memory
+    virtual boost::filesystem::path GetLeafFilePath() const = 0;
+
+    // size and residency of every block of loaded data and of the leaf file
+    std::vector<util::MemoryStatistics> GetMemoryStatistics() const
+    {
+        std::vector<util::MemoryStatistics> statistics;
+        for (const auto &block : GetMemoryBlocks())
+        {
+            statistics.push_back(util::MakeMemoryStatistics(block));
+        }
+        const auto leaf_file_path = GetLeafFilePath();
+        if (!leaf_file_path.empty())
+        {
+            statistics.push_back(util::MakeFileStatistics("r-tree leaves", leaf_file_path));
+        }
+        return statistics;
+    }
+
+    // Filled lazily by the routing algorithms, needs to be cleared when the graph changes.
+    ShortcutUnpackingCache &GetShortcutUnpackingCache() const { return shortcut_unpacking_cache; }
+
+    // Shared by the geospatial queries of all threads, disabled unless a capacity is set.
+    SnappingCache<RTreeLeaf> &GetSnappingCache() const { return snapping_cache; }
+
+    // Counted by the r-trees of all threads.
+    util::LeafReadStatistics &GetLeafReadStatistics() const { return leaf_read_statistics; }
+
+  private:
+    mutable ShortcutUnpackingCache shortcut_unpacking_cache;
+    mutable SnappingCache<RTreeLeaf> snapping_cache;
+    mutable util::LeafReadStatistics leaf_read_statistics;
 };
 }
 }
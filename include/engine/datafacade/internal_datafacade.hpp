@@ -3,6 +3,7 @@
 
 // implements all data storage when shared memory is _NOT_ used
 
+#include "engine/datafacade/cold_block.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 
 #include "engine/geospatial_query.hpp"
@@ -14,6 +15,7 @@
 #include "util/static_rtree.hpp"
 #include "util/range_table.hpp"
 #include "util/graph_loader.hpp"
+#include "util/huge_pages.hpp"
 #include "util/simple_logger.hpp"
 
 #include "osrm/coordinate.hpp"
@@ -21,6 +23,9 @@
 #include <boost/thread.hpp>
 
 #include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace osrm
 {
@@ -29,14 +34,19 @@ namespace engine
 namespace datafacade
 {
 
-template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacade<EdgeDataT>
+// The query graph is a template parameter so that the searches decode the packed graph inline,
+// without a virtual call or a branch per edge.
+template <class EdgeDataT, class QueryGraphT = util::StaticGraph<EdgeDataT>>
+class InternalDataFacade final : public BaseDataFacade<EdgeDataT>
 {
+  public:
+    // the routing algorithms are instantiated on the concrete facade and use these
+    using EdgeData = EdgeDataT;
+    using RTreeLeaf = typename BaseDataFacade<EdgeDataT>::RTreeLeaf;
 
   private:
     using super = BaseDataFacade<EdgeDataT>;
-    using QueryGraph = util::StaticGraph<typename super::EdgeData>;
-    using InputEdge = typename QueryGraph::InputEdge;
-    using RTreeLeaf = typename super::RTreeLeaf;
+    using QueryGraph = QueryGraphT;
     using InternalRTree =
         util::StaticRTree<RTreeLeaf, util::ShM<util::FixedPointCoordinate, false>::vector, false>;
     using InternalGeospatialQuery = GeospatialQuery<InternalRTree>;
@@ -45,6 +55,7 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
 
     unsigned m_check_sum;
     unsigned m_number_of_nodes;
+    ColdDataLoading m_cold_data_loading;
     std::unique_ptr<QueryGraph> m_query_graph;
     std::string m_timestamp;
 
@@ -58,6 +69,9 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
     util::ShM<unsigned, false>::vector m_geometry_indices;
     util::ShM<unsigned, false>::vector m_geometry_list;
     util::ShM<bool, false>::vector m_is_core_node;
+    util::ShM<NodeID, false>::vector m_sweep_order;
+    util::ShM<unsigned, false>::vector m_sweep_level_offsets;
+    util::ShM<util::FixedPointCoordinate, false>::vector m_node_locations;
 
     boost::thread_specific_ptr<InternalRTree> m_static_rtree;
     boost::thread_specific_ptr<InternalGeospatialQuery> m_geospatial_query;
@@ -65,6 +79,11 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
     boost::filesystem::path file_index_path;
     util::RangeTable<16, false> m_name_table;
 
+    // only read to describe routes, loaded depending on the ColdDataLoading
+    std::unique_ptr<ColdBlock> m_edge_information;
+    std::unique_ptr<ColdBlock> m_geometries;
+    std::unique_ptr<ColdBlock> m_street_names;
+
     void LoadTimestamp(const boost::filesystem::path &timestamp_path)
     {
         if (boost::filesystem::exists(timestamp_path))
@@ -88,6 +107,20 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
         }
     }
 
+    template <typename T>
+    static std::pair<const void *, std::size_t> MemoryOf(const std::vector<T> &array)
+    {
+        return {array.data(), array.size() * sizeof(T)};
+    }
+
+    // advising again does not change anything, it only tells whether the array is advised
+    template <typename T>
+    static void ReportHugePages(const char *name, const std::vector<T> &array)
+    {
+        util::HugePages::Report(name, array.data(), array.size() * sizeof(T),
+                                util::HugePages::Advise(array.data(), array.size() * sizeof(T)));
+    }
+
     void LoadGraph(const boost::filesystem::path &hsgr_path)
     {
         typename util::ShM<typename QueryGraph::NodeArrayEntry, false>::vector node_list;
@@ -101,6 +134,8 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
         // BOOST_ASSERT_MSG(0 != edge_list.size(), "edge list empty");
         util::SimpleLogger().Write() << "loaded " << node_list.size() << " nodes and "
                                      << edge_list.size() << " edges";
+        ReportHugePages("graph nodes", node_list);
+        ReportHugePages("graph edges", edge_list);
         m_query_graph = std::unique_ptr<QueryGraph>(new QueryGraph(node_list, edge_list));
 
         BOOST_ASSERT_MSG(0 == node_list.size(), "node list not flushed");
@@ -108,16 +143,16 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
         util::SimpleLogger().Write() << "Data checksum is " << m_check_sum;
     }
 
-    void LoadNodeAndEdgeInformation(const boost::filesystem::path &nodes_file,
-                                    const boost::filesystem::path &edges_file)
+    void LoadCoordinates(const boost::filesystem::path &nodes_file)
     {
         boost::filesystem::ifstream nodes_input_stream(nodes_file, std::ios::binary);
 
         extractor::QueryNode current_node;
         unsigned number_of_coordinates = 0;
         nodes_input_stream.read((char *)&number_of_coordinates, sizeof(unsigned));
-        m_coordinate_list =
-            std::make_shared<std::vector<util::FixedPointCoordinate>>(number_of_coordinates);
+        m_coordinate_list = std::make_shared<std::vector<util::FixedPointCoordinate>>();
+        util::HugePages::Resize(*m_coordinate_list, number_of_coordinates);
+        ReportHugePages("coordinates", *m_coordinate_list);
         for (unsigned i = 0; i < number_of_coordinates; ++i)
         {
             nodes_input_stream.read((char *)&current_node, sizeof(extractor::QueryNode));
@@ -127,12 +162,17 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
             BOOST_ASSERT((std::abs(m_coordinate_list->at(i).lon) >> 30) == 0);
         }
         nodes_input_stream.close();
+    }
 
+    void LoadEdgeInformation(const boost::filesystem::path &edges_file)
+    {
         boost::filesystem::ifstream edges_input_stream(edges_file, std::ios::binary);
         unsigned number_of_edges = 0;
         edges_input_stream.read((char *)&number_of_edges, sizeof(unsigned));
-        m_via_node_list.resize(number_of_edges);
-        m_name_ID_list.resize(number_of_edges);
+        util::HugePages::Resize(m_via_node_list, number_of_edges);
+        util::HugePages::Resize(m_name_ID_list, number_of_edges);
+        ReportHugePages("via nodes", m_via_node_list);
+        ReportHugePages("name ids", m_name_ID_list);
         m_turn_instruction_list.resize(number_of_edges);
         m_travel_mode_list.resize(number_of_edges);
         m_edge_is_compressed.resize(number_of_edges);
@@ -181,6 +221,42 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
         }
     }
 
+    void LoadSweepOrder(const boost::filesystem::path &sweep_order_file)
+    {
+        boost::filesystem::ifstream sweep_order_stream(sweep_order_file, std::ios::binary);
+
+        unsigned number_of_nodes = 0;
+        sweep_order_stream.read((char *)&number_of_nodes, sizeof(unsigned));
+        m_sweep_order.resize(number_of_nodes);
+        if (number_of_nodes > 0)
+        {
+            sweep_order_stream.read((char *)m_sweep_order.data(), sizeof(NodeID) * number_of_nodes);
+        }
+
+        unsigned number_of_offsets = 0;
+        sweep_order_stream.read((char *)&number_of_offsets, sizeof(unsigned));
+        m_sweep_level_offsets.resize(number_of_offsets);
+        if (number_of_offsets > 0)
+        {
+            sweep_order_stream.read((char *)m_sweep_level_offsets.data(),
+                                    sizeof(unsigned) * number_of_offsets);
+        }
+
+        unsigned number_of_locations = 0;
+        sweep_order_stream.read((char *)&number_of_locations, sizeof(unsigned));
+        m_node_locations.resize(number_of_locations);
+        if (number_of_locations > 0)
+        {
+            sweep_order_stream.read((char *)m_node_locations.data(),
+                                    sizeof(util::FixedPointCoordinate) * number_of_locations);
+        }
+
+        if (!sweep_order_stream)
+        {
+            throw util::exception("Could not read " + sweep_order_file.string());
+        }
+    }
+
     void LoadGeometries(const boost::filesystem::path &geometry_file)
     {
         std::ifstream geometry_stream(geometry_file.string().c_str(), std::ios::binary);
@@ -189,7 +265,8 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
 
         geometry_stream.read((char *)&number_of_indices, sizeof(unsigned));
 
-        m_geometry_indices.resize(number_of_indices);
+        util::HugePages::Resize(m_geometry_indices, number_of_indices);
+        ReportHugePages("geometry index", m_geometry_indices);
         if (number_of_indices > 0)
         {
             geometry_stream.read((char *)&(m_geometry_indices[0]),
@@ -199,7 +276,8 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
         geometry_stream.read((char *)&number_of_compressed_geometries, sizeof(unsigned));
 
         BOOST_ASSERT(m_geometry_indices.back() == number_of_compressed_geometries);
-        m_geometry_list.resize(number_of_compressed_geometries);
+        util::HugePages::Resize(m_geometry_list, number_of_compressed_geometries);
+        ReportHugePages("geometries", m_geometry_list);
 
         if (number_of_compressed_geometries > 0)
         {
@@ -214,7 +292,9 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
         BOOST_ASSERT_MSG(!m_coordinate_list->empty(), "coordinates must be loaded before r-tree");
 
         m_static_rtree.reset(new InternalRTree(ram_index_path, file_index_path, m_coordinate_list));
-        m_geospatial_query.reset(new InternalGeospatialQuery(*m_static_rtree, m_coordinate_list));
+        m_static_rtree->SetLeafReadStatistics(&super::GetLeafReadStatistics());
+        m_geospatial_query.reset(new InternalGeospatialQuery(
+            *m_static_rtree, m_coordinate_list, &super::GetSnappingCache(), m_check_sum));
     }
 
     void LoadStreetNames(const boost::filesystem::path &names_file)
@@ -243,7 +323,9 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
     }
 
     explicit InternalDataFacade(
-        const std::unordered_map<std::string, boost::filesystem::path> &server_paths)
+        const std::unordered_map<std::string, boost::filesystem::path> &server_paths,
+        const ColdDataLoading cold_data_loading = ColdDataLoading::Eager)
+        : m_cold_data_loading(cold_data_loading)
     {
         // cache end iterator to quickly check .find against
         const auto end_it = end(server_paths);
@@ -262,20 +344,39 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
         util::SimpleLogger().Write() << "loading graph data";
         LoadGraph(file_for("hsgrdata"));
 
-        util::SimpleLogger().Write() << "loading edge information";
-        LoadNodeAndEdgeInformation(file_for("nodesdata"), file_for("edgesdata"));
+        util::SimpleLogger().Write() << "loading coordinates";
+        LoadCoordinates(file_for("nodesdata"));
 
         util::SimpleLogger().Write() << "loading core information";
         LoadCoreInformation(file_for("coredata"));
 
-        util::SimpleLogger().Write() << "loading geometries";
-        LoadGeometries(file_for("geometries"));
+        // optional, datasets of older versions do not have it
+        const auto sweep_order_it = server_paths.find("orderdata");
+        if (sweep_order_it != end_it && boost::filesystem::is_regular_file(sweep_order_it->second))
+        {
+            util::SimpleLogger().Write() << "loading sweep order";
+            LoadSweepOrder(sweep_order_it->second);
+        }
 
         util::SimpleLogger().Write() << "loading timestamp";
         LoadTimestamp(file_for("timestamp"));
 
-        util::SimpleLogger().Write() << "loading street names";
-        LoadStreetNames(file_for("namesdata"));
+        // the files are checked now, a lazy load must not fail on the first route
+        const auto edges_path = file_for("edgesdata");
+        const auto geometries_path = file_for("geometries");
+        const auto names_path = file_for("namesdata");
+        m_edge_information.reset(new ColdBlock("edge annotations", cold_data_loading, [=]
+                                               {
+                                                   LoadEdgeInformation(edges_path);
+                                               }));
+        m_geometries.reset(new ColdBlock("geometries", cold_data_loading, [=]
+                                         {
+                                             LoadGeometries(geometries_path);
+                                         }));
+        m_street_names.reset(new ColdBlock("street names", cold_data_loading, [=]
+                                           {
+                                               LoadStreetNames(names_path);
+                                           }));
     }
 
     // search graph access
@@ -290,7 +391,7 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
 
     NodeID GetTarget(const EdgeID e) const override final { return m_query_graph->GetTarget(e); }
 
-    EdgeDataT &GetEdgeData(const EdgeID e) const override final
+    EdgeDataT GetEdgeData(const EdgeID e) const override final
     {
         return m_query_graph->GetEdgeData(e);
     }
@@ -329,16 +430,19 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
 
     bool EdgeIsCompressed(const unsigned id) const override final
     {
+        m_edge_information->Require();
         return m_edge_is_compressed.at(id);
     }
 
     extractor::TurnInstruction GetTurnInstructionForEdgeID(const unsigned id) const override final
     {
+        m_edge_information->Require();
         return m_turn_instruction_list.at(id);
     }
 
     extractor::TravelMode GetTravelModeForEdgeID(const unsigned id) const override final
     {
+        m_edge_information->Require();
         return m_travel_mode_list.at(id);
     }
 
@@ -393,6 +497,7 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
 
     unsigned GetNameIndexFromEdgeID(const unsigned id) const override final
     {
+        m_edge_information->Require();
         return m_name_ID_list.at(id);
     }
 
@@ -402,6 +507,7 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
         {
             return "";
         }
+        m_street_names->Require();
         auto range = m_name_table.GetRange(name_id);
 
         std::string result;
@@ -417,6 +523,7 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
 
     virtual unsigned GetGeometryIndexForEdgeID(const unsigned id) const override final
     {
+        m_edge_information->Require();
         return m_via_node_list.at(id);
     }
 
@@ -437,6 +544,7 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
     virtual void GetUncompressedGeometry(const unsigned id,
                                          std::vector<unsigned> &result_nodes) const override final
     {
+        m_geometries->Require();
         const unsigned begin = m_geometry_indices.at(id);
         const unsigned end = m_geometry_indices.at(id + 1);
 
@@ -446,6 +554,73 @@ template <class EdgeDataT> class InternalDataFacade final : public BaseDataFacad
     }
 
     std::string GetTimestamp() const override final { return m_timestamp; }
+
+    unsigned GetNumberOfSweepLevels() const override final
+    {
+        return m_sweep_level_offsets.empty() ? 0 : m_sweep_level_offsets.size() - 1;
+    }
+
+    util::range<unsigned> GetSweepLevel(const unsigned level) const override final
+    {
+        BOOST_ASSERT(level + 1 < m_sweep_level_offsets.size());
+        return util::irange(m_sweep_level_offsets[level], m_sweep_level_offsets[level + 1]);
+    }
+
+    NodeID GetSweepNode(const unsigned position) const override final
+    {
+        return m_sweep_order[position];
+    }
+
+    util::FixedPointCoordinate GetLocationOfEdgeBasedNode(const NodeID id) const override final
+    {
+        return m_node_locations.at(id);
+    }
+
+    bool HasColdData() const override final { return m_cold_data_loading != ColdDataLoading::Skip; }
+
+    std::vector<ColdBlockStatistics> GetColdBlockStatistics() const override final
+    {
+        // the compression flags are a std::vector<bool>, they take one bit per edge
+        return {m_edge_information->GetStatistics(
+                    {MemoryOf(m_via_node_list), MemoryOf(m_name_ID_list),
+                     MemoryOf(m_turn_instruction_list), MemoryOf(m_travel_mode_list)}),
+                m_geometries->GetStatistics(
+                    {MemoryOf(m_geometry_indices), MemoryOf(m_geometry_list)}),
+                m_street_names->GetStatistics({MemoryOf(m_names_char_list)})};
+    }
+
+    std::vector<util::MemoryBlock> GetMemoryBlocks() const override final
+    {
+        auto blocks = m_query_graph->GetMemoryBlocks();
+        blocks.push_back(util::MakeMemoryBlock("coordinates", *m_coordinate_list));
+        blocks.push_back(util::MakeMemoryBlock("sweep order", m_sweep_order));
+        blocks.push_back(util::MakeMemoryBlock("sweep level offsets", m_sweep_level_offsets));
+        blocks.push_back(util::MakeMemoryBlock("node locations", m_node_locations));
+        if (m_edge_information->IsLoaded())
+        {
+            blocks.push_back(util::MakeMemoryBlock("via nodes", m_via_node_list));
+            blocks.push_back(util::MakeMemoryBlock("name ids", m_name_ID_list));
+            blocks.push_back(util::MakeMemoryBlock("turn instructions", m_turn_instruction_list));
+            blocks.push_back(util::MakeMemoryBlock("travel modes", m_travel_mode_list));
+        }
+        if (m_geometries->IsLoaded())
+        {
+            blocks.push_back(util::MakeMemoryBlock("geometry indices", m_geometry_indices));
+            blocks.push_back(util::MakeMemoryBlock("geometries", m_geometry_list));
+        }
+        if (m_street_names->IsLoaded())
+        {
+            blocks.push_back(util::MakeMemoryBlock("name characters", m_names_char_list));
+        }
+        // every thread builds its own search tree, only the one of the calling thread is counted
+        if (m_static_rtree.get())
+        {
+            blocks.push_back(m_static_rtree->GetSearchTreeBlock("r-tree search tree"));
+        }
+        return blocks;
+    }
+
+    boost::filesystem::path GetLeafFilePath() const override final { return file_index_path; }
 };
 }
 }
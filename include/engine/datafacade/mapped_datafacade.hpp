@@ -0,0 +1,81 @@
+#ifndef MAPPED_DATAFACADE_HPP
+#define MAPPED_DATAFACADE_HPP
+
+// implements all data storage when the dataset is a single file mapped into memory
+
+#include "engine/datafacade/contiguous_datafacade.hpp"
+#include "engine/datafacade/shared_datatype.hpp"
+
+#include "datastore/dataset_file.hpp"
+#include "util/osrm_exception.hpp"
+#include "util/simple_logger.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <string>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+// The file written by osrm-pack is mapped read-only and used in place. Nothing is parsed or
+// copied, pages are read on first access and shared with all other processes that map the file.
+template <class EdgeDataT> class MappedDataFacade final : public ContiguousDataFacade<EdgeDataT>
+{
+  private:
+    using super = ContiguousDataFacade<EdgeDataT>;
+
+    boost::interprocess::file_mapping m_file;
+    boost::interprocess::mapped_region m_region;
+
+  public:
+    explicit MappedDataFacade(const boost::filesystem::path &dataset_path)
+    {
+        if (!boost::filesystem::is_regular_file(dataset_path))
+        {
+            throw util::exception(dataset_path.string() + " not found");
+        }
+        const auto file_size = boost::filesystem::file_size(dataset_path);
+        if (file_size < datastore::DATASET_DATA_OFFSET)
+        {
+            throw util::exception(dataset_path.string() + " is not a dataset");
+        }
+
+        m_file = boost::interprocess::file_mapping(dataset_path.string().c_str(),
+                                                   boost::interprocess::read_only);
+        m_region = boost::interprocess::mapped_region(m_file, boost::interprocess::read_only);
+        // the mapping is read-only, nothing writes to the data once it is loaded
+        char *memory = static_cast<char *>(m_region.get_address());
+
+        auto *header = reinterpret_cast<datastore::DatasetFileHeader *>(memory);
+        if (!header->IsDataset())
+        {
+            throw util::exception(dataset_path.string() + " is not a dataset");
+        }
+        if (!header->IsCompatible())
+        {
+            throw util::exception(dataset_path.string() +
+                                  " was written by a different build, run osrm-pack again");
+        }
+        if (file_size < datastore::DATASET_DATA_OFFSET + header->layout.GetSizeOfLayout())
+        {
+            throw util::exception(dataset_path.string() + " is truncated");
+        }
+
+        util::SimpleLogger().Write() << "mapped dataset " << dataset_path.string() << " of "
+                                     << file_size << " bytes";
+        super::LoadData(&header->layout, memory + datastore::DATASET_DATA_OFFSET, 1);
+    }
+
+    virtual ~MappedDataFacade() {}
+};
+}
+}
+}
+
+#endif // MAPPED_DATAFACADE_HPP
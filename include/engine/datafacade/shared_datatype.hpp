@@ -7,6 +7,7 @@
 #include <cstdint>
 
 #include <array>
+#include <string>
 
 namespace osrm
 {
@@ -19,6 +20,8 @@ namespace
 {
 // Added at the start and end of each block as sanity check
 static const char CANARY[] = "OSRM";
+// Blocks start at cache line boundaries, mappings of the data start at page boundaries.
+static const constexpr uint64_t BLOCK_ALIGNMENT = 64;
 }
 
 struct SharedDataLayout
@@ -43,6 +46,10 @@ struct SharedDataLayout
         TIMESTAMP,
         FILE_INDEX_PATH,
         CORE_MARKER,
+        SWEEP_ORDER,
+        SWEEP_LEVEL_OFFSETS,
+        NODE_LOCATIONS,
+        R_SEARCH_TREE_LEAVES,
         NUM_BLOCKS
     };
 
@@ -51,44 +58,29 @@ struct SharedDataLayout
 
     SharedDataLayout() : num_entries(), entry_size() {}
 
+    static const char *GetBlockName(const BlockID bid)
+    {
+        static const char *names[NUM_BLOCKS] = {
+            "NAME_OFFSETS",     "NAME_BLOCKS",           "NAME_CHAR_LIST",
+            "NAME_ID_LIST",     "VIA_NODE_LIST",         "GRAPH_NODE_LIST",
+            "GRAPH_EDGE_LIST",  "COORDINATE_LIST",       "TURN_INSTRUCTION",
+            "TRAVEL_MODE",      "R_SEARCH_TREE",         "GEOMETRIES_INDEX",
+            "GEOMETRIES_LIST",  "GEOMETRIES_INDICATORS", "HSGR_CHECKSUM",
+            "TIMESTAMP",        "FILE_INDEX_PATH",       "CORE_MARKER",
+            "SWEEP_ORDER",      "SWEEP_LEVEL_OFFSETS",   "NODE_LOCATIONS",
+            "R_SEARCH_TREE_LEAVES"};
+        return names[bid];
+    }
+
     void PrintInformation() const
     {
-        util::SimpleLogger().Write(logDEBUG) << "NAME_OFFSETS         "
-                                             << ": " << GetBlockSize(NAME_OFFSETS);
-        util::SimpleLogger().Write(logDEBUG) << "NAME_BLOCKS          "
-                                             << ": " << GetBlockSize(NAME_BLOCKS);
-        util::SimpleLogger().Write(logDEBUG) << "NAME_CHAR_LIST       "
-                                             << ": " << GetBlockSize(NAME_CHAR_LIST);
-        util::SimpleLogger().Write(logDEBUG) << "NAME_ID_LIST         "
-                                             << ": " << GetBlockSize(NAME_ID_LIST);
-        util::SimpleLogger().Write(logDEBUG) << "VIA_NODE_LIST        "
-                                             << ": " << GetBlockSize(VIA_NODE_LIST);
-        util::SimpleLogger().Write(logDEBUG) << "GRAPH_NODE_LIST      "
-                                             << ": " << GetBlockSize(GRAPH_NODE_LIST);
-        util::SimpleLogger().Write(logDEBUG) << "GRAPH_EDGE_LIST      "
-                                             << ": " << GetBlockSize(GRAPH_EDGE_LIST);
-        util::SimpleLogger().Write(logDEBUG) << "COORDINATE_LIST      "
-                                             << ": " << GetBlockSize(COORDINATE_LIST);
-        util::SimpleLogger().Write(logDEBUG) << "TURN_INSTRUCTION     "
-                                             << ": " << GetBlockSize(TURN_INSTRUCTION);
-        util::SimpleLogger().Write(logDEBUG) << "TRAVEL_MODE          "
-                                             << ": " << GetBlockSize(TRAVEL_MODE);
-        util::SimpleLogger().Write(logDEBUG) << "R_SEARCH_TREE        "
-                                             << ": " << GetBlockSize(R_SEARCH_TREE);
-        util::SimpleLogger().Write(logDEBUG) << "GEOMETRIES_INDEX     "
-                                             << ": " << GetBlockSize(GEOMETRIES_INDEX);
-        util::SimpleLogger().Write(logDEBUG) << "GEOMETRIES_LIST      "
-                                             << ": " << GetBlockSize(GEOMETRIES_LIST);
-        util::SimpleLogger().Write(logDEBUG) << "GEOMETRIES_INDICATORS"
-                                             << ": " << GetBlockSize(GEOMETRIES_INDICATORS);
-        util::SimpleLogger().Write(logDEBUG) << "HSGR_CHECKSUM        "
-                                             << ": " << GetBlockSize(HSGR_CHECKSUM);
-        util::SimpleLogger().Write(logDEBUG) << "TIMESTAMP            "
-                                             << ": " << GetBlockSize(TIMESTAMP);
-        util::SimpleLogger().Write(logDEBUG) << "FILE_INDEX_PATH      "
-                                             << ": " << GetBlockSize(FILE_INDEX_PATH);
-        util::SimpleLogger().Write(logDEBUG) << "CORE_MARKER          "
-                                             << ": " << GetBlockSize(CORE_MARKER);
+        for (auto i = 0; i < NUM_BLOCKS; ++i)
+        {
+            std::string name = GetBlockName(static_cast<BlockID>(i));
+            name.resize(21, ' ');
+            util::SimpleLogger().Write(logDEBUG) << name << ": "
+                                                 << GetBlockSize(static_cast<BlockID>(i));
+        }
     }
 
     template <typename T> inline void SetBlockSize(BlockID bid, uint64_t entries)
@@ -108,21 +100,32 @@ struct SharedDataLayout
         return num_entries[bid] * entry_size[bid];
     }
 
+    // The names, the annotations of the original edges and the geometries are only read to
+    // describe routes. A dataset for distance tables leaves them out.
+    inline bool HasColdBlocks() const { return num_entries[NAME_OFFSETS] > 0; }
+
     inline uint64_t GetSizeOfLayout() const
     {
         return GetBlockOffset(NUM_BLOCKS) + NUM_BLOCKS * 2 * sizeof(CANARY);
     }
 
+    // Every block is preceded by a canary and starts at the next multiple of BLOCK_ALIGNMENT,
+    // its end canary follows right behind it.
     inline uint64_t GetBlockOffset(BlockID bid) const
     {
-        uint64_t result = sizeof(CANARY);
+        uint64_t result = AlignBlockOffset(sizeof(CANARY));
         for (auto i = 0; i < bid; i++)
         {
-            result += GetBlockSize((BlockID)i) + 2 * sizeof(CANARY);
+            result = AlignBlockOffset(result + GetBlockSize((BlockID)i) + 2 * sizeof(CANARY));
         }
         return result;
     }
 
+    static inline uint64_t AlignBlockOffset(const uint64_t offset)
+    {
+        return (offset + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+    }
+
     template <typename T, bool WRITE_CANARY = false>
     inline T *GetBlockPtr(char *shared_memory, BlockID bid)
     {
@@ -4,6 +4,7 @@
 #include "util/coordinate_calculation.hpp"
 #include "util/typedefs.hpp"
 #include "engine/phantom_node.hpp"
+#include "engine/snapping_cache.hpp"
 #include "util/bearing.hpp"
 
 #include "osrm/coordinate.hpp"
@@ -20,15 +21,21 @@ namespace engine
 
 // Implements complex queries on top of an RTree and builds PhantomNodes from it.
 //
-// Only holds a weak reference on the RTree!
+// Only holds a weak reference on the RTree and the snapping cache!
 template <typename RTreeT> class GeospatialQuery
 {
     using EdgeData = typename RTreeT::EdgeData;
     using CoordinateList = typename RTreeT::CoordinateList;
 
   public:
-    GeospatialQuery(RTreeT &rtree_, std::shared_ptr<CoordinateList> coordinates_)
-        : rtree(rtree_), coordinates(coordinates_)
+    using SnappingCacheT = SnappingCache<EdgeData>;
+
+    GeospatialQuery(RTreeT &rtree_,
+                    std::shared_ptr<CoordinateList> coordinates_,
+                    SnappingCacheT *snapping_cache_ = nullptr,
+                    const unsigned checksum_ = 0)
+        : rtree(rtree_), coordinates(coordinates_), snapping_cache(snapping_cache_),
+          checksum(checksum_)
     {
     }
 
@@ -81,6 +88,46 @@ template <typename RTreeT> class GeospatialQuery
         const util::FixedPointCoordinate &input_coordinate,
         const int bearing = 0,
         const int bearing_range = 180)
+    {
+        if (snapping_cache && snapping_cache->IsEnabled())
+        {
+            const auto key =
+                SnappingCacheT::MakeKey(checksum, input_coordinate, bearing, bearing_range);
+            auto segments = snapping_cache->Find(key);
+            if (!segments)
+            {
+                const auto results =
+                    NearestSegmentsWithAlternativeFromBigComponent(input_coordinate, bearing,
+                                                                   bearing_range);
+                if (results.empty())
+                {
+                    return std::make_pair(PhantomNode{}, PhantomNode{});
+                }
+                segments = std::make_pair(results.front(), results.back());
+                snapping_cache->Insert(key, *segments);
+            }
+            return std::make_pair(MakePhantomNode(input_coordinate, segments->first).phantom_node,
+                                  MakePhantomNode(input_coordinate, segments->second).phantom_node);
+        }
+
+        const auto results =
+            NearestSegmentsWithAlternativeFromBigComponent(input_coordinate, bearing, bearing_range);
+        if (results.size() == 0)
+        {
+            return std::make_pair(PhantomNode{}, PhantomNode{});
+        }
+
+        BOOST_ASSERT(results.size() > 0);
+        return std::make_pair(MakePhantomNode(input_coordinate, results.front()).phantom_node,
+                              MakePhantomNode(input_coordinate, results.back()).phantom_node);
+    }
+
+  private:
+    // Returns the nearest segments up to and including the first one in a big component.
+    std::vector<EdgeData>
+    NearestSegmentsWithAlternativeFromBigComponent(const util::FixedPointCoordinate &input_coordinate,
+                                                   const int bearing,
+                                                   const int bearing_range)
     {
         bool has_small_component = false;
         bool has_big_component = false;
@@ -110,17 +157,9 @@ template <typename RTreeT> class GeospatialQuery
                 return num_results > 0 && has_big_component;
             });
 
-        if (results.size() == 0)
-        {
-            return std::make_pair(PhantomNode{}, PhantomNode{});
-        }
-
-        BOOST_ASSERT(results.size() > 0);
-        return std::make_pair(MakePhantomNode(input_coordinate, results.front()).phantom_node,
-                              MakePhantomNode(input_coordinate, results.back()).phantom_node);
+        return results;
     }
 
-  private:
     std::vector<PhantomNodeWithDistance>
     MakePhantomNodes(const util::FixedPointCoordinate &input_coordinate,
                      const std::vector<EdgeData> &results) const
@@ -184,6 +223,8 @@ template <typename RTreeT> class GeospatialQuery
 
     RTreeT &rtree;
     const std::shared_ptr<CoordinateList> coordinates;
+    SnappingCacheT *snapping_cache;
+    const unsigned checksum;
 };
 }
 }
@@ -35,7 +35,8 @@ template <typename DataFacadeT> class SegmentList
                 const bool extract_alternative,
                 const unsigned zoom_level,
                 const bool allow_simplification,
-                const DataFacade *facade);
+                const DataFacade *facade,
+                const std::size_t alternative_index = 0);
 
     const std::vector<std::uint32_t> &GetViaIndices() const;
     std::uint32_t GetDistance() const;
@@ -45,7 +46,7 @@ template <typename DataFacadeT> class SegmentList
 
   private:
     void InitRoute(const PhantomNode &phantom_node, const bool traversed_in_reverse);
-    void AddLeg(const std::vector<PathData> &leg_data,
+    void AddLeg(const util::ArenaVector<PathData> &leg_data,
                 const PhantomNode &target_node,
                 const bool traversed_in_reverse,
                 const bool is_via_leg,
@@ -53,6 +54,7 @@ template <typename DataFacadeT> class SegmentList
 
     void AppendSegment(const FixedPointCoordinate &coordinate, const PathData &path_point);
     void Finalize(const bool extract_alternative,
+                  const std::size_t alternative_index,
                   const InternalRouteResult &raw_route,
                   const unsigned zoom_level,
                   const bool allow_simplification);
@@ -74,7 +76,8 @@ SegmentList<DataFacadeT>::SegmentList(const InternalRouteResult &raw_route,
                                       const bool extract_alternative,
                                       const unsigned zoom_level,
                                       const bool allow_simplification,
-                                      const DataFacade *facade)
+                                      const DataFacade *facade,
+                                      const std::size_t alternative_index)
     : total_distance(0), total_duration(0)
 {
     if (!raw_route.is_valid())
@@ -84,12 +87,12 @@ SegmentList<DataFacadeT>::SegmentList(const InternalRouteResult &raw_route,
 
     if (extract_alternative)
     {
-        BOOST_ASSERT(raw_route.has_alternative());
+        BOOST_ASSERT(alternative_index < raw_route.unpacked_alternatives.size());
         InitRoute(raw_route.segment_end_coordinates.front().source_phantom,
-                  raw_route.alt_source_traversed_in_reverse.front());
-        AddLeg(raw_route.unpacked_alternative,
+                  raw_route.alt_source_traversed_in_reverse[alternative_index]);
+        AddLeg(raw_route.unpacked_alternatives[alternative_index],
                raw_route.segment_end_coordinates.back().target_phantom,
-               raw_route.alt_source_traversed_in_reverse.back(), false, facade);
+               raw_route.alt_target_traversed_in_reverse[alternative_index], false, facade);
     }
     else
     {
@@ -131,7 +134,8 @@ SegmentList<DataFacadeT>::SegmentList(const InternalRouteResult &raw_route,
         }
     }
 
-    Finalize(extract_alternative, raw_route, zoom_level, allow_simplification);
+    Finalize(extract_alternative, alternative_index, raw_route, zoom_level,
+             allow_simplification);
 }
 
 template <typename DataFacadeT>
@@ -147,7 +151,7 @@ void SegmentList<DataFacadeT>::InitRoute(const PhantomNode &node, const bool tra
 }
 
 template <typename DataFacadeT>
-void SegmentList<DataFacadeT>::AddLeg(const std::vector<PathData> &leg_data,
+void SegmentList<DataFacadeT>::AddLeg(const util::ArenaVector<PathData> &leg_data,
                                       const PhantomNode &target_node,
                                       const bool traversed_in_reverse,
                                       const bool is_via_leg,
@@ -228,6 +232,7 @@ void SegmentList<DataFacadeT>::AppendSegment(const FixedPointCoordinate &coordin
 
 template <typename DataFacadeT>
 void SegmentList<DataFacadeT>::Finalize(const bool extract_alternative,
+                                        const std::size_t alternative_index,
                                         const InternalRouteResult &raw_route,
                                         const unsigned zoom_level,
                                         const bool allow_simplification)
@@ -269,7 +274,8 @@ void SegmentList<DataFacadeT>::Finalize(const bool extract_alternative,
 
     total_distance = static_cast<std::uint32_t>(std::round(path_length));
     total_duration = static_cast<std::uint32_t>(std::round(
-        (extract_alternative ? raw_route.alternative_path_length : raw_route.shortest_path_length) /
+        (extract_alternative ? raw_route.alternative_path_lengths[alternative_index]
+                             : raw_route.shortest_path_length) /
         10.));
 
     // Post-processing to remove empty or nearly empty path segments
@@ -328,10 +334,11 @@ SegmentList<DataFacadeT> MakeSegmentList(const InternalRouteResult &raw_route,
                                          const bool extract_alternative,
                                          const unsigned zoom_level,
                                          const bool allow_simplification,
-                                         const DataFacadeT *facade)
+                                         const DataFacadeT *facade,
+                                         const std::size_t alternative_index = 0)
 {
     return SegmentList<DataFacadeT>(raw_route, extract_alternative, zoom_level,
-                                    allow_simplification, facade);
+                                    allow_simplification, facade, alternative_index);
 }
 
 } // namespace guidance
@@ -4,6 +4,7 @@
 #include "engine/phantom_node.hpp"
 #include "extractor/travel_mode.hpp"
 #include "extractor/turn_instructions.hpp"
+#include "util/request_arena.hpp"
 #include "util/typedefs.hpp"
 
 #include "osrm/coordinate.hpp"
@@ -42,29 +43,27 @@ struct PathData
 
 struct InternalRouteResult
 {
-    std::vector<std::vector<PathData>> unpacked_path_segments;
-    std::vector<PathData> unpacked_alternative;
+    std::vector<util::ArenaVector<PathData>> unpacked_path_segments;
+    // alternatives ordered by their rank, all of them have the same source and target
+    std::vector<util::ArenaVector<PathData>> unpacked_alternatives;
     std::vector<PhantomNodes> segment_end_coordinates;
     std::vector<bool> source_traversed_in_reverse;
     std::vector<bool> target_traversed_in_reverse;
     std::vector<bool> alt_source_traversed_in_reverse;
     std::vector<bool> alt_target_traversed_in_reverse;
     int shortest_path_length;
-    int alternative_path_length;
+    std::vector<int> alternative_path_lengths;
 
     bool is_valid() const { return INVALID_EDGE_WEIGHT != shortest_path_length; }
 
-    bool has_alternative() const { return INVALID_EDGE_WEIGHT != alternative_path_length; }
+    bool has_alternative() const { return !alternative_path_lengths.empty(); }
 
     bool is_via_leg(const std::size_t leg) const
     {
         return (leg != unpacked_path_segments.size() - 1);
     }
 
-    InternalRouteResult()
-        : shortest_path_length(INVALID_EDGE_WEIGHT), alternative_path_length(INVALID_EDGE_WEIGHT)
-    {
-    }
+    InternalRouteResult() : shortest_path_length(INVALID_EDGE_WEIGHT) {}
 };
 }
 }
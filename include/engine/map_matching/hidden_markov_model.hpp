@@ -4,10 +4,15 @@
 #include "util/integer_range.hpp"
 
 #include <boost/assert.hpp>
+#include <boost/range/iterator_range.hpp>
 
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 
 #include <limits>
+#include <memory>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -36,6 +41,19 @@ struct EmissionLogProbability
     {
         return -0.5 * (log_2_pi + (distance / sigma_z) * (distance / sigma_z)) - log_sigma_z;
     }
+
+    // Replaces the distances in [begin, end) by their log probabilities. This is a plain loop
+    // over contiguous memory, so that the compiler vectorizes it.
+    void operator()(double *begin, double *end) const
+    {
+        const double local_sigma_z = sigma_z;
+        const double local_log_sigma_z = log_sigma_z;
+        for (auto iter = begin; iter != end; ++iter)
+        {
+            const double normalized = *iter / local_sigma_z;
+            *iter = -0.5 * (log_2_pi + normalized * normalized) - local_log_sigma_z;
+        }
+    }
 };
 
 struct TransitionLogProbability
@@ -47,59 +65,205 @@ struct TransitionLogProbability
     double operator()(const double d_t) const { return -log_beta - d_t / beta; }
 };
 
+// Index of the first maximum in [begin, end). The maximum is found in a separate reduction
+// without branches on the index, which the compiler is able to vectorize.
+template <typename RandomIter> std::size_t ArgMax(RandomIter begin, RandomIter end)
+{
+    BOOST_ASSERT(begin != end);
+    auto max_value = *begin;
+    for (auto iter = begin; iter != end; ++iter)
+    {
+        max_value = *iter > max_value ? *iter : max_value;
+    }
+    std::size_t index = 0;
+    while (begin[index] != max_value)
+    {
+        ++index;
+    }
+    return index;
+}
+
+// The states of all timestamps stored back to back in one array per value. The states of
+// timestamp t are [offsets[t], offsets[t + 1]). A storage can be reused for many traces,
+// it keeps its capacity when it is cleared.
+struct StateStorage
+{
+    std::vector<std::size_t> offsets;
+    std::vector<double> emission_log_probabilities;
+    std::vector<double> viterbi;
+    std::vector<std::pair<unsigned, unsigned>> parents;
+    std::vector<double> path_lengths;
+    std::vector<std::uint8_t> pruned;
+    std::vector<std::uint8_t> suspicious;
+
+    void clear()
+    {
+        offsets.clear();
+        offsets.push_back(0);
+        emission_log_probabilities.clear();
+        viterbi.clear();
+        parents.clear();
+        path_lengths.clear();
+        pruned.clear();
+        suspicious.clear();
+    }
+
+    std::size_t size() const { return offsets.size() - 1; }
+
+    std::size_t GetMemoryUsage() const
+    {
+        return offsets.capacity() * sizeof(std::size_t) +
+               (emission_log_probabilities.capacity() + viterbi.capacity() +
+                path_lengths.capacity()) *
+                   sizeof(double) +
+               parents.capacity() * sizeof(std::pair<unsigned, unsigned>) +
+               (pruned.capacity() + suspicious.capacity()) * sizeof(std::uint8_t);
+    }
+
+    // appends the states of a timestamp
+    void push_back(const std::size_t num_candidates)
+    {
+        const auto num_states = offsets.back() + num_candidates;
+        offsets.push_back(num_states);
+        emission_log_probabilities.resize(num_states);
+        viterbi.resize(num_states);
+        parents.resize(num_states);
+        path_lengths.resize(num_states);
+        pruned.resize(num_states);
+        suspicious.resize(num_states);
+    }
+
+    // removes the states of the last timestamp
+    void pop_back()
+    {
+        BOOST_ASSERT(size() > 0);
+        offsets.pop_back();
+        resize_states(offsets.back());
+    }
+
+    // removes the states of the first timestamps
+    void erase_front(const std::size_t count)
+    {
+        BOOST_ASSERT(count <= size());
+        const auto num_erased = offsets[count];
+        erase_states(emission_log_probabilities, num_erased);
+        erase_states(viterbi, num_erased);
+        erase_states(parents, num_erased);
+        erase_states(path_lengths, num_erased);
+        erase_states(pruned, num_erased);
+        erase_states(suspicious, num_erased);
+        offsets.erase(offsets.begin(), offsets.begin() + count);
+        for (auto &offset : offsets)
+        {
+            offset -= num_erased;
+        }
+    }
+
+  private:
+    void resize_states(const std::size_t num_states)
+    {
+        emission_log_probabilities.resize(num_states);
+        viterbi.resize(num_states);
+        parents.resize(num_states);
+        path_lengths.resize(num_states);
+        pruned.resize(num_states);
+        suspicious.resize(num_states);
+    }
+
+    template <typename T> static void erase_states(std::vector<T> &values, const std::size_t count)
+    {
+        values.erase(values.begin(), values.begin() + count);
+    }
+};
+
+// View of one value of a StateStorage that is indexed like a vector of vectors.
+template <typename T> class StateTable
+{
+  public:
+    using Row = boost::iterator_range<typename std::vector<T>::iterator>;
+    using ConstRow = boost::iterator_range<typename std::vector<T>::const_iterator>;
+
+    StateTable(const std::vector<std::size_t> &offsets, std::vector<T> &values)
+        : offsets(offsets), values(values)
+    {
+    }
+
+    Row operator[](const std::size_t timestamp)
+    {
+        return Row(values.begin() + offsets[timestamp], values.begin() + offsets[timestamp + 1]);
+    }
+
+    ConstRow operator[](const std::size_t timestamp) const
+    {
+        return ConstRow(values.begin() + offsets[timestamp],
+                        values.begin() + offsets[timestamp + 1]);
+    }
+
+    std::size_t size() const { return offsets.size() - 1; }
+
+  private:
+    const std::vector<std::size_t> &offsets;
+    std::vector<T> &values;
+};
+
 template <class CandidateLists> struct HiddenMarkovModel
 {
-    std::vector<std::vector<double>> viterbi;
-    std::vector<std::vector<std::pair<unsigned, unsigned>>> parents;
-    std::vector<std::vector<float>> path_lengths;
-    std::vector<std::vector<bool>> pruned;
-    std::vector<std::vector<bool>> suspicious;
+  private:
+    std::unique_ptr<StateStorage> owned_storage;
+    StateStorage &storage;
+
+  public:
+    StateTable<double> emission_log_probabilities;
+    StateTable<double> viterbi;
+    StateTable<std::pair<unsigned, unsigned>> parents;
+    StateTable<double> path_lengths;
+    StateTable<std::uint8_t> pruned;
+    StateTable<std::uint8_t> suspicious;
     std::vector<bool> breakage;
 
     const CandidateLists &candidates_list;
     const EmissionLogProbability &emission_log_probability;
 
+    // uses its own storage
     HiddenMarkovModel(const CandidateLists &candidates_list,
                       const EmissionLogProbability &emission_log_probability)
-        : breakage(candidates_list.size()), candidates_list(candidates_list),
-          emission_log_probability(emission_log_probability)
-    {
-        viterbi.resize(candidates_list.size());
-        parents.resize(candidates_list.size());
-        path_lengths.resize(candidates_list.size());
-        suspicious.resize(candidates_list.size());
-        pruned.resize(candidates_list.size());
-        breakage.resize(candidates_list.size());
-        for (const auto i : util::irange<std::size_t>(0u, candidates_list.size()))
-        {
-            const auto &num_candidates = candidates_list[i].size();
-            // add empty vectors
-            if (num_candidates > 0)
-            {
-                viterbi[i].resize(num_candidates);
-                parents[i].resize(num_candidates);
-                path_lengths[i].resize(num_candidates);
-                suspicious[i].resize(num_candidates);
-                pruned[i].resize(num_candidates);
-            }
-        }
+        : HiddenMarkovModel(candidates_list,
+                            emission_log_probability,
+                            std::unique_ptr<StateStorage>(new StateStorage()))
+    {
+    }
 
-        clear(0);
+    // uses the given storage, which can be shared by all models of a thread
+    HiddenMarkovModel(const CandidateLists &candidates_list,
+                      const EmissionLogProbability &emission_log_probability,
+                      StateStorage &shared_storage)
+        : storage(shared_storage),
+          emission_log_probabilities(storage.offsets, storage.emission_log_probabilities),
+          viterbi(storage.offsets, storage.viterbi), parents(storage.offsets, storage.parents),
+          path_lengths(storage.offsets, storage.path_lengths),
+          pruned(storage.offsets, storage.pruned), suspicious(storage.offsets, storage.suspicious),
+          candidates_list(candidates_list), emission_log_probability(emission_log_probability)
+    {
+        storage.clear();
+        grow();
     }
 
+    HiddenMarkovModel(const HiddenMarkovModel &) = delete;
+    HiddenMarkovModel &operator=(const HiddenMarkovModel &) = delete;
+
     void clear(std::size_t initial_timestamp)
     {
-        BOOST_ASSERT(viterbi.size() == parents.size() && parents.size() == path_lengths.size() &&
-                     path_lengths.size() == pruned.size() && pruned.size() == breakage.size());
+        BOOST_ASSERT(storage.size() == breakage.size());
+        BOOST_ASSERT(initial_timestamp <= storage.size());
 
-        for (const auto t : util::irange(initial_timestamp, viterbi.size()))
-        {
-            std::fill(viterbi[t].begin(), viterbi[t].end(), IMPOSSIBLE_LOG_PROB);
-            std::fill(parents[t].begin(), parents[t].end(), std::make_pair(0u, 0u));
-            std::fill(path_lengths[t].begin(), path_lengths[t].end(), 0);
-            std::fill(suspicious[t].begin(), suspicious[t].end(), true);
-            std::fill(pruned[t].begin(), pruned[t].end(), true);
-        }
+        const auto first_state = storage.offsets[initial_timestamp];
+        std::fill(storage.viterbi.begin() + first_state, storage.viterbi.end(),
+                  IMPOSSIBLE_LOG_PROB);
+        std::fill(storage.parents.begin() + first_state, storage.parents.end(),
+                  std::make_pair(0u, 0u));
+        std::fill(storage.path_lengths.begin() + first_state, storage.path_lengths.end(), 0);
+        std::fill(storage.suspicious.begin() + first_state, storage.suspicious.end(), true);
+        std::fill(storage.pruned.begin() + first_state, storage.pruned.end(), true);
         std::fill(breakage.begin() + initial_timestamp, breakage.end(), true);
     }
 
@@ -110,17 +274,7 @@ template <class CandidateLists> struct HiddenMarkovModel
         {
             BOOST_ASSERT(initial_timestamp < num_points);
 
-            for (const auto s : util::irange<std::size_t>(0u, viterbi[initial_timestamp].size()))
-            {
-                viterbi[initial_timestamp][s] =
-                    emission_log_probability(candidates_list[initial_timestamp][s].distance);
-                parents[initial_timestamp][s] = std::make_pair(initial_timestamp, s);
-                pruned[initial_timestamp][s] = viterbi[initial_timestamp][s] < MINIMAL_LOG_PROB;
-                suspicious[initial_timestamp][s] = false;
-
-                breakage[initial_timestamp] =
-                    breakage[initial_timestamp] && pruned[initial_timestamp][s];
-            }
+            initialize_timestamp(initial_timestamp);
 
             ++initial_timestamp;
         } while (initial_timestamp < num_points && breakage[initial_timestamp - 1]);
@@ -137,6 +291,104 @@ template <class CandidateLists> struct HiddenMarkovModel
 
         return initial_timestamp;
     }
+
+    // sets the initial probabilities of a single timestamp and returns true if any of its
+    // candidates was not pruned
+    bool initialize_timestamp(const std::size_t timestamp)
+    {
+        for (const auto s : util::irange<std::size_t>(0u, viterbi[timestamp].size()))
+        {
+            viterbi[timestamp][s] = emission_log_probabilities[timestamp][s];
+            parents[timestamp][s] = std::make_pair(timestamp, s);
+            pruned[timestamp][s] = viterbi[timestamp][s] < MINIMAL_LOG_PROB;
+            suspicious[timestamp][s] = false;
+
+            breakage[timestamp] = breakage[timestamp] && pruned[timestamp][s];
+        }
+        return !breakage[timestamp];
+    }
+
+    // The following functions are used to keep a sliding window over a trace: the caller
+    // appends or removes candidate lists and then updates the model accordingly.
+
+    // adds cleared states for all candidate lists that were appended
+    void grow()
+    {
+        const auto first_new_timestamp = storage.size();
+        const auto num_points = candidates_list.size();
+        BOOST_ASSERT(first_new_timestamp <= num_points);
+
+        for (const auto t : util::irange(first_new_timestamp, num_points))
+        {
+            storage.push_back(candidates_list[t].size());
+        }
+        breakage.resize(num_points);
+
+        // gather the distances first and compute all emission probabilities in one batch
+        const auto first_new_state = storage.offsets[first_new_timestamp];
+        auto distance_iter = storage.emission_log_probabilities.begin() + first_new_state;
+        for (const auto t : util::irange(first_new_timestamp, num_points))
+        {
+            for (const auto &candidate : candidates_list[t])
+            {
+                *distance_iter++ = candidate.distance;
+            }
+        }
+        BOOST_ASSERT(distance_iter == storage.emission_log_probabilities.end());
+        emission_log_probability(storage.emission_log_probabilities.data() + first_new_state,
+                                 storage.emission_log_probabilities.data() +
+                                     storage.emission_log_probabilities.size());
+
+        clear(first_new_timestamp);
+    }
+
+    // removes the states of the last timestamp
+    void pop_back()
+    {
+        BOOST_ASSERT(!breakage.empty());
+        storage.pop_back();
+        breakage.pop_back();
+    }
+
+    // removes the states of the first timestamps, the new first timestamp becomes a start state
+    void erase_front(const std::size_t count)
+    {
+        BOOST_ASSERT(count <= breakage.size());
+        storage.erase_front(count);
+        breakage.erase(breakage.begin(), breakage.begin() + count);
+
+        for (const auto t : util::irange<std::size_t>(0u, storage.size()))
+        {
+            for (const auto s : util::irange<std::size_t>(0u, parents[t].size()))
+            {
+                auto &parent = parents[t][s];
+                if (parent.first < count)
+                {
+                    parent = std::make_pair(t, s);
+                    path_lengths[t][s] = 0;
+                }
+                else
+                {
+                    parent.first -= count;
+                }
+            }
+        }
+    }
+
+  private:
+    HiddenMarkovModel(const CandidateLists &candidates_list,
+                      const EmissionLogProbability &emission_log_probability,
+                      std::unique_ptr<StateStorage> new_storage)
+        : owned_storage(std::move(new_storage)), storage(*owned_storage),
+          emission_log_probabilities(storage.offsets, storage.emission_log_probabilities),
+          viterbi(storage.offsets, storage.viterbi), parents(storage.offsets, storage.parents),
+          path_lengths(storage.offsets, storage.path_lengths),
+          pruned(storage.offsets, storage.pruned), suspicious(storage.offsets, storage.suspicious),
+          candidates_list(candidates_list), emission_log_probability(emission_log_probability)
+    {
+        storage.clear();
+        grow();
+    }
 };
 }
 }
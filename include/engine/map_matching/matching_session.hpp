@@ -0,0 +1,267 @@
+#ifndef MATCHING_SESSION_HPP
+#define MATCHING_SESSION_HPP
+
+#include "engine/map_matching/hidden_markov_model.hpp"
+#include "engine/phantom_node.hpp"
+#include "util/integer_range.hpp"
+
+#include "osrm/coordinate.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace map_matching
+{
+
+// State of an online map matching session. Points are pushed one at a time and only the
+// points that are not final yet are kept, together with their viterbi states.
+//
+// A point is final as soon as all candidates of the newest point that are still possible
+// share the same ancestor at that point. Since the window might never converge on a noisy
+// trace, it is bounded by MAX_WINDOW_SIZE and the oldest points are decided on the currently
+// most likely path once it grows larger.
+class MatchingSession
+{
+  public:
+    using CandidateLists = std::vector<std::vector<PhantomNodeWithDistance>>;
+    using HMM = HiddenMarkovModel<CandidateLists>;
+    // timestamp and candidate within the window
+    using State = std::pair<std::size_t, std::size_t>;
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t MAX_WINDOW_SIZE = 32;
+
+    MatchingSession(const double matching_beta,
+                    const double gps_precision,
+                    const unsigned dataset_checksum)
+        : dataset_checksum(dataset_checksum), emission_log_probability(gps_precision),
+          transition_log_probability(matching_beta),
+          model(candidates_list, emission_log_probability), last_unbroken(INVALID_STATE),
+          number_of_final_states(0), number_of_points(0), last_timestamp(0),
+          use_timestamps(false), continues_matching(false),
+          last_access(Clock::now().time_since_epoch().count())
+    {
+    }
+
+    // the model references the window
+    MatchingSession(const MatchingSession &) = delete;
+    MatchingSession &operator=(const MatchingSession &) = delete;
+
+    void Append(std::vector<PhantomNodeWithDistance> candidates,
+                const util::FixedPointCoordinate &coordinate,
+                const unsigned timestamp,
+                const unsigned index)
+    {
+        candidates_list.push_back(std::move(candidates));
+        coordinates.push_back(coordinate);
+        timestamps.push_back(timestamp);
+        indices.push_back(index);
+        model.grow();
+    }
+
+    void PopBack()
+    {
+        BOOST_ASSERT(!candidates_list.empty());
+        BOOST_ASSERT(last_unbroken == INVALID_STATE || last_unbroken + 1 < candidates_list.size());
+        model.pop_back();
+        candidates_list.pop_back();
+        coordinates.pop_back();
+        timestamps.pop_back();
+        indices.pop_back();
+    }
+
+    // Drops all states before the given timestamp of the window.
+    void EraseFront(const std::size_t count)
+    {
+        BOOST_ASSERT(count <= candidates_list.size());
+        model.erase_front(count);
+        candidates_list.erase(candidates_list.begin(), candidates_list.begin() + count);
+        coordinates.erase(coordinates.begin(), coordinates.begin() + count);
+        timestamps.erase(timestamps.begin(), timestamps.begin() + count);
+        indices.erase(indices.begin(), indices.begin() + count);
+
+        BOOST_ASSERT(last_unbroken == INVALID_STATE || last_unbroken >= count);
+        if (last_unbroken != INVALID_STATE)
+        {
+            last_unbroken -= count;
+        }
+        number_of_final_states -= std::min(number_of_final_states, count);
+    }
+
+    // Drops the whole window, the next point starts a new matching.
+    void Reset()
+    {
+        last_unbroken = INVALID_STATE;
+        EraseFront(candidates_list.size());
+        number_of_final_states = 0;
+        continues_matching = false;
+    }
+
+    // The time between two points is unsigned, so a point must not be older than the points
+    // that were pushed before it. Equal timestamps are fine.
+    bool AreTimestampsInOrder(const std::vector<unsigned> &new_timestamps) const
+    {
+        auto previous_timestamp = last_timestamp;
+        for (const auto timestamp : new_timestamps)
+        {
+            if (timestamp < previous_timestamp)
+            {
+                return false;
+            }
+            previous_timestamp = timestamp;
+        }
+        return true;
+    }
+
+    // can be called without holding the session mutex
+    void Touch() { last_access = Clock::now().time_since_epoch().count(); }
+
+    bool IsExpired(const Clock::duration timeout) const
+    {
+        return Clock::now().time_since_epoch().count() - last_access > timeout.count();
+    }
+
+    // Returns the newest state that all possible candidates of the last unbroken timestamp
+    // descend from, or INVALID_STATE if they do not converge after the final states.
+    State FindConvergence() const
+    {
+        if (last_unbroken == INVALID_STATE)
+        {
+            return State(INVALID_STATE, INVALID_STATE);
+        }
+
+        std::vector<std::size_t> states;
+        for (const auto s : util::irange<std::size_t>(0u, candidates_list[last_unbroken].size()))
+        {
+            if (!model.pruned[last_unbroken][s])
+            {
+                states.push_back(s);
+            }
+        }
+
+        std::size_t t = last_unbroken;
+        while (t >= number_of_final_states && !states.empty())
+        {
+            if (states.size() == 1)
+            {
+                return State(t, states.front());
+            }
+
+            // all parents of a timestamp belong to the same previous timestamp
+            const auto parent_timestamp = model.parents[t][states.front()].first;
+            if (parent_timestamp == t)
+            {
+                break;
+            }
+            for (auto &s : states)
+            {
+                BOOST_ASSERT(model.parents[t][s].first == parent_timestamp);
+                s = model.parents[t][s].second;
+            }
+            std::sort(states.begin(), states.end());
+            states.erase(std::unique(states.begin(), states.end()), states.end());
+            t = parent_timestamp;
+        }
+
+        return State(INVALID_STATE, INVALID_STATE);
+    }
+
+    // Most likely candidate of the last unbroken timestamp.
+    State GetMostLikelyState() const
+    {
+        BOOST_ASSERT(last_unbroken != INVALID_STATE);
+        const auto viterbi = model.viterbi[last_unbroken];
+        return State(last_unbroken, ArgMax(viterbi.begin(), viterbi.end()));
+    }
+
+    // Follows the parents of a state back to the first state that is not final yet.
+    std::deque<State> Backtrack(State state) const
+    {
+        std::deque<State> path;
+        while (state.first >= number_of_final_states)
+        {
+            path.push_front(state);
+            const auto &parent = model.parents[state.first][state.second];
+            if (parent.first == state.first)
+            {
+                break;
+            }
+            state = State(parent.first, parent.second);
+        }
+        return path;
+    }
+
+    // Removes every candidate that does not descend from the given state, so that all
+    // later decisions agree with it.
+    void Decide(const State decided)
+    {
+        std::vector<std::vector<bool>> descends(candidates_list.size());
+        descends[decided.first].resize(candidates_list[decided.first].size(), false);
+        descends[decided.first][decided.second] = true;
+
+        for (const auto t : util::irange(decided.first, candidates_list.size()))
+        {
+            descends[t].resize(candidates_list[t].size(), false);
+            for (const auto s : util::irange<std::size_t>(0u, candidates_list[t].size()))
+            {
+                const auto &parent = model.parents[t][s];
+                if (t > decided.first && !model.pruned[t][s] && parent.first < t &&
+                    parent.first >= decided.first)
+                {
+                    descends[t][s] = descends[parent.first][parent.second];
+                }
+
+                if (!descends[t][s])
+                {
+                    model.viterbi[t][s] = IMPOSSIBLE_LOG_PROB;
+                    model.pruned[t][s] = true;
+                }
+            }
+        }
+    }
+
+    std::mutex mutex;
+
+    // the candidates refer to the nodes of the dataset the session was opened on
+    const unsigned dataset_checksum;
+    const EmissionLogProbability emission_log_probability;
+    const TransitionLogProbability transition_log_probability;
+
+    // window of points that are not final yet, the first point might be final and is only
+    // kept as start of the next transitions
+    CandidateLists candidates_list;
+    std::vector<util::FixedPointCoordinate> coordinates;
+    std::vector<unsigned> timestamps;
+    std::vector<unsigned> indices;
+    HMM model;
+
+    std::size_t last_unbroken;
+    std::size_t number_of_final_states;
+
+    unsigned number_of_points;
+    // timestamp of the last pushed point, also if it could not be matched
+    unsigned last_timestamp;
+    // the last two pushed coordinates, also of points that could not be matched
+    std::deque<util::FixedPointCoordinate> last_input_coordinates;
+    bool use_timestamps;
+    // true if the next final point continues the last reported matching
+    bool continues_matching;
+    std::atomic<Clock::rep> last_access;
+};
+}
+}
+}
+
+#endif // MATCHING_SESSION_HPP
@@ -0,0 +1,111 @@
+#ifndef MATCHING_SESSION_STORE_HPP
+#define MATCHING_SESSION_STORE_HPP
+
+#include "engine/map_matching/matching_session.hpp"
+#include "util/lru_cache.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Keeps the sessions of the online map matching. The number of sessions is bounded, the
+// least recently used session is dropped if too many are open. Sessions that were not used
+// for longer than the timeout are treated as closed. If the data is replicated, every replica
+// has its own store and the id of a session is congruent to the index of its replica modulo
+// the number of replicas, so requests can be sent to the replica that holds the session.
+class MatchingSessionStore
+{
+  public:
+    using SessionPtr = std::shared_ptr<map_matching::MatchingSession>;
+
+    MatchingSessionStore(const std::size_t max_number_of_sessions,
+                         const std::chrono::seconds session_timeout,
+                         const unsigned replica_index = 0,
+                         const unsigned number_of_replicas = 1)
+        : sessions(max_number_of_sessions), session_timeout(session_timeout),
+          replica_index(replica_index), number_of_replicas(std::max(1u, number_of_replicas)),
+          random_engine(std::random_device()())
+    {
+        BOOST_ASSERT(replica_index < this->number_of_replicas);
+    }
+
+    // Index of the replica that created the session, 0 for ids that were not created by a store.
+    static unsigned GetReplica(const std::string &id, const unsigned number_of_replicas)
+    {
+        if (number_of_replicas < 2 || id.empty() || id.size() > 16 ||
+            id.find_first_not_of("0123456789abcdef") != std::string::npos)
+        {
+            return 0;
+        }
+        return std::stoull(id, nullptr, 16) % number_of_replicas;
+    }
+
+    // Stores a new session and returns its id.
+    std::string Insert(SessionPtr session)
+    {
+        const auto id = GenerateId();
+        sessions.Insert(id, std::move(session));
+        return id;
+    }
+
+    // Returns an empty pointer if the session does not exist or has expired.
+    SessionPtr Find(const std::string &id)
+    {
+        const auto session = sessions.Find(id);
+        if (!session)
+        {
+            return SessionPtr();
+        }
+
+        if ((*session)->IsExpired(session_timeout))
+        {
+            sessions.Erase(id);
+            return SessionPtr();
+        }
+
+        (*session)->Touch();
+        return *session;
+    }
+
+    void Erase(const std::string &id) { sessions.Erase(id); }
+
+  private:
+    std::string GenerateId()
+    {
+        std::uint64_t value;
+        {
+            std::lock_guard<std::mutex> lock(random_engine_mutex);
+            value = random_engine();
+        }
+        // keep the value below the maximum, the next multiple of the number of replicas plus
+        // the index of the replica could overflow otherwise
+        value = (value >> 8) - (value >> 8) % number_of_replicas + replica_index;
+        std::ostringstream id;
+        id << std::hex << std::setw(16) << std::setfill('0') << value;
+        return id.str();
+    }
+
+    util::ShardedLRUCache<std::string, SessionPtr> sessions;
+    const std::chrono::seconds session_timeout;
+    const unsigned replica_index;
+    const unsigned number_of_replicas;
+    std::mutex random_engine_mutex;
+    std::mt19937_64 random_engine;
+};
+}
+}
+
+#endif // MATCHING_SESSION_STORE_HPP
@@ -7,9 +7,12 @@
 #include "osrm/libosrm_config.hpp"
 #include "osrm/osrm.hpp"
 
+#include <cstddef>
+
 #include <memory>
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -25,6 +28,7 @@ struct Object;
 namespace engine
 {
 struct RouteParameters;
+class RouteResultCache;
 namespace plugins
 {
 class BasePlugin;
@@ -40,19 +44,34 @@ class OSRM::OSRM_impl final
 {
   private:
     using PluginMap = std::unordered_map<std::string, std::unique_ptr<plugins::BasePlugin>>;
+    using ServerPaths = std::unordered_map<std::string, boost::filesystem::path>;
+
+    // the data of one profile and the plugins that answer queries on it
+    struct Dataset
+    {
+        // base class pointer to the objects
+        datafacade::BaseDataFacade<contractor::QueryEdge::EdgeData> *query_data_facade = nullptr;
+        PluginMap plugin_map;
+    };
 
   public:
     OSRM_impl(LibOSRMConfig &lib_config);
     OSRM_impl(const OSRM_impl &) = delete;
     int RunQuery(const RouteParameters &route_parameters, util::json::Object &json_result);
+    std::size_t WarmUp(const std::vector<std::string> &block_names);
 
   private:
-    void RegisterPlugin(plugins::BasePlugin *plugin);
-    PluginMap plugin_map;
+    void LoadDataset(Dataset &dataset, ServerPaths &server_paths, const LibOSRMConfig &lib_config);
+    // instantiates the plugins on the concrete type of the facade, see LoadDataset
+    template <typename DataFacadeT>
+    void RegisterPlugins(Dataset &dataset, DataFacadeT *facade, const LibOSRMConfig &lib_config);
+    void RegisterPlugin(Dataset &dataset, plugins::BasePlugin *plugin);
+    // the default dataset has the empty name
+    std::unordered_map<std::string, Dataset> datasets;
     // will only be initialized if shared memory is used
     std::unique_ptr<datafacade::SharedBarriers> barrier;
-    // base class pointer to the objects
-    datafacade::BaseDataFacade<contractor::QueryEdge::EdgeData> *query_data_facade;
+    // will only be initialized if route responses should be cached, shared by all datasets
+    std::unique_ptr<RouteResultCache> route_result_cache;
 
     // decrease number of concurrent queries
     void decrease_concurrent_query_count();
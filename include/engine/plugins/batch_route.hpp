@@ -0,0 +1,241 @@
+#ifndef BATCH_ROUTE_HPP
+#define BATCH_ROUTE_HPP
+
+#include "engine/plugins/plugin_base.hpp"
+
+#include "engine/api_response_generator.hpp"
+#include "engine/object_encoder.hpp"
+#include "engine/search_engine.hpp"
+#include "util/integer_range.hpp"
+#include "util/make_unique.hpp"
+#include "osrm/json_container.hpp"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace plugins
+{
+
+/*
+ * Computes the routes of many independent origin/destination pairs in one request. The
+ * coordinates are read as origin, destination, origin, destination, ... All locations are
+ * snapped in one pass, identical locations only once, and the pairs are routed in parallel.
+ * The routes are returned in the order of the pairs, each in the format of viaroute. A pair
+ * with a location that can not be snapped gets its own error status, the other pairs are
+ * routed anyway.
+ */
+template <class DataFacadeT> class BatchRoutePlugin final : public BasePlugin
+{
+  private:
+    std::string descriptor_string;
+    std::unique_ptr<SearchEngine<DataFacadeT>> search_engine_ptr;
+    DataFacadeT *facade;
+    int max_pairs_batch_route;
+
+    // location and bearing filter of a coordinate, identical keys are snapped once
+    using SnappingKey = std::tuple<int, int, int, int>;
+
+  public:
+    explicit BatchRoutePlugin(DataFacadeT *facade, const int max_pairs_batch_route)
+        : descriptor_string("batchroute"), facade(facade),
+          max_pairs_batch_route(max_pairs_batch_route)
+    {
+        search_engine_ptr = util::make_unique<SearchEngine<DataFacadeT>>(facade);
+    }
+
+    virtual ~BatchRoutePlugin() {}
+
+    const std::string GetDescriptor() const override final { return descriptor_string; }
+
+    Status HandleRequest(const RouteParameters &route_parameters,
+                         util::json::Object &json_result) override final
+    {
+        if (!check_all_coordinates(route_parameters.coordinates) ||
+            route_parameters.coordinates.size() % 2 != 0)
+        {
+            json_result.values["status_message"] =
+                "Invalid coordinates, expected origin/destination pairs";
+            return Status::Error;
+        }
+
+        const auto number_of_pairs = route_parameters.coordinates.size() / 2;
+        if (max_pairs_batch_route > 0 && static_cast<int>(number_of_pairs) > max_pairs_batch_route)
+        {
+            json_result.values["status_message"] =
+                "Number of pairs " + std::to_string(number_of_pairs) +
+                " is higher than current maximum (" + std::to_string(max_pairs_batch_route) + ")";
+            return Status::Error;
+        }
+
+        const auto &input_bearings = route_parameters.bearings;
+        if (input_bearings.size() > 0 &&
+            route_parameters.coordinates.size() != input_bearings.size())
+        {
+            json_result.values["status_message"] =
+                "Number of bearings does not match number of coordinates";
+            return Status::Error;
+        }
+
+        std::vector<PhantomNodePair> phantom_node_pair_list;
+        SnapCoordinates(route_parameters, phantom_node_pair_list);
+
+        // Every pair is routed and described by a single task. Memory of the request arena of
+        // the executing thread is only used within the task, nothing allocated there is part
+        // of the result.
+        std::vector<util::json::Object> routes(number_of_pairs);
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_pairs, 1),
+                          [&](const tbb::blocked_range<std::size_t> &range)
+                          {
+                              for (const auto pair : util::irange(range.begin(), range.end()))
+                              {
+                                  RoutePair(route_parameters, phantom_node_pair_list, pair,
+                                            routes[pair]);
+                              }
+                          });
+
+        util::json::Array json_routes;
+        json_routes.values.reserve(number_of_pairs);
+        for (auto &route : routes)
+        {
+            json_routes.values.push_back(std::move(route));
+        }
+        json_result.values["routes"] = std::move(json_routes);
+        json_result.values["status_message"] = "Found routes between pairs";
+        return Status::Ok;
+    }
+
+  private:
+    // Coordinates that can not be snapped are left with an invalid phantom node.
+    void SnapCoordinates(const RouteParameters &route_parameters,
+                         std::vector<PhantomNodePair> &phantom_node_pair_list) const
+    {
+        const auto &coordinates = route_parameters.coordinates;
+        const auto &input_bearings = route_parameters.bearings;
+        const bool checksum_OK = (route_parameters.check_sum == facade->GetCheckSum());
+
+        phantom_node_pair_list.resize(coordinates.size());
+        std::vector<bool> needs_snapping(coordinates.size(), true);
+        std::vector<std::size_t> snapping_index(coordinates.size());
+        std::vector<std::size_t> unique_coordinates;
+        std::map<SnappingKey, std::size_t> index_of_key;
+        for (const auto i : util::irange<std::size_t>(0, coordinates.size()))
+        {
+            if (checksum_OK && i < route_parameters.hints.size() &&
+                !route_parameters.hints[i].empty())
+            {
+                ObjectEncoder::DecodeFromBase64(route_parameters.hints[i],
+                                                phantom_node_pair_list[i].first);
+                if (phantom_node_pair_list[i].first.is_valid(facade->GetNumberOfNodes()))
+                {
+                    needs_snapping[i] = false;
+                    continue;
+                }
+            }
+            const auto key = MakeSnappingKey(coordinates[i], input_bearings, i);
+            const auto inserted = index_of_key.emplace(key, unique_coordinates.size());
+            if (inserted.second)
+            {
+                unique_coordinates.push_back(i);
+            }
+            snapping_index[i] = inserted.first->second;
+        }
+
+        std::vector<PhantomNodePair> snapped(unique_coordinates.size());
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, unique_coordinates.size()),
+                          [&](const tbb::blocked_range<std::size_t> &range)
+                          {
+                              for (const auto unique : util::irange(range.begin(), range.end()))
+                              {
+                                  const auto i = unique_coordinates[unique];
+                                  const auto key = MakeSnappingKey(coordinates[i], input_bearings,
+                                                                   i);
+                                  snapped[unique] =
+                                      facade->NearestPhantomNodeWithAlternativeFromBigComponent(
+                                          coordinates[i], std::get<2>(key), std::get<3>(key));
+                              }
+                          });
+
+        for (const auto i : util::irange<std::size_t>(0, coordinates.size()))
+        {
+            if (needs_snapping[i])
+            {
+                phantom_node_pair_list[i] = snapped[snapping_index[i]];
+            }
+        }
+    }
+
+    static SnappingKey
+    MakeSnappingKey(const util::FixedPointCoordinate &coordinate,
+                    const std::vector<std::pair<const int, const boost::optional<int>>> &bearings,
+                    const std::size_t i)
+    {
+        const int bearing = bearings.size() > 0 ? bearings[i].first : 0;
+        const int range =
+            bearings.size() > 0 ? (bearings[i].second ? *bearings[i].second : 10) : 180;
+        return SnappingKey(coordinate.lat, coordinate.lon, bearing, range);
+    }
+
+    void RoutePair(const RouteParameters &route_parameters,
+                   const std::vector<PhantomNodePair> &phantom_node_pair_list,
+                   const std::size_t pair,
+                   util::json::Object &json_route) const
+    {
+        for (const auto i : {2 * pair, 2 * pair + 1})
+        {
+            // we didn't found a fitting node, only this pair fails
+            if (!phantom_node_pair_list[i].first.is_valid(facade->GetNumberOfNodes()))
+            {
+                json_route.values["status"] = static_cast<int>(Status::NoSegment);
+                json_route.values["status_message"] =
+                    std::string("Could not find a matching segment for coordinate ") +
+                    std::to_string(i);
+                return;
+            }
+        }
+
+        const std::vector<PhantomNodePair> pair_phantoms = {phantom_node_pair_list[2 * pair],
+                                                            phantom_node_pair_list[2 * pair + 1]};
+        const auto snapped_phantoms = snapPhantomNodes(pair_phantoms);
+        const std::vector<bool> uturns = {route_parameters.uturns[2 * pair],
+                                          route_parameters.uturns[2 * pair + 1]};
+
+        InternalRouteResult raw_route;
+        raw_route.segment_end_coordinates.push_back(
+            PhantomNodes{snapped_phantoms.front(), snapped_phantoms.back()});
+        search_engine_ptr->direct_shortest_path(raw_route.segment_end_coordinates, uturns,
+                                                raw_route);
+
+        if (raw_route.is_valid())
+        {
+            auto generator = MakeApiResponseGenerator(facade);
+            generator.DescribeRoute(route_parameters, raw_route, json_route);
+            json_route.values["status"] = static_cast<int>(Status::Ok);
+            json_route.values["status_message"] = "Found route between points";
+        }
+        else if (snapped_phantoms.front().component.id != snapped_phantoms.back().component.id)
+        {
+            json_route.values["status"] = static_cast<int>(Status::EmptyResult);
+            json_route.values["status_message"] = "Impossible route between points";
+        }
+        else
+        {
+            json_route.values["status"] = static_cast<int>(Status::EmptyResult);
+            json_route.values["status_message"] = "No route found between points";
+        }
+    }
+};
+}
+}
+}
+
+#endif // BATCH_ROUTE_HPP
@@ -0,0 +1,100 @@
+#ifndef CACHE_STATISTICS_PLUGIN_HPP
+#define CACHE_STATISTICS_PLUGIN_HPP
+
+#include "engine/plugins/plugin_base.hpp"
+#include "engine/route_result_cache.hpp"
+
+#include "osrm/json_container.hpp"
+
+#include <string>
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+namespace plugins
+{
+
+// Reports size limits and hit rates of the query caches, and which of the data that is only read
+// to describe routes is loaded and how much of it is in RAM.
+template <class DataFacadeT> class CacheStatisticsPlugin final : public BasePlugin
+{
+  public:
+    CacheStatisticsPlugin(const DataFacadeT *facade, const RouteResultCache *route_result_cache)
+        : descriptor_string("cachestats"), facade(facade), route_result_cache(route_result_cache)
+    {
+    }
+
+    const std::string GetDescriptor() const override final { return descriptor_string; }
+
+    Status HandleRequest(const RouteParameters &route_parameters,
+                         util::json::Object &json_result) override final
+    {
+        (void)route_parameters; // unused
+
+        if (route_result_cache)
+        {
+            json_result.values["route_cache"] =
+                MakeStatistics(route_result_cache->GetStatistics());
+        }
+        else
+        {
+            json_result.values["route_cache"] = util::json::Null();
+        }
+
+        const auto &snapping_cache = facade->GetSnappingCache();
+        if (snapping_cache.IsEnabled())
+        {
+            json_result.values["snapping_cache"] = MakeStatistics(snapping_cache.GetStatistics());
+        }
+        else
+        {
+            json_result.values["snapping_cache"] = util::json::Null();
+        }
+
+        util::json::Array json_cold_blocks;
+        for (const auto &block : facade->GetColdBlockStatistics())
+        {
+            util::json::Object json_block;
+            json_block.values["name"] = block.name;
+            if (block.loaded)
+            {
+                json_block.values["loaded"] = util::json::True();
+            }
+            else
+            {
+                json_block.values["loaded"] = util::json::False();
+            }
+            json_block.values["size"] = block.size;
+            json_block.values["resident"] = block.resident;
+            json_block.values["load_time_ms"] = block.load_time_ms;
+            json_cold_blocks.values.push_back(std::move(json_block));
+        }
+        json_result.values["cold_blocks"] = std::move(json_cold_blocks);
+        return Status::Ok;
+    }
+
+  private:
+    template <typename StatisticsT>
+    static util::json::Object MakeStatistics(const StatisticsT &statistics)
+    {
+        util::json::Object json_statistics;
+        json_statistics.values["capacity"] = statistics.capacity;
+        json_statistics.values["size"] = statistics.size;
+        json_statistics.values["hits"] = statistics.hits;
+        json_statistics.values["misses"] = statistics.misses;
+        json_statistics.values["evictions"] = statistics.evictions;
+        json_statistics.values["hit_rate"] = statistics.GetHitRate();
+        return json_statistics;
+    }
+
+    std::string descriptor_string;
+    const DataFacadeT *facade;
+    const RouteResultCache *route_result_cache;
+};
+}
+}
+}
+
+#endif // CACHE_STATISTICS_PLUGIN_HPP
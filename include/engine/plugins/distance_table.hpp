@@ -28,11 +28,16 @@ template <class DataFacadeT> class DistanceTablePlugin final : public BasePlugin
   private:
     std::unique_ptr<SearchEngine<DataFacadeT>> search_engine_ptr;
     int max_locations_distance_table;
+    // Number of targets from which on the sweep over the restricted graph is used instead of
+    // the buckets. Below, extracting the restricted graph costs more than it saves.
+    long min_targets_for_sweep;
 
   public:
-    explicit DistanceTablePlugin(DataFacadeT *facade, const int max_locations_distance_table)
-        : max_locations_distance_table(max_locations_distance_table), descriptor_string("table"),
-          facade(facade)
+    explicit DistanceTablePlugin(DataFacadeT *facade,
+                                 const int max_locations_distance_table,
+                                 const int min_targets_for_sweep)
+        : max_locations_distance_table(max_locations_distance_table),
+          min_targets_for_sweep(min_targets_for_sweep), descriptor_string("table"), facade(facade)
     {
         search_engine_ptr = util::make_unique<SearchEngine<DataFacadeT>>(facade);
     }
@@ -174,8 +179,13 @@ template <class DataFacadeT> class DistanceTablePlugin final : public BasePlugin
         auto snapped_source_phantoms = snapPhantomNodes(phantom_node_source_vector);
         auto snapped_target_phantoms = snapPhantomNodes(phantom_node_target_vector);
 
+        const bool use_sweep = number_of_destination >= min_targets_for_sweep &&
+                               search_engine_ptr->distance_table_sweep.IsAvailable();
         auto result_table =
-            search_engine_ptr->distance_table(snapped_source_phantoms, snapped_target_phantoms);
+            use_sweep ? search_engine_ptr->distance_table_sweep(snapped_source_phantoms,
+                                                                snapped_target_phantoms)
+                      : search_engine_ptr->distance_table(snapped_source_phantoms,
+                                                          snapped_target_phantoms);
 
         if (!result_table)
         {
@@ -0,0 +1,240 @@
+#ifndef ISOCHRONE_HPP
+#define ISOCHRONE_HPP
+
+#include "engine/plugins/plugin_base.hpp"
+
+#include "engine/object_encoder.hpp"
+#include "engine/search_engine.hpp"
+#include "util/convex_hull.hpp"
+#include "util/integer_range.hpp"
+#include "util/make_unique.hpp"
+#include "osrm/json_container.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace plugins
+{
+
+/*
+ * Computes the travel time from each location to every reachable node of the graph with a
+ * one-to-all search. Returns the polygon reachable within each requested time limit, or with
+ * durations=true the travel time to every node reachable within the largest time limit. At
+ * least one time limit is required, it bounds the searches and the size of the response.
+ */
+template <class DataFacadeT> class IsochronePlugin final : public BasePlugin
+{
+  private:
+    std::unique_ptr<SearchEngine<DataFacadeT>> search_engine_ptr;
+    int max_locations_isochrone;
+
+  public:
+    explicit IsochronePlugin(DataFacadeT *facade, const int max_locations_isochrone)
+        : max_locations_isochrone(max_locations_isochrone), descriptor_string("isochrone"),
+          facade(facade)
+    {
+        search_engine_ptr = util::make_unique<SearchEngine<DataFacadeT>>(facade);
+    }
+
+    virtual ~IsochronePlugin() {}
+
+    const std::string GetDescriptor() const override final { return descriptor_string; }
+
+    Status HandleRequest(const RouteParameters &route_parameters,
+                         util::json::Object &json_result) override final
+    {
+        if (!check_all_coordinates(route_parameters.coordinates, 1))
+        {
+            json_result.values["status_message"] = "Coordinates are invalid";
+            return Status::Error;
+        }
+
+        if (max_locations_isochrone > 0 &&
+            static_cast<int>(route_parameters.coordinates.size()) > max_locations_isochrone)
+        {
+            json_result.values["status_message"] =
+                "Number of entries " + std::to_string(route_parameters.coordinates.size()) +
+                " is higher than current maximum (" + std::to_string(max_locations_isochrone) +
+                ")";
+            return Status::Error;
+        }
+
+        if (!search_engine_ptr->one_to_all.IsAvailable())
+        {
+            json_result.values["status_message"] =
+                "Isochrones are not supported by this dataset";
+            return Status::Error;
+        }
+
+        if (route_parameters.time_limits.empty())
+        {
+            json_result.values["status_message"] = "At least one time_limit is required";
+            return Status::Error;
+        }
+
+        const auto &input_bearings = route_parameters.bearings;
+        if (input_bearings.size() > 0 &&
+            route_parameters.coordinates.size() != input_bearings.size())
+        {
+            json_result.values["status_message"] =
+                "Number of bearings does not match number of coordinates";
+            return Status::Error;
+        }
+
+        const bool checksum_OK = (route_parameters.check_sum == facade->GetCheckSum());
+
+        std::vector<PhantomNodePair> phantom_node_pair_list(route_parameters.coordinates.size());
+        for (const auto i : util::irange<std::size_t>(0u, route_parameters.coordinates.size()))
+        {
+            if (checksum_OK && i < route_parameters.hints.size() &&
+                !route_parameters.hints[i].empty())
+            {
+                PhantomNode current_phantom_node;
+                ObjectEncoder::DecodeFromBase64(route_parameters.hints[i], current_phantom_node);
+                if (current_phantom_node.is_valid(facade->GetNumberOfNodes()))
+                {
+                    phantom_node_pair_list[i] =
+                        std::make_pair(current_phantom_node, current_phantom_node);
+                    continue;
+                }
+            }
+            const int bearing = input_bearings.size() > 0 ? input_bearings[i].first : 0;
+            const int range = input_bearings.size() > 0
+                                  ? (input_bearings[i].second ? *input_bearings[i].second : 10)
+                                  : 180;
+            phantom_node_pair_list[i] = facade->NearestPhantomNodeWithAlternativeFromBigComponent(
+                route_parameters.coordinates[i], bearing, range);
+            // we didn't found a fitting node, return error
+            if (!phantom_node_pair_list[i].first.is_valid(facade->GetNumberOfNodes()))
+            {
+                json_result.values["status_message"] =
+                    std::string("Could not find a matching segment for coordinate ") +
+                    std::to_string(i);
+                return Status::NoSegment;
+            }
+        }
+
+        const auto snapped_phantoms = snapPhantomNodes(phantom_node_pair_list);
+        const auto max_time_limit = *std::max_element(route_parameters.time_limits.begin(),
+                                                      route_parameters.time_limits.end());
+        // the buffer takes four bytes per node and source, small ones are kept for the next
+        // request
+        auto &weights = SearchEngineData::GetThreadLocalOneToAllWeights();
+        search_engine_ptr->one_to_all(snapped_phantoms, ToWeight(max_time_limit), weights);
+        const auto number_of_sources = snapped_phantoms.size();
+        const auto number_of_nodes = facade->GetNumberOfNodes();
+
+        util::json::Array json_results;
+        for (const auto source : util::irange<std::size_t>(0, number_of_sources))
+        {
+            if (route_parameters.durations)
+            {
+                json_results.values.push_back(
+                    MakeDurations(weights, source, number_of_sources, number_of_nodes));
+            }
+            else
+            {
+                json_results.values.push_back(MakeIsochrones(
+                    weights, source, number_of_sources, number_of_nodes,
+                    route_parameters.time_limits));
+            }
+        }
+        json_result.values[route_parameters.durations ? "durations" : "isochrones"] = json_results;
+
+        util::json::Array source_coord_json_array;
+        for (const auto &phantom : snapped_phantoms)
+        {
+            source_coord_json_array.values.push_back(MakeCoordinate(phantom.location));
+        }
+        json_result.values["source_coordinates"] = source_coord_json_array;
+        SearchEngineData::ReleaseThreadLocalOneToAllWeights();
+        return Status::Ok;
+    }
+
+  private:
+    // weights are in tenths of a second
+    static EdgeWeight ToWeight(const unsigned time_limit)
+    {
+        return static_cast<EdgeWeight>(
+            std::min<std::uint64_t>(std::uint64_t{time_limit} * 10, INVALID_EDGE_WEIGHT - 1));
+    }
+
+    static util::json::Array MakeCoordinate(const util::FixedPointCoordinate &coordinate)
+    {
+        util::json::Array json_coord;
+        json_coord.values.push_back(coordinate.lat / COORDINATE_PRECISION);
+        json_coord.values.push_back(coordinate.lon / COORDINATE_PRECISION);
+        return json_coord;
+    }
+
+    // every node reached within the largest time limit as [lat, lon, seconds]
+    util::json::Array MakeDurations(const std::vector<EdgeWeight> &weights,
+                                    const std::size_t source,
+                                    const std::size_t number_of_sources,
+                                    const std::size_t number_of_nodes) const
+    {
+        util::json::Array json_durations;
+        for (const auto node : util::irange<std::size_t>(0, number_of_nodes))
+        {
+            const auto weight = weights[node * number_of_sources + source];
+            if (INVALID_EDGE_WEIGHT == weight)
+            {
+                continue;
+            }
+            auto json_duration = MakeCoordinate(facade->GetLocationOfEdgeBasedNode(node));
+            // the source segment may start behind the snapped location
+            json_duration.values.push_back(std::max(weight, 0) / 10.);
+            json_durations.values.push_back(std::move(json_duration));
+        }
+        return json_durations;
+    }
+
+    // the convex hull of the nodes reached within each time limit
+    util::json::Array MakeIsochrones(const std::vector<EdgeWeight> &weights,
+                                     const std::size_t source,
+                                     const std::size_t number_of_sources,
+                                     const std::size_t number_of_nodes,
+                                     const std::vector<unsigned> &time_limits) const
+    {
+        util::json::Array json_isochrones;
+        for (const auto time_limit : time_limits)
+        {
+            const auto max_weight = ToWeight(time_limit);
+            std::vector<util::FixedPointCoordinate> reached_locations;
+            for (const auto node : util::irange<std::size_t>(0, number_of_nodes))
+            {
+                const auto weight = weights[node * number_of_sources + source];
+                if (INVALID_EDGE_WEIGHT != weight && weight <= max_weight)
+                {
+                    reached_locations.push_back(facade->GetLocationOfEdgeBasedNode(node));
+                }
+            }
+
+            util::json::Array json_polygon;
+            for (const auto &location : util::ConvexHull(std::move(reached_locations)))
+            {
+                json_polygon.values.push_back(MakeCoordinate(location));
+            }
+            util::json::Object json_isochrone;
+            json_isochrone.values["time_limit"] = time_limit;
+            json_isochrone.values["polygon"] = json_polygon;
+            json_isochrones.values.push_back(json_isochrone);
+        }
+        return json_isochrones;
+    }
+
+    std::string descriptor_string;
+    DataFacadeT *facade;
+};
+}
+}
+}
+
+#endif // ISOCHRONE_HPP
@@ -77,6 +77,60 @@ template <class DataFacadeT> class MapMatchingPlugin : public BasePlugin
         return label_with_confidence;
     }
 
+    // Removes duplicated candidates and splits bidirectional candidates into one candidate per
+    // direction if no u-turn is allowed at this location.
+    static void FilterCandidates(routing_algorithms::CandidateList &candidates,
+                                 const bool allow_uturn)
+    {
+        // sort by forward id, then by reverse id and then by distance
+        std::sort(
+            candidates.begin(), candidates.end(),
+            [](const PhantomNodeWithDistance &lhs, const PhantomNodeWithDistance &rhs)
+            {
+                return lhs.phantom_node.forward_node_id < rhs.phantom_node.forward_node_id ||
+                       (lhs.phantom_node.forward_node_id == rhs.phantom_node.forward_node_id &&
+                        (lhs.phantom_node.reverse_node_id < rhs.phantom_node.reverse_node_id ||
+                         (lhs.phantom_node.reverse_node_id ==
+                              rhs.phantom_node.reverse_node_id &&
+                          lhs.distance < rhs.distance)));
+            });
+
+        auto new_end = std::unique(
+            candidates.begin(), candidates.end(),
+            [](const PhantomNodeWithDistance &lhs, const PhantomNodeWithDistance &rhs)
+            {
+                return lhs.phantom_node.forward_node_id == rhs.phantom_node.forward_node_id &&
+                       lhs.phantom_node.reverse_node_id == rhs.phantom_node.reverse_node_id;
+            });
+        candidates.resize(new_end - candidates.begin());
+
+        if (!allow_uturn)
+        {
+            const auto compact_size = candidates.size();
+            for (const auto i : util::irange<std::size_t>(0, compact_size))
+            {
+                // Split edge if it is bidirectional and append reverse direction to end of list
+                if (candidates[i].phantom_node.forward_node_id != SPECIAL_NODEID &&
+                    candidates[i].phantom_node.reverse_node_id != SPECIAL_NODEID)
+                {
+                    PhantomNode reverse_node(candidates[i].phantom_node);
+                    reverse_node.forward_node_id = SPECIAL_NODEID;
+                    candidates.push_back(
+                        PhantomNodeWithDistance{reverse_node, candidates[i].distance});
+
+                    candidates[i].phantom_node.reverse_node_id = SPECIAL_NODEID;
+                }
+            }
+        }
+
+        // sort by distance to make pruning effective
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const PhantomNodeWithDistance &lhs, const PhantomNodeWithDistance &rhs)
+                  {
+                      return lhs.distance < rhs.distance;
+                  });
+    }
+
     CandidateLists getCandidates(
         const std::vector<util::FixedPointCoordinate> &input_coords,
         const std::vector<std::pair<const int, const boost::optional<int>>> &input_bearings,
@@ -133,53 +187,7 @@ template <class DataFacadeT> class MapMatchingPlugin : public BasePlugin
                 break;
             }
 
-            // sort by forward id, then by reverse id and then by distance
-            std::sort(
-                candidates.begin(), candidates.end(),
-                [](const PhantomNodeWithDistance &lhs, const PhantomNodeWithDistance &rhs)
-                {
-                    return lhs.phantom_node.forward_node_id < rhs.phantom_node.forward_node_id ||
-                           (lhs.phantom_node.forward_node_id == rhs.phantom_node.forward_node_id &&
-                            (lhs.phantom_node.reverse_node_id < rhs.phantom_node.reverse_node_id ||
-                             (lhs.phantom_node.reverse_node_id ==
-                                  rhs.phantom_node.reverse_node_id &&
-                              lhs.distance < rhs.distance)));
-                });
-
-            auto new_end = std::unique(
-                candidates.begin(), candidates.end(),
-                [](const PhantomNodeWithDistance &lhs, const PhantomNodeWithDistance &rhs)
-                {
-                    return lhs.phantom_node.forward_node_id == rhs.phantom_node.forward_node_id &&
-                           lhs.phantom_node.reverse_node_id == rhs.phantom_node.reverse_node_id;
-                });
-            candidates.resize(new_end - candidates.begin());
-
-            if (!allow_uturn)
-            {
-                const auto compact_size = candidates.size();
-                for (const auto i : util::irange<std::size_t>(0, compact_size))
-                {
-                    // Split edge if it is bidirectional and append reverse direction to end of list
-                    if (candidates[i].phantom_node.forward_node_id != SPECIAL_NODEID &&
-                        candidates[i].phantom_node.reverse_node_id != SPECIAL_NODEID)
-                    {
-                        PhantomNode reverse_node(candidates[i].phantom_node);
-                        reverse_node.forward_node_id = SPECIAL_NODEID;
-                        candidates.push_back(
-                            PhantomNodeWithDistance{reverse_node, candidates[i].distance});
-
-                        candidates[i].phantom_node.reverse_node_id = SPECIAL_NODEID;
-                    }
-                }
-            }
-
-            // sort by distance to make pruning effective
-            std::sort(candidates.begin(), candidates.end(),
-                      [](const PhantomNodeWithDistance &lhs, const PhantomNodeWithDistance &rhs)
-                      {
-                          return lhs.distance < rhs.distance;
-                      });
+            FilterCandidates(candidates, allow_uturn);
 
             candidates_lists.push_back(std::move(candidates));
         }
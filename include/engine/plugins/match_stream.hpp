@@ -0,0 +1,267 @@
+#ifndef MATCH_STREAM_HPP
+#define MATCH_STREAM_HPP
+
+#include "engine/plugins/plugin_base.hpp"
+#include "engine/plugins/match.hpp"
+
+#include "engine/map_matching/matching_session.hpp"
+#include "engine/matching_session_store.hpp"
+#include "engine/routing_algorithms/map_matching.hpp"
+#include "engine/search_engine.hpp"
+#include "util/compute_angle.hpp"
+#include "util/integer_range.hpp"
+#include "util/json_util.hpp"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace plugins
+{
+
+// Online map matching: a client opens a session, pushes points as they are recorded and
+// receives the matched points as soon as they are final. In contrast to the match plugin the
+// work per point does not depend on the length of the trace.
+//
+//   /matchstream?loc=...&t=...           opens a session and returns its id
+//   /matchstream?session=<id>&loc=...    pushes points to the session
+//   /matchstream?session=<id>&close=true reports all remaining points and closes the session
+template <class DataFacadeT> class StreamingMapMatchingPlugin final : public BasePlugin
+{
+    using SubMatchingList = routing_algorithms::SubMatchingList;
+    using CandidateList = routing_algorithms::CandidateList;
+    using Session = map_matching::MatchingSession;
+
+  public:
+    StreamingMapMatchingPlugin(DataFacadeT *facade,
+                               const int max_locations_map_matching,
+                               const std::size_t max_number_of_sessions,
+                               const std::chrono::seconds session_timeout,
+                               const unsigned replica_index,
+                               const unsigned number_of_replicas)
+        : descriptor_string("matchstream"), facade(facade),
+          max_locations_map_matching(max_locations_map_matching),
+          session_store(max_number_of_sessions, session_timeout, replica_index, number_of_replicas)
+    {
+        search_engine_ptr = std::make_shared<SearchEngine<DataFacadeT>>(facade);
+    }
+
+    const std::string GetDescriptor() const override final { return descriptor_string; }
+
+    Status HandleRequest(const RouteParameters &route_parameters,
+                         util::json::Object &json_result) override final
+    {
+        const auto &input_coords = route_parameters.coordinates;
+        const auto &input_timestamps = route_parameters.timestamps;
+        const auto &input_bearings = route_parameters.bearings;
+
+        // enforce maximum number of locations per request for performance reasons
+        if (max_locations_map_matching > 0 &&
+            static_cast<int>(input_coords.size()) > max_locations_map_matching)
+        {
+            json_result.values["status_message"] = "Too many coodindates";
+            return Status::Error;
+        }
+
+        if (!check_all_coordinates(input_coords, 0))
+        {
+            json_result.values["status_message"] = "Invalid coordinates";
+            return Status::Error;
+        }
+
+        if (input_timestamps.size() > 0 && input_coords.size() != input_timestamps.size())
+        {
+            json_result.values["status_message"] =
+                "Number of timestamps does not match number of coordinates";
+            return Status::Error;
+        }
+
+        if (input_bearings.size() > 0 && input_coords.size() != input_bearings.size())
+        {
+            json_result.values["status_message"] =
+                "Number of bearings does not match number of coordinates";
+            return Status::Error;
+        }
+
+        std::string session_id = route_parameters.session_id;
+        MatchingSessionStore::SessionPtr session;
+        if (session_id.empty())
+        {
+            session = std::make_shared<Session>(route_parameters.matching_beta,
+                                                route_parameters.gps_precision,
+                                                facade->GetCheckSum());
+            session->use_timestamps = !input_timestamps.empty();
+            session_id = session_store.Insert(session);
+        }
+        else
+        {
+            session = session_store.Find(session_id);
+            if (!session)
+            {
+                json_result.values["status_message"] = "Unknown or expired session";
+                return Status::Error;
+            }
+            if (session->dataset_checksum != facade->GetCheckSum())
+            {
+                session_store.Erase(session_id);
+                json_result.values["status_message"] =
+                    "Session was opened on a different dataset, the data was reloaded";
+                return Status::Error;
+            }
+        }
+
+        if (!input_coords.empty() && session->use_timestamps != !input_timestamps.empty())
+        {
+            json_result.values["status_message"] =
+                "Either all or none of the points of a session need timestamps";
+            return Status::Error;
+        }
+
+        SubMatchingList sub_matchings;
+        bool continues_previous = false;
+        std::size_t pending_points = 0;
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+
+            // checked before the first point is pushed, the request is rejected as a whole
+            if (session->use_timestamps && !session->AreTimestampsInOrder(input_timestamps))
+            {
+                if (route_parameters.session_id.empty())
+                {
+                    session_store.Erase(session_id);
+                }
+                json_result.values["status_message"] =
+                    "Timestamps must not be older than the previous points of the session";
+                return Status::Error;
+            }
+
+            for (const auto i : util::irange<std::size_t>(0u, input_coords.size()))
+            {
+                const auto bearing = input_bearings.size() > 0 ? input_bearings[i].first : 0;
+                const auto range =
+                    input_bearings.size() > 0
+                        ? (input_bearings[i].second ? *input_bearings[i].second : 10)
+                        : 180;
+                const auto timestamp = session->use_timestamps ? input_timestamps[i] : 0u;
+
+                // only the first reported matching can continue the previous response
+                const bool had_matchings = !sub_matchings.empty();
+                const bool continues = search_engine_ptr->map_matching(
+                    *session, GetCandidates(*session, input_coords[i], bearing, range),
+                    input_coords[i], timestamp, sub_matchings);
+                if (!had_matchings)
+                {
+                    continues_previous = continues;
+                }
+            }
+
+            if (route_parameters.close_session)
+            {
+                const bool had_matchings = !sub_matchings.empty();
+                const bool continues =
+                    search_engine_ptr->map_matching.Finalize(*session, sub_matchings);
+                if (!had_matchings)
+                {
+                    continues_previous = continues;
+                }
+            }
+            else
+            {
+                pending_points =
+                    session->candidates_list.size() - session->number_of_final_states;
+            }
+        }
+
+        if (route_parameters.close_session)
+        {
+            session_store.Erase(session_id);
+        }
+        else
+        {
+            json_result.values["session"] = session_id;
+        }
+
+        util::json::Array matchings;
+        for (const auto &sub : sub_matchings)
+        {
+            matchings.values.emplace_back(SubmatchingToJSON(sub));
+        }
+        json_result.values["matchings"] = matchings;
+        json_result.values["pending_points"] = pending_points;
+        if (continues_previous)
+        {
+            json_result.values["continues_previous"] = util::json::True();
+        }
+        else
+        {
+            json_result.values["continues_previous"] = util::json::False();
+        }
+
+        json_result.values["status_message"] = "Found matchings";
+        return Status::Ok;
+    }
+
+  private:
+    CandidateList GetCandidates(Session &session,
+                                const util::FixedPointCoordinate &coordinate,
+                                const int bearing,
+                                const int range) const
+    {
+        // whether a point is a turning point is only known once the next point arrives, so
+        // after a sharp turn both directions are allowed at the following point
+        bool allow_uturn = false;
+        if (session.last_input_coordinates.size() == 2)
+        {
+            const double turn_angle =
+                util::ComputeAngle(session.last_input_coordinates.front(),
+                                   session.last_input_coordinates.back(), coordinate);
+            allow_uturn = turn_angle <= 90.0 || turn_angle >= 270.0;
+            session.last_input_coordinates.pop_front();
+        }
+        session.last_input_coordinates.push_back(coordinate);
+
+        // same search radius as the match plugin, gps_precision is the standard deviation
+        const double query_radius = 3 * session.emission_log_probability.sigma_z;
+        auto candidates =
+            facade->NearestPhantomNodesInRange(coordinate, query_radius, bearing, range);
+        MapMatchingPlugin<DataFacadeT>::FilterCandidates(candidates, allow_uturn);
+        return candidates;
+    }
+
+    util::json::Object SubmatchingToJSON(const routing_algorithms::SubMatching &sub) const
+    {
+        util::json::Object subtrace;
+        subtrace.values["indices"] = util::json::make_array(sub.indices);
+
+        util::json::Array points;
+        util::json::Array names;
+        for (const auto &node : sub.nodes)
+        {
+            points.values.emplace_back(
+                util::json::make_array(node.location.lat / COORDINATE_PRECISION,
+                                       node.location.lon / COORDINATE_PRECISION));
+            names.values.emplace_back(facade->get_name_for_id(node.name_id));
+        }
+        subtrace.values["matched_points"] = points;
+        subtrace.values["matched_names"] = names;
+        subtrace.values["length"] = sub.length;
+        return subtrace;
+    }
+
+    std::string descriptor_string;
+    DataFacadeT *facade;
+    std::shared_ptr<SearchEngine<DataFacadeT>> search_engine_ptr;
+    int max_locations_map_matching;
+    MatchingSessionStore session_store;
+};
+}
+}
+}
+
+#endif // MATCH_STREAM_HPP
@@ -0,0 +1,90 @@
+#ifndef MEMORY_STATISTICS_PLUGIN_HPP
+#define MEMORY_STATISTICS_PLUGIN_HPP
+
+#include "engine/plugins/plugin_base.hpp"
+#include "engine/search_engine_data.hpp"
+#include "util/residency.hpp"
+
+#include "osrm/json_container.hpp"
+
+#include <atomic>
+#include <string>
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+namespace plugins
+{
+
+// Reports the memory of the process, the size of every block of the dataset and how much of it is
+// in RAM, how often the r-tree leaves were read from memory or from the leaf file and how much
+// memory the query threads keep between queries.
+template <class DataFacadeT> class MemoryStatisticsPlugin final : public BasePlugin
+{
+  public:
+    explicit MemoryStatisticsPlugin(const DataFacadeT *facade)
+        : descriptor_string("memory"), facade(facade)
+    {
+    }
+
+    const std::string GetDescriptor() const override final { return descriptor_string; }
+
+    Status HandleRequest(const RouteParameters &route_parameters,
+                         util::json::Object &json_result) override final
+    {
+        (void)route_parameters; // unused
+
+        const auto process_memory = util::GetProcessMemory();
+        util::json::Object json_process;
+        json_process.values["virtual_size"] = process_memory.virtual_size;
+        json_process.values["resident"] = process_memory.resident;
+        json_result.values["process"] = std::move(json_process);
+
+        util::json::Array json_blocks;
+        std::size_t total_size = 0, total_resident = 0;
+        for (const auto &block : facade->GetMemoryStatistics())
+        {
+            util::json::Object json_block;
+            json_block.values["name"] = block.name;
+            json_block.values["size"] = block.size;
+            json_block.values["resident"] = block.resident;
+            json_blocks.values.push_back(std::move(json_block));
+            total_size += block.size;
+            total_resident += block.resident;
+        }
+        json_result.values["blocks"] = std::move(json_blocks);
+        json_result.values["size"] = total_size;
+        json_result.values["resident"] = total_resident;
+
+        const auto &leaf_reads = facade->GetLeafReadStatistics();
+        util::json::Object json_leaves;
+        json_leaves.values["reads_from_memory"] =
+            leaf_reads.from_memory.load(std::memory_order_relaxed);
+        json_leaves.values["reads_from_file"] =
+            leaf_reads.from_file.load(std::memory_order_relaxed);
+        json_result.values["rtree_leaves"] = std::move(json_leaves);
+
+        util::json::Array json_slots;
+        for (const auto &slot : SearchEngineData::GetSlotStatistics())
+        {
+            util::json::Object json_slot;
+            json_slot.values["name"] = slot.name;
+            json_slot.values["threads"] = slot.threads;
+            json_slot.values["bytes"] = slot.bytes;
+            json_slots.values.push_back(std::move(json_slot));
+        }
+        json_result.values["search_engine_data"] = std::move(json_slots);
+        return Status::Ok;
+    }
+
+  private:
+    std::string descriptor_string;
+    const DataFacadeT *facade;
+};
+}
+}
+}
+
+#endif // MEMORY_STATISTICS_PLUGIN_HPP
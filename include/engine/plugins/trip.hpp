@@ -8,6 +8,7 @@
 #include "engine/trip/trip_nearest_neighbour.hpp"
 #include "engine/trip/trip_farthest_insertion.hpp"
 #include "engine/trip/trip_brute_force.hpp"
+#include "engine/trip/trip_local_search.hpp"
 #include "engine/search_engine.hpp"
 #include "util/matrix_graph_wrapper.hpp" // wrapper to use tarjan scc on dist table
 #include "engine/api_response_generator.hpp"
@@ -17,6 +18,9 @@
 
 #include <boost/assert.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include <cstdlib>
 #include <algorithm>
 #include <memory>
@@ -275,7 +279,10 @@ template <class DataFacadeT> class RoundTripPlugin final : public BasePlugin
             return Status::Error;
         }
 
-        const constexpr std::size_t BF_MAX_FEASABLE = 10;
+        // components smaller than this are solved exactly, a few milliseconds at most
+        const constexpr std::size_t BF_MAX_FEASABLE = 16;
+        static_assert(BF_MAX_FEASABLE <= trip::BF_MAX_LOCATIONS + 1,
+                      "exact trips are limited to BF_MAX_LOCATIONS");
         BOOST_ASSERT_MSG(result_table.size() == number_of_locations * number_of_locations,
                          "Distance Table has wrong size");
 
@@ -284,50 +291,43 @@ template <class DataFacadeT> class RoundTripPlugin final : public BasePlugin
 
         using NodeIDIterator = typename std::vector<NodeID>::const_iterator;
 
-        std::vector<std::vector<NodeID>> route_result;
-        route_result.reserve(scc.GetNumberOfComponents());
-        // run Trip computation for every SCC
-        for (std::size_t k = 0; k < scc.GetNumberOfComponents(); ++k)
-        {
-            const auto component_size = scc.range[k + 1] - scc.range[k];
-
-            BOOST_ASSERT_MSG(component_size >= 0, "invalid component size");
-
-            if (component_size > 1)
+        // run Trip computation for every SCC, the components are independent of each other
+        std::vector<std::vector<NodeID>> route_result(scc.GetNumberOfComponents());
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, scc.GetNumberOfComponents(), 1),
+            [&](const tbb::blocked_range<std::size_t> &range)
             {
-                std::vector<NodeID> scc_route;
-                NodeIDIterator start = std::begin(scc.component) + scc.range[k];
-                NodeIDIterator end = std::begin(scc.component) + scc.range[k + 1];
-
-                if (component_size < BF_MAX_FEASABLE)
-                {
-                    scc_route = trip::BruteForceTrip(start, end, number_of_locations, result_table);
-                }
-                else
+                for (const auto k : util::irange(range.begin(), range.end()))
                 {
-                    scc_route =
-                        trip::FarthestInsertionTrip(start, end, number_of_locations, result_table);
+                    const auto component_size = scc.range[k + 1] - scc.range[k];
+
+                    BOOST_ASSERT_MSG(component_size >= 0, "invalid component size");
+
+                    if (component_size > 1)
+                    {
+                        NodeIDIterator start = std::begin(scc.component) + scc.range[k];
+                        NodeIDIterator end = std::begin(scc.component) + scc.range[k + 1];
+
+                        if (component_size < BF_MAX_FEASABLE)
+                        {
+                            route_result[k] = trip::BruteForceTrip(start, end, number_of_locations,
+                                                                   result_table);
+                        }
+                        else
+                        {
+                            const auto scc_route = trip::FarthestInsertionTrip(
+                                start, end, number_of_locations, result_table);
+                            route_result[k] = trip::LocalSearchTrip(
+                                start, end, number_of_locations, result_table, scc_route);
+                        }
+                    }
+                    else
+                    {
+                        // if component only consists of one node, add it to the result routes
+                        route_result[k] = {scc.component[scc.range[k]]};
+                    }
                 }
-
-                // use this output if debugging of route is needed:
-                // util::SimpleLogger().Write() << "Route #" << k << ": " << [&scc_route]()
-                // {
-                //     std::string s = "";
-                //     for (auto x : scc_route)
-                //     {
-                //         s += std::to_string(x) + " ";
-                //     }
-                //     return s;
-                // }();
-
-                route_result.push_back(std::move(scc_route));
-            }
-            else
-            {
-                // if component only consists of one node, add it to the result routes
-                route_result.emplace_back(scc.component[scc.range[k]]);
-            }
-        }
+            });
 
         // compute all round trip routes
         std::vector<InternalRouteResult> comp_route;
@@ -5,6 +5,7 @@
 
 #include "engine/api_response_generator.hpp"
 #include "engine/object_encoder.hpp"
+#include "engine/route_result_cache.hpp"
 #include "engine/search_engine.hpp"
 #include "util/for_each_pair.hpp"
 #include "util/integer_range.hpp"
@@ -35,11 +36,15 @@ template <class DataFacadeT> class ViaRoutePlugin final : public BasePlugin
     std::unique_ptr<SearchEngine<DataFacadeT>> search_engine_ptr;
     DataFacadeT *facade;
     int max_locations_viaroute;
+    // optional, nullptr if responses should not be cached
+    RouteResultCache *route_result_cache;
 
   public:
-    explicit ViaRoutePlugin(DataFacadeT *facade, int max_locations_viaroute)
+    explicit ViaRoutePlugin(DataFacadeT *facade,
+                            int max_locations_viaroute,
+                            RouteResultCache *route_result_cache = nullptr)
         : descriptor_string("viaroute"), facade(facade),
-          max_locations_viaroute(max_locations_viaroute)
+          max_locations_viaroute(max_locations_viaroute), route_result_cache(route_result_cache)
     {
         search_engine_ptr = util::make_unique<SearchEngine<DataFacadeT>>(facade);
     }
@@ -110,6 +115,19 @@ template <class DataFacadeT> class ViaRoutePlugin final : public BasePlugin
 
         auto snapped_phantoms = snapPhantomNodes(phantom_node_pair_list);
 
+        RouteResultCache::Key cache_key;
+        if (route_result_cache)
+        {
+            cache_key = RouteResultCache::MakeKey(facade->GetCheckSum(), snapped_phantoms,
+                                                  route_parameters);
+            const auto cached_response = route_result_cache->Find(cache_key);
+            if (cached_response)
+            {
+                json_result = *cached_response;
+                return Status::Ok;
+            }
+        }
+
         InternalRouteResult raw_route;
         auto build_phantom_pairs = [&raw_route](const PhantomNode &first_node,
                                                 const PhantomNode &second_node)
@@ -123,7 +141,8 @@ template <class DataFacadeT> class ViaRoutePlugin final : public BasePlugin
             if (route_parameters.alternate_route)
             {
                 search_engine_ptr->alternative_path(raw_route.segment_end_coordinates.front(),
-                                                    raw_route);
+                                                    raw_route,
+                                                    route_parameters.number_of_alternatives);
             }
             else
             {
@@ -144,6 +163,11 @@ template <class DataFacadeT> class ViaRoutePlugin final : public BasePlugin
             auto generator = MakeApiResponseGenerator(facade);
             generator.DescribeRoute(route_parameters, raw_route, json_result);
             json_result.values["status_message"] = "Found route between points";
+
+            if (route_result_cache)
+            {
+                route_result_cache->Insert(cache_key, json_result);
+            }
         }
         else
         {
@@ -0,0 +1,82 @@
+#ifndef ROUTE_RESULT_CACHE_HPP
+#define ROUTE_RESULT_CACHE_HPP
+
+#include "engine/phantom_node.hpp"
+#include "util/lru_cache.hpp"
+
+#include "osrm/json_container.hpp"
+#include "osrm/route_parameters.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Caches rendered route responses of popular origin/destination pairs.
+//
+// Entries are keyed on the checksum of the dataset, the snapped phantom nodes and all options
+// that change the response, so two requests that snap to the same positions share an entry. One
+// cache serves all datasets of an engine. Entries of a dataset that was replaced can not be
+// found any more and age out of the cache.
+class RouteResultCache
+{
+  public:
+    using Key = std::string;
+    using Response = std::shared_ptr<const util::json::Object>;
+    using Statistics = util::ShardedLRUCache<Key, Response>::Statistics;
+
+    explicit RouteResultCache(const std::size_t max_number_of_routes) : cache(max_number_of_routes)
+    {
+    }
+
+    static Key MakeKey(const unsigned dataset_checksum,
+                       const std::vector<PhantomNode> &phantom_nodes,
+                       const RouteParameters &route_parameters)
+    {
+        Key key;
+        key.reserve(sizeof(dataset_checksum) + phantom_nodes.size() * sizeof(PhantomNode) +
+                    route_parameters.uturns.size() + 8);
+        key.append(reinterpret_cast<const char *>(&dataset_checksum), sizeof(dataset_checksum));
+        // PhantomNode has no padding, see the static_assert on its size
+        for (const auto &phantom_node : phantom_nodes)
+        {
+            key.append(reinterpret_cast<const char *>(&phantom_node), sizeof(PhantomNode));
+        }
+        key.append(reinterpret_cast<const char *>(&route_parameters.zoom_level),
+                   sizeof(route_parameters.zoom_level));
+        key.push_back(route_parameters.alternate_route);
+        key.push_back(static_cast<char>(route_parameters.number_of_alternatives));
+        key.push_back(route_parameters.geometry);
+        key.push_back(route_parameters.compression);
+        key.push_back(route_parameters.print_instructions);
+        for (const bool uturn : route_parameters.uturns)
+        {
+            key.push_back(uturn);
+        }
+        return key;
+    }
+
+    Response Find(const Key &key)
+    {
+        const auto response = cache.Find(key);
+        return response ? *response : Response();
+    }
+
+    void Insert(const Key &key, const util::json::Object &result)
+    {
+        cache.Insert(key, std::make_shared<const util::json::Object>(result));
+    }
+
+    Statistics GetStatistics() const { return cache.GetStatistics(); }
+
+  private:
+    util::ShardedLRUCache<Key, Response> cache;
+};
+}
+}
+
+#endif // ROUTE_RESULT_CACHE_HPP
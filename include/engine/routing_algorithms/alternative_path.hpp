@@ -7,10 +7,15 @@
 
 #include <boost/assert.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <iterator>
-#include <unordered_map>
-#include <unordered_set>
+#include <mutex>
+#include <stack>
 
 #include <vector>
 
@@ -61,25 +66,21 @@ class AlternativeRouting final
 
     virtual ~AlternativeRouting() {}
 
-    void operator()(const PhantomNodes &phantom_node_pair, InternalRouteResult &raw_route_data)
+    void operator()(const PhantomNodes &phantom_node_pair,
+                    InternalRouteResult &raw_route_data,
+                    const unsigned number_of_alternatives = 1)
     {
-        std::vector<NodeID> alternative_path;
         std::vector<NodeID> via_node_candidate_list;
         std::vector<SearchSpaceEdge> forward_search_space;
         std::vector<SearchSpaceEdge> reverse_search_space;
 
-        // Init queues, semi-expensive because access to TSS invokes a sys-call
+        // Init queues, semi-expensive because access to TSS invokes a sys-call. The queues of
+        // the via path searches are set up by the tasks that run them.
         engine_working_data.InitializeOrClearFirstThreadLocalStorage(
             super::facade->GetNumberOfNodes());
-        engine_working_data.InitializeOrClearSecondThreadLocalStorage(
-            super::facade->GetNumberOfNodes());
-        engine_working_data.InitializeOrClearThirdThreadLocalStorage(
-            super::facade->GetNumberOfNodes());
 
         QueryHeap &forward_heap1 = *(engine_working_data.forward_heap_1);
         QueryHeap &reverse_heap1 = *(engine_working_data.reverse_heap_1);
-        QueryHeap &forward_heap2 = *(engine_working_data.forward_heap_2);
-        QueryHeap &reverse_heap2 = *(engine_working_data.reverse_heap_2);
 
         int upper_bound_to_shortest_path_distance = INVALID_EDGE_WEIGHT;
         NodeID middle_node = SPECIAL_NODEID;
@@ -159,79 +160,49 @@ class AlternativeRouting final
         super::RetrievePackedPathFromSingleHeap(forward_heap1, middle_node, packed_forward_path);
         super::RetrievePackedPathFromSingleHeap(reverse_heap1, middle_node, packed_reverse_path);
 
-        // this set is is used as an indicator if a node is on the shortest path
-        std::unordered_set<NodeID> nodes_in_path(packed_forward_path.size() +
-                                                 packed_reverse_path.size());
-        nodes_in_path.insert(packed_forward_path.begin(), packed_forward_path.end());
-        nodes_in_path.insert(middle_node);
-        nodes_in_path.insert(packed_reverse_path.begin(), packed_reverse_path.end());
-
-        std::unordered_map<NodeID, int> approximated_forward_sharing;
-        std::unordered_map<NodeID, int> approximated_reverse_sharing;
-
-        // sweep over search space, compute forward sharing for each current edge (u,v)
-        for (const SearchSpaceEdge &current_edge : forward_search_space)
-        {
-            const NodeID u = current_edge.first;
-            const NodeID v = current_edge.second;
-
-            if (nodes_in_path.find(v) != nodes_in_path.end())
-            {
-                // current_edge is on shortest path => sharing(v):=queue.GetKey(v);
-                approximated_forward_sharing.emplace(v, forward_heap1.GetKey(v));
-            }
-            else
-            {
-                // current edge is not on shortest path. Check if we know a value for the other
-                // endpoint
-                const auto sharing_of_u_iterator = approximated_forward_sharing.find(u);
-                if (sharing_of_u_iterator != approximated_forward_sharing.end())
-                {
-                    approximated_forward_sharing.emplace(v, sharing_of_u_iterator->second);
-                }
-            }
-        }
-
-        // sweep over search space, compute backward sharing
-        for (const SearchSpaceEdge &current_edge : reverse_search_space)
+        // the flags and sharing values of a node are stored at its insertion index in the heaps
+        std::vector<std::uint8_t> forward_on_shortest_path(forward_heap1.NumberOfInsertedNodes(),
+                                                           0);
+        std::vector<std::uint8_t> reverse_on_shortest_path(reverse_heap1.NumberOfInsertedNodes(),
+                                                           0);
+        const auto mark_on_shortest_path = [&](const NodeID node)
         {
-            const NodeID u = current_edge.first;
-            const NodeID v = current_edge.second;
-            if (nodes_in_path.find(v) != nodes_in_path.end())
+            if (forward_heap1.WasInserted(node))
             {
-                // current_edge is on shortest path => sharing(u):=queue.GetKey(u);
-                approximated_reverse_sharing.emplace(v, reverse_heap1.GetKey(v));
+                forward_on_shortest_path[forward_heap1.GetInsertionIndex(node)] = 1;
             }
-            else
+            if (reverse_heap1.WasInserted(node))
             {
-                // current edge is not on shortest path. Check if we know a value for the other
-                // endpoint
-                const auto sharing_of_u_iterator = approximated_reverse_sharing.find(u);
-                if (sharing_of_u_iterator != approximated_reverse_sharing.end())
-                {
-                    approximated_reverse_sharing.emplace(v, sharing_of_u_iterator->second);
-                }
+                reverse_on_shortest_path[reverse_heap1.GetInsertionIndex(node)] = 1;
             }
-        }
-
-        // util::SimpleLogger().Write(logDEBUG) << "fwd_search_space size: " <<
-        // forward_search_space.size() << ", marked " << approximated_forward_sharing.size() << "
-        // nodes";
-        // util::SimpleLogger().Write(logDEBUG) << "rev_search_space size: " <<
-        // reverse_search_space.size() << ", marked " << approximated_reverse_sharing.size() << "
-        // nodes";
+        };
+        std::for_each(packed_forward_path.begin(), packed_forward_path.end(),
+                      mark_on_shortest_path);
+        mark_on_shortest_path(middle_node);
+        std::for_each(packed_reverse_path.begin(), packed_reverse_path.end(),
+                      mark_on_shortest_path);
+
+        std::vector<int> approximated_forward_sharing(forward_heap1.NumberOfInsertedNodes(),
+                                                      INVALID_EDGE_WEIGHT);
+        std::vector<int> approximated_reverse_sharing(reverse_heap1.NumberOfInsertedNodes(),
+                                                      INVALID_EDGE_WEIGHT);
+        ApproximateSharing(forward_heap1, forward_search_space, forward_on_shortest_path,
+                           approximated_forward_sharing);
+        ApproximateSharing(reverse_heap1, reverse_search_space, reverse_on_shortest_path,
+                           approximated_reverse_sharing);
 
         std::vector<NodeID> preselected_node_list;
         for (const NodeID node : via_node_candidate_list)
         {
-            const auto fwd_iterator = approximated_forward_sharing.find(node);
             const int fwd_sharing =
-                (fwd_iterator != approximated_forward_sharing.end()) ? fwd_iterator->second : 0;
-            const auto rev_iterator = approximated_reverse_sharing.find(node);
+                approximated_forward_sharing[forward_heap1.GetInsertionIndex(node)];
             const int rev_sharing =
-                (rev_iterator != approximated_reverse_sharing.end()) ? rev_iterator->second : 0;
+                approximated_reverse_sharing[reverse_heap1.GetInsertionIndex(node)];
 
-            const int approximated_sharing = fwd_sharing + rev_sharing;
+            // nodes without a known sharing do not share anything
+            const int approximated_sharing =
+                (fwd_sharing != INVALID_EDGE_WEIGHT ? fwd_sharing : 0) +
+                (rev_sharing != INVALID_EDGE_WEIGHT ? rev_sharing : 0);
             const int approximated_length = forward_heap1.GetKey(node) + reverse_heap1.GetKey(node);
             const bool length_passes =
                 (approximated_length <
@@ -254,41 +225,88 @@ class AlternativeRouting final
         packed_shortest_path.emplace_back(middle_node);
         packed_shortest_path.insert(packed_shortest_path.end(), packed_reverse_path.begin(),
                                     packed_reverse_path.end());
-        std::vector<RankedCandidateNode> ranked_candidates_list;
 
-        // prioritizing via nodes for deep inspection
-        for (const NodeID node : preselected_node_list)
+        // prioritizing via nodes for deep inspection, the via paths are independent of each
+        // other and computed in parallel
+        std::vector<int> lengths_of_via_paths(preselected_node_list.size(), 0);
+        std::vector<int> sharing_of_via_paths(preselected_node_list.size(), 0);
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, preselected_node_list.size()),
+            [&](const tbb::blocked_range<std::size_t> &range)
+            {
+                for (const auto index : util::irange(range.begin(), range.end()))
+                {
+                    ComputeLengthAndSharingOfViaPath(
+                        forward_heap1, reverse_heap1, preselected_node_list[index],
+                        &lengths_of_via_paths[index], &sharing_of_via_paths[index],
+                        packed_shortest_path, min_edge_offset);
+                }
+            });
+
+        std::vector<RankedCandidateNode> ranked_candidates_list;
+        const int maximum_allowed_sharing =
+            static_cast<int>(upper_bound_to_shortest_path_distance * VIAPATH_GAMMA);
+        for (const auto index : util::irange<std::size_t>(0, preselected_node_list.size()))
         {
-            int length_of_via_path = 0, sharing_of_via_path = 0;
-            ComputeLengthAndSharingOfViaPath(node, &length_of_via_path, &sharing_of_via_path,
-                                             packed_shortest_path, min_edge_offset);
-            const int maximum_allowed_sharing =
-                static_cast<int>(upper_bound_to_shortest_path_distance * VIAPATH_GAMMA);
-            if (sharing_of_via_path <= maximum_allowed_sharing &&
-                length_of_via_path <= upper_bound_to_shortest_path_distance * (1 + VIAPATH_EPSILON))
+            if (sharing_of_via_paths[index] <= maximum_allowed_sharing &&
+                lengths_of_via_paths[index] <=
+                    upper_bound_to_shortest_path_distance * (1 + VIAPATH_EPSILON))
             {
-                ranked_candidates_list.emplace_back(node, length_of_via_path, sharing_of_via_path);
+                ranked_candidates_list.emplace_back(preselected_node_list[index],
+                                                    lengths_of_via_paths[index],
+                                                    sharing_of_via_paths[index]);
             }
         }
         std::sort(ranked_candidates_list.begin(), ranked_candidates_list.end());
 
-        NodeID selected_via_node = SPECIAL_NODEID;
-        int length_of_via_path = INVALID_EDGE_WEIGHT;
-        NodeID s_v_middle = SPECIAL_NODEID, v_t_middle = SPECIAL_NODEID;
-        for (const RankedCandidateNode &candidate : ranked_candidates_list)
+        // select the first admissable candidates in the order of their rank. Every further
+        // alternative must not share too much with the ones selected before.
+        CandidateTests tests(ranked_candidates_list.size());
+        std::vector<std::size_t> selected_candidates;
+        std::vector<std::vector<EdgeID>> selected_original_edges;
+        std::size_t first_untested = 0;
+        while (selected_candidates.size() < number_of_alternatives &&
+               first_untested < ranked_candidates_list.size())
         {
-            if (ViaNodeCandidatePassesTTest(
-                    forward_heap1, reverse_heap1, forward_heap2, reverse_heap2, candidate,
-                    upper_bound_to_shortest_path_distance, &length_of_via_path, &s_v_middle,
-                    &v_t_middle, min_edge_offset))
+            const auto end_of_tested = TestCandidates(
+                forward_heap1, reverse_heap1, ranked_candidates_list, first_untested,
+                number_of_alternatives - selected_candidates.size(),
+                upper_bound_to_shortest_path_distance, min_edge_offset, tests);
+
+            for (const auto index : util::irange(first_untested, end_of_tested))
             {
-                // select first admissable
-                selected_via_node = candidate.node;
-                break;
+                if (!tests.passed[index])
+                {
+                    continue;
+                }
+
+                if (number_of_alternatives > 1)
+                {
+                    auto original_edges = GetSortedOriginalEdges(tests.packed_paths[index]);
+                    const bool shares_too_much = std::any_of(
+                        selected_original_edges.begin(), selected_original_edges.end(),
+                        [&](const std::vector<EdgeID> &selected_edges)
+                        {
+                            return ComputeSharing(original_edges, selected_edges) >
+                                   maximum_allowed_sharing;
+                        });
+                    if (shares_too_much)
+                    {
+                        continue;
+                    }
+                    selected_original_edges.push_back(std::move(original_edges));
+                }
+
+                selected_candidates.push_back(index);
+                if (selected_candidates.size() == number_of_alternatives)
+                {
+                    break;
+                }
             }
+            first_untested = end_of_tested;
         }
 
-        // Unpack shortest path and alternative, if they exist
+        // Unpack shortest path and alternatives, if they exist
         if (INVALID_EDGE_WEIGHT != upper_bound_to_shortest_path_distance)
         {
             BOOST_ASSERT(!packed_shortest_path.empty());
@@ -308,12 +326,9 @@ class AlternativeRouting final
             raw_route_data.shortest_path_length = upper_bound_to_shortest_path_distance;
         }
 
-        if (SPECIAL_NODEID != selected_via_node)
+        for (const auto index : selected_candidates)
         {
-            std::vector<NodeID> packed_alternate_path;
-            // retrieve alternate path
-            RetrievePackedAlternatePath(forward_heap1, reverse_heap1, forward_heap2, reverse_heap2,
-                                        s_v_middle, v_t_middle, packed_alternate_path);
+            const auto &packed_alternate_path = tests.packed_paths[index];
 
             raw_route_data.alt_source_traversed_in_reverse.push_back((
                 packed_alternate_path.front() != phantom_node_pair.source_phantom.forward_node_id));
@@ -321,18 +336,174 @@ class AlternativeRouting final
                 (packed_alternate_path.back() != phantom_node_pair.target_phantom.forward_node_id));
 
             // unpack the alternate path
+            raw_route_data.unpacked_alternatives.emplace_back();
             super::UnpackPath(packed_alternate_path.begin(), packed_alternate_path.end(),
-                              phantom_node_pair, raw_route_data.unpacked_alternative);
+                              phantom_node_pair, raw_route_data.unpacked_alternatives.back());
+
+            raw_route_data.alternative_path_lengths.push_back(tests.lengths[index]);
+        }
+    }
+
+  private:
+    // results of the T-test of the ranked candidates, indexed by the rank
+    struct CandidateTests
+    {
+        explicit CandidateTests(const std::size_t number_of_candidates)
+            : tested(number_of_candidates, 0), passed(number_of_candidates, 0),
+              lengths(number_of_candidates, INVALID_EDGE_WEIGHT),
+              packed_paths(number_of_candidates)
+        {
+        }
+
+        std::vector<std::uint8_t> tested;
+        std::vector<std::uint8_t> passed;
+        std::vector<int> lengths;
+        std::vector<std::vector<NodeID>> packed_paths;
+    };
+
+    // Runs the T-test for the ranked candidates from first_candidate on in parallel. As soon
+    // as the required number of candidates passed, all candidates ranked after them are cut
+    // off. Returns the end of the candidates that are tested.
+    std::size_t TestCandidates(const QueryHeap &forward_heap1,
+                               const QueryHeap &reverse_heap1,
+                               const std::vector<RankedCandidateNode> &ranked_candidates_list,
+                               const std::size_t first_candidate,
+                               const std::size_t required_candidates,
+                               const int length_of_shortest_path,
+                               const EdgeWeight min_edge_offset,
+                               CandidateTests &tests) const
+    {
+        BOOST_ASSERT(required_candidates > 0);
+
+        // candidates that passed in a previous round but were not needed then
+        std::vector<std::size_t> passed_candidates;
+        for (const auto index : util::irange(first_candidate, ranked_candidates_list.size()))
+        {
+            if (tests.passed[index])
+            {
+                passed_candidates.push_back(index);
+            }
+        }
+        std::mutex passed_candidates_mutex;
+        std::atomic<std::size_t> cut_off(passed_candidates.size() >= required_candidates
+                                              ? passed_candidates[required_candidates - 1] + 1
+                                              : ranked_candidates_list.size());
+
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(first_candidate, ranked_candidates_list.size(), 1),
+            [&](const tbb::blocked_range<std::size_t> &range)
+            {
+                for (const auto index : util::irange(range.begin(), range.end()))
+                {
+                    if (index >= cut_off || tests.tested[index])
+                    {
+                        continue;
+                    }
+
+                    // the heaps are thread-local, every task uses the heaps of the thread
+                    // executing it
+                    engine_working_data.InitializeOrClearSecondThreadLocalStorage(
+                        super::facade->GetNumberOfNodes());
+                    QueryHeap &forward_heap2 = *engine_working_data.forward_heap_2;
+                    QueryHeap &reverse_heap2 = *engine_working_data.reverse_heap_2;
+
+                    NodeID s_v_middle = SPECIAL_NODEID, v_t_middle = SPECIAL_NODEID;
+                    tests.tested[index] = 1;
+                    if (!ViaNodeCandidatePassesTTest(forward_heap1, reverse_heap1, forward_heap2,
+                                                     reverse_heap2, ranked_candidates_list[index],
+                                                     length_of_shortest_path,
+                                                     &tests.lengths[index], &s_v_middle,
+                                                     &v_t_middle, min_edge_offset))
+                    {
+                        continue;
+                    }
+                    RetrievePackedAlternatePath(forward_heap1, reverse_heap1, forward_heap2,
+                                                reverse_heap2, s_v_middle, v_t_middle,
+                                                tests.packed_paths[index]);
+                    tests.passed[index] = 1;
+
+                    std::lock_guard<std::mutex> lock(passed_candidates_mutex);
+                    passed_candidates.insert(std::upper_bound(passed_candidates.begin(),
+                                                              passed_candidates.end(), index),
+                                             index);
+                    if (passed_candidates.size() >= required_candidates)
+                    {
+                        cut_off = std::min<std::size_t>(
+                            cut_off, passed_candidates[required_candidates - 1] + 1);
+                    }
+                }
+            });
+
+        return cut_off;
+    }
+
+    // Sweeps over the search space of a heap. A node that is on the shortest path shares its
+    // distance with it, every other node shares as much as its parent.
+    void ApproximateSharing(const QueryHeap &heap,
+                            const std::vector<SearchSpaceEdge> &search_space,
+                            const std::vector<std::uint8_t> &on_shortest_path,
+                            std::vector<int> &approximated_sharing) const
+    {
+        for (const SearchSpaceEdge &current_edge : search_space)
+        {
+            const auto u_index = heap.GetInsertionIndex(current_edge.first);
+            const auto v_index = heap.GetInsertionIndex(current_edge.second);
+
+            if (on_shortest_path[v_index])
+            {
+                approximated_sharing[v_index] = heap.GetKey(current_edge.second);
+            }
+            else if (approximated_sharing[u_index] != INVALID_EDGE_WEIGHT)
+            {
+                approximated_sharing[v_index] = approximated_sharing[u_index];
+            }
+        }
+    }
 
-            raw_route_data.alternative_path_length = length_of_via_path;
+    // original edges of a packed path, sorted to compute the sharing with other paths
+    std::vector<EdgeID> GetSortedOriginalEdges(const std::vector<NodeID> &packed_path) const
+    {
+        ShortcutUnpackingCache::UnpackedEdges unpacked_edges;
+        for (auto current = packed_path.begin(); std::next(current) < packed_path.end(); ++current)
+        {
+            super::UnpackToOriginalEdges(*current, *std::next(current), unpacked_edges);
         }
-        else
+
+        std::vector<EdgeID> original_edges;
+        original_edges.reserve(unpacked_edges.size());
+        for (const auto &unpacked_edge : unpacked_edges)
         {
-            BOOST_ASSERT(raw_route_data.alternative_path_length == INVALID_EDGE_WEIGHT);
+            original_edges.push_back(unpacked_edge.edge);
         }
+        std::sort(original_edges.begin(), original_edges.end());
+        return original_edges;
+    }
+
+    int ComputeSharing(const std::vector<EdgeID> &lhs, const std::vector<EdgeID> &rhs) const
+    {
+        int sharing = 0;
+        auto lhs_iter = lhs.begin();
+        auto rhs_iter = rhs.begin();
+        while (lhs_iter != lhs.end() && rhs_iter != rhs.end())
+        {
+            if (*lhs_iter < *rhs_iter)
+            {
+                ++lhs_iter;
+            }
+            else if (*rhs_iter < *lhs_iter)
+            {
+                ++rhs_iter;
+            }
+            else
+            {
+                sharing += facade->GetEdgeData(*lhs_iter).distance;
+                ++lhs_iter;
+                ++rhs_iter;
+            }
+        }
+        return sharing;
     }
 
-  private:
     // unpack alternate <s,..,v,..,t> by exploring search spaces from v
     void RetrievePackedAlternatePath(const QueryHeap &forward_heap1,
                                      const QueryHeap &reverse_heap1,
@@ -354,21 +525,20 @@ class AlternativeRouting final
         packed_path.insert(packed_path.end(), packed_v_t_path.begin(), packed_v_t_path.end());
     }
 
-    // TODO: reorder parameters
     // compute and unpack <s,..,v> and <v,..,t> by exploring search spaces
     // from v and intersecting against queues. only half-searches have to be
-    // done at this stage
-    void ComputeLengthAndSharingOfViaPath(const NodeID via_node,
+    // done at this stage. Uses the second queues of the calling thread.
+    void ComputeLengthAndSharingOfViaPath(const QueryHeap &existing_forward_heap,
+                                          const QueryHeap &existing_reverse_heap,
+                                          const NodeID via_node,
                                           int *real_length_of_via_path,
                                           int *sharing_of_via_path,
                                           const std::vector<NodeID> &packed_shortest_path,
-                                          const EdgeWeight min_edge_offset)
+                                          const EdgeWeight min_edge_offset) const
     {
         engine_working_data.InitializeOrClearSecondThreadLocalStorage(
             super::facade->GetNumberOfNodes());
 
-        QueryHeap &existing_forward_heap = *engine_working_data.forward_heap_1;
-        QueryHeap &existing_reverse_heap = *engine_working_data.reverse_heap_1;
         QueryHeap &new_forward_heap = *engine_working_data.forward_heap_2;
         QueryHeap &new_reverse_heap = *engine_working_data.reverse_heap_2;
 
@@ -635,8 +805,8 @@ class AlternativeRouting final
     }
 
     // conduct T-Test
-    bool ViaNodeCandidatePassesTTest(QueryHeap &existing_forward_heap,
-                                     QueryHeap &existing_reverse_heap,
+    bool ViaNodeCandidatePassesTTest(const QueryHeap &existing_forward_heap,
+                                     const QueryHeap &existing_reverse_heap,
                                      QueryHeap &new_forward_heap,
                                      QueryHeap &new_reverse_heap,
                                      const RankedCandidateNode &candidate,
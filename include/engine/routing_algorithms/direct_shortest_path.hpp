@@ -91,7 +91,7 @@ class DirectShortestPathRouting final
         }
 
         int distance = INVALID_EDGE_WEIGHT;
-        std::vector<NodeID> packed_leg;
+        util::ArenaVector<NodeID> packed_leg;
 
         if (super::facade->GetCoreSize() > 0)
         {
@@ -114,7 +114,6 @@ class DirectShortestPathRouting final
         if (INVALID_EDGE_WEIGHT == distance)
         {
             raw_route_data.shortest_path_length = INVALID_EDGE_WEIGHT;
-            raw_route_data.alternative_path_length = INVALID_EDGE_WEIGHT;
             return;
         }
 
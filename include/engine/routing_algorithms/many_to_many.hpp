@@ -3,10 +3,12 @@
 
 #include "engine/routing_algorithms/routing_base.hpp"
 #include "engine/search_engine_data.hpp"
+#include "util/integer_range.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <unordered_map>
@@ -31,14 +33,35 @@ class ManyToManyRouting final
     {
         unsigned target_id; // essentially a row in the distance matrix
         EdgeWeight distance;
-        NodeBucket(const unsigned target_id, const EdgeWeight distance)
-            : target_id(target_id), distance(distance)
+        NodeID parent; // parent in the backward search tree of the target
+        NodeBucket(const unsigned target_id, const EdgeWeight distance, const NodeID parent)
+            : target_id(target_id), distance(distance), parent(parent)
         {
         }
     };
     using SearchSpaceWithBuckets = std::unordered_map<NodeID, std::vector<NodeBucket>>;
 
   public:
+    // Distance table together with the packed path of every entry. The packed paths are
+    // stored back to back, entry i covers [offsets[i], offsets[i + 1]) of nodes and is
+    // empty if the target can not be reached from the source.
+    struct PackedPathTable
+    {
+        std::vector<EdgeWeight> weights;
+        std::vector<NodeID> nodes;
+        std::vector<std::size_t> offsets;
+
+        std::vector<NodeID>::const_iterator PathBegin(const std::size_t entry) const
+        {
+            return nodes.begin() + offsets[entry];
+        }
+
+        std::vector<NodeID>::const_iterator PathEnd(const std::size_t entry) const
+        {
+            return nodes.begin() + offsets[entry + 1];
+        }
+    };
+
     ManyToManyRouting(DataFacadeT *facade, SearchEngineData &engine_working_data)
         : super(facade), engine_working_data(engine_working_data)
     {
@@ -62,7 +85,76 @@ class ManyToManyRouting final
         QueryHeap &query_heap = *(engine_working_data.forward_heap_1);
 
         SearchSpaceWithBuckets search_space_with_buckets;
+        FillBuckets(phantom_targets_array, query_heap, search_space_with_buckets);
 
+        // for each source do forward search
+        unsigned source_id = 0;
+        for (const auto &phantom : phantom_sources_array)
+        {
+            ForwardSearch(source_id, phantom, number_of_targets, query_heap,
+                          search_space_with_buckets, *result_table, nullptr);
+            ++source_id;
+        }
+        // BOOST_ASSERT(source_id == target_id);
+        return result_table;
+    }
+
+    // Same search as above, but additionally retrieves the packed path of each entry so
+    // callers can unpack the paths they are interested in.
+    void operator()(const std::vector<PhantomNode> &phantom_sources_array,
+                    const std::vector<PhantomNode> &phantom_targets_array,
+                    PackedPathTable &result_table) const
+    {
+        const auto number_of_sources = phantom_sources_array.size();
+        const auto number_of_targets = phantom_targets_array.size();
+        result_table.weights.assign(number_of_targets * number_of_sources,
+                                    std::numeric_limits<EdgeWeight>::max());
+        result_table.nodes.clear();
+        result_table.offsets.clear();
+        result_table.offsets.reserve(number_of_targets * number_of_sources + 1);
+        result_table.offsets.push_back(0);
+
+        engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+            super::facade->GetNumberOfNodes());
+
+        QueryHeap &query_heap = *(engine_working_data.forward_heap_1);
+
+        SearchSpaceWithBuckets search_space_with_buckets;
+        FillBuckets(phantom_targets_array, query_heap, search_space_with_buckets);
+
+        std::vector<NodeID> middle_nodes(number_of_targets);
+        unsigned source_id = 0;
+        for (const auto &phantom : phantom_sources_array)
+        {
+            std::fill(middle_nodes.begin(), middle_nodes.end(), SPECIAL_NODEID);
+            ForwardSearch(source_id, phantom, number_of_targets, query_heap,
+                          search_space_with_buckets, result_table.weights, &middle_nodes);
+
+            // the forward search tree of this source is still in the heap
+            for (const auto target_id : util::irange<unsigned>(0u, number_of_targets))
+            {
+                const NodeID middle_node = middle_nodes[target_id];
+                if (SPECIAL_NODEID != middle_node)
+                {
+                    const auto path_begin = result_table.nodes.size();
+                    super::RetrievePackedPathFromSingleHeap(query_heap, middle_node,
+                                                            result_table.nodes);
+                    std::reverse(result_table.nodes.begin() + path_begin,
+                                 result_table.nodes.end());
+                    result_table.nodes.push_back(middle_node);
+                    RetrievePackedPathFromBuckets(target_id, middle_node,
+                                                  search_space_with_buckets, result_table.nodes);
+                }
+                result_table.offsets.push_back(result_table.nodes.size());
+            }
+            ++source_id;
+        }
+    }
+
+    void FillBuckets(const std::vector<PhantomNode> &phantom_targets_array,
+                     QueryHeap &query_heap,
+                     SearchSpaceWithBuckets &search_space_with_buckets) const
+    {
         unsigned target_id = 0;
         for (const auto &phantom : phantom_targets_array)
         {
@@ -87,43 +179,44 @@ class ManyToManyRouting final
             }
             ++target_id;
         }
+    }
 
-        // for each source do forward search
-        unsigned source_id = 0;
-        for (const auto &phantom : phantom_sources_array)
-        {
-            query_heap.Clear();
-            // insert target(s) at distance 0
-
-            if (SPECIAL_NODEID != phantom.forward_node_id)
-            {
-                query_heap.Insert(phantom.forward_node_id, -phantom.GetForwardWeightPlusOffset(),
-                                  phantom.forward_node_id);
-            }
-            if (SPECIAL_NODEID != phantom.reverse_node_id)
-            {
-                query_heap.Insert(phantom.reverse_node_id, -phantom.GetReverseWeightPlusOffset(),
-                                  phantom.reverse_node_id);
-            }
+    void ForwardSearch(const unsigned source_id,
+                       const PhantomNode &phantom,
+                       const unsigned number_of_targets,
+                       QueryHeap &query_heap,
+                       const SearchSpaceWithBuckets &search_space_with_buckets,
+                       std::vector<EdgeWeight> &result_table,
+                       std::vector<NodeID> *middle_nodes) const
+    {
+        query_heap.Clear();
+        // insert target(s) at distance 0
 
-            // explore search space
-            while (!query_heap.Empty())
-            {
-                ForwardRoutingStep(source_id, number_of_targets, query_heap,
-                                   search_space_with_buckets, result_table);
-            }
+        if (SPECIAL_NODEID != phantom.forward_node_id)
+        {
+            query_heap.Insert(phantom.forward_node_id, -phantom.GetForwardWeightPlusOffset(),
+                              phantom.forward_node_id);
+        }
+        if (SPECIAL_NODEID != phantom.reverse_node_id)
+        {
+            query_heap.Insert(phantom.reverse_node_id, -phantom.GetReverseWeightPlusOffset(),
+                              phantom.reverse_node_id);
+        }
 
-            ++source_id;
+        // explore search space
+        while (!query_heap.Empty())
+        {
+            ForwardRoutingStep(source_id, number_of_targets, query_heap, search_space_with_buckets,
+                               result_table, middle_nodes);
         }
-        // BOOST_ASSERT(source_id == target_id);
-        return result_table;
     }
 
     void ForwardRoutingStep(const unsigned source_id,
                             const unsigned number_of_targets,
                             QueryHeap &query_heap,
                             const SearchSpaceWithBuckets &search_space_with_buckets,
-                            std::shared_ptr<std::vector<EdgeWeight>> result_table) const
+                            std::vector<EdgeWeight> &result_table,
+                            std::vector<NodeID> *middle_nodes) const
     {
         const NodeID node = query_heap.DeleteMin();
         const int source_distance = query_heap.GetKey(node);
@@ -140,13 +233,17 @@ class ManyToManyRouting final
                 const unsigned target_id = current_bucket.target_id;
                 const int target_distance = current_bucket.distance;
                 const EdgeWeight current_distance =
-                    (*result_table)[source_id * number_of_targets + target_id];
+                    result_table[source_id * number_of_targets + target_id];
                 // check if new distance is better
                 const EdgeWeight new_distance = source_distance + target_distance;
                 if (new_distance >= 0 && new_distance < current_distance)
                 {
-                    (*result_table)[source_id * number_of_targets + target_id] =
+                    result_table[source_id * number_of_targets + target_id] =
                         (source_distance + target_distance);
+                    if (middle_nodes)
+                    {
+                        (*middle_nodes)[target_id] = node;
+                    }
                 }
             }
         }
@@ -157,6 +254,35 @@ class ManyToManyRouting final
         RelaxOutgoingEdges<true>(node, source_distance, query_heap);
     }
 
+    // Follows the parents stored in the buckets from the middle node to the target.
+    // Every node of the backward search tree was settled and thus has a bucket entry.
+    void RetrievePackedPathFromBuckets(const unsigned target_id,
+                                       const NodeID middle_node,
+                                       const SearchSpaceWithBuckets &search_space_with_buckets,
+                                       std::vector<NodeID> &packed_path) const
+    {
+        NodeID current_node = middle_node;
+        while (true)
+        {
+            const auto bucket_iterator = search_space_with_buckets.find(current_node);
+            BOOST_ASSERT(bucket_iterator != search_space_with_buckets.end());
+            const auto &bucket_list = bucket_iterator->second;
+            const auto current_bucket =
+                std::find_if(bucket_list.begin(), bucket_list.end(),
+                             [target_id](const NodeBucket &bucket)
+                             {
+                                 return bucket.target_id == target_id;
+                             });
+            BOOST_ASSERT(current_bucket != bucket_list.end());
+            if (current_bucket->parent == current_node)
+            {
+                break;
+            }
+            current_node = current_bucket->parent;
+            packed_path.push_back(current_node);
+        }
+    }
+
     void BackwardRoutingStep(const unsigned target_id,
                              QueryHeap &query_heap,
                              SearchSpaceWithBuckets &search_space_with_buckets) const
@@ -165,7 +291,8 @@ class ManyToManyRouting final
         const int target_distance = query_heap.GetKey(node);
 
         // store settled nodes in search space bucket
-        search_space_with_buckets[node].emplace_back(target_id, target_distance);
+        search_space_with_buckets[node].emplace_back(target_id, target_distance,
+                                                     query_heap.GetData(node).parent);
 
         if (StallAtNode<false>(node, target_distance, query_heap))
         {
@@ -0,0 +1,383 @@
+#ifndef MANY_TO_MANY_SWEEP_ROUTING_HPP
+#define MANY_TO_MANY_SWEEP_ROUTING_HPP
+
+#include "engine/routing_algorithms/routing_base.hpp"
+#include "engine/search_engine_data.hpp"
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+// Distance table for many targets (RPHAST). Instead of storing the search space of every target
+// in buckets, the part of the graph that leads down to any target is extracted once per request.
+// Every source then runs its upward search and a linear sweep over that subgraph. The sweep
+// handles a batch of sources at once, the weights of a node for all sources of a batch are stored
+// next to each other so the inner loops can be vectorized by the compiler. Batches are processed
+// in parallel.
+template <class DataFacadeT>
+class ManyToManySweepRouting final
+    : public BasicRoutingInterface<DataFacadeT, ManyToManySweepRouting<DataFacadeT>>
+{
+    using super = BasicRoutingInterface<DataFacadeT, ManyToManySweepRouting<DataFacadeT>>;
+    using QueryHeap = SearchEngineData::QueryHeap;
+    SearchEngineData &engine_working_data;
+
+    static constexpr std::size_t SOURCE_BATCH_SIZE = 8;
+    // large enough to never be reached, small enough to add an edge weight without overflow
+    static constexpr EdgeWeight UNREACHED_WEIGHT = std::numeric_limits<EdgeWeight>::max() / 2;
+
+    using BatchWeights = std::array<EdgeWeight, SOURCE_BATCH_SIZE>;
+
+    struct RestrictedEdge
+    {
+        unsigned upper_node; // index of the higher endpoint in the restricted graph
+        EdgeWeight weight;
+    };
+
+    // The nodes from which a target can be reached going down the hierarchy, in topological
+    // order from the top down. Edges are stored at their lower endpoint, node i has the edges
+    // [first_edge[i], first_edge[i + 1]).
+    struct RestrictedGraph
+    {
+        std::vector<NodeID> nodes;
+        std::unordered_map<NodeID, unsigned> node_index;
+        std::vector<unsigned> first_edge;
+        std::vector<RestrictedEdge> edges;
+        // slot in the target weights of every node that is a target node, SPECIAL_NODEID else
+        std::vector<unsigned> target_slot;
+        unsigned number_of_target_slots = 0;
+        // slots of the forward and reverse node of every target
+        std::vector<std::pair<unsigned, unsigned>> slots_of_target;
+    };
+
+  public:
+    ManyToManySweepRouting(DataFacadeT *facade, SearchEngineData &engine_working_data)
+        : super(facade), engine_working_data(engine_working_data)
+    {
+    }
+
+    ~ManyToManySweepRouting() {}
+
+    // The topological order is only guaranteed if the graph has no core.
+    bool IsAvailable() const { return super::facade->GetNumberOfSweepLevels() > 0; }
+
+    // Same result as ManyToManyRouting: the weight from source i to target j is stored at
+    // i * number_of_targets + j and is the maximum weight if the target can not be reached.
+    std::shared_ptr<std::vector<EdgeWeight>>
+    operator()(const std::vector<PhantomNode> &phantom_sources_array,
+               const std::vector<PhantomNode> &phantom_targets_array) const
+    {
+        BOOST_ASSERT(IsAvailable());
+
+        const auto number_of_sources = phantom_sources_array.size();
+        const auto number_of_targets = phantom_targets_array.size();
+        std::shared_ptr<std::vector<EdgeWeight>> result_table =
+            std::make_shared<std::vector<EdgeWeight>>(number_of_targets * number_of_sources,
+                                                      std::numeric_limits<EdgeWeight>::max());
+
+        const auto restricted_graph = ExtractRestrictedGraph(phantom_targets_array);
+
+        const auto number_of_batches =
+            (number_of_sources + SOURCE_BATCH_SIZE - 1) / SOURCE_BATCH_SIZE;
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, number_of_batches, 1),
+            [&](const tbb::blocked_range<std::size_t> &range)
+            {
+                engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+                    super::facade->GetNumberOfNodes());
+                QueryHeap &query_heap = *(engine_working_data.forward_heap_1);
+                std::vector<BatchWeights> weights;
+                std::vector<BatchWeights> target_up_weights;
+                std::vector<BatchWeights> target_down_weights;
+                for (const auto batch : util::irange(range.begin(), range.end()))
+                {
+                    const auto first_source = batch * SOURCE_BATCH_SIZE;
+                    const auto last_source =
+                        std::min(first_source + SOURCE_BATCH_SIZE, number_of_sources);
+
+                    BatchWeights unreached;
+                    unreached.fill(EdgeWeight{UNREACHED_WEIGHT});
+                    weights.assign(restricted_graph.nodes.size(), unreached);
+                    for (const auto source : util::irange(first_source, last_source))
+                    {
+                        UpwardSearch(source - first_source, phantom_sources_array[source],
+                                     restricted_graph, query_heap, weights);
+                    }
+
+                    Sweep(restricted_graph, weights, target_up_weights, target_down_weights);
+
+                    for (const auto source : util::irange(first_source, last_source))
+                    {
+                        for (const auto target : util::irange<std::size_t>(0, number_of_targets))
+                        {
+                            (*result_table)[source * number_of_targets + target] =
+                                GetTargetWeight(restricted_graph.slots_of_target[target],
+                                                phantom_targets_array[target],
+                                                source - first_source, target_up_weights,
+                                                target_down_weights);
+                        }
+                    }
+                }
+            });
+
+        return result_table;
+    }
+
+  private:
+    // Collects all nodes from which a target node can be reached on a downward path. A depth
+    // first search along the upward edges emits every node after all nodes above it, which
+    // yields a top-down order for the sweep.
+    RestrictedGraph ExtractRestrictedGraph(const std::vector<PhantomNode> &phantom_targets_array)
+        const
+    {
+        RestrictedGraph graph;
+        std::vector<std::pair<NodeID, EdgeID>> stack;
+
+        const auto visit = [&](const NodeID root)
+        {
+            if (SPECIAL_NODEID == root || graph.node_index.count(root) > 0)
+            {
+                return;
+            }
+            graph.node_index.emplace(root, SPECIAL_NODEID);
+            stack.emplace_back(root, super::facade->BeginEdges(root));
+            while (!stack.empty())
+            {
+                const auto node = stack.back().first;
+                auto &edge = stack.back().second;
+                if (edge == super::facade->EndEdges(node))
+                {
+                    graph.node_index[node] = graph.nodes.size();
+                    graph.nodes.push_back(node);
+                    stack.pop_back();
+                    continue;
+                }
+                const auto &data = super::facade->GetEdgeData(edge);
+                const auto upper_node = super::facade->GetTarget(edge);
+                ++edge;
+                if (data.backward && graph.node_index.count(upper_node) == 0)
+                {
+                    graph.node_index.emplace(upper_node, SPECIAL_NODEID);
+                    stack.emplace_back(upper_node, super::facade->BeginEdges(upper_node));
+                }
+            }
+        };
+
+        for (const auto &phantom : phantom_targets_array)
+        {
+            visit(phantom.forward_node_id);
+            visit(phantom.reverse_node_id);
+        }
+
+        graph.first_edge.reserve(graph.nodes.size() + 1);
+        graph.first_edge.push_back(0);
+        for (const auto node : graph.nodes)
+        {
+            for (const auto edge : super::facade->GetAdjacentEdgeRange(node))
+            {
+                const auto &data = super::facade->GetEdgeData(edge);
+                if (data.backward)
+                {
+                    const auto upper_index = graph.node_index.at(super::facade->GetTarget(edge));
+                    BOOST_ASSERT(upper_index < graph.first_edge.size() - 1);
+                    graph.edges.push_back(RestrictedEdge{upper_index, data.distance});
+                }
+            }
+            graph.first_edge.push_back(graph.edges.size());
+        }
+
+        graph.target_slot.resize(graph.nodes.size(), SPECIAL_NODEID);
+        const auto assign_slot = [&](const NodeID node) -> unsigned
+        {
+            if (SPECIAL_NODEID == node)
+            {
+                return SPECIAL_NODEID;
+            }
+            auto &slot = graph.target_slot[graph.node_index.at(node)];
+            if (SPECIAL_NODEID == slot)
+            {
+                slot = graph.number_of_target_slots++;
+            }
+            return slot;
+        };
+        graph.slots_of_target.reserve(phantom_targets_array.size());
+        for (const auto &phantom : phantom_targets_array)
+        {
+            const auto forward_slot = assign_slot(phantom.forward_node_id);
+            const auto reverse_slot = assign_slot(phantom.reverse_node_id);
+            graph.slots_of_target.emplace_back(forward_slot, reverse_slot);
+        }
+
+        return graph;
+    }
+
+    // Settles the upward search space of a source and seeds the restricted graph with it.
+    void UpwardSearch(const std::size_t batch_source,
+                      const PhantomNode &phantom,
+                      const RestrictedGraph &restricted_graph,
+                      QueryHeap &query_heap,
+                      std::vector<BatchWeights> &weights) const
+    {
+        query_heap.Clear();
+        if (SPECIAL_NODEID != phantom.forward_node_id)
+        {
+            query_heap.Insert(phantom.forward_node_id, -phantom.GetForwardWeightPlusOffset(),
+                              phantom.forward_node_id);
+        }
+        if (SPECIAL_NODEID != phantom.reverse_node_id)
+        {
+            query_heap.Insert(phantom.reverse_node_id, -phantom.GetReverseWeightPlusOffset(),
+                              phantom.reverse_node_id);
+        }
+
+        while (!query_heap.Empty())
+        {
+            const NodeID node = query_heap.DeleteMin();
+            const EdgeWeight distance = query_heap.GetKey(node);
+
+            const auto index_iter = restricted_graph.node_index.find(node);
+            if (index_iter != restricted_graph.node_index.end())
+            {
+                weights[index_iter->second][batch_source] = distance;
+            }
+
+            if (StallAtNode(node, distance, query_heap))
+            {
+                continue;
+            }
+
+            for (const auto edge : super::facade->GetAdjacentEdgeRange(node))
+            {
+                const auto &data = super::facade->GetEdgeData(edge);
+                if (!data.forward)
+                {
+                    continue;
+                }
+                const NodeID to = super::facade->GetTarget(edge);
+                BOOST_ASSERT_MSG(data.distance > 0, "edge_weight invalid");
+                const EdgeWeight to_distance = distance + data.distance;
+
+                if (!query_heap.WasInserted(to))
+                {
+                    query_heap.Insert(to, to_distance, node);
+                }
+                else if (to_distance < query_heap.GetKey(to))
+                {
+                    query_heap.GetData(to).parent = node;
+                    query_heap.DecreaseKey(to, to_distance);
+                }
+            }
+        }
+    }
+
+    // Stalling of the upward search, the weights of stalled nodes are fixed by the sweep.
+    bool StallAtNode(const NodeID node, const EdgeWeight distance, QueryHeap &query_heap) const
+    {
+        for (const auto edge : super::facade->GetAdjacentEdgeRange(node))
+        {
+            const auto &data = super::facade->GetEdgeData(edge);
+            if (data.backward)
+            {
+                const NodeID to = super::facade->GetTarget(edge);
+                BOOST_ASSERT_MSG(data.distance > 0, "edge_weight invalid");
+                if (query_heap.WasInserted(to) && query_heap.GetKey(to) + data.distance < distance)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Pulls the weights down the restricted graph. The weight a target node got from the upward
+    // search is kept apart from the weight over the graph: if the source lies on the same
+    // segment behind the target, the first one is negative and a loop has to be taken instead.
+    void Sweep(const RestrictedGraph &restricted_graph,
+               std::vector<BatchWeights> &weights,
+               std::vector<BatchWeights> &target_up_weights,
+               std::vector<BatchWeights> &target_down_weights) const
+    {
+        target_up_weights.resize(restricted_graph.number_of_target_slots);
+        target_down_weights.resize(restricted_graph.number_of_target_slots);
+
+        for (const auto node : util::irange<std::size_t>(0, restricted_graph.nodes.size()))
+        {
+            BatchWeights down_weights;
+            down_weights.fill(EdgeWeight{UNREACHED_WEIGHT});
+            for (const auto edge : util::irange(restricted_graph.first_edge[node],
+                                                restricted_graph.first_edge[node + 1]))
+            {
+                const auto &restricted_edge = restricted_graph.edges[edge];
+                const auto &upper_weights = weights[restricted_edge.upper_node];
+                for (const auto source : util::irange<std::size_t>(0, SOURCE_BATCH_SIZE))
+                {
+                    down_weights[source] =
+                        std::min(down_weights[source],
+                                 upper_weights[source] + restricted_edge.weight);
+                }
+            }
+
+            auto &node_weights = weights[node];
+            const auto slot = restricted_graph.target_slot[node];
+            if (SPECIAL_NODEID != slot)
+            {
+                target_up_weights[slot] = node_weights;
+                target_down_weights[slot] = down_weights;
+            }
+            for (const auto source : util::irange<std::size_t>(0, SOURCE_BATCH_SIZE))
+            {
+                node_weights[source] = std::min(node_weights[source], down_weights[source]);
+            }
+        }
+    }
+
+    EdgeWeight GetTargetWeight(const std::pair<unsigned, unsigned> &slots,
+                               const PhantomNode &phantom,
+                               const std::size_t batch_source,
+                               const std::vector<BatchWeights> &target_up_weights,
+                               const std::vector<BatchWeights> &target_down_weights) const
+    {
+        EdgeWeight result = std::numeric_limits<EdgeWeight>::max();
+        const auto relax = [&](const unsigned slot, const EdgeWeight offset)
+        {
+            if (SPECIAL_NODEID == slot)
+            {
+                return;
+            }
+            for (const auto weight :
+                 {target_up_weights[slot][batch_source], target_down_weights[slot][batch_source]})
+            {
+                if (weight < UNREACHED_WEIGHT && weight + offset >= 0 && weight + offset < result)
+                {
+                    result = weight + offset;
+                }
+            }
+        };
+        relax(slots.first, phantom.GetForwardWeightPlusOffset());
+        relax(slots.second, phantom.GetReverseWeightPlusOffset());
+        return result;
+    }
+};
+}
+}
+}
+
+#endif // MANY_TO_MANY_SWEEP_ROUTING_HPP
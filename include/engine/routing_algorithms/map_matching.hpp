@@ -2,9 +2,11 @@
 #define MAP_MATCHING_HPP
 
 #include "engine/routing_algorithms/routing_base.hpp"
+#include "engine/routing_algorithms/many_to_many.hpp"
 
 #include "util/coordinate_calculation.hpp"
 #include "engine/map_matching/hidden_markov_model.hpp"
+#include "engine/map_matching/matching_session.hpp"
 #include "util/json_logger.hpp"
 #include "util/matching_debug_info.hpp"
 
@@ -46,8 +48,9 @@ template <class DataFacadeT>
 class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<DataFacadeT>>
 {
     using super = BasicRoutingInterface<DataFacadeT, MapMatching<DataFacadeT>>;
-    using QueryHeap = SearchEngineData::QueryHeap;
-    SearchEngineData &engine_working_data;
+    using ManyToMany = ManyToManyRouting<DataFacadeT>;
+    using PackedPathTable = typename ManyToMany::PackedPathTable;
+    ManyToMany many_to_many;
 
     unsigned GetMedianSampleTime(const std::vector<unsigned> &timestamps) const
     {
@@ -64,9 +67,149 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
         return *median;
     }
 
+    // Computes the viterbi values of timestamp t from the last unbroken timestamp and clears
+    // the breakage flag of t if any of its candidates can be reached.
+    void ComputeTransitions(HMM &model,
+                            const util::FixedPointCoordinate &prev_coordinate,
+                            const util::FixedPointCoordinate &current_coordinate,
+                            const std::size_t prev_unbroken_timestamp,
+                            const std::size_t t,
+                            const double max_distance_delta,
+                            const map_matching::TransitionLogProbability
+                                &transition_log_probability,
+                            util::MatchingDebugInfo &matching_debug) const
+    {
+        const auto &prev_viterbi = model.viterbi[prev_unbroken_timestamp];
+        const auto &prev_pruned = model.pruned[prev_unbroken_timestamp];
+        const auto &prev_unbroken_timestamps_list = model.candidates_list[prev_unbroken_timestamp];
+
+        auto current_viterbi = model.viterbi[t];
+        auto current_pruned = model.pruned[t];
+        auto current_suspicious = model.suspicious[t];
+        auto current_parents = model.parents[t];
+        auto current_lengths = model.path_lengths[t];
+        const auto &current_timestamps_list = model.candidates_list[t];
+
+        const auto haversine_distance = util::coordinate_calculation::haversineDistance(
+            prev_coordinate, current_coordinate);
+
+        // compute the routes from all candidates of the last unbroken timestamp that were
+        // not pruned to all candidates of this timestamp with a single many-to-many search
+        std::vector<std::size_t> source_candidates;
+        std::vector<PhantomNode> source_phantoms;
+        for (const auto s : util::irange<std::size_t>(0u, prev_viterbi.size()))
+        {
+            if (!prev_pruned[s])
+            {
+                source_candidates.push_back(s);
+                source_phantoms.push_back(prev_unbroken_timestamps_list[s].phantom_node);
+            }
+        }
+        std::vector<PhantomNode> target_phantoms;
+        for (const auto &candidate : current_timestamps_list)
+        {
+            target_phantoms.push_back(candidate.phantom_node);
+        }
+        PackedPathTable transition_paths;
+        if (!source_phantoms.empty())
+        {
+            many_to_many(source_phantoms, target_phantoms, transition_paths);
+        }
+
+        // compute d_t for this timestamp and the next one
+        for (const auto source_index : util::irange<std::size_t>(0u, source_candidates.size()))
+        {
+            const auto s = source_candidates[source_index];
+
+            for (const auto s_prime : util::irange<std::size_t>(0u, current_viterbi.size()))
+            {
+                // how likely is candidate s_prime at time t to be emitted?
+                const double emission_pr = model.emission_log_probabilities[t][s_prime];
+                double new_value = prev_viterbi[s] + emission_pr;
+                if (current_viterbi[s_prime] > new_value)
+                {
+                    continue;
+                }
+
+                // only unpack the routes that can still improve the viterbi value
+                const auto entry = source_index * current_viterbi.size() + s_prime;
+                const auto network_distance = super::get_path_distance(
+                    transition_paths.PathBegin(entry), transition_paths.PathEnd(entry),
+                    prev_unbroken_timestamps_list[s].phantom_node,
+                    current_timestamps_list[s_prime].phantom_node);
+
+                const auto d_t = std::abs(network_distance - haversine_distance);
+
+                // very low probability transition -> prune
+                if (d_t >= max_distance_delta)
+                {
+                    continue;
+                }
+
+                const double transition_pr = transition_log_probability(d_t);
+                new_value += transition_pr;
+
+                matching_debug.add_transition_info(prev_unbroken_timestamp, t, s, s_prime,
+                                                   prev_viterbi[s], emission_pr, transition_pr,
+                                                   network_distance, haversine_distance);
+
+                if (new_value > current_viterbi[s_prime])
+                {
+                    current_viterbi[s_prime] = new_value;
+                    current_parents[s_prime] = std::make_pair(prev_unbroken_timestamp, s);
+                    current_lengths[s_prime] = network_distance;
+                    current_pruned[s_prime] = false;
+                    current_suspicious[s_prime] = d_t > SUSPICIOUS_DISTANCE_DELTA;
+                    model.breakage[t] = false;
+                }
+            }
+        }
+    }
+
+    // Appends the path that ends in a final state to the reported matchings and drops all
+    // states before it from the window.
+    void ReportFinalStates(map_matching::MatchingSession &session,
+                           const map_matching::MatchingSession::State final_state,
+                           SubMatchingList &sub_matchings) const
+    {
+        const auto path = session.Backtrack(final_state);
+        if (!path.empty())
+        {
+            if (sub_matchings.empty() || !session.continues_matching)
+            {
+                sub_matchings.emplace_back();
+                sub_matchings.back().length = 0.0;
+                sub_matchings.back().confidence = 0.0;
+            }
+            auto &matching = sub_matchings.back();
+            for (const auto &state : path)
+            {
+                matching.nodes.push_back(
+                    session.candidates_list[state.first][state.second].phantom_node);
+                matching.indices.push_back(session.indices[state.first]);
+                matching.length += session.model.path_lengths[state.first][state.second];
+            }
+            session.continues_matching = true;
+        }
+
+        // the final state is kept as start of the next transitions
+        session.EraseFront(final_state.first);
+        session.number_of_final_states = 1;
+    }
+
+    // Decides the remaining states of a session on the most likely path.
+    void FinalizeSession(map_matching::MatchingSession &session,
+                         SubMatchingList &sub_matchings) const
+    {
+        if (session.last_unbroken != map_matching::INVALID_STATE)
+        {
+            ReportFinalStates(session, session.GetMostLikelyState(), sub_matchings);
+        }
+    }
+
   public:
     MapMatching(DataFacadeT *facade, SearchEngineData &engine_working_data)
-        : super(facade), engine_working_data(engine_working_data)
+        : super(facade), many_to_many(facade, engine_working_data)
     {
     }
 
@@ -110,7 +253,8 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
         map_matching::EmissionLogProbability emission_log_probability(gps_precision);
         map_matching::TransitionLogProbability transition_log_probability(matching_beta);
 
-        HMM model(candidates_list, emission_log_probability);
+        HMM model(candidates_list, emission_log_probability,
+                  SearchEngineData::GetThreadLocalHMMStorage());
 
         std::size_t initial_timestamp = model.initialize(0);
         if (initial_timestamp == map_matching::INVALID_STATE)
@@ -121,12 +265,6 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
         util::MatchingDebugInfo matching_debug(util::json::Logger::get());
         matching_debug.initialize(candidates_list);
 
-        engine_working_data.InitializeOrClearFirstThreadLocalStorage(
-            super::facade->GetNumberOfNodes());
-
-        QueryHeap &forward_heap = *(engine_working_data.forward_heap_1);
-        QueryHeap &reverse_heap = *(engine_working_data.reverse_heap_1);
-
         std::size_t breakage_begin = map_matching::INVALID_STATE;
         std::vector<std::size_t> split_points;
         std::vector<std::size_t> prev_unbroken_timestamps;
@@ -181,76 +319,9 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
             BOOST_ASSERT(!prev_unbroken_timestamps.empty());
             const std::size_t prev_unbroken_timestamp = prev_unbroken_timestamps.back();
 
-            const auto &prev_viterbi = model.viterbi[prev_unbroken_timestamp];
-            const auto &prev_pruned = model.pruned[prev_unbroken_timestamp];
-            const auto &prev_unbroken_timestamps_list = candidates_list[prev_unbroken_timestamp];
-            const auto &prev_coordinate = trace_coordinates[prev_unbroken_timestamp];
-
-            auto &current_viterbi = model.viterbi[t];
-            auto &current_pruned = model.pruned[t];
-            auto &current_suspicious = model.suspicious[t];
-            auto &current_parents = model.parents[t];
-            auto &current_lengths = model.path_lengths[t];
-            const auto &current_timestamps_list = candidates_list[t];
-            const auto &current_coordinate = trace_coordinates[t];
-
-            const auto haversine_distance = util::coordinate_calculation::haversineDistance(
-                prev_coordinate, current_coordinate);
-
-            // compute d_t for this timestamp and the next one
-            for (const auto s : util::irange<std::size_t>(0u, prev_viterbi.size()))
-            {
-                if (prev_pruned[s])
-                {
-                    continue;
-                }
-
-                for (const auto s_prime : util::irange<std::size_t>(0u, current_viterbi.size()))
-                {
-                    // how likely is candidate s_prime at time t to be emitted?
-                    // FIXME this can be pre-computed
-                    const double emission_pr =
-                        emission_log_probability(candidates_list[t][s_prime].distance);
-                    double new_value = prev_viterbi[s] + emission_pr;
-                    if (current_viterbi[s_prime] > new_value)
-                    {
-                        continue;
-                    }
-
-                    forward_heap.Clear();
-                    reverse_heap.Clear();
-
-                    // get distance diff between loc1/2 and locs/s_prime
-                    const auto network_distance = super::get_network_distance(
-                        forward_heap, reverse_heap, prev_unbroken_timestamps_list[s].phantom_node,
-                        current_timestamps_list[s_prime].phantom_node);
-
-                    const auto d_t = std::abs(network_distance - haversine_distance);
-
-                    // very low probability transition -> prune
-                    if (d_t >= max_distance_delta)
-                    {
-                        continue;
-                    }
-
-                    const double transition_pr = transition_log_probability(d_t);
-                    new_value += transition_pr;
-
-                    matching_debug.add_transition_info(prev_unbroken_timestamp, t, s, s_prime,
-                                                       prev_viterbi[s], emission_pr, transition_pr,
-                                                       network_distance, haversine_distance);
-
-                    if (new_value > current_viterbi[s_prime])
-                    {
-                        current_viterbi[s_prime] = new_value;
-                        current_parents[s_prime] = std::make_pair(prev_unbroken_timestamp, s);
-                        current_lengths[s_prime] = network_distance;
-                        current_pruned[s_prime] = false;
-                        current_suspicious[s_prime] = d_t > SUSPICIOUS_DISTANCE_DELTA;
-                        model.breakage[t] = false;
-                    }
-                }
-            }
+            ComputeTransitions(model, trace_coordinates[prev_unbroken_timestamp],
+                               trace_coordinates[t], prev_unbroken_timestamp, t,
+                               max_distance_delta, transition_log_probability, matching_debug);
 
             if (model.breakage[t])
             {
@@ -301,12 +372,9 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
             }
 
             // loop through the columns, and only compare the last entry
-            const auto max_element_iter =
-                std::max_element(model.viterbi[parent_timestamp_index].begin(),
-                                 model.viterbi[parent_timestamp_index].end());
-
             std::size_t parent_candidate_index =
-                std::distance(model.viterbi[parent_timestamp_index].begin(), max_element_iter);
+                map_matching::ArgMax(model.viterbi[parent_timestamp_index].begin(),
+                                     model.viterbi[parent_timestamp_index].end());
 
             std::deque<std::pair<std::size_t, std::size_t>> reconstructed_indices;
             while (parent_timestamp_index > sub_matching_begin)
@@ -353,6 +421,116 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
         }
         matching_debug.add_breakage(model.breakage);
     }
+
+    // Online map matching: adds one point to a session and appends all points that became
+    // final to sub_matchings. Returns true if the first of them continues the matching that
+    // was reported last for this session.
+    bool operator()(map_matching::MatchingSession &session,
+                    CandidateList candidates,
+                    const util::FixedPointCoordinate &coordinate,
+                    const unsigned timestamp,
+                    SubMatchingList &sub_matchings) const
+    {
+        bool continues_previous = session.continues_matching;
+        const auto index = session.number_of_points++;
+        BOOST_ASSERT(!session.use_timestamps || timestamp >= session.last_timestamp);
+        session.last_timestamp = timestamp;
+
+        // points without candidates are skipped like broken points
+        if (candidates.empty())
+        {
+            return continues_previous && !sub_matchings.empty();
+        }
+
+        double max_distance_delta = std::numeric_limits<double>::max();
+        if (session.last_unbroken != map_matching::INVALID_STATE)
+        {
+            bool trace_split;
+            if (session.use_timestamps)
+            {
+                // the sample time is estimated from the points in the window
+                std::vector<unsigned> window_timestamps(session.timestamps);
+                window_timestamps.push_back(timestamp);
+                const auto median_sample_time =
+                    std::max(1u, GetMedianSampleTime(window_timestamps));
+                trace_split = timestamp - session.timestamps[session.last_unbroken] >
+                              median_sample_time * MAX_BROKEN_STATES;
+                max_distance_delta = median_sample_time * MAX_SPEED;
+            }
+            else
+            {
+                trace_split = index - session.indices[session.last_unbroken] > MAX_BROKEN_STATES;
+            }
+
+            if (trace_split)
+            {
+                FinalizeSession(session, sub_matchings);
+                if (sub_matchings.empty())
+                {
+                    continues_previous = false;
+                }
+                session.Reset();
+            }
+        }
+
+        session.Append(std::move(candidates), coordinate, timestamp, index);
+        const std::size_t t = session.candidates_list.size() - 1;
+
+        if (session.last_unbroken == map_matching::INVALID_STATE)
+        {
+            if (session.model.initialize_timestamp(t))
+            {
+                session.last_unbroken = t;
+            }
+            else
+            {
+                session.PopBack();
+            }
+            return continues_previous && !sub_matchings.empty();
+        }
+
+        util::MatchingDebugInfo matching_debug(nullptr);
+        ComputeTransitions(session.model, session.coordinates[session.last_unbroken], coordinate,
+                           session.last_unbroken, t, max_distance_delta,
+                           session.transition_log_probability, matching_debug);
+
+        if (session.model.breakage[t])
+        {
+            // unlike the offline matching we can not go back to the start of the breakage,
+            // so unreachable points are dropped until the trace is split
+            session.PopBack();
+            return continues_previous && !sub_matchings.empty();
+        }
+        session.last_unbroken = t;
+
+        const auto converged_state = session.FindConvergence();
+        if (converged_state.first != map_matching::INVALID_STATE)
+        {
+            ReportFinalStates(session, converged_state, sub_matchings);
+        }
+
+        if (session.candidates_list.size() > map_matching::MatchingSession::MAX_WINDOW_SIZE)
+        {
+            // the window did not converge, decide the older half on the most likely path
+            const auto path = session.Backtrack(session.GetMostLikelyState());
+            BOOST_ASSERT(path.size() > map_matching::MatchingSession::MAX_WINDOW_SIZE / 2);
+            const auto decided_state =
+                path[path.size() - map_matching::MatchingSession::MAX_WINDOW_SIZE / 2 - 1];
+            session.Decide(decided_state);
+            ReportFinalStates(session, decided_state, sub_matchings);
+        }
+
+        return continues_previous && !sub_matchings.empty();
+    }
+
+    // Reports all points of a session that are not final yet.
+    bool Finalize(map_matching::MatchingSession &session, SubMatchingList &sub_matchings) const
+    {
+        const bool continues_previous = session.continues_matching;
+        FinalizeSession(session, sub_matchings);
+        session.Reset();
+        return continues_previous && !sub_matchings.empty();
+    }
 };
 }
 }
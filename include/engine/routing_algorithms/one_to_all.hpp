@@ -0,0 +1,198 @@
+#ifndef ONE_TO_ALL_ROUTING_HPP
+#define ONE_TO_ALL_ROUTING_HPP
+
+#include "engine/routing_algorithms/routing_base.hpp"
+#include "engine/search_engine_data.hpp"
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+// Computes the weights from a set of sources to all nodes of the graph (PHAST). An upward search
+// from each source settles the top of the hierarchy, then a single sweep over all nodes in the
+// sweep order of the dataset pulls the weights down the hierarchy. Every node is scanned once for
+// all sources together, so the sweep reads the graph linearly instead of searching it with a
+// priority queue. Nodes of one level do not depend on each other and are swept in parallel.
+template <class DataFacadeT>
+class OneToAllRouting final
+    : public BasicRoutingInterface<DataFacadeT, OneToAllRouting<DataFacadeT>>
+{
+    using super = BasicRoutingInterface<DataFacadeT, OneToAllRouting<DataFacadeT>>;
+    using QueryHeap = SearchEngineData::QueryHeap;
+    SearchEngineData &engine_working_data;
+
+    // levels with fewer nodes are swept by the calling thread
+    static constexpr unsigned PARALLEL_SWEEP_MIN_LEVEL_SIZE = 4096;
+    static constexpr unsigned SWEEP_GRAIN_SIZE = 1024;
+
+  public:
+    OneToAllRouting(DataFacadeT *facade, SearchEngineData &engine_working_data)
+        : super(facade), engine_working_data(engine_working_data)
+    {
+    }
+
+    ~OneToAllRouting() {}
+
+    // Needs the sweep order of the dataset, which does not exist for graphs with a core.
+    bool IsAvailable() const { return super::facade->GetNumberOfSweepLevels() > 0; }
+
+    // Stores the weight of every node from every source in weights, the weights of a node are
+    // next to each other at node * sources.size() + source. Nodes that can not be reached from
+    // a source within max_weight have INVALID_EDGE_WEIGHT. The searches stop at max_weight, the
+    // sweep still visits every node. The caller owns the weights so that they can be reused,
+    // they take number of nodes times number of sources entries.
+    void operator()(const std::vector<PhantomNode> &sources,
+                    const EdgeWeight max_weight,
+                    std::vector<EdgeWeight> &weights) const
+    {
+        BOOST_ASSERT(IsAvailable());
+        BOOST_ASSERT(max_weight >= 0);
+
+        const auto number_of_sources = sources.size();
+        const auto number_of_nodes = super::facade->GetNumberOfNodes();
+        weights.assign(number_of_nodes * number_of_sources, INVALID_EDGE_WEIGHT);
+
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_sources, 1),
+                          [&](const tbb::blocked_range<std::size_t> &range)
+                          {
+                              engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+                                  number_of_nodes);
+                              QueryHeap &query_heap = *(engine_working_data.forward_heap_1);
+                              for (const auto source : util::irange(range.begin(), range.end()))
+                              {
+                                  UpwardSearch(source, number_of_sources, sources[source],
+                                               max_weight, query_heap, weights);
+                              }
+                          });
+
+        for (const auto level : util::irange(0u, super::facade->GetNumberOfSweepLevels()))
+        {
+            const auto positions = super::facade->GetSweepLevel(level);
+            if (positions.size() < PARALLEL_SWEEP_MIN_LEVEL_SIZE)
+            {
+                for (const auto position : positions)
+                {
+                    SweepNode(super::facade->GetSweepNode(position), number_of_sources,
+                              max_weight, weights);
+                }
+                continue;
+            }
+
+            tbb::parallel_for(tbb::blocked_range<unsigned>(positions.front(),
+                                                           positions.back() + 1,
+                                                           SWEEP_GRAIN_SIZE),
+                              [&](const tbb::blocked_range<unsigned> &range)
+                              {
+                                  for (const auto position : util::irange(range.begin(),
+                                                                          range.end()))
+                                  {
+                                      SweepNode(super::facade->GetSweepNode(position),
+                                                number_of_sources, max_weight, weights);
+                                  }
+                              });
+        }
+    }
+
+  private:
+    // Settles the upward search space of a source. The weights are upper bounds that are exact
+    // for all nodes that are reached on a path that only goes up the hierarchy.
+    void UpwardSearch(const std::size_t source,
+                      const std::size_t number_of_sources,
+                      const PhantomNode &phantom,
+                      const EdgeWeight max_weight,
+                      QueryHeap &query_heap,
+                      std::vector<EdgeWeight> &weights) const
+    {
+        query_heap.Clear();
+        if (SPECIAL_NODEID != phantom.forward_node_id)
+        {
+            query_heap.Insert(phantom.forward_node_id, -phantom.GetForwardWeightPlusOffset(),
+                              phantom.forward_node_id);
+        }
+        if (SPECIAL_NODEID != phantom.reverse_node_id)
+        {
+            query_heap.Insert(phantom.reverse_node_id, -phantom.GetReverseWeightPlusOffset(),
+                              phantom.reverse_node_id);
+        }
+
+        while (!query_heap.Empty())
+        {
+            const NodeID node = query_heap.DeleteMin();
+            const EdgeWeight distance = query_heap.GetKey(node);
+            if (distance > max_weight)
+            {
+                // all weights below are larger
+                break;
+            }
+            weights[node * number_of_sources + source] = distance;
+
+            for (const auto edge : super::facade->GetAdjacentEdgeRange(node))
+            {
+                const auto &data = super::facade->GetEdgeData(edge);
+                if (!data.forward)
+                {
+                    continue;
+                }
+                const NodeID to = super::facade->GetTarget(edge);
+                BOOST_ASSERT_MSG(data.distance > 0, "edge_weight invalid");
+                const EdgeWeight to_distance = distance + data.distance;
+
+                if (!query_heap.WasInserted(to))
+                {
+                    query_heap.Insert(to, to_distance, node);
+                }
+                else if (to_distance < query_heap.GetKey(to))
+                {
+                    query_heap.GetData(to).parent = node;
+                    query_heap.DecreaseKey(to, to_distance);
+                }
+            }
+        }
+    }
+
+    // All edges of a node lead up the hierarchy and the nodes above were swept already. The
+    // edges that can be traversed downwards carry the backward flag.
+    void SweepNode(const NodeID node,
+                   const std::size_t number_of_sources,
+                   const EdgeWeight max_weight,
+                   std::vector<EdgeWeight> &weights) const
+    {
+        const auto node_weights = weights.begin() + node * number_of_sources;
+        for (const auto edge : super::facade->GetAdjacentEdgeRange(node))
+        {
+            const auto &data = super::facade->GetEdgeData(edge);
+            if (!data.backward)
+            {
+                continue;
+            }
+            const auto upper_weights =
+                weights.begin() + super::facade->GetTarget(edge) * number_of_sources;
+            for (const auto source : util::irange<std::size_t>(0, number_of_sources))
+            {
+                if (INVALID_EDGE_WEIGHT != upper_weights[source] &&
+                    upper_weights[source] + data.distance < node_weights[source] &&
+                    upper_weights[source] + data.distance <= max_weight)
+                {
+                    node_weights[source] = upper_weights[source] + data.distance;
+                }
+            }
+        }
+    }
+};
+}
+}
+}
+
+#endif // ONE_TO_ALL_ROUTING_HPP
@@ -5,23 +5,18 @@
 #include "engine/internal_route_result.hpp"
 #include "engine/search_engine_data.hpp"
 #include "extractor/turn_instructions.hpp"
+#include "util/request_arena.hpp"
 
 #include <boost/assert.hpp>
 
-#include <stack>
+#include <iterator>
+#include <utility>
 
 namespace osrm
 {
 namespace engine
 {
 
-SearchEngineData::SearchEngineHeapPtr SearchEngineData::forward_heap_1;
-SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_1;
-SearchEngineData::SearchEngineHeapPtr SearchEngineData::forward_heap_2;
-SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_2;
-SearchEngineData::SearchEngineHeapPtr SearchEngineData::forward_heap_3;
-SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_3;
-
 namespace routing_algorithms
 {
 
@@ -69,7 +64,7 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
     we need to add an offset to the termination criterion.
     */
     void RoutingStep(SearchEngineData::QueryHeap &forward_heap,
-                     SearchEngineData::QueryHeap &reverse_heap,
+                     const SearchEngineData::QueryHeap &reverse_heap,
                      NodeID &middle_node_id,
                      int &upper_bound,
                      int min_edge_offset,
@@ -159,7 +154,7 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
     void UnpackPath(RandomIter packed_path_begin,
                     RandomIter packed_path_end,
                     const PhantomNodes &phantom_node_pair,
-                    std::vector<PathData> &unpacked_path) const
+                    util::ArenaVector<PathData> &unpacked_path) const
     {
         const bool start_traversed_in_reverse =
             (*packed_path_begin != phantom_node_pair.source_phantom.forward_node_id);
@@ -167,110 +162,62 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
             (*std::prev(packed_path_end) != phantom_node_pair.target_phantom.forward_node_id);
 
         BOOST_ASSERT(std::distance(packed_path_begin, packed_path_end) > 0);
-        std::stack<std::pair<NodeID, NodeID>> recursion_stack;
 
-        // We have to push the path in reverse order onto the stack because it's LIFO.
-        for (auto current = std::prev(packed_path_end); current != packed_path_begin;
-             current = std::prev(current))
+        auto &buffers = SearchEngineData::GetThreadLocalUnpackingBuffers();
+        auto &unpacked_edges = buffers.unpacked_edges;
+        unpacked_edges.clear();
+        for (auto current = packed_path_begin; std::next(current) != packed_path_end; ++current)
         {
-            recursion_stack.emplace(*std::prev(current), *current);
+            UnpackToOriginalEdges(*current, *std::next(current), unpacked_edges);
         }
 
-        std::pair<NodeID, NodeID> edge;
-        while (!recursion_stack.empty())
+        for (const auto &unpacked_edge : unpacked_edges)
         {
-            // edge.first         edge.second
-            //     *------------------>*
-            //            edge_id
-            edge = recursion_stack.top();
-            recursion_stack.pop();
-
-            // facade->FindEdge does not suffice here in case of shortcuts.
-            // The above explanation unclear? Think!
-            EdgeID smaller_edge_id = SPECIAL_EDGEID;
-            int edge_weight = std::numeric_limits<EdgeWeight>::max();
-            for (const auto edge_id : facade->GetAdjacentEdgeRange(edge.first))
+            const EdgeData &ed = facade->GetEdgeData(unpacked_edge.edge);
+            BOOST_ASSERT_MSG(!ed.shortcut, "original edge flagged as shortcut");
+            unsigned name_index = facade->GetNameIndexFromEdgeID(ed.id);
+            const extractor::TurnInstruction turn_instruction =
+                facade->GetTurnInstructionForEdgeID(ed.id);
+            const extractor::TravelMode travel_mode = facade->GetTravelModeForEdgeID(ed.id);
+
+            if (!facade->EdgeIsCompressed(ed.id))
             {
-                const int weight = facade->GetEdgeData(edge_id).distance;
-                if ((facade->GetTarget(edge_id) == edge.second) && (weight < edge_weight) &&
-                    facade->GetEdgeData(edge_id).forward)
-                {
-                    smaller_edge_id = edge_id;
-                    edge_weight = weight;
-                }
-            }
-
-            // edge.first         edge.second
-            //     *<------------------*
-            //            edge_id
-            if (SPECIAL_EDGEID == smaller_edge_id)
-            {
-                for (const auto edge_id : facade->GetAdjacentEdgeRange(edge.second))
-                {
-                    const int weight = facade->GetEdgeData(edge_id).distance;
-                    if ((facade->GetTarget(edge_id) == edge.first) && (weight < edge_weight) &&
-                        facade->GetEdgeData(edge_id).backward)
-                    {
-                        smaller_edge_id = edge_id;
-                        edge_weight = weight;
-                    }
-                }
-            }
-            BOOST_ASSERT_MSG(edge_weight != INVALID_EDGE_WEIGHT, "edge id invalid");
-
-            const EdgeData &ed = facade->GetEdgeData(smaller_edge_id);
-            if (ed.shortcut)
-            { // unpack
-                const NodeID middle_node_id = ed.id;
-                // again, we need to this in reversed order
-                recursion_stack.emplace(middle_node_id, edge.second);
-                recursion_stack.emplace(edge.first, middle_node_id);
+                BOOST_ASSERT(!facade->EdgeIsCompressed(ed.id));
+                unpacked_path.emplace_back(facade->GetGeometryIndexForEdgeID(ed.id), name_index,
+                                           turn_instruction, ed.distance, travel_mode);
             }
             else
             {
-                BOOST_ASSERT_MSG(!ed.shortcut, "original edge flagged as shortcut");
-                unsigned name_index = facade->GetNameIndexFromEdgeID(ed.id);
-                const extractor::TurnInstruction turn_instruction =
-                    facade->GetTurnInstructionForEdgeID(ed.id);
-                const extractor::TravelMode travel_mode = facade->GetTravelModeForEdgeID(ed.id);
-
-                if (!facade->EdgeIsCompressed(ed.id))
+                auto &id_vector = buffers.geometry;
+                id_vector.clear();
+                facade->GetUncompressedGeometry(facade->GetGeometryIndexForEdgeID(ed.id),
+                                                id_vector);
+
+                const std::size_t start_index =
+                    (unpacked_path.empty()
+                         ? ((start_traversed_in_reverse)
+                                ? id_vector.size() -
+                                      phantom_node_pair.source_phantom.fwd_segment_position - 1
+                                : phantom_node_pair.source_phantom.fwd_segment_position)
+                         : 0);
+                const std::size_t end_index = id_vector.size();
+
+                BOOST_ASSERT(start_index >= 0);
+                BOOST_ASSERT(start_index <= end_index);
+                for (std::size_t i = start_index; i < end_index; ++i)
                 {
-                    BOOST_ASSERT(!facade->EdgeIsCompressed(ed.id));
-                    unpacked_path.emplace_back(facade->GetGeometryIndexForEdgeID(ed.id), name_index,
-                                               turn_instruction, ed.distance, travel_mode);
-                }
-                else
-                {
-                    std::vector<unsigned> id_vector;
-                    facade->GetUncompressedGeometry(facade->GetGeometryIndexForEdgeID(ed.id),
-                                                    id_vector);
-
-                    const std::size_t start_index =
-                        (unpacked_path.empty()
-                             ? ((start_traversed_in_reverse)
-                                    ? id_vector.size() -
-                                          phantom_node_pair.source_phantom.fwd_segment_position - 1
-                                    : phantom_node_pair.source_phantom.fwd_segment_position)
-                             : 0);
-                    const std::size_t end_index = id_vector.size();
-
-                    BOOST_ASSERT(start_index >= 0);
-                    BOOST_ASSERT(start_index <= end_index);
-                    for (std::size_t i = start_index; i < end_index; ++i)
-                    {
-                        unpacked_path.emplace_back(id_vector[i], name_index,
-                                                   extractor::TurnInstruction::NoTurn, 0,
-                                                   travel_mode);
-                    }
-                    unpacked_path.back().turn_instruction = turn_instruction;
-                    unpacked_path.back().segment_duration = ed.distance;
+                    unpacked_path.emplace_back(id_vector[i], name_index,
+                                               extractor::TurnInstruction::NoTurn, 0,
+                                               travel_mode);
                 }
+                unpacked_path.back().turn_instruction = turn_instruction;
+                unpacked_path.back().segment_duration = ed.distance;
             }
         }
         if (SPECIAL_EDGEID != phantom_node_pair.target_phantom.packed_geometry_id)
         {
-            std::vector<unsigned> id_vector;
+            auto &id_vector = buffers.geometry;
+            id_vector.clear();
             facade->GetUncompressedGeometry(phantom_node_pair.target_phantom.packed_geometry_id,
                                             id_vector);
             const bool is_local_path = (phantom_node_pair.source_phantom.packed_geometry_id ==
@@ -335,65 +282,112 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
 
     void UnpackEdge(const NodeID s, const NodeID t, std::vector<NodeID> &unpacked_path) const
     {
-        std::stack<std::pair<NodeID, NodeID>> recursion_stack;
-        recursion_stack.emplace(s, t);
+        auto &unpacked_edges = SearchEngineData::GetThreadLocalUnpackingBuffers().unpacked_edges;
+        unpacked_edges.clear();
+        UnpackToOriginalEdges(s, t, unpacked_edges);
+
+        for (const auto &unpacked_edge : unpacked_edges)
+        {
+            unpacked_path.emplace_back(unpacked_edge.source);
+        }
+        unpacked_path.emplace_back(t);
+    }
+
+    // Appends the original edges that the (possibly shortcut) edge from -> to expands to.
+    // Long shortcuts are served from and added to the facade's unpacking cache.
+    void UnpackToOriginalEdges(const NodeID from,
+                               const NodeID to,
+                               ShortcutUnpackingCache::UnpackedEdges &unpacked_edges) const
+    {
+        auto &unpacking_cache = facade->GetShortcutUnpackingCache();
+        const auto dataset_checksum = facade->GetCheckSum();
+        if (const auto cached_edges = unpacking_cache.Find(dataset_checksum, from, to))
+        {
+            unpacked_edges.insert(unpacked_edges.end(), cached_edges->begin(),
+                                  cached_edges->end());
+            return;
+        }
+
+        const auto first_unpacked_edge = unpacked_edges.size();
+        auto &recursion_stack = SearchEngineData::GetThreadLocalUnpackingBuffers().recursion_stack;
+        recursion_stack.clear();
+        recursion_stack.emplace_back(from, to);
 
         std::pair<NodeID, NodeID> edge;
         while (!recursion_stack.empty())
         {
-            edge = recursion_stack.top();
-            recursion_stack.pop();
-
-            EdgeID smaller_edge_id = SPECIAL_EDGEID;
-            int edge_weight = std::numeric_limits<EdgeWeight>::max();
-            for (const auto edge_id : facade->GetAdjacentEdgeRange(edge.first))
-            {
-                const int weight = facade->GetEdgeData(edge_id).distance;
-                if ((facade->GetTarget(edge_id) == edge.second) && (weight < edge_weight) &&
-                    facade->GetEdgeData(edge_id).forward)
-                {
-                    smaller_edge_id = edge_id;
-                    edge_weight = weight;
-                }
-            }
+            // edge.first         edge.second
+            //     *------------------>*
+            //            edge_id
+            edge = recursion_stack.back();
+            recursion_stack.pop_back();
 
-            if (SPECIAL_EDGEID == smaller_edge_id)
-            {
-                for (const auto edge_id : facade->GetAdjacentEdgeRange(edge.second))
-                {
-                    const int weight = facade->GetEdgeData(edge_id).distance;
-                    if ((facade->GetTarget(edge_id) == edge.first) && (weight < edge_weight) &&
-                        facade->GetEdgeData(edge_id).backward)
-                    {
-                        smaller_edge_id = edge_id;
-                        edge_weight = weight;
-                    }
-                }
-            }
-            BOOST_ASSERT_MSG(edge_weight != std::numeric_limits<EdgeWeight>::max(),
-                             "edge weight invalid");
+            const EdgeID smaller_edge_id = FindSmallestEdge(edge.first, edge.second);
+            BOOST_ASSERT_MSG(smaller_edge_id != SPECIAL_EDGEID, "edge id invalid");
 
             const EdgeData &ed = facade->GetEdgeData(smaller_edge_id);
             if (ed.shortcut)
             { // unpack
                 const NodeID middle_node_id = ed.id;
                 // again, we need to this in reversed order
-                recursion_stack.emplace(middle_node_id, edge.second);
-                recursion_stack.emplace(edge.first, middle_node_id);
+                recursion_stack.emplace_back(middle_node_id, edge.second);
+                recursion_stack.emplace_back(edge.first, middle_node_id);
             }
             else
             {
-                BOOST_ASSERT_MSG(!ed.shortcut, "edge must be shortcut");
-                unpacked_path.emplace_back(edge.first);
+                unpacked_edges.push_back({edge.first, smaller_edge_id});
             }
         }
-        unpacked_path.emplace_back(t);
+
+        unpacking_cache.Insert(dataset_checksum, from, to,
+                               unpacked_edges.begin() + first_unpacked_edge, unpacked_edges.end());
+    }
+
+    // Finds the edge with the smallest weight that can be used to get from `from` to `to`.
+    // facade->FindEdge does not suffice here in case of shortcuts, as they can be stored at
+    // either node.
+    EdgeID FindSmallestEdge(const NodeID from, const NodeID to) const
+    {
+        // from                 to
+        //     *------------------>*
+        //            edge_id
+        EdgeID smaller_edge_id = SPECIAL_EDGEID;
+        EdgeWeight edge_weight = std::numeric_limits<EdgeWeight>::max();
+        for (const auto edge_id : facade->GetAdjacentEdgeRange(from))
+        {
+            const EdgeWeight weight = facade->GetEdgeData(edge_id).distance;
+            if ((facade->GetTarget(edge_id) == to) && (weight < edge_weight) &&
+                facade->GetEdgeData(edge_id).forward)
+            {
+                smaller_edge_id = edge_id;
+                edge_weight = weight;
+            }
+        }
+
+        // from                 to
+        //     *<------------------*
+        //            edge_id
+        if (SPECIAL_EDGEID == smaller_edge_id)
+        {
+            for (const auto edge_id : facade->GetAdjacentEdgeRange(to))
+            {
+                const EdgeWeight weight = facade->GetEdgeData(edge_id).distance;
+                if ((facade->GetTarget(edge_id) == from) && (weight < edge_weight) &&
+                    facade->GetEdgeData(edge_id).backward)
+                {
+                    smaller_edge_id = edge_id;
+                    edge_weight = weight;
+                }
+            }
+        }
+        return smaller_edge_id;
     }
 
+    template <typename PackedPathT>
     void RetrievePackedPathFromHeap(const SearchEngineData::QueryHeap &forward_heap,
                                     const SearchEngineData::QueryHeap &reverse_heap,
                                     const NodeID middle_node_id,
-                                    std::vector<NodeID> &packed_path) const
+                                    PackedPathT &packed_path) const
     {
         RetrievePackedPathFromSingleHeap(forward_heap, middle_node_id, packed_path);
         std::reverse(packed_path.begin(), packed_path.end());
@@ -401,9 +395,10 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
         RetrievePackedPathFromSingleHeap(reverse_heap, middle_node_id, packed_path);
     }
 
+    template <typename PackedPathT>
     void RetrievePackedPathFromSingleHeap(const SearchEngineData::QueryHeap &search_heap,
                                           const NodeID middle_node_id,
-                                          std::vector<NodeID> &packed_path) const
+                                          PackedPathT &packed_path) const
     {
         NodeID current_node_id = middle_node_id;
         while (current_node_id != search_heap.GetData(current_node_id).parent)
@@ -414,10 +409,11 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
     }
 
     // assumes that heaps are already setup correctly.
+    template <typename PackedPathT>
     void Search(SearchEngineData::QueryHeap &forward_heap,
                 SearchEngineData::QueryHeap &reverse_heap,
                 int &distance,
-                std::vector<NodeID> &packed_leg) const
+                PackedPathT &packed_leg) const
     {
         NodeID middle = SPECIAL_NODEID;
 
@@ -454,12 +450,13 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
     }
 
     // assumes that heaps are already setup correctly.
+    template <typename PackedPathT>
     void SearchWithCore(SearchEngineData::QueryHeap &forward_heap,
                         SearchEngineData::QueryHeap &reverse_heap,
                         SearchEngineData::QueryHeap &forward_core_heap,
                         SearchEngineData::QueryHeap &reverse_core_heap,
                         int &distance,
-                        std::vector<NodeID> &packed_leg) const
+                        PackedPathT &packed_leg) const
     {
         NodeID middle = SPECIAL_NODEID;
 
@@ -576,7 +573,7 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
         // we need to unpack sub path from core heaps
         if (facade->IsCoreNode(middle))
         {
-            std::vector<NodeID> packed_core_leg;
+            util::ArenaVector<NodeID> packed_core_leg;
             RetrievePackedPathFromHeap(forward_core_heap, reverse_core_heap, middle,
                                        packed_core_leg);
             BOOST_ASSERT(packed_core_leg.size() > 0);
@@ -642,30 +639,46 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
             }
         }
 
-        double distance = std::numeric_limits<double>::max();
+        util::ArenaVector<NodeID> packed_leg;
         if (upper_bound != INVALID_EDGE_WEIGHT)
         {
-            std::vector<NodeID> packed_leg;
             RetrievePackedPathFromHeap(forward_heap, reverse_heap, middle_node, packed_leg);
-            std::vector<PathData> unpacked_path;
-            PhantomNodes nodes;
-            nodes.source_phantom = source_phantom;
-            nodes.target_phantom = target_phantom;
-            UnpackPath(packed_leg.begin(), packed_leg.end(), nodes, unpacked_path);
-
-            util::FixedPointCoordinate previous_coordinate = source_phantom.location;
-            util::FixedPointCoordinate current_coordinate;
-            distance = 0;
-            for (const auto &p : unpacked_path)
-            {
-                current_coordinate = facade->GetCoordinateOfNode(p.node);
-                distance += util::coordinate_calculation::haversineDistance(previous_coordinate,
-                                                                            current_coordinate);
-                previous_coordinate = current_coordinate;
-            }
+        }
+        return get_path_distance(packed_leg.begin(), packed_leg.end(), source_phantom,
+                                 target_phantom);
+    }
+
+    // Geographic length of a packed path between two phantom nodes.
+    // An empty path means that the target is not reachable.
+    template <typename RandomIter>
+    double get_path_distance(RandomIter packed_path_begin,
+                             RandomIter packed_path_end,
+                             const PhantomNode &source_phantom,
+                             const PhantomNode &target_phantom) const
+    {
+        if (packed_path_begin == packed_path_end)
+        {
+            return std::numeric_limits<double>::max();
+        }
+
+        util::ArenaVector<PathData> unpacked_path;
+        PhantomNodes nodes;
+        nodes.source_phantom = source_phantom;
+        nodes.target_phantom = target_phantom;
+        UnpackPath(packed_path_begin, packed_path_end, nodes, unpacked_path);
+
+        util::FixedPointCoordinate previous_coordinate = source_phantom.location;
+        util::FixedPointCoordinate current_coordinate;
+        double distance = 0;
+        for (const auto &p : unpacked_path)
+        {
+            current_coordinate = facade->GetCoordinateOfNode(p.node);
             distance += util::coordinate_calculation::haversineDistance(previous_coordinate,
-                                                                        target_phantom.location);
+                                                                        current_coordinate);
+            previous_coordinate = current_coordinate;
         }
+        distance += util::coordinate_calculation::haversineDistance(previous_coordinate,
+                                                                    target_phantom.location);
         return distance;
     }
 };
@@ -7,9 +7,16 @@
 
 #include "engine/search_engine_data.hpp"
 #include "util/integer_range.hpp"
+#include "util/request_arena.hpp"
 
 #include <boost/assert.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <atomic>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -46,7 +53,7 @@ class ShortestPathRouting final
                          const int total_distance_to_forward,
                          const int total_distance_to_reverse,
                          int &new_total_distance,
-                         std::vector<NodeID> &leg_packed_path) const
+                         util::ArenaVector<NodeID> &leg_packed_path) const
     {
         forward_heap.Clear();
         reverse_heap.Clear();
@@ -102,8 +109,8 @@ class ShortestPathRouting final
                     const int total_distance_to_reverse,
                     int &new_total_distance_to_forward,
                     int &new_total_distance_to_reverse,
-                    std::vector<NodeID> &leg_packed_path_forward,
-                    std::vector<NodeID> &leg_packed_path_reverse) const
+                    util::ArenaVector<NodeID> &leg_packed_path_forward,
+                    util::ArenaVector<NodeID> &leg_packed_path_reverse) const
     {
         BOOST_ASSERT(source_phantom.forward_node_id == target_phantom.forward_node_id);
         BOOST_ASSERT(source_phantom.reverse_node_id == target_phantom.reverse_node_id);
@@ -200,8 +207,8 @@ class ShortestPathRouting final
                 const int total_distance_to_reverse,
                 int &new_total_distance_to_forward,
                 int &new_total_distance_to_reverse,
-                std::vector<NodeID> &leg_packed_path_forward,
-                std::vector<NodeID> &leg_packed_path_reverse) const
+                util::ArenaVector<NodeID> &leg_packed_path_forward,
+                util::ArenaVector<NodeID> &leg_packed_path_reverse) const
     {
         if (search_to_forward_node)
         {
@@ -260,23 +267,50 @@ class ShortestPathRouting final
     }
 
     void UnpackLegs(const std::vector<PhantomNodes> &phantom_nodes_vector,
-                    const std::vector<NodeID> &total_packed_path,
-                    const std::vector<std::size_t> &packed_leg_begin,
+                    const util::ArenaVector<NodeID> &total_packed_path,
+                    const util::ArenaVector<std::size_t> &packed_leg_begin,
                     const int shortest_path_length,
                     InternalRouteResult &raw_route_data) const
     {
-        raw_route_data.unpacked_path_segments.resize(packed_leg_begin.size() - 1);
+        const auto number_of_legs = packed_leg_begin.size() - 1;
 
         raw_route_data.shortest_path_length = shortest_path_length;
 
-        for (const auto current_leg : util::irange<std::size_t>(0, packed_leg_begin.size() - 1))
+        const auto unpack_leg = [&](const std::size_t current_leg,
+                                    util::ArenaVector<PathData> &unpacked_path)
         {
             auto leg_begin = total_packed_path.begin() + packed_leg_begin[current_leg];
             auto leg_end = total_packed_path.begin() + packed_leg_begin[current_leg + 1];
-            const auto &unpack_phantom_node_pair = phantom_nodes_vector[current_leg];
-            super::UnpackPath(leg_begin, leg_end, unpack_phantom_node_pair,
-                              raw_route_data.unpacked_path_segments[current_leg]);
+            super::UnpackPath(leg_begin, leg_end, phantom_nodes_vector[current_leg],
+                              unpacked_path);
+        };
+
+        if (number_of_legs == 1)
+        {
+            raw_route_data.unpacked_path_segments.resize(1);
+            unpack_leg(0, raw_route_data.unpacked_path_segments.front());
+        }
+        else
+        {
+            // the request arena is not thread-safe, legs that are unpacked in parallel use the
+            // global allocator
+            const util::ArenaVector<PathData> empty_leg(util::ArenaAllocator<PathData>(nullptr));
+            std::vector<util::ArenaVector<PathData>> unpacked_legs(number_of_legs, empty_leg);
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_legs, 1),
+                              [&](const tbb::blocked_range<std::size_t> &range)
+                              {
+                                  for (const auto leg : util::irange(range.begin(), range.end()))
+                                  {
+                                      unpack_leg(leg, unpacked_legs[leg]);
+                                  }
+                              });
+            raw_route_data.unpacked_path_segments = std::move(unpacked_legs);
+        }
 
+        for (const auto current_leg : util::irange<std::size_t>(0, number_of_legs))
+        {
+            auto leg_begin = total_packed_path.begin() + packed_leg_begin[current_leg];
+            auto leg_end = total_packed_path.begin() + packed_leg_begin[current_leg + 1];
             raw_route_data.source_traversed_in_reverse.push_back(
                 (*leg_begin != phantom_nodes_vector[current_leg].source_phantom.forward_node_id));
             raw_route_data.target_traversed_in_reverse.push_back(
@@ -285,42 +319,80 @@ class ShortestPathRouting final
         }
     }
 
-    void operator()(const std::vector<PhantomNodes> &phantom_nodes_vector,
-                    const std::vector<bool> &uturn_indicators,
-                    InternalRouteResult &raw_route_data) const
+    // Shortest paths through a chain of legs that depend on each other, one ending at the
+    // forward and one ending at the reverse node of the last target.
+    struct PackedLegs
     {
-        BOOST_ASSERT(uturn_indicators.size() == phantom_nodes_vector.size() + 1);
-        engine_working_data.InitializeOrClearFirstThreadLocalStorage(
-            super::facade->GetNumberOfNodes());
+        explicit PackedLegs(util::RequestArena *arena = util::RequestArena::Current())
+            : total_distance_to_forward(INVALID_EDGE_WEIGHT),
+              total_distance_to_reverse(INVALID_EDGE_WEIGHT),
+              total_packed_path_to_forward(util::ArenaAllocator<NodeID>(arena)),
+              packed_leg_to_forward_begin(util::ArenaAllocator<std::size_t>(arena)),
+              total_packed_path_to_reverse(util::ArenaAllocator<NodeID>(arena)),
+              packed_leg_to_reverse_begin(util::ArenaAllocator<std::size_t>(arena))
+        {
+        }
 
-        QueryHeap &forward_heap = *(engine_working_data.forward_heap_1);
-        QueryHeap &reverse_heap = *(engine_working_data.reverse_heap_1);
+        int total_distance_to_forward;
+        int total_distance_to_reverse;
+        util::ArenaVector<NodeID> total_packed_path_to_forward;
+        util::ArenaVector<std::size_t> packed_leg_to_forward_begin;
+        util::ArenaVector<NodeID> total_packed_path_to_reverse;
+        util::ArenaVector<std::size_t> packed_leg_to_reverse_begin;
+    };
+
+    // A leg that allows a u-turn at its target reaches both nodes of the target with the same
+    // path, so the search of the next leg does not depend on it. This does not hold if the
+    // leg needs to loop because source and target are on the same segment.
+    static bool EndsWithUTurn(const PhantomNodes &phantom_node_pair, const bool allow_u_turn_at_via)
+    {
+        const auto &source_phantom = phantom_node_pair.source_phantom;
+        const auto &target_phantom = phantom_node_pair.target_phantom;
+        const bool reaches_forward_node =
+            target_phantom.forward_node_id != SPECIAL_NODEID &&
+            target_phantom.forward_node_id != source_phantom.forward_node_id;
+        const bool reaches_reverse_node =
+            target_phantom.reverse_node_id != SPECIAL_NODEID &&
+            target_phantom.reverse_node_id != source_phantom.reverse_node_id;
+        return allow_u_turn_at_via && (reaches_forward_node || reaches_reverse_node);
+    }
 
+    // Searches the legs [first_leg, last_leg) one after another. Returns false if no path
+    // was found.
+    bool SearchLegs(QueryHeap &forward_heap,
+                    QueryHeap &reverse_heap,
+                    const std::vector<PhantomNodes> &phantom_nodes_vector,
+                    const std::vector<bool> &uturn_indicators,
+                    const std::size_t first_leg,
+                    const std::size_t last_leg,
+                    PackedLegs &legs) const
+    {
         int total_distance_to_forward = 0;
         int total_distance_to_reverse = 0;
         bool search_from_forward_node =
-            phantom_nodes_vector.front().source_phantom.forward_node_id != SPECIAL_NODEID;
+            phantom_nodes_vector[first_leg].source_phantom.forward_node_id != SPECIAL_NODEID;
         bool search_from_reverse_node =
-            phantom_nodes_vector.front().source_phantom.reverse_node_id != SPECIAL_NODEID;
+            phantom_nodes_vector[first_leg].source_phantom.reverse_node_id != SPECIAL_NODEID;
 
-        std::vector<NodeID> prev_packed_leg_to_forward;
-        std::vector<NodeID> prev_packed_leg_to_reverse;
+        util::ArenaVector<NodeID> prev_packed_leg_to_forward;
+        util::ArenaVector<NodeID> prev_packed_leg_to_reverse;
 
-        std::vector<NodeID> total_packed_path_to_forward;
-        std::vector<std::size_t> packed_leg_to_forward_begin;
-        std::vector<NodeID> total_packed_path_to_reverse;
-        std::vector<std::size_t> packed_leg_to_reverse_begin;
+        auto &total_packed_path_to_forward = legs.total_packed_path_to_forward;
+        auto &packed_leg_to_forward_begin = legs.packed_leg_to_forward_begin;
+        auto &total_packed_path_to_reverse = legs.total_packed_path_to_reverse;
+        auto &packed_leg_to_reverse_begin = legs.packed_leg_to_reverse_begin;
 
-        std::size_t current_leg = 0;
         // this implements a dynamic program that finds the shortest route through
         // a list of vias
-        for (const auto &phantom_node_pair : phantom_nodes_vector)
+        for (const auto current_leg : util::irange(first_leg, last_leg))
         {
+            const auto &phantom_node_pair = phantom_nodes_vector[current_leg];
+
             int new_total_distance_to_forward = INVALID_EDGE_WEIGHT;
             int new_total_distance_to_reverse = INVALID_EDGE_WEIGHT;
 
-            std::vector<NodeID> packed_leg_to_forward;
-            std::vector<NodeID> packed_leg_to_reverse;
+            util::ArenaVector<NodeID> packed_leg_to_forward;
+            util::ArenaVector<NodeID> packed_leg_to_reverse;
 
             const auto &source_phantom = phantom_node_pair.source_phantom;
             const auto &target_phantom = phantom_node_pair.target_phantom;
@@ -402,13 +474,11 @@ class ShortestPathRouting final
             if ((INVALID_EDGE_WEIGHT == new_total_distance_to_forward) &&
                 (INVALID_EDGE_WEIGHT == new_total_distance_to_reverse))
             {
-                raw_route_data.shortest_path_length = INVALID_EDGE_WEIGHT;
-                raw_route_data.alternative_path_length = INVALID_EDGE_WEIGHT;
-                return;
+                return false;
             }
 
             // we need to figure out how the new legs connect to the previous ones
-            if (current_leg > 0)
+            if (current_leg > first_leg)
             {
                 bool forward_to_forward =
                     (new_total_distance_to_forward != INVALID_EDGE_WEIGHT) &&
@@ -493,32 +563,109 @@ class ShortestPathRouting final
 
             total_distance_to_forward = new_total_distance_to_forward;
             total_distance_to_reverse = new_total_distance_to_reverse;
-
-            ++current_leg;
         }
 
         BOOST_ASSERT(total_distance_to_forward != INVALID_EDGE_WEIGHT ||
                      total_distance_to_reverse != INVALID_EDGE_WEIGHT);
 
-        // We make sure the fastest route is always in packed_legs_to_forward
-        if (total_distance_to_forward > total_distance_to_reverse)
+        legs.total_distance_to_forward = total_distance_to_forward;
+        legs.total_distance_to_reverse = total_distance_to_reverse;
+        return true;
+    }
+
+    void operator()(const std::vector<PhantomNodes> &phantom_nodes_vector,
+                    const std::vector<bool> &uturn_indicators,
+                    InternalRouteResult &raw_route_data) const
+    {
+        BOOST_ASSERT(uturn_indicators.size() == phantom_nodes_vector.size() + 1);
+        const auto number_of_nodes = super::facade->GetNumberOfNodes();
+
+        // legs that end with a u-turn split the route into chains of legs that can be
+        // searched independently of each other
+        util::ArenaVector<std::size_t> chain_begin(1, 0);
+        for (const auto current_leg : util::irange<std::size_t>(1, phantom_nodes_vector.size()))
         {
-            // insert sentinel
-            packed_leg_to_reverse_begin.push_back(total_packed_path_to_reverse.size());
-            BOOST_ASSERT(packed_leg_to_reverse_begin.size() == phantom_nodes_vector.size() + 1);
+            if (EndsWithUTurn(phantom_nodes_vector[current_leg - 1],
+                              uturn_indicators[current_leg]))
+            {
+                chain_begin.push_back(current_leg);
+            }
+        }
+        chain_begin.push_back(phantom_nodes_vector.size());
+        const auto number_of_chains = chain_begin.size() - 1;
 
-            UnpackLegs(phantom_nodes_vector, total_packed_path_to_reverse,
-                       packed_leg_to_reverse_begin, total_distance_to_reverse, raw_route_data);
+        const auto search_chain = [&](const std::size_t chain, PackedLegs &legs)
+        {
+            // the heaps are thread-local, every task uses the heaps of the thread executing it
+            engine_working_data.InitializeOrClearFirstThreadLocalStorage(number_of_nodes);
+            return SearchLegs(*engine_working_data.forward_heap_1,
+                              *engine_working_data.reverse_heap_1, phantom_nodes_vector,
+                              uturn_indicators, chain_begin[chain], chain_begin[chain + 1], legs);
+        };
+
+        std::vector<PackedLegs> chains;
+        bool found_path = true;
+        if (number_of_chains == 1)
+        {
+            chains.emplace_back();
+            found_path = search_chain(0, chains.front());
         }
         else
         {
-            // insert sentinel
-            packed_leg_to_forward_begin.push_back(total_packed_path_to_forward.size());
-            BOOST_ASSERT(packed_leg_to_forward_begin.size() == phantom_nodes_vector.size() + 1);
+            // the request arena is not thread-safe, chains that are searched in parallel use
+            // the global allocator
+            chains.assign(number_of_chains, PackedLegs(nullptr));
+            std::atomic<bool> found_all_paths(true);
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_chains, 1),
+                              [&](const tbb::blocked_range<std::size_t> &range)
+                              {
+                                  for (const auto chain : util::irange(range.begin(), range.end()))
+                                  {
+                                      if (found_all_paths && !search_chain(chain, chains[chain]))
+                                      {
+                                          found_all_paths = false;
+                                      }
+                                  }
+                              });
+            found_path = found_all_paths;
+        }
 
-            UnpackLegs(phantom_nodes_vector, total_packed_path_to_forward,
-                       packed_leg_to_forward_begin, total_distance_to_forward, raw_route_data);
+        // No path found for both target nodes of a leg?
+        if (!found_path)
+        {
+            raw_route_data.shortest_path_length = INVALID_EDGE_WEIGHT;
+            return;
         }
+
+        int shortest_path_length = 0;
+        util::ArenaVector<NodeID> total_packed_path;
+        util::ArenaVector<std::size_t> packed_leg_begin;
+        for (const auto &legs : chains)
+        {
+            // We make sure the fastest route is always in packed_legs_to_forward
+            const bool use_reverse =
+                legs.total_distance_to_forward > legs.total_distance_to_reverse;
+            const auto &packed_path =
+                use_reverse ? legs.total_packed_path_to_reverse : legs.total_packed_path_to_forward;
+            const auto &leg_begin =
+                use_reverse ? legs.packed_leg_to_reverse_begin : legs.packed_leg_to_forward_begin;
+
+            for (const auto begin : leg_begin)
+            {
+                packed_leg_begin.push_back(total_packed_path.size() + begin);
+            }
+            total_packed_path.insert(total_packed_path.end(), packed_path.begin(),
+                                     packed_path.end());
+            shortest_path_length +=
+                use_reverse ? legs.total_distance_to_reverse : legs.total_distance_to_forward;
+        }
+
+        // insert sentinel
+        packed_leg_begin.push_back(total_packed_path.size());
+        BOOST_ASSERT(packed_leg_begin.size() == phantom_nodes_vector.size() + 1);
+
+        UnpackLegs(phantom_nodes_vector, total_packed_path, packed_leg_begin, shortest_path_length,
+                   raw_route_data);
     }
 };
 }
@@ -4,7 +4,9 @@
 #include "engine/search_engine_data.hpp"
 #include "engine/routing_algorithms/alternative_path.hpp"
 #include "engine/routing_algorithms/many_to_many.hpp"
+#include "engine/routing_algorithms/many_to_many_sweep.hpp"
 #include "engine/routing_algorithms/map_matching.hpp"
+#include "engine/routing_algorithms/one_to_all.hpp"
 #include "engine/routing_algorithms/shortest_path.hpp"
 #include "engine/routing_algorithms/direct_shortest_path.hpp"
 
@@ -26,13 +28,18 @@ template <class DataFacadeT> class SearchEngine
     routing_algorithms::DirectShortestPathRouting<DataFacadeT> direct_shortest_path;
     routing_algorithms::AlternativeRouting<DataFacadeT> alternative_path;
     routing_algorithms::ManyToManyRouting<DataFacadeT> distance_table;
+    routing_algorithms::ManyToManySweepRouting<DataFacadeT> distance_table_sweep;
     routing_algorithms::MapMatching<DataFacadeT> map_matching;
+    routing_algorithms::OneToAllRouting<DataFacadeT> one_to_all;
 
     explicit SearchEngine(DataFacadeT *facade)
         : facade(facade), shortest_path(facade, engine_working_data),
           direct_shortest_path(facade, engine_working_data),
           alternative_path(facade, engine_working_data),
-          distance_table(facade, engine_working_data), map_matching(facade, engine_working_data)
+          distance_table(facade, engine_working_data),
+          distance_table_sweep(facade, engine_working_data),
+          map_matching(facade, engine_working_data),
+          one_to_all(facade, engine_working_data)
     {
         static_assert(!std::is_pointer<DataFacadeT>::value, "don't instantiate with ptr type");
         static_assert(std::is_object<DataFacadeT>::value,
@@ -3,9 +3,17 @@
 
 #include <boost/thread/tss.hpp>
 
+#include "engine/map_matching/hidden_markov_model.hpp"
+#include "engine/shortcut_unpacking_cache.hpp"
 #include "util/typedefs.hpp"
 #include "util/binary_heap.hpp"
 
+#include <cstddef>
+
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -30,11 +38,65 @@ struct SearchEngineData
     static SearchEngineHeapPtr forward_heap_3;
     static SearchEngineHeapPtr reverse_heap_3;
 
+    // Scratch space for path unpacking, reused across queries to avoid allocations.
+    struct UnpackingBuffers
+    {
+        std::vector<std::pair<NodeID, NodeID>> recursion_stack;
+        ShortcutUnpackingCache::UnpackedEdges unpacked_edges;
+        std::vector<unsigned> geometry;
+
+        std::size_t GetMemoryUsage() const
+        {
+            return recursion_stack.capacity() * sizeof(std::pair<NodeID, NodeID>) +
+                   unpacked_edges.capacity() * sizeof(ShortcutUnpackingCache::UnpackedEdge) +
+                   geometry.capacity() * sizeof(unsigned);
+        }
+    };
+    using UnpackingBuffersPtr = boost::thread_specific_ptr<UnpackingBuffers>;
+
+    static UnpackingBuffersPtr unpacking_buffers;
+
+    static UnpackingBuffers &GetThreadLocalUnpackingBuffers();
+
+    // Viterbi states of the map matching, reused across requests to avoid allocations.
+    using HMMStoragePtr = boost::thread_specific_ptr<map_matching::StateStorage>;
+
+    static HMMStoragePtr hmm_storage;
+
+    static map_matching::StateStorage &GetThreadLocalHMMStorage();
+
+    // Weights of the one-to-all search for every node and source, reused across requests.
+    // Holds number of nodes times the number of sources of the last request of a thread, as
+    // long as that is not more than MAX_RETAINED_ONE_TO_ALL_BYTES.
+    using OneToAllWeightsPtr = boost::thread_specific_ptr<std::vector<EdgeWeight>>;
+
+    static OneToAllWeightsPtr one_to_all_weights;
+
+    static constexpr std::size_t MAX_RETAINED_ONE_TO_ALL_BYTES = 64 * 1024 * 1024;
+
+    static std::vector<EdgeWeight> &GetThreadLocalOneToAllWeights();
+
+    // Has to be called after each request. Frees the weights if they are too large to be kept,
+    // otherwise a single large request holds on to its memory on every thread.
+    static void ReleaseThreadLocalOneToAllWeights();
+
     void InitializeOrClearFirstThreadLocalStorage(const unsigned number_of_nodes);
 
     void InitializeOrClearSecondThreadLocalStorage(const unsigned number_of_nodes);
 
     void InitializeOrClearThirdThreadLocalStorage(const unsigned number_of_nodes);
+
+    // Memory the thread local storage of all threads holds on to between queries. A thread
+    // reports the memory of a slot whenever it reuses it, the report is taken back when the
+    // thread exits.
+    struct SlotStatistics
+    {
+        std::string name;
+        std::size_t threads;
+        std::size_t bytes;
+    };
+
+    static std::vector<SlotStatistics> GetSlotStatistics();
 };
 }
 }
@@ -0,0 +1,144 @@
+#ifndef SHORTCUT_UNPACKING_CACHE_HPP
+#define SHORTCUT_UNPACKING_CACHE_HPP
+
+#include "util/typedefs.hpp"
+
+#include <boost/thread/locks.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Holds the original edges that shortcuts expand to, so that long shortcuts from the top of
+// the hierarchy do not have to be unpacked recursively on every query.
+//
+// The cache is filled lazily while unpacking and never evicts: once the memory budget is used
+// up no further shortcuts are added. Like the SnappingCache it is bound to the checksum of the
+// dataset and drops all entries as soon as a different dataset is queried. Find() hands out
+// shared ownership, so entries stay valid for queries that still run on the previous dataset.
+class ShortcutUnpackingCache
+{
+  public:
+    // An original edge of the query graph together with the node it is traversed from.
+    struct UnpackedEdge
+    {
+        NodeID source;
+        EdgeID edge;
+    };
+    using UnpackedEdges = std::vector<UnpackedEdge>;
+
+    // Shortcuts on the lower levels of the hierarchy expand to few edges and are cheap to
+    // unpack. Only caching long shortcuts keeps the cache focused on the top levels.
+    static constexpr std::size_t MIN_UNPACKED_EDGES = 16;
+
+    ShortcutUnpackingCache() : memory_budget(0), used_memory(0), checksum(0) {}
+
+    void SetMemoryBudget(const std::size_t budget_in_bytes) { memory_budget = budget_in_bytes; }
+
+    bool IsEnabled() const { return memory_budget > 0; }
+
+    std::size_t GetUsedMemory() const { return used_memory; }
+
+    std::shared_ptr<const UnpackedEdges>
+    Find(const unsigned dataset_checksum, const NodeID from, const NodeID to) const
+    {
+        if (!IsEnabled() || dataset_checksum != checksum)
+        {
+            return nullptr;
+        }
+
+        boost::shared_lock<boost::shared_mutex> lock(mutex);
+        // checked again, the entries might have been dropped in the meantime
+        if (dataset_checksum != checksum)
+        {
+            return nullptr;
+        }
+        const auto iter = unpacked_shortcuts.find(MakeKey(from, to));
+        if (iter == unpacked_shortcuts.end())
+        {
+            return nullptr;
+        }
+        return iter->second;
+    }
+
+    template <typename ForwardIter>
+    void Insert(const unsigned dataset_checksum,
+                const NodeID from,
+                const NodeID to,
+                ForwardIter begin,
+                ForwardIter end)
+    {
+        const std::size_t number_of_edges = std::distance(begin, end);
+        const std::size_t entry_size = GetEntrySize(number_of_edges);
+        if (!IsEnabled() || number_of_edges < MIN_UNPACKED_EDGES)
+        {
+            return;
+        }
+        if (dataset_checksum == checksum && used_memory + entry_size > memory_budget)
+        {
+            return;
+        }
+
+        boost::unique_lock<boost::shared_mutex> lock(mutex);
+        if (dataset_checksum != checksum)
+        {
+            ClearEntries();
+            checksum = dataset_checksum;
+        }
+        if (used_memory + entry_size > memory_budget)
+        {
+            return;
+        }
+        const auto inserted = unpacked_shortcuts.emplace(
+            MakeKey(from, to), std::make_shared<const UnpackedEdges>(begin, end));
+        if (inserted.second)
+        {
+            used_memory += entry_size;
+        }
+    }
+
+    void Clear()
+    {
+        boost::unique_lock<boost::shared_mutex> lock(mutex);
+        ClearEntries();
+    }
+
+  private:
+    void ClearEntries()
+    {
+        unpacked_shortcuts.clear();
+        used_memory = 0;
+    }
+
+    static std::uint64_t MakeKey(const NodeID from, const NodeID to)
+    {
+        return (static_cast<std::uint64_t>(from) << 32) | to;
+    }
+
+    // approximation of the hash map node and shared_ptr control block overhead plus the payload
+    static std::size_t GetEntrySize(const std::size_t number_of_edges)
+    {
+        return sizeof(std::uint64_t) + sizeof(std::shared_ptr<const UnpackedEdges>) +
+               sizeof(UnpackedEdges) + 4 * sizeof(void *) +
+               number_of_edges * sizeof(UnpackedEdge);
+    }
+
+    std::size_t memory_budget;
+    std::atomic<std::size_t> used_memory;
+    std::atomic<unsigned> checksum;
+    mutable boost::shared_mutex mutex;
+    std::unordered_map<std::uint64_t, std::shared_ptr<const UnpackedEdges>> unpacked_shortcuts;
+};
+}
+}
+
+#endif // SHORTCUT_UNPACKING_CACHE_HPP
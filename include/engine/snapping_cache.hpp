@@ -0,0 +1,143 @@
+#ifndef SNAPPING_CACHE_HPP
+#define SNAPPING_CACHE_HPP
+
+#include "util/lru_cache.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/optional.hpp>
+
+#include "osrm/coordinate.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Remembers which r-tree segments a coordinate was snapped to, so that repeated coordinates
+// (depots, stations, ...) do not need to walk the r-tree again.
+//
+// The key is the fixed-point coordinate, which is already quantized to COORDINATE_PRECISION,
+// together with the bearing filter and the checksum of the dataset. Only the segments are
+// cached, the phantom nodes are still computed from the exact input coordinate. All entries are
+// dropped as soon as a different dataset is queried. A query that still runs on the previous
+// dataset after a reload can only insert its segments under the previous checksum, so they are
+// never returned for the new dataset.
+template <typename EdgeDataT> class SnappingCache
+{
+  public:
+    struct Key
+    {
+        unsigned dataset_checksum;
+        std::int32_t lat;
+        std::int32_t lon;
+        std::int16_t bearing;
+        std::int16_t bearing_range;
+
+        bool operator==(const Key &other) const
+        {
+            return dataset_checksum == other.dataset_checksum && lat == other.lat &&
+                   lon == other.lon && bearing == other.bearing &&
+                   bearing_range == other.bearing_range;
+        }
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key &key) const
+        {
+            std::uint64_t hash = key.dataset_checksum;
+            hash = hash * 0x100000001B3ull ^ static_cast<std::uint32_t>(key.lat);
+            hash = hash * 0x100000001B3ull ^ static_cast<std::uint32_t>(key.lon);
+            hash = hash * 0x100000001B3ull ^ static_cast<std::uint16_t>(key.bearing);
+            hash = hash * 0x100000001B3ull ^ static_cast<std::uint16_t>(key.bearing_range);
+            return static_cast<std::size_t>(hash ^ (hash >> 29));
+        }
+    };
+
+    // nearest segment and nearest segment in a big component
+    using Segments = std::pair<EdgeDataT, EdgeDataT>;
+    using Cache = util::ShardedLRUCache<Key, Segments, KeyHash>;
+    using Statistics = typename Cache::Statistics;
+
+    SnappingCache() : checksum(0) {}
+
+    // Needs to be called before any queries are run.
+    void SetCapacity(const std::size_t max_number_of_coordinates)
+    {
+        cache.reset(max_number_of_coordinates > 0 ? new Cache(max_number_of_coordinates)
+                                                  : nullptr);
+    }
+
+    bool IsEnabled() const { return static_cast<bool>(cache); }
+
+    static Key MakeKey(const unsigned dataset_checksum,
+                       const util::FixedPointCoordinate &coordinate,
+                       const int bearing,
+                       const int bearing_range)
+    {
+        return Key{dataset_checksum, coordinate.lat, coordinate.lon,
+                   static_cast<std::int16_t>(bearing), static_cast<std::int16_t>(bearing_range)};
+    }
+
+    boost::optional<Segments> Find(const Key &key)
+    {
+        BOOST_ASSERT(IsEnabled());
+        CheckDataset(key.dataset_checksum);
+        return cache->Find(key);
+    }
+
+    // Segments of a dataset that is not the most recently queried one are not cached.
+    void Insert(const Key &key, const Segments &segments)
+    {
+        BOOST_ASSERT(IsEnabled());
+        if (key.dataset_checksum == checksum)
+        {
+            cache->Insert(key, segments);
+        }
+    }
+
+    void Clear()
+    {
+        if (cache)
+        {
+            cache->Clear();
+        }
+    }
+
+    Statistics GetStatistics() const
+    {
+        BOOST_ASSERT(IsEnabled());
+        return cache->GetStatistics();
+    }
+
+  private:
+    // Only frees the entries of the previous dataset, the key keeps the datasets apart.
+    void CheckDataset(const unsigned dataset_checksum)
+    {
+        if (dataset_checksum == checksum)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(checksum_mutex);
+        if (dataset_checksum != checksum)
+        {
+            cache->Clear();
+            checksum = dataset_checksum;
+        }
+    }
+
+    std::unique_ptr<Cache> cache;
+    std::atomic<unsigned> checksum;
+    std::mutex checksum_mutex;
+};
+}
+}
+
+#endif // SNAPPING_CACHE_HPP
@@ -1,18 +1,21 @@
 #ifndef TRIP_BRUTE_FORCE_HPP
 #define TRIP_BRUTE_FORCE_HPP
 
-#include "engine/search_engine.hpp"
 #include "util/dist_table_wrapper.hpp"
-#include "util/simple_logger.hpp"
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
 
-#include "osrm/json_container.hpp"
+#include <boost/assert.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <cstdint>
 #include <cstdlib>
 #include <algorithm>
-#include <string>
+#include <bitset>
 #include <iterator>
 #include <vector>
-#include <limits>
 
 namespace osrm
 {
@@ -21,27 +24,14 @@ namespace engine
 namespace trip
 {
 
-// computes the distance of a given permutation
-EdgeWeight ReturnDistance(const util::DistTableWrapper<EdgeWeight> &dist_table,
-                          const std::vector<NodeID> &location_order,
-                          const EdgeWeight min_route_dist,
-                          const std::size_t component_size)
-{
-    EdgeWeight route_dist = 0;
-    std::size_t i = 0;
-    while (i < location_order.size() && (route_dist < min_route_dist))
-    {
-        route_dist += dist_table(location_order[i], location_order[(i + 1) % component_size]);
-        BOOST_ASSERT_MSG(dist_table(location_order[i], location_order[(i + 1) % component_size]) !=
-                             INVALID_EDGE_WEIGHT,
-                         "invalid route found");
-        ++i;
-    }
-
-    return route_dist;
-}
+// Largest component for which the exact trip is computed, the memory and time needed grow with
+// 2^n * n and 2^n * n^2.
+const constexpr std::size_t BF_MAX_LOCATIONS = 20;
 
-// computes the route by computing all permutations and selecting the shortest
+// Computes the shortest round trip exactly with dynamic programming over the subsets of the
+// locations (Held-Karp). All subsets of the same size are independent and are computed in
+// parallel. Of all shortest trips the lexicographically largest order of the locations is
+// returned, which is the one that enumerating all permutations would have picked.
 template <typename NodeIDIterator>
 std::vector<NodeID> BruteForceTrip(const NodeIDIterator start,
                                    const NodeIDIterator end,
@@ -50,30 +40,112 @@ std::vector<NodeID> BruteForceTrip(const NodeIDIterator start,
 {
     (void)number_of_locations; // unused
 
-    const auto component_size = std::distance(start, end);
+    std::vector<NodeID> others(start, end);
+
+    BOOST_ASSERT_MSG(others.size() > 0, "no permutation given");
+    BOOST_ASSERT_MSG(others.size() <= BF_MAX_LOCATIONS, "too many locations");
+    BOOST_ASSERT_MSG(*(std::max_element(std::begin(others), std::end(others))) <
+                         number_of_locations,
+                     "invalid node id");
+
+    // the lexicographically largest trip starts at the largest location
+    const auto first_position = std::max_element(others.begin(), others.end());
+    const auto first = *first_position;
+    others.erase(first_position);
 
-    std::vector<NodeID> perm(start, end);
     std::vector<NodeID> route;
-    route.reserve(component_size);
+    route.reserve(others.size() + 1);
+    route.push_back(first);
+    if (others.empty())
+    {
+        return route;
+    }
+
+    // subsets of the other locations as bit masks, ordered by their size
+    using Subset = std::uint32_t;
+    const std::size_t number_of_others = others.size();
+    const Subset all_others = (Subset{1} << number_of_others) - 1;
+    std::vector<std::vector<Subset>> subsets_by_size(number_of_others + 1);
+    for (const auto subset : util::irange<Subset>(0, all_others + 1))
+    {
+        subsets_by_size[std::bitset<32>(subset).count()].push_back(subset);
+    }
 
-    EdgeWeight min_route_dist = INVALID_EDGE_WEIGHT;
+    // remaining_length[subset * n + i]: length of the shortest path from others[i] through all
+    // locations of the subset back to the first location. others[i] is not in the subset.
+    std::vector<EdgeWeight> remaining_length((std::size_t{all_others} + 1) * number_of_others,
+                                             INVALID_EDGE_WEIGHT);
+    const auto index = [number_of_others](const Subset subset, const std::size_t i)
+    {
+        return subset * number_of_others + i;
+    };
+    // length of the path from location to others[next] and then through the rest of the subset
+    const auto path_length = [&](const NodeID location, const Subset subset, const std::size_t next)
+    {
+        return dist_table(location, others[next]) +
+               remaining_length[index(subset & ~(Subset{1} << next), next)];
+    };
 
-    // check length of all possible permutation of the component ids
+    for (const auto i : util::irange<std::size_t>(0, number_of_others))
+    {
+        remaining_length[index(0, i)] = dist_table(others[i], first);
+    }
+    for (const auto size : util::irange<std::size_t>(1, number_of_others))
+    {
+        const auto &subsets = subsets_by_size[size];
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, subsets.size(), 64),
+            [&](const tbb::blocked_range<std::size_t> &range)
+            {
+                for (const auto subset : util::irange(range.begin(), range.end()))
+                {
+                    const auto members = subsets[subset];
+                    for (const auto i : util::irange<std::size_t>(0, number_of_others))
+                    {
+                        if (members & (Subset{1} << i))
+                        {
+                            continue;
+                        }
+                        auto shortest = INVALID_EDGE_WEIGHT;
+                        for (const auto next : util::irange<std::size_t>(0, number_of_others))
+                        {
+                            if (members & (Subset{1} << next))
+                            {
+                                shortest =
+                                    std::min(shortest, path_length(others[i], members, next));
+                            }
+                        }
+                        remaining_length[index(members, i)] = shortest;
+                    }
+                }
+            });
+    }
 
-    BOOST_ASSERT_MSG(perm.size() > 0, "no permutation given");
-    BOOST_ASSERT_MSG(*(std::max_element(std::begin(perm), std::end(perm))) < number_of_locations,
-                     "invalid node id");
-    BOOST_ASSERT_MSG(*(std::min_element(std::begin(perm), std::end(perm))) >= 0, "invalid node id");
+    auto trip_length = INVALID_EDGE_WEIGHT;
+    for (const auto next : util::irange<std::size_t>(0, number_of_others))
+    {
+        trip_length = std::min(trip_length, path_length(first, all_others, next));
+    }
 
-    do
+    // walk along the shortest trip, always taking the largest location that continues it
+    auto remaining = all_others;
+    while (remaining != 0)
     {
-        const auto new_distance = ReturnDistance(dist_table, perm, min_route_dist, component_size);
-        if (new_distance <= min_route_dist)
+        std::size_t best_next = number_of_others;
+        for (const auto next : util::irange<std::size_t>(0, number_of_others))
         {
-            min_route_dist = new_distance;
-            route = perm;
+            if ((remaining & (Subset{1} << next)) &&
+                path_length(route.back(), remaining, next) == trip_length &&
+                (best_next == number_of_others || others[next] > others[best_next]))
+            {
+                best_next = next;
+            }
         }
-    } while (std::next_permutation(std::begin(perm), std::end(perm)));
+        BOOST_ASSERT(best_next < number_of_others);
+        trip_length -= dist_table(route.back(), others[best_next]);
+        remaining &= ~(Subset{1} << best_next);
+        route.push_back(others[best_next]);
+    }
 
     return route;
 }
@@ -0,0 +1,359 @@
+#ifndef TRIP_LOCAL_SEARCH_HPP
+#define TRIP_LOCAL_SEARCH_HPP
+
+#include "engine/trip/trip_nearest_neighbour.hpp"
+#include "util/dist_table_wrapper.hpp"
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace trip
+{
+
+// Candidates for new edges of a location: the locations closest to it in either direction.
+inline std::vector<std::vector<NodeID>>
+ComputeNeighbourLists(const std::vector<NodeID> &locations,
+                      const std::size_t number_of_locations,
+                      const util::DistTableWrapper<EdgeWeight> &dist_table,
+                      const std::size_t number_of_neighbours)
+{
+    std::vector<std::vector<NodeID>> neighbours(number_of_locations);
+    for (const auto location : locations)
+    {
+        auto &candidates = neighbours[location];
+        for (const auto other : locations)
+        {
+            if (other != location)
+            {
+                candidates.push_back(other);
+            }
+        }
+        const auto closer = [&](const NodeID lhs, const NodeID rhs)
+        {
+            return dist_table(location, lhs) + dist_table(lhs, location) <
+                   dist_table(location, rhs) + dist_table(rhs, location);
+        };
+        if (candidates.size() > number_of_neighbours)
+        {
+            std::partial_sort(candidates.begin(), candidates.begin() + number_of_neighbours,
+                              candidates.end(), closer);
+            candidates.resize(number_of_neighbours);
+        }
+        else
+        {
+            std::sort(candidates.begin(), candidates.end(), closer);
+        }
+    }
+    return neighbours;
+}
+
+// Improves a round trip with 2-opt and Or-opt moves until it is locally optimal. Only moves that
+// create an edge to one of the neighbours of a location are tried. The distances need not be
+// symmetric, the length of a reversed path is taken from prefix sums over the tour. The first
+// location of the tour never moves.
+class LocalSearchTour
+{
+  public:
+    LocalSearchTour(std::vector<NodeID> tour_,
+                    const std::size_t number_of_locations,
+                    const util::DistTableWrapper<EdgeWeight> &dist_table,
+                    const std::vector<std::vector<NodeID>> &neighbours)
+        : tour(std::move(tour_)), position(number_of_locations), dist_table(dist_table),
+          neighbours(neighbours)
+    {
+        Update();
+    }
+
+    const std::vector<NodeID> &GetTour() const { return tour; }
+
+    EdgeWeight GetLength() const
+    {
+        return forward_prefix.back() + dist_table(tour.back(), tour.front());
+    }
+
+    void Optimize()
+    {
+        while (TwoOpt() || OrOpt())
+        {
+        }
+    }
+
+    // Reorders the tour A B C D into A C B D, which is not undone by a single 2-opt or Or-opt
+    // move. Used to leave a local optimum, returns false if the tour is too short.
+    template <typename RandomEngine> bool DoubleBridge(RandomEngine &random_engine)
+    {
+        const auto size = tour.size();
+        if (size < 8)
+        {
+            return false;
+        }
+        std::uniform_int_distribution<std::size_t> cut(1, size - 1);
+        std::size_t cuts[3];
+        do
+        {
+            for (auto &c : cuts)
+            {
+                c = cut(random_engine);
+            }
+            std::sort(std::begin(cuts), std::end(cuts));
+        } while (cuts[0] == cuts[1] || cuts[1] == cuts[2]);
+        std::rotate(tour.begin() + cuts[0], tour.begin() + cuts[1], tour.begin() + cuts[2]);
+        Update();
+        return true;
+    }
+
+  private:
+    std::size_t Next(const std::size_t index) const
+    {
+        return index + 1 == tour.size() ? 0 : index + 1;
+    }
+
+    // Change of the length if the path tour[first..last] is reversed.
+    EdgeWeight TwoOptGain(const std::size_t first, const std::size_t last) const
+    {
+        const auto before = tour[first - 1];
+        const auto after = tour[Next(last)];
+        const auto old_length = dist_table(before, tour[first]) + dist_table(tour[last], after) +
+                                forward_prefix[last] - forward_prefix[first];
+        const auto new_length = dist_table(before, tour[last]) + dist_table(tour[first], after) +
+                                backward_prefix[last] - backward_prefix[first];
+        return new_length - old_length;
+    }
+
+    bool TryTwoOpt(const std::size_t first, const std::size_t last)
+    {
+        if (first < 1 || last >= tour.size() || first >= last || TwoOptGain(first, last) >= 0)
+        {
+            return false;
+        }
+        std::reverse(tour.begin() + first, tour.begin() + last + 1);
+        Update();
+        return true;
+    }
+
+    bool TwoOpt()
+    {
+        for (const auto index : util::irange<std::size_t>(0, tour.size()))
+        {
+            const auto location = tour[index];
+            for (const auto neighbour : neighbours[location])
+            {
+                const auto neighbour_index = position[neighbour];
+                // location -> neighbour becomes the edge in front of the reversed path
+                if (TryTwoOpt(index + 1, neighbour_index))
+                {
+                    return true;
+                }
+                // location -> neighbour becomes the edge behind the reversed path
+                const auto after_index = neighbour_index == 0 ? tour.size() : neighbour_index;
+                if (index > 0 && TryTwoOpt(index, after_index - 1))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Change of the length if tour[first..last] is moved between tour[target] and its successor.
+    EdgeWeight OrOptGain(const std::size_t first,
+                         const std::size_t last,
+                         const std::size_t target) const
+    {
+        const auto before = tour[first - 1];
+        const auto after = tour[Next(last)];
+        const auto target_after = tour[Next(target)];
+        return dist_table(before, after) - dist_table(before, tour[first]) -
+               dist_table(tour[last], after) + dist_table(tour[target], tour[first]) +
+               dist_table(tour[last], target_after) - dist_table(tour[target], target_after);
+    }
+
+    bool TryOrOpt(const std::size_t first, const std::size_t last, const std::size_t target)
+    {
+        if (target + 1 >= first && target <= last)
+        {
+            return false;
+        }
+        if (OrOptGain(first, last, target) >= 0)
+        {
+            return false;
+        }
+        if (target > last)
+        {
+            std::rotate(tour.begin() + first, tour.begin() + last + 1, tour.begin() + target + 1);
+        }
+        else
+        {
+            std::rotate(tour.begin() + target + 1, tour.begin() + first, tour.begin() + last + 1);
+        }
+        Update();
+        return true;
+    }
+
+    bool OrOpt()
+    {
+        static const constexpr std::size_t MAX_SEGMENT_LENGTH = 3;
+        for (const auto length : util::irange<std::size_t>(1, MAX_SEGMENT_LENGTH + 1))
+        {
+            for (std::size_t first = 1; first + length <= tour.size(); ++first)
+            {
+                const auto last = first + length - 1;
+                // insert behind a neighbour of the first location
+                for (const auto neighbour : neighbours[tour[first]])
+                {
+                    if (TryOrOpt(first, last, position[neighbour]))
+                    {
+                        return true;
+                    }
+                }
+                // insert in front of a neighbour of the last location
+                for (const auto neighbour : neighbours[tour[last]])
+                {
+                    const auto neighbour_index = position[neighbour];
+                    const auto target =
+                        neighbour_index == 0 ? tour.size() - 1 : neighbour_index - 1;
+                    if (TryOrOpt(first, last, target))
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    void Update()
+    {
+        forward_prefix.resize(tour.size());
+        backward_prefix.resize(tour.size());
+        forward_prefix[0] = 0;
+        backward_prefix[0] = 0;
+        for (const auto index : util::irange<std::size_t>(1, tour.size()))
+        {
+            forward_prefix[index] =
+                forward_prefix[index - 1] + dist_table(tour[index - 1], tour[index]);
+            backward_prefix[index] =
+                backward_prefix[index - 1] + dist_table(tour[index], tour[index - 1]);
+        }
+        for (const auto index : util::irange<std::size_t>(0, tour.size()))
+        {
+            position[tour[index]] = index;
+        }
+    }
+
+    std::vector<NodeID> tour;
+    // index of every location in the tour
+    std::vector<std::size_t> position;
+    // length of the path from the first location to tour[i], forwards and backwards
+    std::vector<EdgeWeight> forward_prefix;
+    std::vector<EdgeWeight> backward_prefix;
+    const util::DistTableWrapper<EdgeWeight> &dist_table;
+    const std::vector<std::vector<NodeID>> &neighbours;
+};
+
+// Improves the given round trip with an iterated local search. Several runs start from the given
+// trip and from a nearest neighbour trip in parallel, each perturbs its best tour and optimizes
+// it again for a number of iterations that grows with the trip, and stops early if a number of
+// perturbations in a row did not improve it. Every run has its own seed and the work is bounded
+// by counts only, so the same input always gives the same trip. Returns the shortest trip found,
+// starting at the same location as the given one.
+template <typename NodeIDIterator>
+std::vector<NodeID> LocalSearchTrip(const NodeIDIterator &start,
+                                    const NodeIDIterator &end,
+                                    const std::size_t number_of_locations,
+                                    const util::DistTableWrapper<EdgeWeight> &dist_table,
+                                    const std::vector<NodeID> &initial_trip)
+{
+    static const constexpr std::size_t NUMBER_OF_NEIGHBOURS = 10;
+    static const constexpr std::size_t NUMBER_OF_RUNS = 8;
+    static const constexpr std::size_t PERTURBATIONS_PER_LOCATION = 10;
+    static const constexpr std::size_t MAX_PERTURBATIONS_WITHOUT_IMPROVEMENT = 100;
+
+    const auto component_size = static_cast<std::size_t>(std::distance(start, end));
+    BOOST_ASSERT(initial_trip.size() == component_size);
+    if (component_size < 4)
+    {
+        return initial_trip;
+    }
+
+    const std::vector<NodeID> locations(start, end);
+    const auto neighbours =
+        ComputeNeighbourLists(locations, number_of_locations, dist_table, NUMBER_OF_NEIGHBOURS);
+
+    // every start has to begin at the same location, the first one of a tour never moves
+    auto nearest_neighbour_trip = NearestNeighbourTrip(start, end, number_of_locations, dist_table);
+    std::rotate(nearest_neighbour_trip.begin(),
+                std::find(nearest_neighbour_trip.begin(), nearest_neighbour_trip.end(),
+                          initial_trip.front()),
+                nearest_neighbour_trip.end());
+
+    std::vector<std::pair<EdgeWeight, std::vector<NodeID>>> results(NUMBER_OF_RUNS);
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, NUMBER_OF_RUNS, 1),
+        [&](const tbb::blocked_range<std::size_t> &range)
+        {
+            for (const auto run : util::irange(range.begin(), range.end()))
+            {
+                std::mt19937 random_engine(run);
+                LocalSearchTour tour(run % 2 == 0 ? initial_trip : nearest_neighbour_trip,
+                                     number_of_locations, dist_table, neighbours);
+                tour.Optimize();
+                auto &best = results[run];
+                best = std::make_pair(tour.GetLength(), tour.GetTour());
+
+                const auto perturbations = PERTURBATIONS_PER_LOCATION * component_size;
+                std::size_t without_improvement = 0;
+                for (std::size_t iteration = 0;
+                     iteration < perturbations &&
+                     without_improvement < MAX_PERTURBATIONS_WITHOUT_IMPROVEMENT;
+                     ++iteration)
+                {
+                    LocalSearchTour candidate(best.second, number_of_locations, dist_table,
+                                              neighbours);
+                    if (!candidate.DoubleBridge(random_engine))
+                    {
+                        break;
+                    }
+                    candidate.Optimize();
+                    if (candidate.GetLength() < best.first)
+                    {
+                        best = std::make_pair(candidate.GetLength(), candidate.GetTour());
+                        without_improvement = 0;
+                    }
+                    else
+                    {
+                        ++without_improvement;
+                    }
+                }
+            }
+        });
+
+    // the first of equally short trips wins to keep the result independent of the scheduling
+    const auto shortest = std::min_element(
+        results.begin(), results.end(),
+        [](const std::pair<EdgeWeight, std::vector<NodeID>> &lhs,
+           const std::pair<EdgeWeight, std::vector<NodeID>> &rhs)
+        {
+            return lhs.first < rhs.first;
+        });
+    return shortest->second;
+}
+}
+}
+}
+
+#endif // TRIP_LOCAL_SEARCH_HPP
@@ -39,7 +39,7 @@ std::vector<NodeID> NearestNeighbourTrip(const NodeIDIterator &start,
     std::vector<NodeID> route;
     route.reserve(number_of_locations);
 
-    const auto component_size = std::distance(start, end);
+    const auto component_size = static_cast<std::size_t>(std::distance(start, end));
     auto shortest_trip_distance = INVALID_EDGE_WEIGHT;
 
     // ALWAYS START AT ANOTHER STARTING POINT
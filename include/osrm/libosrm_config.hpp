@@ -39,11 +39,41 @@ namespace osrm
 struct LibOSRMConfig
 {
     std::unordered_map<std::string, boost::filesystem::path> server_paths;
+    // further datasets by name and base path (.osrm or .dataset), selected by a request that
+    // starts with /<name>/, only when the data is loaded from files
+    std::unordered_map<std::string, boost::filesystem::path> named_datasets;
     int max_locations_trip = -1;
     int max_locations_viaroute = -1;
     int max_locations_distance_table = -1;
     int max_locations_map_matching = -1;
+    int max_locations_isochrone = -1;
+    int max_pairs_batch_route = -1;
+    // number of targets from which on a distance table is computed with a sweep instead of
+    // buckets, see the table mode of route-bench
+    int min_targets_for_sweep = 256;
+    // memory budget in MiB for caching unpacked shortcuts, 0 disables the cache
+    int unpacking_cache_size = 0;
+    // number of viaroute responses to cache, 0 disables the cache
+    int route_cache_size = 0;
+    // number of snapped coordinates to cache, 0 disables the cache
+    int snapping_cache_size = 0;
+    // number of open online map matching sessions, 0 disables the service
+    int max_matching_sessions = 0;
+    // seconds after which an unused online map matching session is closed
+    int matching_session_timeout = 300;
+    // index of this copy of the data among the NUMA replicas of osrm-routed, the ids of online
+    // map matching sessions tell which replica holds the session
+    unsigned replica_index = 0;
+    unsigned number_of_replicas = 1;
     bool use_shared_memory = true;
+    // back the large arrays with huge pages where the platform supports it
+    bool use_huge_pages = false;
+    // bit-pack the edges of the query graph, only when the data is loaded from files
+    bool use_compact_graph = false;
+    // load names, edge annotations and geometries on the first query that reads them
+    bool lazy_loading = false;
+    // serve only distance tables and isochrones, the data to describe routes is not loaded
+    bool table_only = false;
 };
 }
 
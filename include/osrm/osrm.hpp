@@ -28,7 +28,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef OSRM_HPP
 #define OSRM_HPP
 
+#include <cstddef>
+
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -56,6 +60,9 @@ class OSRM
     OSRM(LibOSRMConfig &lib_config);
     ~OSRM(); // needed because we need to define it with the implementation of OSRM_impl
     int RunQuery(const RouteParameters &route_parameters, util::json::Object &json_result);
+    // Pages in the named blocks of all datasets, all blocks if no names are given. The names
+    // are the ones the memory service reports. Returns the number of bytes paged in.
+    std::size_t WarmUp(const std::vector<std::string> &block_names);
 };
 }
 
@@ -51,12 +51,18 @@ struct RouteParameters
 
     void SetAlternateRouteFlag(const bool flag);
 
+    void SetNumberOfAlternatives(const short number);
+
     void SetUTurn(const bool flag);
 
     void SetAllUTurns(const bool flag);
 
     void SetClassify(const bool classify);
 
+    void SetSession(const std::string &id);
+
+    void SetCloseSession(const bool flag);
+
     void SetMatchingBeta(const double beta);
 
     void SetGPSPrecision(const double precision);
@@ -69,6 +75,8 @@ struct RouteParameters
 
     void SetService(const std::string &service);
 
+    void SetDataset(const std::string &dataset);
+
     void SetOutputFormat(const std::string &format);
 
     void SetJSONpParameter(const std::string &parameter);
@@ -77,6 +85,10 @@ struct RouteParameters
 
     void AddTimestamp(const unsigned timestamp);
 
+    void AddTimeLimit(const unsigned seconds);
+
+    void SetDurationsFlag(const bool flag);
+
     void AddBearing(const boost::fusion::vector<int, boost::optional<int>> &received_bearing,
                     boost::spirit::qi::unused_type unused,
                     bool &pass);
@@ -103,16 +115,24 @@ struct RouteParameters
     bool deprecatedAPI;
     bool uturn_default;
     bool classify;
+    bool close_session;
+    // isochrone requests return the duration to every node instead of polygons
+    bool durations;
     double matching_beta;
     double gps_precision;
     unsigned check_sum;
     short num_results;
+    short number_of_alternatives;
     std::string service;
+    // empty for the default dataset
+    std::string dataset;
     std::string output_format;
     std::string jsonp_parameter;
     std::string language;
+    std::string session_id;
     std::vector<std::string> hints;
     std::vector<unsigned> timestamps;
+    std::vector<unsigned> time_limits;
     std::vector<std::pair<const int, const boost::optional<int>>> bearings;
     std::vector<bool> uturns;
     std::vector<FixedPointCoordinate> coordinates;
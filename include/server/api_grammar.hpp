@@ -16,12 +16,15 @@ template <typename Iterator, class HandlerT> struct APIGrammar : qi::grammar<Ite
 {
     explicit APIGrammar(HandlerT *h) : APIGrammar::base_type(api_call), handler(h)
     {
-        api_call =
-            qi::lit('/') >> string[boost::bind(&HandlerT::SetService, handler, ::_1)] >> -query;
+        // an optional leading path segment names the dataset: /car/viaroute?...
+        api_call = qi::lit('/') >> -dataset[boost::bind(&HandlerT::SetDataset, handler, ::_1)] >>
+                   string[boost::bind(&HandlerT::SetService, handler, ::_1)] >> -query;
+        dataset = dataset_name >> qi::lit('/');
         query = ('?') >> +(zoom | output | jsonp | checksum | uturns | location_with_options |
                            destination_with_options | source_with_options | cmp | language |
-                           instruction | geometry | alt_route | old_API | num_results |
-                           matching_beta | gps_precision | classify | locs);
+                           instruction | geometry | alt_route | num_alternatives | old_API |
+                           num_results | matching_beta | gps_precision | classify | session |
+                           close_session | time_limit | durations | locs);
         // all combinations of timestamp, uturn, hint and bearing without duplicates
         t_u = (u >> -timestamp) | (timestamp >> -u);
         t_h = (hint >> -timestamp) | (timestamp >> -hint);
@@ -73,6 +76,9 @@ template <typename Iterator, class HandlerT> struct APIGrammar : qi::grammar<Ite
                    string[boost::bind(&HandlerT::SetLanguage, handler, ::_1)];
         alt_route = (-qi::lit('&')) >> qi::lit("alt") >> '=' >>
                     qi::bool_[boost::bind(&HandlerT::SetAlternateRouteFlag, handler, ::_1)];
+        num_alternatives =
+            (-qi::lit('&')) >> qi::lit("alternatives") >> '=' >>
+            qi::short_[boost::bind(&HandlerT::SetNumberOfAlternatives, handler, ::_1)];
         old_API = (-qi::lit('&')) >> qi::lit("geomformat") >> '=' >>
                   string[boost::bind(&HandlerT::SetDeprecatedAPIFlag, handler, ::_1)];
         num_results = (-qi::lit('&')) >> qi::lit("num_results") >> '=' >>
@@ -83,10 +89,19 @@ template <typename Iterator, class HandlerT> struct APIGrammar : qi::grammar<Ite
                         qi::float_[boost::bind(&HandlerT::SetGPSPrecision, handler, ::_1)];
         classify = (-qi::lit('&')) >> qi::lit("classify") >> '=' >>
                    qi::bool_[boost::bind(&HandlerT::SetClassify, handler, ::_1)];
+        session = (-qi::lit('&')) >> qi::lit("session") >> '=' >>
+                  stringwithDot[boost::bind(&HandlerT::SetSession, handler, ::_1)];
+        close_session = (-qi::lit('&')) >> qi::lit("close") >> '=' >>
+                        qi::bool_[boost::bind(&HandlerT::SetCloseSession, handler, ::_1)];
+        time_limit = (-qi::lit('&')) >> qi::lit("time_limit") >> '=' >>
+                     qi::uint_[boost::bind(&HandlerT::AddTimeLimit, handler, ::_1)];
+        durations = (-qi::lit('&')) >> qi::lit("durations") >> '=' >>
+                    qi::bool_[boost::bind(&HandlerT::SetDurationsFlag, handler, ::_1)];
         locs = (-qi::lit('&')) >> qi::lit("locs") >> '=' >>
                stringforPolyline[boost::bind(&HandlerT::SetCoordinatesFromGeometry, handler, ::_1)];
 
         string = +(qi::char_("a-zA-Z"));
+        dataset_name = +(qi::char_("a-zA-Z0-9_-"));
         stringwithDot = +(qi::char_("a-zA-Z0-9_.-"));
         stringwithPercent = +(qi::char_("a-zA-Z0-9_.-") | qi::char_('[') | qi::char_(']') |
                               (qi::char_('%') >> qi::char_("0-9A-Z") >> qi::char_("0-9A-Z")));
@@ -97,8 +112,9 @@ template <typename Iterator, class HandlerT> struct APIGrammar : qi::grammar<Ite
         destination_with_options, source_with_options, t_u, t_h, u_h, t_u_h;
     qi::rule<Iterator, std::string()> service, zoom, output, string, jsonp, checksum, location,
         destination, source, hint, timestamp, bearing, stringwithDot, stringwithPercent, language,
-        geometry, cmp, alt_route, u, uturns, old_API, num_results, matching_beta, gps_precision,
-        classify, locs, instruction, stringforPolyline;
+        geometry, cmp, alt_route, num_alternatives, u, uturns, old_API, num_results, matching_beta,
+        gps_precision, classify, session, close_session, time_limit, durations, locs,
+        instruction, stringforPolyline, dataset, dataset_name;
 
     HandlerT *handler;
 };
@@ -1,7 +1,9 @@
 #ifndef REQUEST_HANDLER_HPP
 #define REQUEST_HANDLER_HPP
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -31,9 +33,14 @@ class RequestHandler
 
     void handle_request(const http::request &current_request, http::reply &current_reply);
     void RegisterRoutingMachine(engine::OSRM *osrm);
+    // one routing machine per NUMA node, requests are handled by the one of the node the
+    // handling thread is pinned to
+    void RegisterRoutingMachines(const std::vector<engine::OSRM *> &osrms);
 
   private:
-    engine::OSRM *routing_machine;
+    std::size_t GetReplica(const engine::RouteParameters &route_parameters) const;
+
+    std::vector<engine::OSRM *> routing_machines;
 };
 }
 }
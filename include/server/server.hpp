@@ -5,6 +5,7 @@
 #include "server/request_handler.hpp"
 
 #include "util/integer_range.hpp"
+#include "util/numa.hpp"
 #include "util/simple_logger.hpp"
 
 #include <boost/asio.hpp>
@@ -27,18 +28,25 @@ class Server
 {
   public:
     // Note: returns a shared instead of a unique ptr as it is captured in a lambda somewhere else
-    static std::shared_ptr<Server>
-    CreateServer(std::string &ip_address, int ip_port, unsigned requested_num_threads)
+    static std::shared_ptr<Server> CreateServer(std::string &ip_address,
+                                                int ip_port,
+                                                unsigned requested_num_threads,
+                                                bool pin_threads_to_numa_nodes = false)
     {
         util::SimpleLogger().Write() << "http 1.1 compression handled by zlib version "
                                      << zlibVersion();
         const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
         const unsigned real_num_threads = std::min(hardware_threads, requested_num_threads);
-        return std::make_shared<Server>(ip_address, ip_port, real_num_threads);
+        return std::make_shared<Server>(ip_address, ip_port, real_num_threads,
+                                        pin_threads_to_numa_nodes);
     }
 
-    explicit Server(const std::string &address, const int port, const unsigned thread_pool_size)
-        : thread_pool_size(thread_pool_size), acceptor(io_service),
+    explicit Server(const std::string &address,
+                    const int port,
+                    const unsigned thread_pool_size,
+                    const bool pin_threads_to_numa_nodes = false)
+        : thread_pool_size(thread_pool_size),
+          pin_threads_to_numa_nodes(pin_threads_to_numa_nodes), acceptor(io_service),
           new_connection(std::make_shared<Connection>(io_service, request_handler))
     {
         const auto port_string = std::to_string(port);
@@ -59,10 +67,20 @@ class Server
     void Run()
     {
         std::vector<std::shared_ptr<std::thread>> threads;
+        const auto run_pinned = [this](const unsigned node)
+        {
+            if (pin_threads_to_numa_nodes)
+            {
+                util::NUMATopology::Get().PinThreadToNode(node);
+            }
+            io_service.run();
+        };
+        const auto number_of_nodes = util::NUMATopology::Get().GetNumberOfNodes();
         for (unsigned i = 0; i < thread_pool_size; ++i)
         {
-            std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(
-                boost::bind(&boost::asio::io_service::run, &io_service));
+            // the threads are spread evenly over the nodes
+            std::shared_ptr<std::thread> thread =
+                std::make_shared<std::thread>(run_pinned, i % number_of_nodes);
             threads.push_back(thread);
         }
         for (auto thread : threads)
@@ -89,6 +107,7 @@ class Server
     }
 
     unsigned thread_pool_size;
+    bool pin_threads_to_numa_nodes;
     boost::asio::io_service io_service;
     boost::asio::ip::tcp::acceptor acceptor;
     std::shared_ptr<Connection> new_connection;
@@ -3,11 +3,14 @@
 
 #include <boost/assert.hpp>
 
+#include <cstddef>
+
 #include <algorithm>
 #include <limits>
 #include <map>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -28,6 +31,8 @@ template <typename NodeID, typename Key> class ArrayStorage
 
     void Clear() {}
 
+    std::size_t GetMemoryUsage() const { return positions.capacity() * sizeof(Key); }
+
   private:
     std::vector<Key> positions;
 };
@@ -51,6 +56,12 @@ template <typename NodeID, typename Key> class MapStorage
         return std::numeric_limits<Key>::max();
     }
 
+    // a tree node holds the entry, three pointers and its colour
+    std::size_t GetMemoryUsage() const
+    {
+        return nodes.size() * (sizeof(std::pair<const NodeID, Key>) + 4 * sizeof(void *));
+    }
+
   private:
     std::map<NodeID, Key> nodes;
 };
@@ -80,6 +91,13 @@ template <typename NodeID, typename Key> class UnorderedMapStorage
 
     void Clear() { nodes.clear(); }
 
+    // the buckets are kept when the map is cleared, a node holds the entry and the next pointer
+    std::size_t GetMemoryUsage() const
+    {
+        return nodes.bucket_count() * sizeof(void *) +
+               nodes.size() * (sizeof(std::pair<const NodeID, Key>) + sizeof(void *));
+    }
+
   private:
     std::unordered_map<NodeID, Key> nodes;
 };
@@ -111,6 +129,13 @@ class BinaryHeap
 
     std::size_t Size() const { return (heap.size() - 1); }
 
+    // the arrays keep their capacity when the heap is cleared
+    std::size_t GetMemoryUsage() const
+    {
+        return inserted_nodes.capacity() * sizeof(HeapNode) +
+               heap.capacity() * sizeof(HeapElement) + node_index.GetMemoryUsage();
+    }
+
     bool Empty() const { return 0 == Size(); }
 
     void Insert(NodeID node, Weight weight, const Data &data)
@@ -144,6 +169,21 @@ class BinaryHeap
         return inserted_nodes[index].weight;
     }
 
+    Weight const &GetKey(NodeID node) const
+    {
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].weight;
+    }
+
+    // Dense index of a node in the order of insertion, valid until the heap is cleared.
+    std::size_t GetInsertionIndex(const NodeID node) const
+    {
+        BOOST_ASSERT(WasInserted(node));
+        return node_index.peek_index(node);
+    }
+
+    std::size_t NumberOfInsertedNodes() const { return inserted_nodes.size(); }
+
     bool WasRemoved(const NodeID node) const
     {
         BOOST_ASSERT(WasInserted(node));
@@ -0,0 +1,71 @@
+#ifndef CONVEX_HULL_HPP
+#define CONVEX_HULL_HPP
+
+#include "osrm/coordinate.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace detail
+{
+// > 0 if a, b, c turn counter-clockwise, with lon as x and lat as y
+inline std::int64_t Cross(const FixedPointCoordinate &a,
+                          const FixedPointCoordinate &b,
+                          const FixedPointCoordinate &c)
+{
+    return (static_cast<std::int64_t>(b.lon) - a.lon) * (static_cast<std::int64_t>(c.lat) - a.lat) -
+           (static_cast<std::int64_t>(b.lat) - a.lat) * (static_cast<std::int64_t>(c.lon) - a.lon);
+}
+}
+
+// Computes the convex hull of a set of coordinates with Andrew's monotone chain. The hull is
+// returned counter-clockwise without repeating the first coordinate, collinear coordinates on the
+// boundary are dropped. Coordinates are treated as planar, which is fine for hulls of a city.
+inline std::vector<FixedPointCoordinate> ConvexHull(std::vector<FixedPointCoordinate> coordinates)
+{
+    std::sort(coordinates.begin(), coordinates.end(),
+              [](const FixedPointCoordinate &lhs, const FixedPointCoordinate &rhs)
+              {
+                  return lhs.lon < rhs.lon || (lhs.lon == rhs.lon && lhs.lat < rhs.lat);
+              });
+    coordinates.erase(std::unique(coordinates.begin(), coordinates.end()), coordinates.end());
+    if (coordinates.size() < 3)
+    {
+        return coordinates;
+    }
+
+    std::vector<FixedPointCoordinate> hull(2 * coordinates.size());
+    std::size_t size = 0;
+    // lower hull
+    for (const auto &coordinate : coordinates)
+    {
+        while (size >= 2 && detail::Cross(hull[size - 2], hull[size - 1], coordinate) <= 0)
+        {
+            --size;
+        }
+        hull[size++] = coordinate;
+    }
+    // upper hull
+    const auto lower_size = size + 1;
+    for (auto iter = coordinates.rbegin() + 1; iter != coordinates.rend(); ++iter)
+    {
+        while (size >= lower_size && detail::Cross(hull[size - 2], hull[size - 1], *iter) <= 0)
+        {
+            --size;
+        }
+        hull[size++] = *iter;
+    }
+    // the last coordinate is the first one again
+    hull.resize(size - 1);
+    return hull;
+}
+}
+}
+
+#endif // CONVEX_HULL_HPP
@@ -21,7 +21,10 @@ namespace util
 // generate boost::program_options object for the routing part
 bool GenerateDataStoreOptions(const int argc,
                               const char *argv[],
-                              std::unordered_map<std::string, boost::filesystem::path> &paths)
+                              std::unordered_map<std::string, boost::filesystem::path> &paths,
+                              bool &use_huge_pages,
+                              bool &table_only,
+                              bool &warm_up)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
@@ -29,7 +32,13 @@ bool GenerateDataStoreOptions(const int argc,
         "springclean,s", "Remove all regions in shared memory")(
         "config,c", boost::program_options::value<boost::filesystem::path>(&paths["config"])
                         ->default_value("server.ini"),
-        "Path to a configuration file");
+        "Path to a configuration file")(
+        "hugepages", boost::program_options::bool_switch(&use_huge_pages)->default_value(false),
+        "Allocate the shared memory on huge pages, falls back to regular pages")(
+        "table-only", boost::program_options::bool_switch(&table_only)->default_value(false),
+        "Leave out names, turn instructions and geometries, only distance tables are served")(
+        "warm-up", boost::program_options::bool_switch(&warm_up)->default_value(false),
+        "Read the leaf file of the r-tree into the page cache before switching to the new data");
 
     // declare a group of options that will be allowed both on command line
     // as well as in a config file
@@ -52,7 +61,9 @@ bool GenerateDataStoreOptions(const int argc,
         "namesdata", boost::program_options::value<boost::filesystem::path>(&paths["namesdata"]),
         ".names file")("timestamp",
                        boost::program_options::value<boost::filesystem::path>(&paths["timestamp"]),
-                       ".timestamp file");
+                       ".timestamp file")(
+        "order", boost::program_options::value<boost::filesystem::path>(&paths["order"]),
+        ".order file");
 
     // hidden options, will be allowed both on command line and in config
     // file, but will not be shown to the user
@@ -198,6 +209,12 @@ bool GenerateDataStoreOptions(const int argc,
         {
             path_iterator->second = base_string + ".timestamp";
         }
+
+        path_iterator = paths.find("order");
+        if (path_iterator != paths.end())
+        {
+            path_iterator->second = base_string + ".order";
+        }
     }
 
     path_iterator = paths.find("hsgrdata");
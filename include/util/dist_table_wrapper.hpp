@@ -1,6 +1,10 @@
 #ifndef DIST_TABLE_WRAPPER_H
 #define DIST_TABLE_WRAPPER_H
 
+#include "util/typedefs.hpp"
+
+#include <algorithm>
+#include <iterator>
 #include <vector>
 #include <utility>
 #include <boost/assert.hpp>
@@ -2,6 +2,7 @@
 #define GRAPH_LOADER_HPP
 
 #include "util/fingerprint.hpp"
+#include "util/huge_pages.hpp"
 #include "util/osrm_exception.hpp"
 #include "util/simple_logger.hpp"
 #include "extractor/external_memory_node.hpp"
@@ -184,11 +185,11 @@ unsigned readHSGRFromStream(const boost::filesystem::path &hsgr_file,
                            << ", number_of_edges: " << number_of_edges;
 
     // BOOST_ASSERT_MSG( 0 != number_of_edges, "number of edges is zero");
-    node_list.resize(number_of_nodes);
+    HugePages::Resize(node_list, number_of_nodes);
     hsgr_input_stream.read(reinterpret_cast<char *>(&node_list[0]),
                            number_of_nodes * sizeof(NodeT));
 
-    edge_list.resize(number_of_edges);
+    HugePages::Resize(edge_list, number_of_edges);
     if (number_of_edges > 0)
     {
         hsgr_input_stream.read(reinterpret_cast<char *>(&edge_list[0]),
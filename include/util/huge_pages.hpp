@@ -0,0 +1,220 @@
+#ifndef HUGE_PAGES_HPP
+#define HUGE_PAGES_HPP
+
+#include "util/simple_logger.hpp"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Opt-in backing of the large arrays with huge pages. Random access over the graph and the
+// coordinates of a big dataset misses the TLB on nearly every access with 4K pages, with 2M pages
+// the whole working set is covered by a few hundred entries.
+//
+// On Linux transparent huge pages are requested with madvise(MADV_HUGEPAGE). Memory that is
+// advised before it is touched for the first time is faulted in as huge pages directly, memory
+// that was touched before is collapsed by khugepaged in the background. Everywhere else this is a
+// no-op and the arrays simply stay on regular pages.
+class HugePages
+{
+  public:
+    static const constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    static void Enable(const bool enable) { GetEnabled() = enable; }
+
+    static bool IsEnabled() { return GetEnabled(); }
+
+    // Advises the huge page aligned part of the given memory. Returns false if huge pages are
+    // disabled, not supported or the memory does not span a whole huge page.
+    static bool Advise(const void *ptr, const std::size_t size)
+    {
+        if (!IsEnabled())
+        {
+            return false;
+        }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        const auto begin = reinterpret_cast<std::uintptr_t>(ptr);
+        const auto aligned_begin = (begin + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        const auto aligned_end = (begin + size) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        if (aligned_end <= aligned_begin)
+        {
+            return false;
+        }
+        return 0 == madvise(reinterpret_cast<void *>(aligned_begin), aligned_end - aligned_begin,
+                            MADV_HUGEPAGE);
+#else
+        (void)ptr;
+        (void)size;
+        return false;
+#endif
+    }
+
+    // Resizes the vector like std::vector::resize, but advises the new storage before the new
+    // entries are written so that they are faulted in as huge pages.
+    template <typename T> static bool Resize(std::vector<T> &vector, const std::size_t size)
+    {
+        vector.reserve(size);
+        const bool advised = Advise(vector.data(), vector.capacity() * sizeof(T));
+        vector.resize(size);
+        return advised;
+    }
+
+    // Bytes of the given memory that are backed by huge pages right now. Reads the counters of
+    // the mappings the memory lies in from /proc/self/smaps. The counters are kept per mapping,
+    // so this is an upper bound if the memory shares its mapping with other data. Zero where
+    // /proc is not available.
+    static std::size_t GetBackedBytes(const void *ptr, const std::size_t size)
+    {
+#if defined(__linux__)
+        std::ifstream smaps("/proc/self/smaps");
+        return ParseBackedBytes(smaps, reinterpret_cast<std::uintptr_t>(ptr), size);
+#else
+        (void)ptr;
+        (void)size;
+        return 0;
+#endif
+    }
+
+    // Sums the huge page counters of all mappings in the smaps format, each capped at the part
+    // of the mapping that overlaps the memory.
+    static std::size_t
+    ParseBackedBytes(std::istream &smaps, const std::uintptr_t begin, const std::size_t size)
+    {
+        const auto end = begin + size;
+        std::size_t backed_bytes = 0;
+        std::size_t overlap = 0;
+        std::size_t mapping_backed_bytes = 0;
+        std::string line;
+        while (std::getline(smaps, line))
+        {
+            std::istringstream fields(line);
+            std::string name;
+            fields >> name;
+            if (name.empty())
+            {
+                continue;
+            }
+
+            // counters are "Name: value kB", everything else starts a new mapping "begin-end"
+            if (name.back() == ':')
+            {
+                std::size_t kilobytes = 0;
+                if (IsHugePageCounter(name) && fields >> kilobytes)
+                {
+                    mapping_backed_bytes += kilobytes * 1024;
+                }
+                continue;
+            }
+
+            backed_bytes += std::min(mapping_backed_bytes, overlap);
+            mapping_backed_bytes = 0;
+            overlap = 0;
+
+            const auto separator = name.find('-');
+            if (separator == std::string::npos)
+            {
+                continue;
+            }
+            const auto mapping_begin =
+                static_cast<std::uintptr_t>(std::stoull(name.substr(0, separator), nullptr, 16));
+            const auto mapping_end =
+                static_cast<std::uintptr_t>(std::stoull(name.substr(separator + 1), nullptr, 16));
+            if (mapping_begin < end && begin < mapping_end)
+            {
+                overlap = std::min(end, mapping_end) - std::max(begin, mapping_begin);
+            }
+        }
+        return backed_bytes + std::min(mapping_backed_bytes, overlap);
+    }
+
+    // The active mode of transparent huge pages: always, madvise or never. Empty if unknown.
+    static std::string GetTransparentHugePageMode()
+    {
+#if defined(__linux__)
+        std::ifstream settings("/sys/kernel/mm/transparent_hugepage/enabled");
+        std::string modes;
+        std::getline(settings, modes);
+        return ParseTransparentHugePageMode(modes);
+#else
+        return {};
+#endif
+    }
+
+    // The selected mode is the one in brackets, e.g. "always [madvise] never".
+    static std::string ParseTransparentHugePageMode(const std::string &modes)
+    {
+        const auto open = modes.find('[');
+        const auto close = modes.find(']', open);
+        if (open == std::string::npos || close == std::string::npos)
+        {
+            return {};
+        }
+        return modes.substr(open + 1, close - open - 1);
+    }
+
+    // Logs the mode of transparent huge pages once huge pages are enabled. madvise succeeds even
+    // if they are switched off, the memory then simply stays on regular pages.
+    static void ReportMode()
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+        const auto mode = GetTransparentHugePageMode();
+        if (mode == "never")
+        {
+            SimpleLogger().Write(logWARNING)
+                << "transparent huge pages are disabled, the data stays on regular pages";
+            return;
+        }
+        SimpleLogger().Write() << "transparent huge pages: " << (mode.empty() ? "unknown" : mode);
+    }
+
+    // Logs how much of an array is on huge pages, this is the report at startup. Memory that was
+    // touched before it was advised is only collapsed later by khugepaged and is not counted.
+    static void
+    Report(const std::string &name, const void *ptr, const std::size_t size, const bool advised)
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+        SimpleLogger().Write() << name << ": " << (size / (1024 * 1024)) << " MiB, "
+                               << (GetBackedBytes(ptr, size) / (1024 * 1024))
+                               << " MiB on huge pages" << (advised ? "" : ", not advised");
+    }
+
+  private:
+    static bool IsHugePageCounter(const std::string &name)
+    {
+        return name == "AnonHugePages:" || name == "ShmemPmdMapped:" ||
+               name == "FilePmdMapped:" || name == "Shared_Hugetlb:" ||
+               name == "Private_Hugetlb:";
+    }
+
+    static std::atomic<bool> &GetEnabled()
+    {
+        static std::atomic<bool> enabled(false);
+        return enabled;
+    }
+};
+}
+}
+
+#endif // HUGE_PAGES_HPP
@@ -0,0 +1,183 @@
+#ifndef LRU_CACHE_HPP
+#define LRU_CACHE_HPP
+
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Thread-safe least recently used cache. Keys are distributed over independently locked
+// shards so that concurrent lookups of different keys rarely contend.
+//
+// Values are returned by copy, so large values should be stored behind a shared_ptr.
+template <typename KeyT, typename ValueT, typename HashT = std::hash<KeyT>> class ShardedLRUCache
+{
+  public:
+    struct Statistics
+    {
+        std::size_t capacity;
+        std::size_t size;
+        std::uint64_t hits;
+        std::uint64_t misses;
+        std::uint64_t evictions;
+
+        double GetHitRate() const
+        {
+            const auto lookups = hits + misses;
+            return lookups == 0 ? 0. : static_cast<double>(hits) / lookups;
+        }
+    };
+
+    static constexpr std::size_t DEFAULT_NUMBER_OF_SHARDS = 16;
+
+    explicit ShardedLRUCache(const std::size_t capacity,
+                             const std::size_t number_of_shards = DEFAULT_NUMBER_OF_SHARDS)
+        : capacity(capacity), hits(0), misses(0), evictions(0)
+    {
+        const auto shard_count = std::max<std::size_t>(1, std::min(capacity, number_of_shards));
+        const auto shard_capacity = (capacity + shard_count - 1) / shard_count;
+        for (std::size_t i = 0; i < shard_count; ++i)
+        {
+            shards.emplace_back(new Shard(shard_capacity));
+        }
+    }
+
+    bool IsEnabled() const { return capacity > 0; }
+
+    boost::optional<ValueT> Find(const KeyT &key)
+    {
+        if (!IsEnabled())
+        {
+            return boost::none;
+        }
+
+        auto &shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto iter = shard.index.find(key);
+        if (iter == shard.index.end())
+        {
+            ++misses;
+            return boost::none;
+        }
+        ++hits;
+        // move to the front of the usage list
+        shard.entries.splice(shard.entries.begin(), shard.entries, iter->second);
+        return iter->second->second;
+    }
+
+    void Insert(const KeyT &key, ValueT value)
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+
+        auto &shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto iter = shard.index.find(key);
+        if (iter != shard.index.end())
+        {
+            iter->second->second = std::move(value);
+            shard.entries.splice(shard.entries.begin(), shard.entries, iter->second);
+            return;
+        }
+
+        if (shard.index.size() >= shard.capacity)
+        {
+            shard.index.erase(shard.entries.back().first);
+            shard.entries.pop_back();
+            ++evictions;
+        }
+        shard.entries.emplace_front(key, std::move(value));
+        shard.index.emplace(key, shard.entries.begin());
+    }
+
+    void Erase(const KeyT &key)
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+
+        auto &shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto iter = shard.index.find(key);
+        if (iter != shard.index.end())
+        {
+            shard.entries.erase(iter->second);
+            shard.index.erase(iter);
+        }
+    }
+
+    void Clear()
+    {
+        for (auto &shard : shards)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->index.clear();
+            shard->entries.clear();
+        }
+    }
+
+    Statistics GetStatistics() const
+    {
+        Statistics statistics;
+        statistics.capacity = capacity;
+        statistics.size = 0;
+        for (const auto &shard : shards)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            statistics.size += shard->index.size();
+        }
+        statistics.hits = hits;
+        statistics.misses = misses;
+        statistics.evictions = evictions;
+        return statistics;
+    }
+
+  private:
+    using EntryList = std::list<std::pair<KeyT, ValueT>>;
+
+    struct Shard
+    {
+        explicit Shard(const std::size_t capacity) : capacity(capacity) {}
+
+        mutable std::mutex mutex;
+        const std::size_t capacity;
+        EntryList entries;
+        std::unordered_map<KeyT, typename EntryList::iterator, HashT> index;
+    };
+
+    Shard &GetShard(const KeyT &key)
+    {
+        // the shard index uses other bits of the hash than the buckets inside of a shard
+        const std::uint64_t hash = HashT()(key) * 0x9E3779B97F4A7C15ull;
+        return *shards[(hash >> 32) % shards.size()];
+    }
+
+    const std::size_t capacity;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<std::uint64_t> hits;
+    std::atomic<std::uint64_t> misses;
+    std::atomic<std::uint64_t> evictions;
+};
+
+template <typename KeyT, typename ValueT, typename HashT>
+constexpr std::size_t ShardedLRUCache<KeyT, ValueT, HashT>::DEFAULT_NUMBER_OF_SHARDS;
+}
+}
+
+#endif // LRU_CACHE_HPP
@@ -80,9 +80,10 @@ struct MatchingDebugInfo
             .values.push_back(transistion);
     }
 
-    void set_viterbi(const std::vector<std::vector<double>> &viterbi,
-                     const std::vector<std::vector<bool>> &pruned,
-                     const std::vector<std::vector<bool>> &suspicious)
+    template <class ViterbiTable, class FlagTable>
+    void set_viterbi(const ViterbiTable &viterbi,
+                     const FlagTable &pruned,
+                     const FlagTable &suspicious)
     {
         // json logger not enabled
         if (!logger)
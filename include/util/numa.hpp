@@ -0,0 +1,86 @@
+#ifndef NUMA_HPP
+#define NUMA_HPP
+
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// The NUMA nodes of the machine and the CPUs that belong to them, read from sysfs on Linux.
+// Everywhere else, and on machines with a single node, there is exactly one node that holds all
+// CPUs and pinning does nothing.
+//
+// Only threads that call PinThreadToNode are pinned. The worker threads of TBB, which run the
+// parallel parts of a request (batch routes, isochrones, large tables, trips), are shared by
+// all nodes and may read the replica of another node.
+class NUMATopology
+{
+  public:
+    static const NUMATopology &Get();
+
+    unsigned GetNumberOfNodes() const { return static_cast<unsigned>(node_cpus.size()); }
+
+    bool IsNUMA() const { return node_cpus.size() > 1; }
+
+    // Restricts the calling thread to the CPUs of the node. Memory the thread touches first is
+    // then allocated on that node. Returns false if the thread could not be pinned.
+    bool PinThreadToNode(const unsigned node) const;
+
+    // the node the calling thread was pinned to, 0 for threads that were never pinned
+    static unsigned GetThreadNode();
+
+    // Creates one replica per node, each one by a thread that is pinned to its node. Everything
+    // the replica allocates and fills while it is created is local to the node.
+    template <typename T, typename Factory>
+    std::vector<std::unique_ptr<T>> CreateReplicas(Factory factory) const
+    {
+        std::vector<std::unique_ptr<T>> replicas(GetNumberOfNodes());
+        std::vector<std::exception_ptr> errors(GetNumberOfNodes());
+        std::vector<std::thread> threads;
+        for (unsigned node = 0; node < GetNumberOfNodes(); ++node)
+        {
+            threads.emplace_back([this, node, &replicas, &errors, &factory]
+                                 {
+                                     try
+                                     {
+                                         PinThreadToNode(node);
+                                         replicas[node] = factory();
+                                     }
+                                     catch (...)
+                                     {
+                                         errors[node] = std::current_exception();
+                                     }
+                                 });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        for (const auto &error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+        return replicas;
+    }
+
+    // parses a cpulist of sysfs like "0-3,8,10-11"
+    static std::vector<unsigned> ParseCPUList(const std::string &cpu_list);
+
+  private:
+    NUMATopology();
+
+    std::vector<std::vector<unsigned>> node_cpus;
+};
+}
+}
+
+#endif // NUMA_HPP
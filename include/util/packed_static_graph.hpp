@@ -0,0 +1,239 @@
+#ifndef PACKED_STATIC_GRAPH_HPP
+#define PACKED_STATIC_GRAPH_HPP
+
+#include "util/huge_pages.hpp"
+#include "util/integer_range.hpp"
+#include "util/residency.hpp"
+#include "util/static_graph.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Read-only variant of the StaticGraph of the query graph that stores every edge as a bit-packed
+// record instead of a 12 byte struct. The widths of target, id and distance are the ones the
+// largest value of the graph needs, the three flags take one bit each, so a record is at most
+// 95 instead of 96 bits wide and much smaller on graphs with fewer nodes (51 bits for 65536
+// nodes). graph-bench prints the width for a dataset. Decoding costs time on every access, the
+// packed graph trades query time for memory.
+//
+// Records have a fixed width so that an edge is still addressed by its EdgeID, which the
+// unpacking and the many-to-many searches rely on. Edges are decoded by value on access.
+template <typename EdgeDataT> class PackedStaticGraph
+{
+  public:
+    using NodeIterator = NodeID;
+    using EdgeIterator = NodeID;
+    using EdgeData = EdgeDataT;
+    using EdgeRange = range<EdgeIterator>;
+    // the input is the same as for the StaticGraph, which is what the .hsgr file stores
+    using NodeArrayEntry = typename StaticGraph<EdgeDataT>::NodeArrayEntry;
+    using EdgeArrayEntry = typename StaticGraph<EdgeDataT>::EdgeArrayEntry;
+
+    // Takes the node array and packs the edges. Both vectors are empty afterwards.
+    PackedStaticGraph(std::vector<NodeArrayEntry> &nodes, std::vector<EdgeArrayEntry> &edges)
+    {
+        BOOST_ASSERT(!nodes.empty());
+        number_of_nodes = static_cast<decltype(number_of_nodes)>(nodes.size() - 1);
+        number_of_edges = static_cast<decltype(number_of_edges)>(edges.size());
+        node_array.swap(nodes);
+
+        std::uint32_t max_target = 0, max_id = 0, max_distance = 0;
+        for (const auto &edge : edges)
+        {
+            BOOST_ASSERT(edge.data.distance >= 0);
+            max_target = std::max<std::uint32_t>(max_target, edge.target);
+            max_id = std::max<std::uint32_t>(max_id, edge.data.id);
+            max_distance = std::max<std::uint32_t>(max_distance, edge.data.distance);
+        }
+        target_bits = BitsFor(max_target);
+        id_bits = BitsFor(max_id);
+        distance_bits = BitsFor(max_distance);
+        record_bits = target_bits + id_bits + distance_bits + 3;
+
+        // one word of padding, decoding always reads the word after the one a field starts in
+        const auto number_of_words = (std::uint64_t(number_of_edges) * record_bits + 63) / 64 + 1;
+        HugePages::Resize(packed_edges, number_of_words);
+        for (const auto edge : irange(0u, number_of_edges))
+        {
+            const auto &entry = edges[edge];
+            auto offset = std::uint64_t(edge) * record_bits;
+            offset = Encode(offset, target_bits, entry.target);
+            offset = Encode(offset, id_bits, entry.data.id);
+            offset = Encode(offset, distance_bits, entry.data.distance);
+            offset = Encode(offset, 1, entry.data.shortcut);
+            offset = Encode(offset, 1, entry.data.forward);
+            Encode(offset, 1, entry.data.backward);
+        }
+        std::vector<EdgeArrayEntry>().swap(edges);
+    }
+
+    unsigned GetNumberOfNodes() const { return number_of_nodes; }
+
+    unsigned GetNumberOfEdges() const { return number_of_edges; }
+
+    std::vector<MemoryBlock> GetMemoryBlocks() const
+    {
+        return {MakeMemoryBlock("graph nodes", node_array),
+                MakeMemoryBlock("packed graph edges", packed_edges)};
+    }
+
+    unsigned GetRecordBits() const { return record_bits; }
+
+    std::size_t GetSizeInBytes() const
+    {
+        return node_array.size() * sizeof(NodeArrayEntry) +
+               packed_edges.size() * sizeof(std::uint64_t);
+    }
+
+    EdgeRange GetAdjacentEdgeRange(const NodeID node) const
+    {
+        return irange(BeginEdges(node), EndEdges(node));
+    }
+
+    unsigned GetOutDegree(const NodeIterator n) const { return EndEdges(n) - BeginEdges(n); }
+
+    inline NodeIterator GetTarget(const EdgeIterator e) const
+    {
+        return Decode(std::uint64_t(e) * record_bits, target_bits);
+    }
+
+    inline EdgeDataT GetEdgeData(const EdgeIterator e) const
+    {
+        auto offset = std::uint64_t(e) * record_bits + target_bits;
+        EdgeDataT data;
+        data.id = Decode(offset, id_bits);
+        offset += id_bits;
+        data.distance = static_cast<int>(Decode(offset, distance_bits));
+        offset += distance_bits;
+        // the flags are adjacent, one decode gets all three
+        const auto flags = Decode(offset, 3);
+        data.shortcut = (flags & 1) != 0;
+        data.forward = (flags & 2) != 0;
+        data.backward = (flags & 4) != 0;
+        return data;
+    }
+
+    EdgeIterator BeginEdges(const NodeIterator n) const
+    {
+        return EdgeIterator(node_array[n].first_edge);
+    }
+
+    EdgeIterator EndEdges(const NodeIterator n) const
+    {
+        return EdgeIterator(node_array[n + 1].first_edge);
+    }
+
+    // searches for a specific edge
+    EdgeIterator FindEdge(const NodeIterator from, const NodeIterator to) const
+    {
+        for (const auto i : irange(BeginEdges(from), EndEdges(from)))
+        {
+            if (to == GetTarget(i))
+            {
+                return i;
+            }
+        }
+        return SPECIAL_EDGEID;
+    }
+
+    // searches for a specific edge
+    EdgeIterator FindSmallestEdge(const NodeIterator from, const NodeIterator to) const
+    {
+        EdgeIterator smallest_edge = SPECIAL_EDGEID;
+        EdgeWeight smallest_weight = INVALID_EDGE_WEIGHT;
+        for (auto edge : GetAdjacentEdgeRange(from))
+        {
+            const NodeID target = GetTarget(edge);
+            const EdgeWeight weight = GetEdgeData(edge).distance;
+            if (target == to && weight < smallest_weight)
+            {
+                smallest_edge = edge;
+                smallest_weight = weight;
+            }
+        }
+        return smallest_edge;
+    }
+
+    EdgeIterator FindEdgeInEitherDirection(const NodeIterator from, const NodeIterator to) const
+    {
+        EdgeIterator tmp = FindEdge(from, to);
+        return (SPECIAL_NODEID != tmp ? tmp : FindEdge(to, from));
+    }
+
+    EdgeIterator
+    FindEdgeIndicateIfReverse(const NodeIterator from, const NodeIterator to, bool &result) const
+    {
+        EdgeIterator current_iterator = FindEdge(from, to);
+        if (SPECIAL_NODEID == current_iterator)
+        {
+            current_iterator = FindEdge(to, from);
+            if (SPECIAL_NODEID != current_iterator)
+            {
+                result = true;
+            }
+        }
+        return current_iterator;
+    }
+
+  private:
+    static unsigned BitsFor(std::uint32_t max_value)
+    {
+        unsigned bits = 1;
+        while (max_value >>= 1)
+        {
+            ++bits;
+        }
+        return bits;
+    }
+
+    // fields are at most 32 bits wide and span at most two words
+    inline std::uint32_t Decode(const std::uint64_t offset, const unsigned bits) const
+    {
+        const auto word = offset / 64;
+        const auto shift = static_cast<unsigned>(offset % 64);
+        std::uint64_t value = packed_edges[word] >> shift;
+        if (shift + bits > 64)
+        {
+            value |= packed_edges[word + 1] << (64 - shift);
+        }
+        return static_cast<std::uint32_t>(value & ((std::uint64_t(1) << bits) - 1));
+    }
+
+    std::uint64_t Encode(const std::uint64_t offset, const unsigned bits, const std::uint32_t value)
+    {
+        BOOST_ASSERT(bits == 32 || (std::uint64_t(value) >> bits) == 0);
+        const auto word = offset / 64;
+        const auto shift = static_cast<unsigned>(offset % 64);
+        packed_edges[word] |= std::uint64_t(value) << shift;
+        if (shift + bits > 64)
+        {
+            packed_edges[word + 1] |= std::uint64_t(value) >> (64 - shift);
+        }
+        return offset + bits;
+    }
+
+    NodeIterator number_of_nodes;
+    EdgeIterator number_of_edges;
+    unsigned target_bits;
+    unsigned id_bits;
+    unsigned distance_bits;
+    unsigned record_bits;
+
+    std::vector<NodeArrayEntry> node_array;
+    std::vector<std::uint64_t> packed_edges;
+};
+}
+}
+
+#endif // PACKED_STATIC_GRAPH_HPP
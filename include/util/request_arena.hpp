@@ -0,0 +1,177 @@
+#ifndef REQUEST_ARENA_HPP
+#define REQUEST_ARENA_HPP
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Monotonic buffer for all temporary memory of a single request.
+//
+// Allocations only bump a pointer and deallocation is a no-op. Release() frees everything at
+// once, but keeps the largest block so that following requests on the same thread do not need
+// to touch the system allocator at all.
+class RequestArena
+{
+  public:
+    struct Statistics
+    {
+        std::size_t allocations = 0;
+        std::size_t allocated_bytes = 0;
+        // number of blocks that needed to be requested from the system allocator
+        std::size_t system_allocations = 0;
+    };
+
+    static constexpr std::size_t INITIAL_BLOCK_SIZE = 64 * 1024;
+
+    RequestArena() : current(nullptr), remaining(0), last_block_size(0) {}
+    RequestArena(const RequestArena &) = delete;
+    RequestArena &operator=(const RequestArena &) = delete;
+
+    void *Allocate(const std::size_t bytes, const std::size_t alignment)
+    {
+        BOOST_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+        std::size_t padding = GetPadding(alignment);
+        if (current == nullptr || padding + bytes > remaining)
+        {
+            AddBlock(bytes + alignment);
+            padding = GetPadding(alignment);
+        }
+        BOOST_ASSERT(padding + bytes <= remaining);
+
+        char *pointer = current + padding;
+        current = pointer + bytes;
+        remaining -= padding + bytes;
+
+        ++statistics.allocations;
+        statistics.allocated_bytes += bytes;
+        return pointer;
+    }
+
+    // Frees all memory of the request. Memory handed out before must not be used afterwards.
+    void Release()
+    {
+        if (blocks.size() > 1)
+        {
+            // keep the last block, it is the largest one
+            blocks.front() = std::move(blocks.back());
+            blocks.resize(1);
+        }
+        current = blocks.empty() ? nullptr : blocks.front().get();
+        remaining = blocks.empty() ? 0 : last_block_size;
+        statistics = Statistics();
+    }
+
+    const Statistics &GetStatistics() const { return statistics; }
+
+    // Arena of the request that is currently handled by this thread, nullptr if none.
+    static RequestArena *Current();
+
+  private:
+    friend class RequestArenaScope;
+
+    std::size_t GetPadding(const std::size_t alignment) const
+    {
+        const auto address = reinterpret_cast<std::uintptr_t>(current);
+        return (alignment - address % alignment) % alignment;
+    }
+
+    void AddBlock(const std::size_t min_size)
+    {
+        std::size_t block_size = std::max(INITIAL_BLOCK_SIZE, 2 * last_block_size);
+        while (block_size < min_size)
+        {
+            block_size *= 2;
+        }
+
+        blocks.emplace_back(new char[block_size]);
+        current = blocks.back().get();
+        remaining = block_size;
+        last_block_size = block_size;
+        ++statistics.system_allocations;
+    }
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char *current;
+    std::size_t remaining;
+    std::size_t last_block_size;
+    Statistics statistics;
+};
+
+// Makes the thread's arena the current one for the lifetime of the scope and releases it at
+// the end. Nested scopes share the arena of the outermost one.
+class RequestArenaScope
+{
+  public:
+    RequestArenaScope();
+    ~RequestArenaScope();
+
+    RequestArenaScope(const RequestArenaScope &) = delete;
+    RequestArenaScope &operator=(const RequestArenaScope &) = delete;
+
+    RequestArena &GetArena() const { return arena; }
+
+  private:
+    RequestArena &arena;
+    bool is_outermost;
+};
+
+// Allocator handing out memory of the current request arena. Falls back to the global
+// allocator if no request is being handled, e.g. in tests and tools.
+template <typename T> class ArenaAllocator
+{
+  public:
+    using value_type = T;
+
+    ArenaAllocator() : arena(RequestArena::Current()) {}
+    explicit ArenaAllocator(RequestArena *arena) : arena(arena) {}
+    template <typename U> ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    T *allocate(const std::size_t n)
+    {
+        if (arena)
+        {
+            return static_cast<T *>(arena->Allocate(n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *pointer, const std::size_t)
+    {
+        if (!arena)
+        {
+            ::operator delete(pointer);
+        }
+    }
+
+    template <typename U> bool operator==(const ArenaAllocator<U> &other) const
+    {
+        return arena == other.arena;
+    }
+
+    template <typename U> bool operator!=(const ArenaAllocator<U> &other) const
+    {
+        return arena != other.arena;
+    }
+
+  private:
+    template <typename U> friend class ArenaAllocator;
+
+    RequestArena *arena;
+};
+
+// Vector whose memory is owned by the current request. Must not outlive the request.
+template <typename T> using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+}
+}
+
+#endif // REQUEST_ARENA_HPP
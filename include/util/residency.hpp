@@ -0,0 +1,134 @@
+#ifndef RESIDENCY_HPP
+#define RESIDENCY_HPP
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Returns how many bytes of the given memory are in RAM, counted in whole pages. Mapped files and
+// shared memory that were evicted from the page cache and heap memory that was never touched
+// count as not resident. Where mincore is not available all memory counts as resident.
+inline std::size_t GetResidentBytes(const void *ptr, const std::size_t size)
+{
+    if (ptr == nullptr || size == 0)
+    {
+        return 0;
+    }
+#if defined(__linux__) || defined(__APPLE__)
+    const auto page_size = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = reinterpret_cast<std::uintptr_t>(ptr) / page_size * page_size;
+    const auto end = reinterpret_cast<std::uintptr_t>(ptr) + size;
+    const auto number_of_pages = (end - begin + page_size - 1) / page_size;
+
+#if defined(__APPLE__)
+    std::vector<char> residency(number_of_pages);
+#else
+    std::vector<unsigned char> residency(number_of_pages);
+#endif
+    if (0 != mincore(reinterpret_cast<void *>(begin), end - begin, residency.data()))
+    {
+        return 0;
+    }
+
+    std::size_t resident_pages = 0;
+    for (const auto page : residency)
+    {
+        resident_pages += page & 1;
+    }
+    // the first and last page are only partly part of the memory
+    return std::min<std::size_t>(size, resident_pages * page_size);
+#else
+    return size;
+#endif
+}
+
+// Size of a block of data and how much of it is in RAM.
+struct MemoryStatistics
+{
+    std::string name;
+    std::size_t size;
+    std::size_t resident;
+};
+
+inline MemoryStatistics
+MakeMemoryStatistics(std::string name, const void *ptr, const std::size_t size)
+{
+    return {std::move(name), size, GetResidentBytes(ptr, size)};
+}
+
+// A named block of loaded data.
+struct MemoryBlock
+{
+    std::string name;
+    const void *ptr;
+    std::size_t size;
+};
+
+template <typename VectorT> MemoryBlock MakeMemoryBlock(std::string name, const VectorT &array)
+{
+    return {std::move(name), array.data(), array.size() * sizeof(typename VectorT::value_type)};
+}
+
+inline MemoryStatistics MakeMemoryStatistics(const MemoryBlock &block)
+{
+    return MakeMemoryStatistics(block.name, block.ptr, block.size);
+}
+
+// How much of a file is in the page cache. The file is mapped without reading any of it.
+inline MemoryStatistics MakeFileStatistics(std::string name, const boost::filesystem::path &path)
+{
+    if (!boost::filesystem::is_regular_file(path) || boost::filesystem::file_size(path) == 0)
+    {
+        return {std::move(name), 0, 0};
+    }
+    boost::interprocess::file_mapping file(path.string().c_str(), boost::interprocess::read_only);
+    boost::interprocess::mapped_region region(file, boost::interprocess::read_only);
+    return MakeMemoryStatistics(std::move(name), region.get_address(), region.get_size());
+}
+
+struct ProcessMemory
+{
+    std::size_t virtual_size;
+    std::size_t resident;
+};
+
+// Memory of the calling process, zero where /proc is not available.
+inline ProcessMemory GetProcessMemory()
+{
+    ProcessMemory memory{0, 0};
+#if defined(__linux__)
+    // sizes in pages: total program size, resident set size, ...
+    boost::filesystem::ifstream statm("/proc/self/statm");
+    std::size_t virtual_pages = 0, resident_pages = 0;
+    if (statm >> virtual_pages >> resident_pages)
+    {
+        const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        memory.virtual_size = virtual_pages * page_size;
+        memory.resident = resident_pages * page_size;
+    }
+#endif
+    return memory;
+}
+}
+}
+
+#endif // RESIDENCY_HPP
@@ -12,6 +12,7 @@
 #include <unordered_map>
 #include <fstream>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -31,6 +32,19 @@ populate_base_path(std::unordered_map<std::string, boost::filesystem::path> &ser
     if (path_iterator != server_paths.end())
     {
         const std::string base_string = path_iterator->second.string();
+
+        // a dataset written by osrm-pack contains all the other files
+        if (path_iterator->second.extension() == ".dataset")
+        {
+            if (!boost::filesystem::is_regular_file(path_iterator->second))
+            {
+                throw exception(".dataset not found");
+            }
+            server_paths["dataset"] = path_iterator->second;
+            SimpleLogger().Write() << "Dataset file:\t" << server_paths["dataset"];
+            return;
+        }
+
         SimpleLogger().Write() << "populating base path: " << base_string;
 
         server_paths["hsgrdata"] = base_string + ".hsgr";
@@ -51,6 +65,8 @@ populate_base_path(std::unordered_map<std::string, boost::filesystem::path> &ser
         BOOST_ASSERT(server_paths.find("namesdata") != server_paths.end());
         server_paths["timestamp"] = base_string + ".timestamp";
         BOOST_ASSERT(server_paths.find("timestamp") != server_paths.end());
+        server_paths["orderdata"] = base_string + ".order";
+        BOOST_ASSERT(server_paths.find("orderdata") != server_paths.end());
     }
 
     // check if files are give and whether they exist at all
@@ -111,6 +127,7 @@ populate_base_path(std::unordered_map<std::string, boost::filesystem::path> &ser
     SimpleLogger().Write(logDEBUG) << "Index file:\t" << server_paths["fileindex"];
     SimpleLogger().Write(logDEBUG) << "Names file:\t" << server_paths["namesdata"];
     SimpleLogger().Write(logDEBUG) << "Timestamp file:\t" << server_paths["timestamp"];
+    SimpleLogger().Write(logDEBUG) << "Order file:\t" << server_paths["orderdata"];
 }
 
 // generate boost::program_options object for the routing part
@@ -118,19 +135,37 @@ inline unsigned
 GenerateServerProgramOptions(const int argc,
                              const char *argv[],
                              std::unordered_map<std::string, boost::filesystem::path> &paths,
+                             std::unordered_map<std::string, boost::filesystem::path> &datasets,
                              std::string &ip_address,
                              int &ip_port,
                              int &requested_num_threads,
                              bool &use_shared_memory,
+                             bool &use_huge_pages,
+                             bool &use_compact_graph,
+                             bool &lazy_loading,
+                             bool &table_only,
+                             bool &use_numa,
                              bool &trial,
+                             bool &warm_up,
+                             std::vector<std::string> &warm_up_blocks,
+                             boost::filesystem::path &warm_up_queries,
                              int &max_locations_trip,
                              int &max_locations_viaroute,
                              int &max_locations_distance_table,
-                             int &max_locations_map_matching)
+                             int &max_locations_map_matching,
+                             int &unpacking_cache_size,
+                             int &route_cache_size,
+                             int &snapping_cache_size,
+                             int &max_matching_sessions,
+                             int &matching_session_timeout,
+                             int &max_locations_isochrone,
+                             int &max_pairs_batch_route)
 {
     using boost::program_options::value;
     using boost::filesystem::path;
 
+    std::vector<std::string> dataset_options;
+
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
     generic_options.add_options()                                         //
@@ -154,6 +189,10 @@ GenerateServerProgramOptions(const int argc,
          ".names file") //
         ("timestamp", value<boost::filesystem::path>(&paths["timestamp"]),
          ".timestamp file") //
+        ("orderdata", value<boost::filesystem::path>(&paths["orderdata"]),
+         ".order file") //
+        ("dataset", value<std::vector<std::string>>(&dataset_options)->composing(),
+         "Further dataset as <name>=<base.osrm>, queried with /<name>/<service>, repeatable") //
         ("ip,i", value<std::string>(&ip_address)->default_value("0.0.0.0"),
          "IP address") //
         ("port,p", value<int>(&ip_port)->default_value(5000),
@@ -163,6 +202,24 @@ GenerateServerProgramOptions(const int argc,
         ("shared-memory,s",
          value<bool>(&use_shared_memory)->implicit_value(true)->default_value(false),
          "Load data from shared memory") //
+        ("hugepages", value<bool>(&use_huge_pages)->implicit_value(true)->default_value(false),
+         "Back the graph and coordinates with huge pages if available") //
+        ("compact-graph",
+         value<bool>(&use_compact_graph)->implicit_value(true)->default_value(false),
+         "Bit-pack the edges of the search graph to save memory, queries get slower") //
+        ("lazy-loading", value<bool>(&lazy_loading)->implicit_value(true)->default_value(false),
+         "Load names, turn instructions and geometries on the first query that needs them") //
+        ("table-only", value<bool>(&table_only)->implicit_value(true)->default_value(false),
+         "Serve only distance tables and isochrones, without loading the data of routes") //
+        ("numa", value<bool>(&use_numa)->implicit_value(true)->default_value(false),
+         "Keep a copy of the data on every NUMA node and pin the server threads to the nodes, "
+         "the parallel parts of a request still run on any node") //
+        ("warm-up", value<bool>(&warm_up)->implicit_value(true)->default_value(false),
+         "Page in the data before accepting connections") //
+        ("warm-up-block", value<std::vector<std::string>>(&warm_up_blocks)->composing(),
+         "Only page in this block as named by the memory service, repeatable") //
+        ("warm-up-queries", value<boost::filesystem::path>(&warm_up_queries),
+         "Replay the request paths in this file, one per line, before accepting connections") //
         ("max-viaroute-size", value<int>(&max_locations_viaroute)->default_value(500),
          "Max. locations supported in viaroute query") //
         ("max-trip-size", value<int>(&max_locations_trip)->default_value(100),
@@ -170,7 +227,22 @@ GenerateServerProgramOptions(const int argc,
         ("max-table-size", value<int>(&max_locations_distance_table)->default_value(100),
          "Max. locations supported in distance table query") //
         ("max-matching-size", value<int>(&max_locations_map_matching)->default_value(100),
-         "Max. locations supported in map matching query");
+         "Max. locations supported in map matching query") //
+        ("unpacking-cache-size", value<int>(&unpacking_cache_size)->default_value(0),
+         "Memory in MiB used to cache unpacked shortcuts of long routes (0 = disabled)") //
+        ("route-cache-size", value<int>(&route_cache_size)->default_value(0),
+         "Number of route responses to cache for repeated queries (0 = disabled)") //
+        ("snapping-cache-size", value<int>(&snapping_cache_size)->default_value(0),
+         "Number of snapped coordinates to cache for repeated locations (0 = disabled)") //
+        ("max-matching-sessions", value<int>(&max_matching_sessions)->default_value(0),
+         "Max. open sessions of the online map matching (0 = disabled)") //
+        ("matching-session-timeout", value<int>(&matching_session_timeout)->default_value(300),
+         "Seconds after which an unused online map matching session is closed") //
+        ("max-isochrone-size", value<int>(&max_locations_isochrone)->default_value(10),
+         "Max. locations supported in isochrone query, every location takes 4 bytes per "
+         "graph node and thread while the query runs") //
+        ("max-batch-route-size", value<int>(&max_pairs_batch_route)->default_value(1000),
+         "Max. origin/destination pairs supported in batch route query");
 
     // hidden options, will be allowed both on command line and in config
     // file, but will not be shown to the user
@@ -229,6 +301,23 @@ GenerateServerProgramOptions(const int argc,
         return INIT_OK_START_ENGINE;
     }
 
+    for (const auto &dataset_option : dataset_options)
+    {
+        const auto separator = dataset_option.find('=');
+        const auto name = dataset_option.substr(0, separator);
+        if (separator == std::string::npos || name.empty() ||
+            name.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                   "0123456789_-") != std::string::npos)
+        {
+            throw exception("Dataset must be given as <name>=<base.osrm> with a name of letters, "
+                            "digits, _ and -");
+        }
+        if (!datasets.emplace(name, dataset_option.substr(separator + 1)).second)
+        {
+            throw exception("Dataset " + name + " is given twice");
+        }
+    }
+
     if (1 > requested_num_threads)
     {
         throw exception("Number of threads must be a positive number");
@@ -241,6 +330,22 @@ GenerateServerProgramOptions(const int argc,
     {
         throw exception("Max location for map matching must be at least two");
     }
+    if (1 > max_locations_isochrone)
+    {
+        throw exception("Max location for isochrones must be at least one");
+    }
+    if (1 > max_pairs_batch_route)
+    {
+        throw exception("Max pairs for batch routes must be at least one");
+    }
+    if (1 > matching_session_timeout)
+    {
+        throw exception("Timeout of map matching sessions must be a positive number");
+    }
+    if (!warm_up_queries.empty() && !boost::filesystem::is_regular_file(warm_up_queries))
+    {
+        throw exception("Warm-up queries " + warm_up_queries.string() + " not found");
+    }
 
     if (!use_shared_memory && option_variables.count("base"))
     {
@@ -2,6 +2,7 @@
 #define STATIC_GRAPH_HPP
 
 #include "util/percent.hpp"
+#include "util/residency.hpp"
 #include "util/shared_memory_vector_wrapper.hpp"
 #include "util/integer_range.hpp"
 #include "util/typedefs.hpp"
@@ -113,6 +114,12 @@ template <typename EdgeDataT, bool UseSharedMemory = false> class StaticGraph
 
     unsigned GetNumberOfEdges() const { return number_of_edges; }
 
+    std::vector<MemoryBlock> GetMemoryBlocks() const
+    {
+        return {MakeMemoryBlock("graph nodes", node_array),
+                MakeMemoryBlock("graph edges", edge_array)};
+    }
+
     unsigned GetOutDegree(const NodeIterator n) const { return EndEdges(n) - BeginEdges(n); }
 
     inline NodeIterator GetTarget(const EdgeIterator e) const
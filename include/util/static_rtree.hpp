@@ -11,6 +11,7 @@
 #include "util/integer_range.hpp"
 #include "util/mercator.hpp"
 #include "util/osrm_exception.hpp"
+#include "util/residency.hpp"
 #include "util/typedefs.hpp"
 
 #include "osrm/coordinate.hpp"
@@ -26,6 +27,8 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstdint>
 #include <limits>
 #include <memory>
 #include <queue>
@@ -37,6 +40,14 @@ namespace osrm
 namespace util
 {
 
+// Counts the leaves the queries of all threads read, from memory or from the leaf file. The
+// operating system caches the leaf file, how much of it is cached is its residency.
+struct LeafReadStatistics
+{
+    std::atomic<std::uint64_t> from_memory{0};
+    std::atomic<std::uint64_t> from_file{0};
+};
+
 // Static RTree for serving nearest neighbour queries
 template <class EdgeDataT,
           class CoordinateListT = std::vector<FixedPointCoordinate>,
@@ -105,6 +116,9 @@ class StaticRTree
     const std::string m_leaf_node_filename;
     std::shared_ptr<CoordinateListT> m_coordinate_list;
     boost::filesystem::ifstream leaves_stream;
+    // set if the leaves are in memory instead of the leaf file
+    const LeafNode *m_leaves = nullptr;
+    LeafReadStatistics *m_leaf_read_statistics = nullptr;
 
   public:
     StaticRTree() = delete;
@@ -322,6 +336,31 @@ class StaticRTree
         leaves_stream.read((char *)&m_element_count, sizeof(uint64_t));
     }
 
+    // The leaves are given in memory in the format of the leaf file, no file is read.
+    explicit StaticRTree(TreeNode *tree_node_ptr,
+                         const uint64_t number_of_nodes,
+                         const char *leaves_ptr,
+                         std::shared_ptr<CoordinateListT> coordinate_list)
+        : m_search_tree(tree_node_ptr, number_of_nodes),
+          m_coordinate_list(std::move(coordinate_list))
+    {
+        std::copy(leaves_ptr, leaves_ptr + sizeof(uint64_t),
+                  reinterpret_cast<char *>(&m_element_count));
+        m_leaves = reinterpret_cast<const LeafNode *>(leaves_ptr + sizeof(uint64_t));
+    }
+
+    // the statistics are shared by the trees of all threads and outlive them
+    void SetLeafReadStatistics(LeafReadStatistics *statistics)
+    {
+        m_leaf_read_statistics = statistics;
+    }
+
+    MemoryBlock GetSearchTreeBlock(std::string name) const
+    {
+        return {std::move(name), m_search_tree.empty() ? nullptr : &m_search_tree[0],
+                m_search_tree.size() * sizeof(TreeNode)};
+    }
+
     // Override filter and terminator for the desired behaviour.
     std::vector<EdgeDataT> Nearest(const FixedPointCoordinate &input_coordinate,
                                    const std::size_t max_results)
@@ -405,6 +444,69 @@ class StaticRTree
         return results;
     }
 
+    // Calls visitor on every object stored in the leaf file, in on-disk order.
+    template <typename VisitorT>
+    static void VisitLeafObjects(const boost::filesystem::path &leaf_file, VisitorT visitor)
+    {
+        boost::filesystem::ifstream leaf_stream(leaf_file, std::ios::binary);
+        if (!leaf_stream)
+        {
+            throw exception("Could not open leaf file " + leaf_file.string());
+        }
+        uint64_t element_count = 0;
+        leaf_stream.read((char *)&element_count, sizeof(uint64_t));
+
+        LeafNode current_leaf;
+        for (uint64_t processed_objects = 0; processed_objects < element_count;
+             processed_objects += current_leaf.object_count)
+        {
+            leaf_stream.read((char *)&current_leaf, sizeof(LeafNode));
+            if (!leaf_stream || 0 == current_leaf.object_count)
+            {
+                throw exception("Leaf file " + leaf_file.string() + " is truncated");
+            }
+            for (const auto i : irange(0u, current_leaf.object_count))
+            {
+                visitor(static_cast<const EdgeDataT &>(current_leaf.objects[i]));
+            }
+        }
+    }
+
+    // Rewrites every object stored in the leaf file in place. The tree structure does not
+    // change, so the updater must not modify anything that the bounding boxes depend on.
+    template <typename UpdaterT>
+    static void UpdateLeafObjects(const boost::filesystem::path &leaf_file, UpdaterT updater)
+    {
+        boost::filesystem::fstream leaf_stream(leaf_file,
+                                               std::ios::in | std::ios::out | std::ios::binary);
+        if (!leaf_stream)
+        {
+            throw exception("Could not open leaf file " + leaf_file.string());
+        }
+        uint64_t element_count = 0;
+        leaf_stream.read((char *)&element_count, sizeof(uint64_t));
+
+        LeafNode current_leaf;
+        uint64_t leaf_position = sizeof(uint64_t);
+        for (uint64_t processed_objects = 0; processed_objects < element_count;
+             processed_objects += current_leaf.object_count)
+        {
+            leaf_stream.seekg(leaf_position);
+            leaf_stream.read((char *)&current_leaf, sizeof(LeafNode));
+            if (!leaf_stream || 0 == current_leaf.object_count)
+            {
+                throw exception("Leaf file " + leaf_file.string() + " is truncated");
+            }
+            for (const auto i : irange(0u, current_leaf.object_count))
+            {
+                updater(current_leaf.objects[i]);
+            }
+            leaf_stream.seekp(leaf_position);
+            leaf_stream.write((char *)&current_leaf, sizeof(LeafNode));
+            leaf_position += sizeof(LeafNode);
+        }
+    }
+
   private:
     template <typename QueueT>
     void ExploreLeafNode(const std::uint32_t leaf_id,
@@ -448,6 +550,19 @@ class StaticRTree
 
     inline void LoadLeafFromDisk(const uint32_t leaf_id, LeafNode &result_node)
     {
+        if (m_leaves)
+        {
+            if (m_leaf_read_statistics)
+            {
+                m_leaf_read_statistics->from_memory.fetch_add(1, std::memory_order_relaxed);
+            }
+            result_node = m_leaves[leaf_id];
+            return;
+        }
+        if (m_leaf_read_statistics)
+        {
+            m_leaf_read_statistics->from_file.fetch_add(1, std::memory_order_relaxed);
+        }
         if (!leaves_stream.is_open())
         {
             leaves_stream.open(m_leaf_node_filename, std::ios::in | std::ios::binary);
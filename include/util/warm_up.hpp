@@ -0,0 +1,108 @@
+#ifndef WARM_UP_HPP
+#define WARM_UP_HPP
+
+#include "util/residency.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace detail
+{
+inline std::size_t GetPageSize()
+{
+#if defined(__linux__) || defined(__APPLE__)
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 4096;
+#endif
+}
+
+// reads one byte of every page, the pages of mapped files and shared memory are paged in
+inline void TouchPages(const void *ptr, const std::size_t size, const std::size_t page_size)
+{
+#if defined(__linux__) || defined(__APPLE__)
+    // starts the reads of all pages before the first one blocks
+    const auto begin = reinterpret_cast<std::uintptr_t>(ptr) / page_size * page_size;
+    const auto end = reinterpret_cast<std::uintptr_t>(ptr) + size;
+    (void)madvise(reinterpret_cast<void *>(begin), end - begin, MADV_WILLNEED);
+#endif
+    const auto *bytes = static_cast<const volatile char *>(ptr);
+    for (std::size_t offset = 0; offset < size; offset += page_size)
+    {
+        (void)bytes[offset];
+    }
+    (void)bytes[size - 1];
+}
+}
+
+// Pages in mapped files and shared memory that were evicted or never read, so that the first
+// queries after a restart or a data swap do not wait for the disk. The blocks are cut into chunks
+// that are paged in in parallel. Returns the number of bytes that were paged in.
+inline std::size_t PageIn(const std::vector<MemoryBlock> &blocks)
+{
+    // large enough for readahead, small enough to spread a single block over all threads
+    static const constexpr std::size_t CHUNK_SIZE = 16 * 1024 * 1024;
+
+    std::vector<std::pair<const char *, std::size_t>> chunks;
+    for (const auto &block : blocks)
+    {
+        for (std::size_t offset = 0; offset < block.size; offset += CHUNK_SIZE)
+        {
+            chunks.emplace_back(static_cast<const char *>(block.ptr) + offset,
+                                std::min(CHUNK_SIZE, block.size - offset));
+        }
+    }
+
+    const auto page_size = detail::GetPageSize();
+    std::atomic<std::size_t> paged_in(0);
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, chunks.size(), 1),
+                      [&](const tbb::blocked_range<std::size_t> &range)
+                      {
+                          for (auto index = range.begin(); index != range.end(); ++index)
+                          {
+                              detail::TouchPages(chunks[index].first, chunks[index].second,
+                                                 page_size);
+                              paged_in.fetch_add(chunks[index].second, std::memory_order_relaxed);
+                          }
+                      });
+    return paged_in.load();
+}
+
+// Reads a file into the page cache, it stays there after the mapping is gone.
+inline std::size_t PageInFile(const std::string &name, const boost::filesystem::path &path)
+{
+    if (!boost::filesystem::is_regular_file(path) || boost::filesystem::file_size(path) == 0)
+    {
+        return 0;
+    }
+    boost::interprocess::file_mapping file(path.string().c_str(), boost::interprocess::read_only);
+    boost::interprocess::mapped_region region(file, boost::interprocess::read_only);
+    return PageIn({{name, region.get_address(), region.get_size()}});
+}
+}
+}
+
+#endif // WARM_UP_HPP
@@ -0,0 +1,176 @@
+#include "extractor/query_node.hpp"
+#include "util/make_unique.hpp"
+#include "util/numa.hpp"
+#include "util/routed_options.hpp"
+#include "util/simple_logger.hpp"
+#include "util/timing_util.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/libosrm_config.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/route_parameters.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+
+using CoordinatePair = std::pair<util::FixedPointCoordinate, util::FixedPointCoordinate>;
+
+std::vector<CoordinatePair> sampleQueries(const boost::filesystem::path &nodes_file,
+                                          unsigned num_queries)
+{
+    boost::filesystem::ifstream nodes_input_stream(nodes_file, std::ios::binary);
+    unsigned coordinate_count = 0;
+    nodes_input_stream.read((char *)&coordinate_count, sizeof(unsigned));
+    std::vector<extractor::QueryNode> nodes(coordinate_count);
+    nodes_input_stream.read((char *)nodes.data(), coordinate_count * sizeof(extractor::QueryNode));
+
+    std::mt19937 mt_rand(RANDOM_SEED);
+    std::uniform_int_distribution<std::size_t> index_udist(0, nodes.size() - 1);
+    std::vector<CoordinatePair> queries;
+    for (unsigned i = 0; i < num_queries && !nodes.empty(); i++)
+    {
+        const auto &source = nodes[index_udist(mt_rand)];
+        const auto &target = nodes[index_udist(mt_rand)];
+        queries.emplace_back(util::FixedPointCoordinate(source.lat, source.lon),
+                             util::FixedPointCoordinate(target.lat, target.lon));
+    }
+    return queries;
+}
+
+// Runs all queries on num_threads threads that take the next query from a shared counter. With
+// pinning, thread i runs on node i % number of nodes and queries the routing machine of its node.
+void benchmarkThroughput(const std::vector<OSRM *> &routing_machines,
+                         const std::vector<CoordinatePair> &queries,
+                         const unsigned num_threads,
+                         const bool pin_threads,
+                         const std::string &name)
+{
+    std::cout << "Running " << name << " with " << queries.size() << " queries on "
+              << num_threads << " threads: " << std::flush;
+
+    const auto &topology = util::NUMATopology::Get();
+    std::atomic<std::size_t> next_query(0);
+    std::atomic<unsigned> num_found(0);
+    const auto run_queries = [&](const unsigned node)
+    {
+        if (pin_threads)
+        {
+            topology.PinThreadToNode(node);
+        }
+        auto &routing_machine = *routing_machines[node % routing_machines.size()];
+        for (auto i = next_query++; i < queries.size(); i = next_query++)
+        {
+            RouteParameters route_parameters;
+            route_parameters.zoom_level = 18;
+            route_parameters.print_instructions = false;
+            route_parameters.alternate_route = false;
+            route_parameters.geometry = false;
+            route_parameters.check_sum = -1;
+            route_parameters.service = "viaroute";
+            route_parameters.coordinates.push_back(queries[i].first);
+            route_parameters.coordinates.push_back(queries[i].second);
+
+            util::json::Object json_result;
+            if (routing_machine.RunQuery(route_parameters, json_result) == 200)
+            {
+                ++num_found;
+            }
+        }
+    };
+
+    TIMER_START(query);
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < num_threads; ++i)
+    {
+        threads.emplace_back(run_queries, i % topology.GetNumberOfNodes());
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    TIMER_STOP(query);
+
+    std::cout << "Took " << TIMER_SEC(query) << " seconds "
+              << "(" << num_found << " routes found)  ->  " << queries.size() / TIMER_SEC(query)
+              << " queries/s" << std::endl;
+}
+}
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cout << "./numa-bench file.osrm [number of queries] [number of threads]"
+                  << "\n";
+        return 1;
+    }
+
+    const unsigned num_queries = argc > 2 ? std::atoi(argv[2]) : 10000;
+    const unsigned num_threads =
+        argc > 3 ? std::atoi(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+
+    osrm::LibOSRMConfig lib_config;
+    lib_config.use_shared_memory = false;
+    lib_config.server_paths["base"] = argv[1];
+    osrm::util::populate_base_path(lib_config.server_paths);
+
+    const auto queries =
+        osrm::benchmarks::sampleQueries(lib_config.server_paths["nodesdata"], num_queries);
+    if (queries.empty())
+    {
+        std::cout << "No coordinates found in " << lib_config.server_paths["nodesdata"] << "\n";
+        return 1;
+    }
+
+    const auto &topology = osrm::util::NUMATopology::Get();
+    std::cout << topology.GetNumberOfNodes() << " NUMA nodes\n";
+
+    {
+        osrm::OSRM routing_machine(lib_config);
+        osrm::benchmarks::benchmarkThroughput({&routing_machine}, queries, num_threads, false,
+                                              "single copy");
+    }
+
+    if (topology.IsNUMA())
+    {
+        const auto create_replica = [&lib_config]
+        {
+            auto node_config = lib_config;
+            return osrm::util::make_unique<osrm::OSRM>(node_config);
+        };
+        const auto replicas = topology.CreateReplicas<osrm::OSRM>(create_replica);
+        std::vector<osrm::OSRM *> routing_machines;
+        for (const auto &replica : replicas)
+        {
+            routing_machines.push_back(replica.get());
+        }
+        osrm::benchmarks::benchmarkThroughput(routing_machines, queries, num_threads, true,
+                                              "copy per NUMA node");
+    }
+    else
+    {
+        std::cout << "Not a NUMA machine, skipping the copy per NUMA node\n";
+    }
+
+    return 0;
+}
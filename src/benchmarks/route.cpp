@@ -0,0 +1,334 @@
+#include "extractor/query_node.hpp"
+#include "util/integer_range.hpp"
+#include "util/routed_options.hpp"
+#include "util/simple_logger.hpp"
+#include "util/timing_util.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/libosrm_config.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/route_parameters.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+// traces are cut to the default limit of points of a match request
+constexpr std::size_t MAX_TRACE_LENGTH = 100;
+// distance tables of a few sources to a growing number of targets
+constexpr unsigned TABLE_SOURCES = 16;
+constexpr unsigned TABLE_ROUNDS = 10;
+
+using CoordinatePair = std::pair<util::FixedPointCoordinate, util::FixedPointCoordinate>;
+
+std::vector<util::FixedPointCoordinate> loadCoordinates(const boost::filesystem::path &nodes_file)
+{
+    boost::filesystem::ifstream nodes_input_stream(nodes_file, std::ios::binary);
+
+    extractor::QueryNode current_node;
+    unsigned coordinate_count = 0;
+    nodes_input_stream.read((char *)&coordinate_count, sizeof(unsigned));
+    std::vector<util::FixedPointCoordinate> coords(coordinate_count);
+    for (unsigned i = 0; i < coordinate_count; ++i)
+    {
+        nodes_input_stream.read((char *)&current_node, sizeof(extractor::QueryNode));
+        coords[i] = util::FixedPointCoordinate(current_node.lat, current_node.lon);
+    }
+    return coords;
+}
+
+// Samples both endpoints from the coordinates of the dataset, so every query snaps
+// to the road network and actually exercises the routing search.
+std::vector<CoordinatePair>
+sampleQueries(const std::vector<util::FixedPointCoordinate> &coords, unsigned num_queries)
+{
+    std::mt19937 mt_rand(RANDOM_SEED);
+    std::uniform_int_distribution<std::size_t> index_udist(0, coords.size() - 1);
+    std::vector<CoordinatePair> queries;
+    for (unsigned i = 0; i < num_queries; i++)
+    {
+        queries.emplace_back(coords[index_udist(mt_rand)], coords[index_udist(mt_rand)]);
+    }
+    return queries;
+}
+
+void benchmarkRoutes(OSRM &routing_machine,
+                     const std::vector<CoordinatePair> &queries,
+                     const std::string &name,
+                     const short number_of_alternatives)
+{
+    std::cout << "Running " << name << " with " << queries.size() << " queries: " << std::flush;
+
+    unsigned num_found = 0;
+    TIMER_START(query);
+    for (const auto &q : queries)
+    {
+        RouteParameters route_parameters;
+        route_parameters.zoom_level = 18;
+        route_parameters.print_instructions = false;
+        route_parameters.alternate_route = number_of_alternatives > 0;
+        route_parameters.SetNumberOfAlternatives(number_of_alternatives);
+        route_parameters.geometry = false;
+        route_parameters.check_sum = -1;
+        route_parameters.service = "viaroute";
+        route_parameters.coordinates.push_back(q.first);
+        route_parameters.coordinates.push_back(q.second);
+
+        util::json::Object json_result;
+        if (routing_machine.RunQuery(route_parameters, json_result) == 200)
+        {
+            ++num_found;
+        }
+    }
+    TIMER_STOP(query);
+
+    std::cout << "Took " << TIMER_SEC(query) << " seconds "
+              << "(" << num_found << " routes found)  ->  " << TIMER_MSEC(query) / queries.size()
+              << " ms/query" << std::endl;
+}
+
+// Turns the routes between the sampled queries into traces, so the points lie on the road
+// network. The points are the vertices of the route geometry.
+std::vector<std::vector<util::FixedPointCoordinate>>
+sampleTraces(OSRM &routing_machine, const std::vector<CoordinatePair> &queries)
+{
+    std::vector<std::vector<util::FixedPointCoordinate>> traces;
+    for (const auto &q : queries)
+    {
+        RouteParameters route_parameters;
+        route_parameters.zoom_level = 18;
+        route_parameters.print_instructions = false;
+        route_parameters.geometry = true;
+        route_parameters.compression = true;
+        route_parameters.check_sum = -1;
+        route_parameters.service = "viaroute";
+        route_parameters.coordinates.push_back(q.first);
+        route_parameters.coordinates.push_back(q.second);
+
+        util::json::Object json_result;
+        if (routing_machine.RunQuery(route_parameters, json_result) != 200)
+        {
+            continue;
+        }
+        RouteParameters trace;
+        trace.SetCoordinatesFromGeometry(
+            json_result.values["route_geometry"].get<util::json::String>().value);
+        if (trace.coordinates.size() > MAX_TRACE_LENGTH)
+        {
+            trace.coordinates.resize(MAX_TRACE_LENGTH);
+        }
+        if (trace.coordinates.size() > 1)
+        {
+            traces.push_back(std::move(trace.coordinates));
+        }
+    }
+    return traces;
+}
+
+// Matches every trace once with a single match request and once by pushing the points one
+// at a time to a matchstream session, which is how a tracking client would use it.
+void benchmarkMatching(OSRM &routing_machine,
+                       const std::vector<std::vector<util::FixedPointCoordinate>> &traces)
+{
+    std::size_t number_of_points = 0;
+    for (const auto &trace : traces)
+    {
+        number_of_points += trace.size();
+    }
+    std::cout << "Running match and matchstream with " << traces.size() << " traces of "
+              << number_of_points << " points" << std::endl;
+    if (number_of_points == 0)
+    {
+        return;
+    }
+
+    unsigned num_found = 0;
+    TIMER_START(match);
+    for (const auto &trace : traces)
+    {
+        RouteParameters route_parameters;
+        route_parameters.geometry = false;
+        route_parameters.check_sum = -1;
+        route_parameters.service = "match";
+        route_parameters.coordinates = trace;
+
+        util::json::Object json_result;
+        if (routing_machine.RunQuery(route_parameters, json_result) == 200)
+        {
+            ++num_found;
+        }
+    }
+    TIMER_STOP(match);
+    std::cout << "  match:       " << TIMER_SEC(match) << " seconds (" << num_found
+              << " traces matched)  ->  " << number_of_points / std::max(TIMER_SEC(match), 1e-9)
+              << " points/second" << std::endl;
+
+    num_found = 0;
+    TIMER_START(matchstream);
+    for (const auto &trace : traces)
+    {
+        std::string session_id;
+        bool failed = false;
+        for (const auto i : util::irange<std::size_t>(0, trace.size()))
+        {
+            RouteParameters route_parameters;
+            route_parameters.check_sum = -1;
+            route_parameters.service = "matchstream";
+            route_parameters.SetSession(session_id);
+            route_parameters.SetCloseSession(i + 1 == trace.size());
+            route_parameters.coordinates.push_back(trace[i]);
+
+            util::json::Object json_result;
+            if (routing_machine.RunQuery(route_parameters, json_result) != 200)
+            {
+                failed = true;
+                break;
+            }
+            if (session_id.empty())
+            {
+                session_id = json_result.values["session"].get<util::json::String>().value;
+            }
+        }
+        num_found += !failed;
+    }
+    TIMER_STOP(matchstream);
+    std::cout << "  matchstream: " << TIMER_SEC(matchstream) << " seconds (" << num_found
+              << " sessions completed)  ->  "
+              << number_of_points / std::max(TIMER_SEC(matchstream), 1e-9) << " points/second, "
+              << TIMER_MSEC(matchstream) / number_of_points << " ms/point" << std::endl;
+}
+
+// Average ms of a distance table from TABLE_SOURCES sources to each number of targets.
+std::vector<double> timeTables(OSRM &routing_machine,
+                               const std::vector<util::FixedPointCoordinate> &coords,
+                               const std::vector<unsigned> &target_counts)
+{
+    std::mt19937 mt_rand(RANDOM_SEED);
+    std::uniform_int_distribution<std::size_t> index_udist(0, coords.size() - 1);
+    std::vector<double> ms_per_table;
+    for (const auto number_of_targets : target_counts)
+    {
+        RouteParameters route_parameters;
+        route_parameters.check_sum = -1;
+        route_parameters.service = "table";
+        for (const auto i : util::irange(0u, TABLE_SOURCES + number_of_targets))
+        {
+            route_parameters.coordinates.push_back(coords[index_udist(mt_rand)]);
+            route_parameters.is_source.push_back(i < TABLE_SOURCES);
+            route_parameters.is_destination.push_back(i >= TABLE_SOURCES);
+        }
+
+        TIMER_START(table);
+        for (unsigned round = 0; round < TABLE_ROUNDS; ++round)
+        {
+            util::json::Object json_result;
+            routing_machine.RunQuery(route_parameters, json_result);
+        }
+        TIMER_STOP(table);
+        ms_per_table.push_back(TIMER_MSEC(table) / TABLE_ROUNDS);
+    }
+    return ms_per_table;
+}
+
+// Runs the same distance tables once with the buckets and once with the sweep over the
+// restricted graph, to choose min_targets_for_sweep where the sweep starts to be faster.
+void benchmarkTables(LibOSRMConfig lib_config,
+                     const std::vector<util::FixedPointCoordinate> &coords)
+{
+    const std::vector<unsigned> target_counts = {32, 64, 128, 256, 512, 1024, 2048, 4096};
+    std::cout << "Running distance tables from " << TABLE_SOURCES << " sources, "
+              << TABLE_ROUNDS << " rounds each" << std::endl;
+
+    lib_config.min_targets_for_sweep = std::numeric_limits<int>::max();
+    std::vector<double> buckets_ms;
+    {
+        OSRM routing_machine(lib_config);
+        buckets_ms = timeTables(routing_machine, coords, target_counts);
+    }
+    lib_config.min_targets_for_sweep = 0;
+    std::vector<double> sweep_ms;
+    {
+        OSRM routing_machine(lib_config);
+        sweep_ms = timeTables(routing_machine, coords, target_counts);
+    }
+
+    std::cout << std::setw(8) << "targets" << std::setw(14) << "buckets ms" << std::setw(14)
+              << "sweep ms" << std::endl;
+    for (const auto i : util::irange<std::size_t>(0, target_counts.size()))
+    {
+        std::cout << std::setw(8) << target_counts[i] << std::setw(14) << buckets_ms[i]
+                  << std::setw(14) << sweep_ms[i] << std::endl;
+    }
+}
+}
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cout << "./route-bench file.osrm [number of queries] [hugepages] [compact] [table]"
+                  << "\n";
+        return 1;
+    }
+
+    const unsigned num_queries = argc > 2 ? std::atoi(argv[2]) : 1000;
+
+    osrm::LibOSRMConfig lib_config;
+    lib_config.use_shared_memory = false;
+    lib_config.max_matching_sessions = 16;
+    // run once with and once without to compare the query latency
+    bool tables_only = false;
+    for (int i = 3; i < argc; ++i)
+    {
+        tables_only |= std::string(argv[i]) == "table";
+        lib_config.use_huge_pages |= std::string(argv[i]) == "hugepages";
+        lib_config.use_compact_graph |= std::string(argv[i]) == "compact";
+    }
+    std::cout << "Using " << (lib_config.use_huge_pages ? "huge pages" : "regular pages")
+              << " and " << (lib_config.use_compact_graph ? "the compact graph" : "the graph")
+              << "\n";
+    lib_config.server_paths["base"] = argv[1];
+    osrm::util::populate_base_path(lib_config.server_paths);
+
+    const auto coords = osrm::benchmarks::loadCoordinates(lib_config.server_paths["nodesdata"]);
+    if (coords.empty())
+    {
+        std::cout << "No coordinates found in " << lib_config.server_paths["nodesdata"] << "\n";
+        return 1;
+    }
+    if (tables_only)
+    {
+        osrm::benchmarks::benchmarkTables(lib_config, coords);
+        return 0;
+    }
+    const auto queries = osrm::benchmarks::sampleQueries(coords, num_queries);
+
+    osrm::OSRM routing_machine(lib_config);
+
+    osrm::benchmarks::benchmarkRoutes(routing_machine, queries, "viaroute queries", 0);
+    osrm::benchmarks::benchmarkRoutes(routing_machine, queries, "viaroute queries with alternatives",
+                                      1);
+    osrm::benchmarks::benchmarkRoutes(routing_machine, queries,
+                                      "viaroute queries with 3 alternatives", 3);
+    osrm::benchmarks::benchmarkMatching(
+        routing_machine, osrm::benchmarks::sampleTraces(routing_machine, queries));
+
+    return 0;
+}
@@ -0,0 +1,212 @@
+#include "contractor/query_edge.hpp"
+#include "util/binary_heap.hpp"
+#include "util/graph_loader.hpp"
+#include "util/huge_pages.hpp"
+#include "util/packed_static_graph.hpp"
+#include "util/routed_options.hpp"
+#include "util/static_graph.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include "osrm/libosrm_config.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+
+using EdgeData = contractor::QueryEdge::EdgeData;
+using Graph = util::StaticGraph<EdgeData>;
+using PackedGraph = util::PackedStaticGraph<EdgeData>;
+
+struct HeapData
+{
+    NodeID parent;
+    /* explicit */ HeapData(NodeID p) : parent(p) {}
+};
+using QueryHeap = util::BinaryHeap<NodeID, NodeID, int, HeapData>;
+
+// One step of the bidirectional search on the contraction hierarchy, the same relaxation with
+// stall-on-demand as RoutingStep of the engine but on the graph directly.
+template <typename GraphT>
+void routingStep(const GraphT &graph,
+                 QueryHeap &forward_heap,
+                 const QueryHeap &reverse_heap,
+                 int &upper_bound,
+                 const bool forward_direction)
+{
+    const NodeID node = forward_heap.DeleteMin();
+    const int distance = forward_heap.GetKey(node);
+
+    if (reverse_heap.WasInserted(node))
+    {
+        upper_bound = std::min(upper_bound, reverse_heap.GetKey(node) + distance);
+    }
+    if (distance > upper_bound)
+    {
+        forward_heap.DeleteAll();
+        return;
+    }
+
+    for (const auto edge : graph.GetAdjacentEdgeRange(node))
+    {
+        const auto &data = graph.GetEdgeData(edge);
+        if (forward_direction ? data.backward : data.forward)
+        {
+            const NodeID to = graph.GetTarget(edge);
+            if (forward_heap.WasInserted(to) && forward_heap.GetKey(to) + data.distance < distance)
+            {
+                return;
+            }
+        }
+    }
+
+    for (const auto edge : graph.GetAdjacentEdgeRange(node))
+    {
+        const auto &data = graph.GetEdgeData(edge);
+        if (forward_direction ? data.forward : data.backward)
+        {
+            const NodeID to = graph.GetTarget(edge);
+            const int to_distance = distance + data.distance;
+            if (!forward_heap.WasInserted(to))
+            {
+                forward_heap.Insert(to, to_distance, node);
+            }
+            else if (to_distance < forward_heap.GetKey(to))
+            {
+                forward_heap.GetData(to).parent = node;
+                forward_heap.DecreaseKey(to, to_distance);
+            }
+        }
+    }
+}
+
+template <typename GraphT>
+void benchmarkQueries(const GraphT &graph,
+                      const std::vector<std::pair<NodeID, NodeID>> &queries,
+                      const std::string &name)
+{
+    std::cout << "Running " << name << " with " << queries.size() << " queries: " << std::flush;
+
+    QueryHeap forward_heap(graph.GetNumberOfNodes());
+    QueryHeap reverse_heap(graph.GetNumberOfNodes());
+    // the sum of all distances, which has to be the same for every graph
+    std::uint64_t checksum = 0;
+    unsigned num_found = 0;
+
+    TIMER_START(query);
+    for (const auto &query : queries)
+    {
+        forward_heap.Clear();
+        reverse_heap.Clear();
+        forward_heap.Insert(query.first, 0, query.first);
+        reverse_heap.Insert(query.second, 0, query.second);
+
+        int upper_bound = INVALID_EDGE_WEIGHT;
+        while (0 < forward_heap.Size() + reverse_heap.Size())
+        {
+            if (!forward_heap.Empty())
+            {
+                routingStep(graph, forward_heap, reverse_heap, upper_bound, true);
+            }
+            if (!reverse_heap.Empty())
+            {
+                routingStep(graph, reverse_heap, forward_heap, upper_bound, false);
+            }
+        }
+        if (upper_bound != INVALID_EDGE_WEIGHT)
+        {
+            checksum += upper_bound;
+            ++num_found;
+        }
+    }
+    TIMER_STOP(query);
+
+    std::cout << "Took " << TIMER_SEC(query) << " seconds "
+              << "(" << num_found << " routes found, checksum " << checksum << ")  ->  "
+              << TIMER_MSEC(query) / queries.size() << " ms/query" << std::endl;
+}
+
+void printSize(const std::string &name, const std::size_t bytes, const unsigned number_of_edges)
+{
+    std::cout << name << ": " << bytes / (1024 * 1024) << " MiB, "
+              << (number_of_edges > 0 ? 8. * bytes / number_of_edges : 0.) << " bits per edge"
+              << std::endl;
+}
+}
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cout << "./graph-bench file.osrm [number of queries] [hugepages]"
+                  << "\n";
+        return 1;
+    }
+
+    const unsigned num_queries = argc > 2 ? std::atoi(argv[2]) : 10000;
+    // run once with and once without to compare the query latency
+    osrm::util::HugePages::Enable(argc > 3 && std::string(argv[3]) == "hugepages");
+    std::cout << "Using " << (osrm::util::HugePages::IsEnabled() ? "huge" : "regular")
+              << " pages" << std::endl;
+
+    using namespace osrm::benchmarks;
+
+    osrm::LibOSRMConfig lib_config;
+    lib_config.server_paths["base"] = argv[1];
+    osrm::util::populate_base_path(lib_config.server_paths);
+
+    std::vector<Graph::NodeArrayEntry> node_list;
+    std::vector<Graph::EdgeArrayEntry> edge_list;
+    unsigned check_sum = 0;
+    const auto number_of_nodes = osrm::util::readHSGRFromStream(
+        lib_config.server_paths["hsgrdata"], node_list, edge_list, &check_sum);
+    if (number_of_nodes < 2)
+    {
+        std::cout << "No graph found in " << lib_config.server_paths["hsgrdata"] << "\n";
+        return 1;
+    }
+
+    // the node list has a sentinel entry
+    std::mt19937 mt_rand(RANDOM_SEED);
+    std::uniform_int_distribution<NodeID> node_udist(0, number_of_nodes - 2);
+    std::vector<std::pair<NodeID, NodeID>> queries;
+    for (unsigned i = 0; i < num_queries; ++i)
+    {
+        queries.emplace_back(node_udist(mt_rand), node_udist(mt_rand));
+    }
+
+    auto packed_node_list = node_list;
+    auto packed_edge_list = edge_list;
+    const auto number_of_edges = static_cast<unsigned>(edge_list.size());
+    const auto graph_size = node_list.size() * sizeof(Graph::NodeArrayEntry) +
+                            edge_list.size() * sizeof(Graph::EdgeArrayEntry);
+
+    {
+        Graph graph(node_list, edge_list);
+        printSize("StaticGraph", graph_size, number_of_edges);
+        benchmarkQueries(graph, queries, "StaticGraph");
+    }
+
+    {
+        PackedGraph graph(packed_node_list, packed_edge_list);
+        printSize("PackedStaticGraph", graph.GetSizeInBytes(), number_of_edges);
+        std::cout << "PackedStaticGraph records have " << graph.GetRecordBits() << " bits"
+                  << std::endl;
+        benchmarkQueries(graph, queries, "PackedStaticGraph");
+    }
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include "engine/trip/trip_brute_force.hpp"
+#include "util/dist_table_wrapper.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+
+// Travel times between random locations on a plane with a random detour for each direction,
+// like the distance tables of trip requests.
+util::DistTableWrapper<EdgeWeight> randomTable(const std::size_t number_of_locations,
+                                               std::mt19937 &mt_rand)
+{
+    std::uniform_real_distribution<double> coordinate_udist(0, 10000);
+    std::uniform_real_distribution<double> detour_udist(1.0, 1.5);
+    std::vector<std::pair<double, double>> locations(number_of_locations);
+    for (auto &location : locations)
+    {
+        location = std::make_pair(coordinate_udist(mt_rand), coordinate_udist(mt_rand));
+    }
+
+    std::vector<EdgeWeight> table(number_of_locations * number_of_locations, 0);
+    for (std::size_t from = 0; from < number_of_locations; ++from)
+    {
+        for (std::size_t to = 0; to < number_of_locations; ++to)
+        {
+            if (from != to)
+            {
+                const auto distance =
+                    std::hypot(locations[from].first - locations[to].first,
+                               locations[from].second - locations[to].second);
+                table[from * number_of_locations + to] =
+                    static_cast<EdgeWeight>(distance * detour_udist(mt_rand));
+            }
+        }
+    }
+    return util::DistTableWrapper<EdgeWeight>(std::move(table), number_of_locations);
+}
+
+void benchmarkTrips(const std::size_t number_of_locations, const unsigned num_trips)
+{
+    std::mt19937 mt_rand(RANDOM_SEED);
+    std::vector<util::DistTableWrapper<EdgeWeight>> tables;
+    tables.reserve(num_trips);
+    for (unsigned i = 0; i < num_trips; ++i)
+    {
+        tables.push_back(randomTable(number_of_locations, mt_rand));
+    }
+    std::vector<NodeID> locations(number_of_locations);
+    std::iota(locations.begin(), locations.end(), 0);
+
+    std::cout << "Running exact trips of " << number_of_locations << " locations: " << std::flush;
+
+    std::size_t checksum = 0;
+    TIMER_START(trips);
+    for (const auto &table : tables)
+    {
+        const auto trip = engine::trip::BruteForceTrip(locations.cbegin(), locations.cend(),
+                                                       number_of_locations, table);
+        checksum += trip.back();
+    }
+    TIMER_STOP(trips);
+
+    std::cout << "Took " << TIMER_SEC(trips) << " seconds "
+              << "(checksum " << checksum << ")  ->  " << TIMER_MSEC(trips) / num_trips
+              << " ms/trip" << std::endl;
+}
+}
+}
+
+int main(int argc, char **argv)
+{
+    const std::size_t max_locations =
+        argc > 1 ? std::atoi(argv[1]) : osrm::engine::trip::BF_MAX_LOCATIONS - 4;
+    const unsigned num_trips = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    if (max_locations > osrm::engine::trip::BF_MAX_LOCATIONS || num_trips == 0)
+    {
+        std::cout << "./trip-bench [max number of locations <= "
+                  << osrm::engine::trip::BF_MAX_LOCATIONS << "] [number of trips]"
+                  << "\n";
+        return 1;
+    }
+
+    for (std::size_t number_of_locations = 4; number_of_locations <= max_locations;
+         ++number_of_locations)
+    {
+        osrm::benchmarks::benchmarkTrips(number_of_locations, num_trips);
+    }
+
+    return 0;
+}
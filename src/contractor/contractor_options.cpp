@@ -43,7 +43,12 @@ ContractorOptions::ParseArguments(int argc, char *argv[], ContractorConfig &cont
         "Lookup file containing nodeA,nodeB,speed data to adjust edge weights")(
         "level-cache,o", boost::program_options::value<bool>(&contractor_config.use_cached_priority)
                              ->default_value(false),
-        "Use .level file to retain the contaction level for each node from the last run.");
+        "Use .level file to retain the contaction level for each node from the last run.")(
+        "renumber-nodes",
+        boost::program_options::value<bool>(&contractor_config.renumber_nodes)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Renumber nodes by contraction level and spatial order to improve query cache locality");
 
 #ifdef DEBUG_GEOMETRY
     config_options.add_options()(
@@ -123,6 +128,12 @@ void ContractorOptions::GenerateOutputFilesNames(ContractorConfig &contractor_co
         contractor_config.osrm_input_path.string() + ".edge_segment_lookup";
     contractor_config.edge_penalty_path =
         contractor_config.osrm_input_path.string() + ".edge_penalties";
+    contractor_config.node_permutation_path =
+        contractor_config.osrm_input_path.string() + ".permutation";
+    contractor_config.nodes_data_path = contractor_config.osrm_input_path.string() + ".nodes";
+    contractor_config.edge_data_path = contractor_config.osrm_input_path.string() + ".edges";
+    contractor_config.rtree_leaf_path = contractor_config.osrm_input_path.string() + ".fileIndex";
+    contractor_config.sweep_order_path = contractor_config.osrm_input_path.string() + ".order";
 }
 }
 }
@@ -0,0 +1,431 @@
+#include "contractor/graph_renumbering.hpp"
+
+#include "extractor/edge_based_node.hpp"
+#include "extractor/original_edge_data.hpp"
+#include "extractor/query_node.hpp"
+#include "util/hilbert_value.hpp"
+#include "util/integer_range.hpp"
+#include "util/osrm_exception.hpp"
+#include "util/simple_logger.hpp"
+#include "util/static_rtree.hpp"
+
+#include "osrm/coordinate.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/crc.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+namespace osrm
+{
+namespace contractor
+{
+
+namespace
+{
+using LeafRTree = util::StaticRTree<extractor::EdgeBasedNode>;
+
+// Returns for every id that is currently stored in a file the id it has to be replaced with.
+// An empty result means that nothing needs to be changed.
+template <typename IdT>
+std::vector<IdT> ComposeTranslation(const std::vector<IdT> &current_ids,
+                                    const std::vector<IdT> &next_ids,
+                                    const std::size_t number_of_ids)
+{
+    std::vector<IdT> translation;
+    if (current_ids.empty() && next_ids.empty())
+    {
+        return translation;
+    }
+    BOOST_ASSERT(current_ids.empty() || current_ids.size() == number_of_ids);
+    BOOST_ASSERT(next_ids.empty() || next_ids.size() == number_of_ids);
+
+    translation.resize(number_of_ids);
+    for (const auto id : util::irange<std::size_t>(0, number_of_ids))
+    {
+        const auto current_id = current_ids.empty() ? id : current_ids[id];
+        const auto next_id = next_ids.empty() ? id : next_ids[id];
+        translation[current_id] = next_id;
+    }
+    return translation;
+}
+
+template <typename T>
+void WriteVector(boost::filesystem::ofstream &output_stream, const std::vector<T> &data)
+{
+    const unsigned size = data.size();
+    output_stream.write((char *)&size, sizeof(unsigned));
+    if (size > 0)
+    {
+        output_stream.write((char *)data.data(), sizeof(T) * size);
+    }
+}
+
+template <typename T>
+void ReadVector(boost::filesystem::ifstream &input_stream, std::vector<T> &data)
+{
+    unsigned size = 0;
+    input_stream.read((char *)&size, sizeof(unsigned));
+    data.resize(size);
+    if (size > 0)
+    {
+        input_stream.read((char *)data.data(), sizeof(T) * size);
+    }
+}
+
+// Returns the band of a contraction level. Bands grow exponentially, because the number of
+// nodes per level shrinks quickly towards the top of the hierarchy.
+inline unsigned LevelBand(const float level)
+{
+    return static_cast<unsigned>(std::log2(1.0f + std::max(0.0f, level)));
+}
+}
+
+std::uint32_t ComputeFileChecksum(const boost::filesystem::path &path)
+{
+    boost::filesystem::ifstream input_stream(path, std::ios::binary);
+    if (!input_stream)
+    {
+        throw util::exception("Could not read " + path.string());
+    }
+    boost::crc_32_type checksum;
+    std::vector<char> buffer(1 << 20);
+    while (input_stream)
+    {
+        input_stream.read(buffer.data(), buffer.size());
+        checksum.process_bytes(buffer.data(), static_cast<std::size_t>(input_stream.gcount()));
+    }
+    return checksum.checksum();
+}
+
+GraphPermutation ReadGraphPermutation(const boost::filesystem::path &permutation_path,
+                                      const boost::filesystem::path &leaf_path,
+                                      const boost::filesystem::path &edge_data_path,
+                                      const std::size_t number_of_nodes)
+{
+    GraphPermutation permutation;
+    if (!boost::filesystem::exists(permutation_path))
+    {
+        return permutation;
+    }
+
+    boost::filesystem::ifstream permutation_stream(permutation_path, std::ios::binary);
+    ReadVector(permutation_stream, permutation.new_node_ids);
+    ReadVector(permutation_stream, permutation.new_edge_ids);
+    permutation_stream.read((char *)&permutation.number_of_nodes, sizeof(std::uint64_t));
+    permutation_stream.read((char *)&permutation.leaf_file_checksum, sizeof(std::uint32_t));
+    permutation_stream.read((char *)&permutation.edge_data_file_checksum, sizeof(std::uint32_t));
+
+    // the cheap checks first, the checksums read both files
+    if (!permutation_stream || permutation.number_of_nodes != number_of_nodes ||
+        (!permutation.new_node_ids.empty() &&
+         permutation.new_node_ids.size() != number_of_nodes) ||
+        (!permutation.new_edge_ids.empty() &&
+         permutation.new_edge_ids.size() != ReadNumberOfOriginalEdges(edge_data_path)) ||
+        permutation.leaf_file_checksum != ComputeFileChecksum(leaf_path) ||
+        permutation.edge_data_file_checksum != ComputeFileChecksum(edge_data_path))
+    {
+        util::SimpleLogger().Write() << "Discarding stale node permutation "
+                                     << permutation_path.string();
+        return GraphPermutation{};
+    }
+
+    return permutation;
+}
+
+void WriteGraphPermutation(const boost::filesystem::path &permutation_path,
+                           const boost::filesystem::path &leaf_path,
+                           const boost::filesystem::path &edge_data_path,
+                           const std::size_t number_of_nodes,
+                           GraphPermutation &permutation)
+{
+    if (permutation.IsIdentity())
+    {
+        boost::filesystem::remove(permutation_path);
+        return;
+    }
+
+    permutation.number_of_nodes = number_of_nodes;
+    permutation.leaf_file_checksum = ComputeFileChecksum(leaf_path);
+    permutation.edge_data_file_checksum = ComputeFileChecksum(edge_data_path);
+
+    boost::filesystem::ofstream permutation_stream(permutation_path, std::ios::binary);
+    WriteVector(permutation_stream, permutation.new_node_ids);
+    WriteVector(permutation_stream, permutation.new_edge_ids);
+    permutation_stream.write((char *)&permutation.number_of_nodes, sizeof(std::uint64_t));
+    permutation_stream.write((char *)&permutation.leaf_file_checksum, sizeof(std::uint32_t));
+    permutation_stream.write((char *)&permutation.edge_data_file_checksum,
+                             sizeof(std::uint32_t));
+}
+
+void VisitSegmentCentroids(
+    const boost::filesystem::path &leaf_path,
+    const boost::filesystem::path &nodes_path,
+    const std::function<void(const extractor::EdgeBasedNode &, const util::FixedPointCoordinate &)>
+        &visitor)
+{
+    boost::filesystem::ifstream nodes_input_stream(nodes_path, std::ios::binary);
+    unsigned number_of_coordinates = 0;
+    nodes_input_stream.read((char *)&number_of_coordinates, sizeof(unsigned));
+    std::vector<extractor::QueryNode> coordinates(number_of_coordinates);
+    if (number_of_coordinates > 0)
+    {
+        nodes_input_stream.read((char *)coordinates.data(),
+                                sizeof(extractor::QueryNode) * number_of_coordinates);
+    }
+
+    LeafRTree::VisitLeafObjects(
+        leaf_path, [&](const extractor::EdgeBasedNode &segment)
+        {
+            BOOST_ASSERT(segment.u < coordinates.size());
+            BOOST_ASSERT(segment.v < coordinates.size());
+            const auto &u = coordinates[segment.u];
+            const auto &v = coordinates[segment.v];
+            visitor(segment, extractor::EdgeBasedNode::Centroid(
+                                 util::FixedPointCoordinate(u.lat, u.lon),
+                                 util::FixedPointCoordinate(v.lat, v.lon)));
+        });
+}
+
+std::vector<std::uint64_t>
+ComputeNodeHilbertValues(const boost::filesystem::path &leaf_path,
+                         const boost::filesystem::path &nodes_path,
+                         const std::size_t number_of_nodes,
+                         const GraphPermutation &current_permutation)
+{
+    // hilbert values indexed by the ids currently stored in the leaves
+    std::vector<std::uint64_t> stored_hilbert_values(number_of_nodes,
+                                                     std::numeric_limits<std::uint64_t>::max());
+    util::HilbertCode get_hilbert_number;
+    const auto update_hilbert_value = [&stored_hilbert_values](const NodeID node,
+                                                               const std::uint64_t value)
+    {
+        if (node != SPECIAL_NODEID && node < stored_hilbert_values.size())
+        {
+            stored_hilbert_values[node] = std::min(stored_hilbert_values[node], value);
+        }
+    };
+
+    VisitSegmentCentroids(leaf_path, nodes_path,
+                          [&](const extractor::EdgeBasedNode &segment,
+                              const util::FixedPointCoordinate &centroid)
+                          {
+                              const auto hilbert_value = get_hilbert_number(centroid);
+                              update_hilbert_value(segment.forward_edge_based_node_id,
+                                                   hilbert_value);
+                              update_hilbert_value(segment.reverse_edge_based_node_id,
+                                                   hilbert_value);
+                          });
+
+    if (current_permutation.new_node_ids.empty())
+    {
+        return stored_hilbert_values;
+    }
+
+    std::vector<std::uint64_t> hilbert_values(number_of_nodes);
+    for (const auto node : util::irange<std::size_t>(0, number_of_nodes))
+    {
+        hilbert_values[node] = stored_hilbert_values[current_permutation.new_node_ids[node]];
+    }
+    return hilbert_values;
+}
+
+std::vector<NodeID> ComputeNodeOrder(const std::vector<float> &node_levels,
+                                     const std::vector<bool> &is_core_node,
+                                     const std::vector<std::uint64_t> &hilbert_values)
+{
+    const auto number_of_nodes = hilbert_values.size();
+    BOOST_ASSERT(node_levels.size() == number_of_nodes);
+    BOOST_ASSERT(is_core_node.empty() || is_core_node.size() == number_of_nodes);
+
+    if (0 == number_of_nodes)
+    {
+        return {};
+    }
+    const auto max_level = *std::max_element(node_levels.begin(), node_levels.end());
+    const unsigned core_band = LevelBand(max_level) + 1;
+
+    struct NodeKey
+    {
+        unsigned band;
+        std::uint64_t hilbert_value;
+        NodeID node;
+
+        bool operator<(const NodeKey &other) const
+        {
+            // topmost band first
+            return std::tie(other.band, hilbert_value, node) <
+                   std::tie(band, other.hilbert_value, other.node);
+        }
+    };
+
+    std::vector<NodeKey> keys(number_of_nodes);
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        const bool is_core = !is_core_node.empty() && is_core_node[node];
+        keys[node] = {is_core ? core_band : LevelBand(node_levels[node]), hilbert_values[node],
+                      node};
+    }
+    tbb::parallel_sort(keys.begin(), keys.end());
+
+    std::vector<NodeID> new_node_ids(number_of_nodes);
+    for (const auto position : util::irange<NodeID>(0, number_of_nodes))
+    {
+        new_node_ids[keys[position].node] = position;
+    }
+    return new_node_ids;
+}
+
+void RenumberContractedGraph(const std::vector<NodeID> &new_node_ids,
+                             util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+                             std::vector<bool> &is_core_node)
+{
+    for (auto &edge : contracted_edge_list)
+    {
+        BOOST_ASSERT(edge.source < new_node_ids.size());
+        BOOST_ASSERT(edge.target < new_node_ids.size());
+        edge.source = new_node_ids[edge.source];
+        edge.target = new_node_ids[edge.target];
+        // shortcuts store the id of the contracted middle node
+        if (edge.data.shortcut)
+        {
+            BOOST_ASSERT(edge.data.id < new_node_ids.size());
+            edge.data.id = new_node_ids[edge.data.id];
+        }
+    }
+
+    if (!is_core_node.empty())
+    {
+        std::vector<bool> renumbered_is_core_node(is_core_node.size());
+        for (const auto node : util::irange<std::size_t>(0, is_core_node.size()))
+        {
+            renumbered_is_core_node[new_node_ids[node]] = is_core_node[node];
+        }
+        is_core_node.swap(renumbered_is_core_node);
+    }
+}
+
+std::vector<EdgeID>
+RenumberOriginalEdges(const std::size_t number_of_original_edges,
+                      util::DeallocatingVector<QueryEdge> &contracted_edge_list)
+{
+    tbb::parallel_sort(contracted_edge_list.begin(), contracted_edge_list.end());
+
+    std::vector<EdgeID> new_edge_ids(number_of_original_edges, SPECIAL_EDGEID);
+    EdgeID next_edge_id = 0;
+    for (const auto &edge : contracted_edge_list)
+    {
+        if (!edge.data.shortcut && SPECIAL_EDGEID == new_edge_ids[edge.data.id])
+        {
+            new_edge_ids[edge.data.id] = next_edge_id++;
+        }
+    }
+    // original edges that were dropped during contraction keep their relative order
+    for (auto &new_edge_id : new_edge_ids)
+    {
+        if (SPECIAL_EDGEID == new_edge_id)
+        {
+            new_edge_id = next_edge_id++;
+        }
+    }
+    BOOST_ASSERT(next_edge_id == number_of_original_edges);
+
+    for (auto &edge : contracted_edge_list)
+    {
+        if (!edge.data.shortcut)
+        {
+            edge.data.id = new_edge_ids[edge.data.id];
+        }
+    }
+    return new_edge_ids;
+}
+
+std::size_t ReadNumberOfOriginalEdges(const boost::filesystem::path &edge_data_path)
+{
+    boost::filesystem::ifstream edge_data_stream(edge_data_path, std::ios::binary);
+    unsigned number_of_edges = 0;
+    edge_data_stream.read((char *)&number_of_edges, sizeof(unsigned));
+    if (!edge_data_stream)
+    {
+        throw util::exception("Could not read " + edge_data_path.string());
+    }
+    return number_of_edges;
+}
+
+void RenumberRTreeLeaves(const boost::filesystem::path &leaf_path,
+                         const GraphPermutation &current_permutation,
+                         const GraphPermutation &next_permutation)
+{
+    const auto number_of_nodes = std::max(current_permutation.new_node_ids.size(),
+                                          next_permutation.new_node_ids.size());
+    const auto translation = ComposeTranslation(current_permutation.new_node_ids,
+                                                next_permutation.new_node_ids, number_of_nodes);
+    if (translation.empty())
+    {
+        return;
+    }
+
+    util::SimpleLogger().Write() << "Renumbering r-tree leaves in " << leaf_path.string();
+    LeafRTree::UpdateLeafObjects(leaf_path, [&translation](extractor::EdgeBasedNode &segment)
+                                 {
+                                     if (SPECIAL_NODEID != segment.forward_edge_based_node_id)
+                                     {
+                                         segment.forward_edge_based_node_id =
+                                             translation[segment.forward_edge_based_node_id];
+                                     }
+                                     if (SPECIAL_NODEID != segment.reverse_edge_based_node_id)
+                                     {
+                                         segment.reverse_edge_based_node_id =
+                                             translation[segment.reverse_edge_based_node_id];
+                                     }
+                                 });
+}
+
+void RenumberOriginalEdgeData(const boost::filesystem::path &edge_data_path,
+                              const GraphPermutation &current_permutation,
+                              const GraphPermutation &next_permutation)
+{
+    const auto number_of_edges = ReadNumberOfOriginalEdges(edge_data_path);
+    const auto translation = ComposeTranslation(current_permutation.new_edge_ids,
+                                                next_permutation.new_edge_ids, number_of_edges);
+    if (translation.empty())
+    {
+        return;
+    }
+
+    util::SimpleLogger().Write() << "Renumbering original edge data in "
+                                 << edge_data_path.string();
+
+    std::vector<extractor::OriginalEdgeData> stored_edge_data(number_of_edges);
+    {
+        boost::filesystem::ifstream edge_data_stream(edge_data_path, std::ios::binary);
+        edge_data_stream.seekg(sizeof(unsigned));
+        edge_data_stream.read((char *)stored_edge_data.data(),
+                              sizeof(extractor::OriginalEdgeData) * number_of_edges);
+        if (!edge_data_stream)
+        {
+            throw util::exception("Could not read " + edge_data_path.string());
+        }
+    }
+
+    std::vector<extractor::OriginalEdgeData> renumbered_edge_data(number_of_edges);
+    for (const auto edge : util::irange<std::size_t>(0, number_of_edges))
+    {
+        renumbered_edge_data[translation[edge]] = stored_edge_data[edge];
+    }
+
+    boost::filesystem::ofstream edge_data_stream(edge_data_path, std::ios::binary);
+    const unsigned size = number_of_edges;
+    edge_data_stream.write((char *)&size, sizeof(unsigned));
+    edge_data_stream.write((char *)renumbered_edge_data.data(),
+                           sizeof(extractor::OriginalEdgeData) * number_of_edges);
+}
+}
+}
@@ -1,5 +1,7 @@
 #include "contractor/processing_chain.hpp"
 #include "contractor/contractor.hpp"
+#include "contractor/graph_renumbering.hpp"
+#include "contractor/sweep_order.hpp"
 
 #include "extractor/edge_based_edge.hpp"
 
@@ -22,6 +24,7 @@
 
 #include <tbb/parallel_sort.h>
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <string>
@@ -93,13 +96,22 @@ int Prepare::Run()
 
     util::SimpleLogger().Write() << "Contraction took " << TIMER_SEC(contraction) << " sec";
 
-    std::size_t number_of_used_edges = WriteContractedGraph(max_edge_id, contracted_edge_list);
-    WriteCoreNodeMarker(std::move(is_core_node));
-    if (!config.use_cached_priority)
+    // the levels are only handed back if they were not read from the cache
+    if (config.use_cached_priority)
+    {
+        ReadNodeLevels(node_levels);
+    }
+    else
     {
-        WriteNodeLevels(std::move(node_levels));
+        WriteNodeLevels(node_levels);
     }
 
+    RenumberGraph(max_edge_id, node_levels, contracted_edge_list, is_core_node);
+    WriteSweepOrder(max_edge_id, contracted_edge_list, is_core_node);
+
+    std::size_t number_of_used_edges = WriteContractedGraph(max_edge_id, contracted_edge_list);
+    WriteCoreNodeMarker(std::move(is_core_node));
+
     TIMER_STOP(preparing);
 
     util::SimpleLogger().Write() << "Preprocessing : " << TIMER_SEC(preparing) << " seconds";
@@ -256,10 +268,8 @@ void Prepare::ReadNodeLevels(std::vector<float> &node_levels) const
     order_input_stream.read((char *)node_levels.data(), sizeof(float) * node_levels.size());
 }
 
-void Prepare::WriteNodeLevels(std::vector<float> &&in_node_levels) const
+void Prepare::WriteNodeLevels(const std::vector<float> &node_levels) const
 {
-    std::vector<float> node_levels(std::move(in_node_levels));
-
     boost::filesystem::ofstream order_output_stream(config.level_output_path, std::ios::binary);
 
     unsigned level_size = node_levels.size();
@@ -284,6 +294,75 @@ void Prepare::WriteCoreNodeMarker(std::vector<bool> &&in_is_core_node) const
                                     sizeof(char) * unpacked_bool_flags.size());
 }
 
+void Prepare::RenumberGraph(const unsigned max_edge_id,
+                            const std::vector<float> &node_levels,
+                            util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+                            std::vector<bool> &is_core_node) const
+{
+    // The r-tree leaves and the original edge data might still be renumbered by a previous run.
+    // In that case they need to be translated, even if renumbering is disabled now.
+    const auto current_permutation =
+        ReadGraphPermutation(config.node_permutation_path, config.rtree_leaf_path,
+                             config.edge_data_path, max_edge_id + 1);
+    if (!config.renumber_nodes && current_permutation.IsIdentity())
+    {
+        return;
+    }
+
+    GraphPermutation next_permutation;
+    if (config.renumber_nodes)
+    {
+        TIMER_START(renumbering);
+        util::SimpleLogger().Write() << "Renumbering nodes for cache locality";
+
+        const auto hilbert_values =
+            ComputeNodeHilbertValues(config.rtree_leaf_path, config.nodes_data_path,
+                                     max_edge_id + 1, current_permutation);
+        next_permutation.new_node_ids = ComputeNodeOrder(node_levels, is_core_node, hilbert_values);
+        RenumberContractedGraph(next_permutation.new_node_ids, contracted_edge_list, is_core_node);
+        next_permutation.new_edge_ids = RenumberOriginalEdges(
+            ReadNumberOfOriginalEdges(config.edge_data_path), contracted_edge_list);
+
+        TIMER_STOP(renumbering);
+        util::SimpleLogger().Write() << "Renumbering took " << TIMER_SEC(renumbering) << " sec";
+    }
+
+    RenumberRTreeLeaves(config.rtree_leaf_path, current_permutation, next_permutation);
+    RenumberOriginalEdgeData(config.edge_data_path, current_permutation, next_permutation);
+    WriteGraphPermutation(config.node_permutation_path, config.rtree_leaf_path,
+                          config.edge_data_path, max_edge_id + 1, next_permutation);
+}
+
+void Prepare::WriteSweepOrder(const unsigned max_edge_id,
+                              const util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+                              const std::vector<bool> &is_core_node) const
+{
+    TIMER_START(sweep_order);
+    SweepOrder sweep_order;
+    if (std::find(is_core_node.begin(), is_core_node.end(), true) == is_core_node.end())
+    {
+        sweep_order = ComputeSweepOrder(max_edge_id + 1, contracted_edge_list);
+    }
+    if (sweep_order.level_offsets.empty())
+    {
+        util::SimpleLogger().Write(logWARNING)
+            << "Graph has a core, one-to-all queries will not be available";
+    }
+    else
+    {
+        util::SimpleLogger().Write() << "Sweep order has "
+                                     << sweep_order.level_offsets.size() - 1 << " levels";
+    }
+
+    // the r-tree leaves are in the final node order at this point
+    const auto node_locations = ComputeNodeLocations(config.rtree_leaf_path,
+                                                     config.nodes_data_path, max_edge_id + 1);
+    contractor::WriteSweepOrder(config.sweep_order_path, sweep_order, node_locations);
+    TIMER_STOP(sweep_order);
+    util::SimpleLogger().Write() << "Writing sweep order took " << TIMER_SEC(sweep_order)
+                                 << " sec";
+}
+
 std::size_t
 Prepare::WriteContractedGraph(unsigned max_node_id,
                               const util::DeallocatingVector<QueryEdge> &contracted_edge_list)
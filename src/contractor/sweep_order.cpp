@@ -0,0 +1,148 @@
+#include "contractor/sweep_order.hpp"
+#include "contractor/graph_renumbering.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/simple_logger.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+namespace osrm
+{
+namespace contractor
+{
+
+namespace
+{
+template <typename T>
+void WriteVector(boost::filesystem::ofstream &output_stream, const std::vector<T> &data)
+{
+    const unsigned size = data.size();
+    output_stream.write((char *)&size, sizeof(unsigned));
+    if (size > 0)
+    {
+        output_stream.write((char *)data.data(), sizeof(T) * size);
+    }
+}
+}
+
+SweepOrder ComputeSweepOrder(const std::size_t number_of_nodes,
+                             const util::DeallocatingVector<QueryEdge> &contracted_edge_list)
+{
+    // adjacency array of the upward edges, from the lower to the higher endpoint
+    std::vector<unsigned> first_edge(number_of_nodes + 1, 0);
+    std::vector<unsigned> in_degree(number_of_nodes, 0);
+    for (const auto &edge : contracted_edge_list)
+    {
+        BOOST_ASSERT(edge.source < number_of_nodes);
+        BOOST_ASSERT(edge.target < number_of_nodes);
+        ++first_edge[edge.source + 1];
+        ++in_degree[edge.target];
+    }
+    std::partial_sum(first_edge.begin(), first_edge.end(), first_edge.begin());
+
+    std::vector<NodeID> targets(contracted_edge_list.size());
+    {
+        std::vector<unsigned> position(first_edge.begin(), first_edge.end() - 1);
+        for (const auto &edge : contracted_edge_list)
+        {
+            targets[position[edge.source]++] = edge.target;
+        }
+    }
+
+    // level of a node is the length of the longest upward path ending in it
+    std::vector<unsigned> levels(number_of_nodes, 0);
+    std::vector<NodeID> queue;
+    queue.reserve(number_of_nodes);
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        if (0 == in_degree[node])
+        {
+            queue.push_back(node);
+        }
+    }
+    for (std::size_t head = 0; head < queue.size(); ++head)
+    {
+        const auto node = queue[head];
+        for (const auto edge : util::irange(first_edge[node], first_edge[node + 1]))
+        {
+            const auto target = targets[edge];
+            levels[target] = std::max(levels[target], levels[node] + 1);
+            if (0 == --in_degree[target])
+            {
+                queue.push_back(target);
+            }
+        }
+    }
+
+    SweepOrder sweep_order;
+    if (queue.size() != number_of_nodes)
+    {
+        // the remaining nodes lie on cycles of the core
+        return sweep_order;
+    }
+
+    const auto number_of_levels =
+        number_of_nodes > 0 ? *std::max_element(levels.begin(), levels.end()) + 1 : 0;
+
+    // counting sort by level, topmost level first
+    sweep_order.level_offsets.resize(number_of_levels + 1, 0);
+    for (const auto level : levels)
+    {
+        ++sweep_order.level_offsets[number_of_levels - level];
+    }
+    std::partial_sum(sweep_order.level_offsets.begin(), sweep_order.level_offsets.end(),
+                     sweep_order.level_offsets.begin());
+
+    sweep_order.nodes.resize(number_of_nodes);
+    std::vector<unsigned> position(sweep_order.level_offsets.begin(),
+                                   sweep_order.level_offsets.end() - 1);
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        sweep_order.nodes[position[number_of_levels - 1 - levels[node]]++] = node;
+    }
+    BOOST_ASSERT(sweep_order.level_offsets.back() == number_of_nodes);
+
+    return sweep_order;
+}
+
+std::vector<util::FixedPointCoordinate>
+ComputeNodeLocations(const boost::filesystem::path &leaf_path,
+                     const boost::filesystem::path &nodes_path,
+                     const std::size_t number_of_nodes)
+{
+    std::vector<util::FixedPointCoordinate> node_locations(number_of_nodes);
+    std::vector<bool> has_location(number_of_nodes, false);
+    const auto set_location = [&](const NodeID node, const util::FixedPointCoordinate &location)
+    {
+        if (node != SPECIAL_NODEID && node < number_of_nodes && !has_location[node])
+        {
+            node_locations[node] = location;
+            has_location[node] = true;
+        }
+    };
+
+    VisitSegmentCentroids(leaf_path, nodes_path,
+                          [&](const extractor::EdgeBasedNode &segment,
+                              const util::FixedPointCoordinate &centroid)
+                          {
+                              set_location(segment.forward_edge_based_node_id, centroid);
+                              set_location(segment.reverse_edge_based_node_id, centroid);
+                          });
+    return node_locations;
+}
+
+void WriteSweepOrder(const boost::filesystem::path &sweep_order_path,
+                     const SweepOrder &sweep_order,
+                     const std::vector<util::FixedPointCoordinate> &node_locations)
+{
+    boost::filesystem::ofstream sweep_order_stream(sweep_order_path, std::ios::binary);
+    WriteVector(sweep_order_stream, sweep_order.nodes);
+    WriteVector(sweep_order_stream, sweep_order.level_offsets);
+    WriteVector(sweep_order_stream, node_locations);
+}
+}
+}
@@ -0,0 +1,640 @@
+#include "datastore/dataset_loader.hpp"
+
+#include "extractor/original_edge_data.hpp"
+#include "util/range_table.hpp"
+#include "contractor/query_edge.hpp"
+#include "extractor/query_node.hpp"
+#include "util/shared_memory_vector_wrapper.hpp"
+#include "util/static_graph.hpp"
+#include "util/static_rtree.hpp"
+#include "engine/datafacade/datafacade_base.hpp"
+#include "extractor/travel_mode.hpp"
+#include "extractor/turn_instructions.hpp"
+#include "util/fingerprint.hpp"
+#include "util/integer_range.hpp"
+#include "util/osrm_exception.hpp"
+#include "util/simple_logger.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include "osrm/coordinate.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/iostreams/seek.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <cstdint>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace datastore
+{
+
+using engine::datafacade::SharedDataLayout;
+
+using RTreeLeaf =
+    typename engine::datafacade::BaseDataFacade<contractor::QueryEdge::EdgeData>::RTreeLeaf;
+using RTreeNode = util::StaticRTree<RTreeLeaf,
+                                    util::ShM<util::FixedPointCoordinate, true>::vector,
+                                    true>::TreeNode;
+using QueryGraph = util::StaticGraph<contractor::QueryEdge::EdgeData>;
+
+namespace
+{
+const boost::filesystem::path &GetPath(const DatasetPaths &paths, const std::string &name)
+{
+    const auto paths_iterator = paths.find(name);
+    BOOST_ASSERT(paths.end() != paths_iterator);
+    BOOST_ASSERT(!paths_iterator->second.empty());
+    return paths_iterator->second;
+}
+
+// the sweep order is optional, datasets of older versions do not have it
+boost::filesystem::path GetSweepOrderPath(const DatasetPaths &paths)
+{
+    const auto paths_iterator = paths.find("order");
+    if (paths.end() == paths_iterator || paths_iterator->second.empty() ||
+        !boost::filesystem::is_regular_file(paths_iterator->second))
+    {
+        return boost::filesystem::path();
+    }
+    return paths_iterator->second;
+}
+
+std::string GetFileIndexPath(const DatasetPaths &paths)
+{
+    return boost::filesystem::canonical(GetPath(paths, "fileindex")).string();
+}
+
+std::string LoadTimestamp(const DatasetPaths &paths)
+{
+    const auto paths_iterator = paths.find("timestamp");
+    std::string timestamp;
+    if (paths.end() != paths_iterator && boost::filesystem::exists(paths_iterator->second))
+    {
+        boost::filesystem::ifstream timestamp_stream(paths_iterator->second);
+        if (!timestamp_stream)
+        {
+            util::SimpleLogger().Write(logWARNING) << paths_iterator->second
+                                                   << " not found. setting to default";
+        }
+        else
+        {
+            getline(timestamp_stream, timestamp);
+            timestamp_stream.close();
+        }
+    }
+    if (timestamp.empty())
+    {
+        timestamp = "n/a";
+    }
+    if (25 < timestamp.length())
+    {
+        timestamp.resize(25);
+    }
+    return timestamp;
+}
+
+// sets the bit of every marked entry in blocks of 32 bits, every block is written by one thread
+template <typename IsMarked>
+void PackBits(unsigned *bits_ptr, const unsigned number_of_entries, IsMarked is_marked)
+{
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_entries / 32 + 1, 1024),
+                      [&](const tbb::blocked_range<std::size_t> &range)
+                      {
+                          for (const auto block : util::irange(range.begin(), range.end()))
+                          {
+                              const std::size_t first = block * 32;
+                              const std::size_t last = std::min<std::size_t>(
+                                  first + 32, number_of_entries);
+                              unsigned bits = 0;
+                              for (auto i = first; i < last; ++i)
+                              {
+                                  if (is_marked(i))
+                                  {
+                                      bits |= (1u << (i % 32));
+                                  }
+                              }
+                              bits_ptr[block] = bits;
+                          }
+                      });
+}
+
+// Reads count entries of type T in chunks and hands every entry to transform in parallel, so
+// neither the file nor the transformed arrays need to be held in memory twice.
+template <typename T, typename Transform>
+void ReadTransformed(std::istream &stream,
+                     const std::size_t count,
+                     const boost::filesystem::path &path,
+                     Transform transform)
+{
+    const constexpr std::size_t CHUNK_SIZE = 1024 * 1024;
+    std::vector<T> buffer(std::min(count, CHUNK_SIZE));
+    for (std::size_t first = 0; first < count; first += CHUNK_SIZE)
+    {
+        const auto chunk_size = std::min(CHUNK_SIZE, count - first);
+        stream.read(reinterpret_cast<char *>(buffer.data()), chunk_size * sizeof(T));
+        if (!stream)
+        {
+            throw util::exception("Could not read " + path.string());
+        }
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, chunk_size, 4096),
+                          [&](const tbb::blocked_range<std::size_t> &range)
+                          {
+                              for (const auto i : util::irange(range.begin(), range.end()))
+                              {
+                                  transform(first + i, buffer[i]);
+                              }
+                          });
+    }
+}
+
+// reads a whole block at once, blocks are laid out exactly as in the files
+void ReadBlock(std::istream &stream,
+               const boost::filesystem::path &path,
+               const SharedDataLayout &layout,
+               const SharedDataLayout::BlockID bid,
+               char *block_ptr)
+{
+    if (layout.GetBlockSize(bid) > 0)
+    {
+        stream.read(block_ptr, layout.GetBlockSize(bid));
+        if (!stream)
+        {
+            throw util::exception("Could not read " + path.string());
+        }
+    }
+}
+
+// the blocks that are only read to describe routes
+const SharedDataLayout::BlockID COLD_BLOCKS[] = {
+    SharedDataLayout::NAME_OFFSETS, SharedDataLayout::NAME_BLOCKS,
+    SharedDataLayout::NAME_CHAR_LIST, SharedDataLayout::NAME_ID_LIST,
+    SharedDataLayout::VIA_NODE_LIST, SharedDataLayout::TURN_INSTRUCTION,
+    SharedDataLayout::TRAVEL_MODE, SharedDataLayout::GEOMETRIES_INDEX,
+    SharedDataLayout::GEOMETRIES_LIST, SharedDataLayout::GEOMETRIES_INDICATORS};
+
+struct BlockLoader
+{
+    const char *name;
+    std::function<void()> load;
+};
+
+void LoadGraph(const DatasetPaths &paths, SharedDataLayout &layout, char *memory)
+{
+    const auto &path = GetPath(paths, "hsgrdata");
+    boost::filesystem::ifstream hsgr_input_stream(path, std::ios::binary);
+    hsgr_input_stream.seekg(sizeof(util::FingerPrint));
+    unsigned *checksum_ptr =
+        layout.GetBlockPtr<unsigned, true>(memory, SharedDataLayout::HSGR_CHECKSUM);
+    hsgr_input_stream.read((char *)checksum_ptr, sizeof(unsigned));
+    // skip the number of nodes and edges
+    hsgr_input_stream.seekg(2 * sizeof(unsigned), BOOST_IOS::cur);
+
+    ReadBlock(hsgr_input_stream, path, layout, SharedDataLayout::GRAPH_NODE_LIST,
+              layout.GetBlockPtr<char, true>(memory, SharedDataLayout::GRAPH_NODE_LIST));
+    ReadBlock(hsgr_input_stream, path, layout, SharedDataLayout::GRAPH_EDGE_LIST,
+              layout.GetBlockPtr<char, true>(memory, SharedDataLayout::GRAPH_EDGE_LIST));
+}
+
+void LoadNames(const DatasetPaths &paths, SharedDataLayout &layout, char *memory)
+{
+    const auto &path = GetPath(paths, "namesdata");
+    boost::filesystem::ifstream name_stream(path, std::ios::binary);
+    name_stream.seekg(2 * sizeof(unsigned));
+    ReadBlock(name_stream, path, layout, SharedDataLayout::NAME_OFFSETS,
+              layout.GetBlockPtr<char, true>(memory, SharedDataLayout::NAME_OFFSETS));
+    ReadBlock(name_stream, path, layout, SharedDataLayout::NAME_BLOCKS,
+              layout.GetBlockPtr<char, true>(memory, SharedDataLayout::NAME_BLOCKS));
+
+    unsigned temp_length;
+    name_stream.read((char *)&temp_length, sizeof(unsigned));
+    BOOST_ASSERT_MSG(temp_length == layout.GetBlockSize(SharedDataLayout::NAME_CHAR_LIST),
+                     "Name file corrupted!");
+
+    ReadBlock(name_stream, path, layout, SharedDataLayout::NAME_CHAR_LIST,
+              layout.GetBlockPtr<char, true>(memory, SharedDataLayout::NAME_CHAR_LIST));
+}
+
+void LoadOriginalEdges(const DatasetPaths &paths, SharedDataLayout &layout, char *memory)
+{
+    NodeID *via_node_ptr =
+        layout.GetBlockPtr<NodeID, true>(memory, SharedDataLayout::VIA_NODE_LIST);
+    unsigned *name_id_ptr =
+        layout.GetBlockPtr<unsigned, true>(memory, SharedDataLayout::NAME_ID_LIST);
+    extractor::TravelMode *travel_mode_ptr =
+        layout.GetBlockPtr<extractor::TravelMode, true>(memory, SharedDataLayout::TRAVEL_MODE);
+    extractor::TurnInstruction *turn_instructions_ptr =
+        layout.GetBlockPtr<extractor::TurnInstruction, true>(memory,
+                                                             SharedDataLayout::TURN_INSTRUCTION);
+    unsigned *geometries_indicator_ptr =
+        layout.GetBlockPtr<unsigned, true>(memory, SharedDataLayout::GEOMETRIES_INDICATORS);
+
+    const auto &path = GetPath(paths, "edgesdata");
+    boost::filesystem::ifstream edges_input_stream(path, std::ios::binary);
+    edges_input_stream.seekg(sizeof(unsigned));
+    const unsigned number_of_original_edges =
+        layout.num_entries[SharedDataLayout::VIA_NODE_LIST];
+    // not a std::vector<bool>, the entries are written concurrently
+    std::vector<char> is_compressed(number_of_original_edges);
+    ReadTransformed<extractor::OriginalEdgeData>(
+        edges_input_stream, number_of_original_edges, path,
+        [&](const std::size_t i, const extractor::OriginalEdgeData &edge_data)
+        {
+            via_node_ptr[i] = edge_data.via_node;
+            name_id_ptr[i] = edge_data.name_id;
+            travel_mode_ptr[i] = edge_data.travel_mode;
+            turn_instructions_ptr[i] = edge_data.turn_instruction;
+            is_compressed[i] = edge_data.compressed_geometry;
+        });
+    PackBits(geometries_indicator_ptr, number_of_original_edges, [&](const unsigned i)
+             {
+                 return is_compressed[i] != 0;
+             });
+}
+
+void LoadGeometries(const DatasetPaths &paths, SharedDataLayout &layout, char *memory)
+{
+    const auto &path = GetPath(paths, "geometry");
+    std::ifstream geometry_input_stream(path.string().c_str(), std::ios::binary);
+    unsigned temporary_value;
+    geometry_input_stream.read((char *)&temporary_value, sizeof(unsigned));
+    BOOST_ASSERT(temporary_value == layout.num_entries[SharedDataLayout::GEOMETRIES_INDEX]);
+    ReadBlock(geometry_input_stream, path, layout, SharedDataLayout::GEOMETRIES_INDEX,
+              layout.GetBlockPtr<char, true>(memory, SharedDataLayout::GEOMETRIES_INDEX));
+
+    geometry_input_stream.read((char *)&temporary_value, sizeof(unsigned));
+    BOOST_ASSERT(temporary_value == layout.num_entries[SharedDataLayout::GEOMETRIES_LIST]);
+    ReadBlock(geometry_input_stream, path, layout, SharedDataLayout::GEOMETRIES_LIST,
+              layout.GetBlockPtr<char, true>(memory, SharedDataLayout::GEOMETRIES_LIST));
+}
+
+void LoadCoordinates(const DatasetPaths &paths, SharedDataLayout &layout, char *memory)
+{
+    util::FixedPointCoordinate *coordinates_ptr =
+        layout.GetBlockPtr<util::FixedPointCoordinate, true>(memory,
+                                                             SharedDataLayout::COORDINATE_LIST);
+
+    const auto &path = GetPath(paths, "nodesdata");
+    boost::filesystem::ifstream nodes_input_stream(path, std::ios::binary);
+    nodes_input_stream.seekg(sizeof(unsigned));
+    ReadTransformed<extractor::QueryNode>(
+        nodes_input_stream, layout.num_entries[SharedDataLayout::COORDINATE_LIST], path,
+        [&](const std::size_t i, const extractor::QueryNode &node)
+        {
+            coordinates_ptr[i] = util::FixedPointCoordinate(node.lat, node.lon);
+        });
+}
+
+void LoadRTree(const DatasetPaths &paths, SharedDataLayout &layout, char *memory)
+{
+    // store search tree portion of rtree
+    const auto &tree_path = GetPath(paths, "ramindex");
+    boost::filesystem::ifstream tree_node_file(tree_path, std::ios::binary);
+    tree_node_file.seekg(sizeof(uint32_t));
+    ReadBlock(tree_node_file, tree_path, layout, SharedDataLayout::R_SEARCH_TREE,
+              layout.GetBlockPtr<char, true>(memory, SharedDataLayout::R_SEARCH_TREE));
+
+    // store leaves of the rtree if they are part of the dataset
+    char *rtree_leaves_ptr =
+        layout.GetBlockPtr<char, true>(memory, SharedDataLayout::R_SEARCH_TREE_LEAVES);
+    if (layout.GetBlockSize(SharedDataLayout::R_SEARCH_TREE_LEAVES) > 0)
+    {
+        const auto &leaves_path = GetPath(paths, "fileindex");
+        boost::filesystem::ifstream leaves_file(leaves_path, std::ios::binary);
+        ReadBlock(leaves_file, leaves_path, layout, SharedDataLayout::R_SEARCH_TREE_LEAVES,
+                  rtree_leaves_ptr);
+    }
+}
+
+void LoadCoreMarkers(const DatasetPaths &paths, SharedDataLayout &layout, char *memory)
+{
+    const auto &path = GetPath(paths, "core");
+    boost::filesystem::ifstream core_marker_file(path, std::ios::binary);
+    core_marker_file.seekg(sizeof(uint32_t));
+    const unsigned number_of_core_markers = layout.num_entries[SharedDataLayout::CORE_MARKER];
+    std::vector<char> unpacked_core_markers(number_of_core_markers);
+    core_marker_file.read((char *)unpacked_core_markers.data(),
+                          sizeof(char) * number_of_core_markers);
+    if (!core_marker_file)
+    {
+        throw util::exception("Could not read " + path.string());
+    }
+
+    unsigned *core_marker_ptr =
+        layout.GetBlockPtr<unsigned, true>(memory, SharedDataLayout::CORE_MARKER);
+    PackBits(core_marker_ptr, number_of_core_markers, [&](const unsigned i)
+             {
+                 BOOST_ASSERT(unpacked_core_markers[i] == 0 || unpacked_core_markers[i] == 1);
+                 return unpacked_core_markers[i] == 1;
+             });
+}
+
+void LoadSweepOrder(const DatasetPaths &paths, SharedDataLayout &layout, char *memory)
+{
+    char *sweep_order_ptr = layout.GetBlockPtr<char, true>(memory, SharedDataLayout::SWEEP_ORDER);
+    char *sweep_level_offsets_ptr =
+        layout.GetBlockPtr<char, true>(memory, SharedDataLayout::SWEEP_LEVEL_OFFSETS);
+    char *node_locations_ptr =
+        layout.GetBlockPtr<char, true>(memory, SharedDataLayout::NODE_LOCATIONS);
+    const auto sweep_order_path = GetSweepOrderPath(paths);
+    if (!sweep_order_path.empty())
+    {
+        boost::filesystem::ifstream sweep_order_file(sweep_order_path, std::ios::binary);
+        sweep_order_file.seekg(sizeof(uint32_t));
+        ReadBlock(sweep_order_file, sweep_order_path, layout, SharedDataLayout::SWEEP_ORDER,
+                  sweep_order_ptr);
+        sweep_order_file.seekg(sizeof(uint32_t), BOOST_IOS::cur);
+        ReadBlock(sweep_order_file, sweep_order_path, layout,
+                  SharedDataLayout::SWEEP_LEVEL_OFFSETS, sweep_level_offsets_ptr);
+        sweep_order_file.seekg(sizeof(uint32_t), BOOST_IOS::cur);
+        ReadBlock(sweep_order_file, sweep_order_path, layout, SharedDataLayout::NODE_LOCATIONS,
+                  node_locations_ptr);
+    }
+}
+
+void LoadTimestampAndFileIndexPath(const DatasetPaths &paths,
+                                   SharedDataLayout &layout,
+                                   char *memory)
+{
+    // ram index file name
+    const auto file_index_path = GetFileIndexPath(paths);
+    char *file_index_path_ptr =
+        layout.GetBlockPtr<char, true>(memory, SharedDataLayout::FILE_INDEX_PATH);
+    // make sure we have 0 ending
+    std::fill(file_index_path_ptr,
+              file_index_path_ptr + layout.GetBlockSize(SharedDataLayout::FILE_INDEX_PATH), 0);
+    std::copy(file_index_path.begin(), file_index_path.end(), file_index_path_ptr);
+
+    const auto timestamp = LoadTimestamp(paths);
+    char *timestamp_ptr = layout.GetBlockPtr<char, true>(memory, SharedDataLayout::TIMESTAMP);
+    std::copy(timestamp.c_str(), timestamp.c_str() + timestamp.length(), timestamp_ptr);
+}
+
+// the sizes of the blocks that are only read to describe routes
+void LoadColdBlockSizes(const DatasetPaths &paths, SharedDataLayout &layout)
+{
+    // collect number of elements to store in shared memory object
+    util::SimpleLogger().Write() << "load names from: " << GetPath(paths, "namesdata");
+    // number of entries in name index
+    boost::filesystem::ifstream name_stream(GetPath(paths, "namesdata"), std::ios::binary);
+    unsigned name_blocks = 0;
+    name_stream.read((char *)&name_blocks, sizeof(unsigned));
+    layout.SetBlockSize<unsigned>(SharedDataLayout::NAME_OFFSETS, name_blocks);
+    layout.SetBlockSize<typename util::RangeTable<16, true>::BlockT>(
+        SharedDataLayout::NAME_BLOCKS, name_blocks);
+    util::SimpleLogger().Write() << "name offsets size: " << name_blocks;
+    BOOST_ASSERT_MSG(0 != name_blocks, "name file broken");
+
+    unsigned number_of_chars = 0;
+    name_stream.read((char *)&number_of_chars, sizeof(unsigned));
+    layout.SetBlockSize<char>(SharedDataLayout::NAME_CHAR_LIST, number_of_chars);
+
+    // Loading information for original edges
+    boost::filesystem::ifstream edges_input_stream(GetPath(paths, "edgesdata"), std::ios::binary);
+    unsigned number_of_original_edges = 0;
+    edges_input_stream.read((char *)&number_of_original_edges, sizeof(unsigned));
+
+    // note: settings this all to the same size is correct, we extract them from the same struct
+    layout.SetBlockSize<NodeID>(SharedDataLayout::VIA_NODE_LIST, number_of_original_edges);
+    layout.SetBlockSize<unsigned>(SharedDataLayout::NAME_ID_LIST, number_of_original_edges);
+    layout.SetBlockSize<extractor::TravelMode>(SharedDataLayout::TRAVEL_MODE,
+                                               number_of_original_edges);
+    layout.SetBlockSize<extractor::TurnInstruction>(SharedDataLayout::TURN_INSTRUCTION,
+                                                    number_of_original_edges);
+    // note: there are 32 geometry indicators in one unsigned block
+    layout.SetBlockSize<unsigned>(SharedDataLayout::GEOMETRIES_INDICATORS,
+                                  number_of_original_edges);
+
+    // load geometries sizes
+    std::ifstream geometry_input_stream(GetPath(paths, "geometry").string().c_str(),
+                                        std::ios::binary);
+    unsigned number_of_geometries_indices = 0;
+    unsigned number_of_compressed_geometries = 0;
+
+    geometry_input_stream.read((char *)&number_of_geometries_indices, sizeof(unsigned));
+    layout.SetBlockSize<unsigned>(SharedDataLayout::GEOMETRIES_INDEX,
+                                  number_of_geometries_indices);
+    boost::iostreams::seek(geometry_input_stream, number_of_geometries_indices * sizeof(unsigned),
+                           BOOST_IOS::cur);
+    geometry_input_stream.read((char *)&number_of_compressed_geometries, sizeof(unsigned));
+    layout.SetBlockSize<unsigned>(SharedDataLayout::GEOMETRIES_LIST,
+                                  number_of_compressed_geometries);
+}
+}
+
+void CheckDatasetPaths(const DatasetPaths &paths)
+{
+    const auto require = [&paths](const std::string &name, const std::string &message)
+    {
+        const auto paths_iterator = paths.find(name);
+        if (paths_iterator == paths.end() || paths_iterator->second.empty())
+        {
+            throw util::exception(message);
+        }
+    };
+    require("hsgrdata", "no hsgr file found");
+    require("ramindex", "no ram index file found");
+    require("fileindex", "no leaf index file found");
+    require("nodesdata", "no nodes file found");
+    require("edgesdata", "no edges file found");
+    require("namesdata", "no names file found");
+    require("geometry", "no geometry file found");
+    require("core", "no core file found");
+}
+
+SharedDataLayout
+LoadDatasetLayout(const DatasetPaths &paths, const bool embed_leaves, const bool table_only)
+{
+    SharedDataLayout layout;
+
+    layout.SetBlockSize<char>(SharedDataLayout::FILE_INDEX_PATH,
+                              GetFileIndexPath(paths).length() + 1);
+
+    if (table_only)
+    {
+        util::SimpleLogger().Write() << "leaving out names, original edges and geometries";
+    }
+    else
+    {
+        LoadColdBlockSizes(paths, layout);
+    }
+
+    boost::filesystem::ifstream hsgr_input_stream(GetPath(paths, "hsgrdata"), std::ios::binary);
+
+    util::FingerPrint fingerprint_valid = util::FingerPrint::GetValid();
+    util::FingerPrint fingerprint_loaded;
+    hsgr_input_stream.read((char *)&fingerprint_loaded, sizeof(util::FingerPrint));
+    if (fingerprint_loaded.TestGraphUtil(fingerprint_valid))
+    {
+        util::SimpleLogger().Write(logDEBUG) << "Fingerprint checked out ok";
+    }
+    else
+    {
+        util::SimpleLogger().Write(logWARNING) << ".hsgr was prepared with different build. "
+                                                  "Reprocess to get rid of this warning.";
+    }
+
+    // load checksum
+    unsigned checksum = 0;
+    hsgr_input_stream.read((char *)&checksum, sizeof(unsigned));
+    layout.SetBlockSize<unsigned>(SharedDataLayout::HSGR_CHECKSUM, 1);
+    // load graph node size
+    unsigned number_of_graph_nodes = 0;
+    hsgr_input_stream.read((char *)&number_of_graph_nodes, sizeof(unsigned));
+
+    BOOST_ASSERT_MSG((0 != number_of_graph_nodes), "number of nodes is zero");
+    layout.SetBlockSize<QueryGraph::NodeArrayEntry>(SharedDataLayout::GRAPH_NODE_LIST,
+                                                    number_of_graph_nodes);
+
+    // load graph edge size
+    unsigned number_of_graph_edges = 0;
+    hsgr_input_stream.read((char *)&number_of_graph_edges, sizeof(unsigned));
+    // BOOST_ASSERT_MSG(0 != number_of_graph_edges, "number of graph edges is zero");
+    layout.SetBlockSize<QueryGraph::EdgeArrayEntry>(SharedDataLayout::GRAPH_EDGE_LIST,
+                                                    number_of_graph_edges);
+
+    // load rsearch tree size
+    boost::filesystem::ifstream tree_node_file(GetPath(paths, "ramindex"), std::ios::binary);
+
+    uint32_t tree_size = 0;
+    tree_node_file.read((char *)&tree_size, sizeof(uint32_t));
+    layout.SetBlockSize<RTreeNode>(SharedDataLayout::R_SEARCH_TREE, tree_size);
+
+    // the leaves are stored with the number of elements in front, exactly as in the file
+    layout.SetBlockSize<char>(SharedDataLayout::R_SEARCH_TREE_LEAVES,
+                              embed_leaves
+                                  ? boost::filesystem::file_size(GetPath(paths, "fileindex"))
+                                  : 0);
+
+    // load timestamp size
+    layout.SetBlockSize<char>(SharedDataLayout::TIMESTAMP, LoadTimestamp(paths).length());
+
+    // load core marker size
+    boost::filesystem::ifstream core_marker_file(GetPath(paths, "core"), std::ios::binary);
+
+    uint32_t number_of_core_markers = 0;
+    core_marker_file.read((char *)&number_of_core_markers, sizeof(uint32_t));
+    layout.SetBlockSize<unsigned>(SharedDataLayout::CORE_MARKER, number_of_core_markers);
+
+    // load sweep order sizes
+    const auto sweep_order_path = GetSweepOrderPath(paths);
+    uint32_t number_of_sweep_nodes = 0;
+    uint32_t number_of_sweep_level_offsets = 0;
+    uint32_t number_of_node_locations = 0;
+    if (!sweep_order_path.empty())
+    {
+        boost::filesystem::ifstream sweep_order_file(sweep_order_path, std::ios::binary);
+        sweep_order_file.read((char *)&number_of_sweep_nodes, sizeof(uint32_t));
+        boost::iostreams::seek(sweep_order_file, number_of_sweep_nodes * sizeof(NodeID),
+                               BOOST_IOS::cur);
+        sweep_order_file.read((char *)&number_of_sweep_level_offsets, sizeof(uint32_t));
+        boost::iostreams::seek(sweep_order_file, number_of_sweep_level_offsets * sizeof(unsigned),
+                               BOOST_IOS::cur);
+        sweep_order_file.read((char *)&number_of_node_locations, sizeof(uint32_t));
+        if (!sweep_order_file)
+        {
+            throw util::exception("Could not read " + sweep_order_path.string());
+        }
+    }
+    else
+    {
+        util::SimpleLogger().Write(logWARNING) << "no sweep order file found, one-to-all "
+                                                  "queries will not be available";
+    }
+    layout.SetBlockSize<NodeID>(SharedDataLayout::SWEEP_ORDER, number_of_sweep_nodes);
+    layout.SetBlockSize<unsigned>(SharedDataLayout::SWEEP_LEVEL_OFFSETS,
+                                  number_of_sweep_level_offsets);
+    layout.SetBlockSize<util::FixedPointCoordinate>(SharedDataLayout::NODE_LOCATIONS,
+                                                    number_of_node_locations);
+
+    // load coordinate size
+    boost::filesystem::ifstream nodes_input_stream(GetPath(paths, "nodesdata"), std::ios::binary);
+    unsigned coordinate_list_size = 0;
+    nodes_input_stream.read((char *)&coordinate_list_size, sizeof(unsigned));
+    layout.SetBlockSize<util::FixedPointCoordinate>(SharedDataLayout::COORDINATE_LIST,
+                                                    coordinate_list_size);
+
+    return layout;
+}
+
+void LoadDatasetData(const DatasetPaths &paths, SharedDataLayout &layout, char *memory)
+{
+    // every loader reads its own files into its own blocks, they do not depend on each other
+    std::vector<BlockLoader> loaders = {
+        {"graph", [&]
+         {
+             LoadGraph(paths, layout, memory);
+         }},
+        {"coordinates", [&]
+         {
+             LoadCoordinates(paths, layout, memory);
+         }},
+        {"r-tree", [&]
+         {
+             LoadRTree(paths, layout, memory);
+         }},
+        {"core markers", [&]
+         {
+             LoadCoreMarkers(paths, layout, memory);
+         }},
+        {"sweep order", [&]
+         {
+             LoadSweepOrder(paths, layout, memory);
+         }},
+        {"timestamp", [&]
+         {
+             LoadTimestampAndFileIndexPath(paths, layout, memory);
+         }}};
+    if (layout.HasColdBlocks())
+    {
+        loaders.push_back({"names", [&]
+                           {
+                               LoadNames(paths, layout, memory);
+                           }});
+        loaders.push_back({"original edges", [&]
+                           {
+                               LoadOriginalEdges(paths, layout, memory);
+                           }});
+        loaders.push_back({"geometries", [&]
+                           {
+                               LoadGeometries(paths, layout, memory);
+                           }});
+    }
+    else
+    {
+        // the empty blocks still need their canaries
+        for (const auto bid : COLD_BLOCKS)
+        {
+            layout.GetBlockPtr<char, true>(memory, bid);
+        }
+    }
+
+    TIMER_START(load_data);
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, loaders.size(), 1),
+                      [&](const tbb::blocked_range<std::size_t> &range)
+                      {
+                          for (const auto i : util::irange(range.begin(), range.end()))
+                          {
+                              TIMER_START(load_block);
+                              loaders[i].load();
+                              TIMER_STOP(load_block);
+                              util::SimpleLogger().Write() << "loaded " << loaders[i].name
+                                                           << " in " << TIMER_MSEC(load_block)
+                                                           << "ms";
+                          }
+                      });
+    TIMER_STOP(load_data);
+    util::SimpleLogger().Write() << "loaded all blocks in " << TIMER_MSEC(load_data) << "ms";
+}
+}
+}
@@ -1,19 +1,31 @@
 #include "engine/osrm_impl.hpp"
 
+#include "engine/plugins/batch_route.hpp"
+#include "engine/plugins/cache_statistics.hpp"
 #include "engine/plugins/distance_table.hpp"
 #include "engine/plugins/hello_world.hpp"
+#include "engine/plugins/isochrone.hpp"
+#include "engine/plugins/memory_statistics.hpp"
 #include "engine/plugins/nearest.hpp"
 #include "engine/plugins/timestamp.hpp"
 #include "engine/plugins/trip.hpp"
 #include "engine/plugins/viaroute.hpp"
 #include "engine/plugins/match.hpp"
+#include "engine/plugins/match_stream.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/datafacade/internal_datafacade.hpp"
+#include "engine/datafacade/mapped_datafacade.hpp"
 #include "engine/datafacade/shared_barriers.hpp"
 #include "engine/datafacade/shared_datafacade.hpp"
+#include "engine/route_result_cache.hpp"
+#include "util/huge_pages.hpp"
 #include "util/make_unique.hpp"
+#include "util/osrm_exception.hpp"
+#include "util/packed_static_graph.hpp"
+#include "util/request_arena.hpp"
 #include "util/routed_options.hpp"
 #include "util/simple_logger.hpp"
+#include "util/warm_up.hpp"
 
 #include <boost/assert.hpp>
 #include <boost/interprocess/sync/named_condition.hpp>
@@ -24,7 +36,9 @@
 #include "osrm/route_parameters.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <fstream>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -35,45 +49,180 @@ namespace engine
 
 OSRM::OSRM_impl::OSRM_impl(LibOSRMConfig &lib_config)
 {
+    using EdgeData = contractor::QueryEdge::EdgeData;
+
+    if (lib_config.route_cache_size > 0)
+    {
+        route_result_cache = util::make_unique<RouteResultCache>(lib_config.route_cache_size);
+    }
+
+    util::HugePages::Enable(lib_config.use_huge_pages);
+    util::HugePages::ReportMode();
     if (lib_config.use_shared_memory)
     {
+        if (!lib_config.named_datasets.empty())
+        {
+            throw util::exception("named datasets can only be loaded from files");
+        }
+        if (lib_config.use_compact_graph)
+        {
+            util::SimpleLogger().Write(logWARNING)
+                << "the compact graph is only supported when loading from files, ignoring it";
+        }
         barrier = util::make_unique<datafacade::SharedBarriers>();
-        query_data_facade = new datafacade::SharedDataFacade<contractor::QueryEdge::EdgeData>();
+        auto *facade = new datafacade::SharedDataFacade<EdgeData>();
+        auto &dataset = datasets[""];
+        dataset.query_data_facade = facade;
+        RegisterPlugins(dataset, facade, lib_config);
     }
     else
     {
-        // populate base path
-        util::populate_base_path(lib_config.server_paths);
-        query_data_facade = new datafacade::InternalDataFacade<contractor::QueryEdge::EdgeData>(
-            lib_config.server_paths);
+        LoadDataset(datasets[""], lib_config.server_paths, lib_config);
+    }
+
+    // all datasets share the threads of the server and the route cache
+    for (const auto &name_and_base : lib_config.named_datasets)
+    {
+        util::SimpleLogger().Write() << "loading dataset " << name_and_base.first;
+        ServerPaths server_paths;
+        server_paths["base"] = name_and_base.second;
+        LoadDataset(datasets[name_and_base.first], server_paths, lib_config);
+    }
+
+    for (const auto &name_and_dataset : datasets)
+    {
+        auto *query_data_facade = name_and_dataset.second.query_data_facade;
+        if (lib_config.unpacking_cache_size > 0)
+        {
+            query_data_facade->GetShortcutUnpackingCache().SetMemoryBudget(
+                static_cast<std::size_t>(lib_config.unpacking_cache_size) * 1024 * 1024);
+        }
+
+        if (lib_config.snapping_cache_size > 0)
+        {
+            query_data_facade->GetSnappingCache().SetCapacity(lib_config.snapping_cache_size);
+        }
+    }
+}
+
+namespace
+{
+// Mapped files and shared memory are paged in on demand anyway, the options only change what is
+// read from files.
+datafacade::ColdDataLoading GetColdDataLoading(const LibOSRMConfig &lib_config)
+{
+    if (lib_config.table_only)
+    {
+        return datafacade::ColdDataLoading::Skip;
     }
+    return lib_config.lazy_loading ? datafacade::ColdDataLoading::Lazy
+                                   : datafacade::ColdDataLoading::Eager;
+}
+}
 
-    using DataFacade = datafacade::BaseDataFacade<contractor::QueryEdge::EdgeData>;
+// The type of the facade is chosen once here. The plugins and with them the routing algorithms
+// are instantiated on that concrete type, whose accessors are final, so that the searches do not
+// make a virtual call for every edge they relax. Only the cold paths use the facade through its
+// base class.
+void OSRM::OSRM_impl::LoadDataset(Dataset &dataset,
+                                  ServerPaths &server_paths,
+                                  const LibOSRMConfig &lib_config)
+{
+    using EdgeData = contractor::QueryEdge::EdgeData;
 
+    // populate base path
+    util::populate_base_path(server_paths);
+    const auto dataset_iterator = server_paths.find("dataset");
+    if (dataset_iterator != server_paths.end())
+    {
+        if (lib_config.use_compact_graph)
+        {
+            util::SimpleLogger().Write(logWARNING)
+                << "the compact graph is only supported when loading from files, ignoring it";
+        }
+        auto *facade = new datafacade::MappedDataFacade<EdgeData>(dataset_iterator->second);
+        dataset.query_data_facade = facade;
+        RegisterPlugins(dataset, facade, lib_config);
+    }
+    else if (lib_config.use_compact_graph)
+    {
+        using PackedGraph = util::PackedStaticGraph<EdgeData>;
+        auto *facade = new datafacade::InternalDataFacade<EdgeData, PackedGraph>(
+            server_paths, GetColdDataLoading(lib_config));
+        dataset.query_data_facade = facade;
+        RegisterPlugins(dataset, facade, lib_config);
+    }
+    else
+    {
+        auto *facade = new datafacade::InternalDataFacade<EdgeData>(
+            server_paths, GetColdDataLoading(lib_config));
+        dataset.query_data_facade = facade;
+        RegisterPlugins(dataset, facade, lib_config);
+    }
+}
+
+template <typename DataFacadeT>
+void OSRM::OSRM_impl::RegisterPlugins(Dataset &dataset,
+                                      DataFacadeT *facade,
+                                      const LibOSRMConfig &lib_config)
+{
     // The following plugins handle all requests.
-    RegisterPlugin(new plugins::DistanceTablePlugin<DataFacade>(
-        query_data_facade, lib_config.max_locations_distance_table));
-    RegisterPlugin(new plugins::HelloWorldPlugin());
-    RegisterPlugin(new plugins::NearestPlugin<DataFacade>(query_data_facade));
-    RegisterPlugin(new plugins::MapMatchingPlugin<DataFacade>(
-        query_data_facade, lib_config.max_locations_map_matching));
-    RegisterPlugin(new plugins::TimestampPlugin<DataFacade>(query_data_facade));
-    RegisterPlugin(new plugins::ViaRoutePlugin<DataFacade>(query_data_facade,
-                                                           lib_config.max_locations_viaroute));
-    RegisterPlugin(
-        new plugins::RoundTripPlugin<DataFacade>(query_data_facade, lib_config.max_locations_trip));
+    RegisterPlugin(dataset, new plugins::DistanceTablePlugin<DataFacadeT>(
+                                facade, lib_config.max_locations_distance_table,
+                                lib_config.min_targets_for_sweep));
+    RegisterPlugin(dataset, new plugins::HelloWorldPlugin());
+    RegisterPlugin(dataset, new plugins::IsochronePlugin<DataFacadeT>(
+                                facade, lib_config.max_locations_isochrone));
+    RegisterPlugin(dataset, new plugins::TimestampPlugin<DataFacadeT>(facade));
+    RegisterPlugin(dataset, new plugins::CacheStatisticsPlugin<DataFacadeT>(
+                                facade, route_result_cache.get()));
+    RegisterPlugin(dataset, new plugins::MemoryStatisticsPlugin<DataFacadeT>(facade));
+
+    // the other services describe routes or snapped locations by name
+    if (lib_config.table_only || !facade->HasColdData())
+    {
+        util::SimpleLogger().Write() << "serving distance tables and isochrones only";
+        return;
+    }
+
+    RegisterPlugin(dataset, new plugins::NearestPlugin<DataFacadeT>(facade));
+    RegisterPlugin(dataset, new plugins::MapMatchingPlugin<DataFacadeT>(
+                                facade, lib_config.max_locations_map_matching));
+    if (lib_config.max_matching_sessions > 0)
+    {
+        RegisterPlugin(dataset, new plugins::StreamingMapMatchingPlugin<DataFacadeT>(
+                                    facade, lib_config.max_locations_map_matching,
+                                    lib_config.max_matching_sessions,
+                                    std::chrono::seconds(lib_config.matching_session_timeout),
+                                    lib_config.replica_index, lib_config.number_of_replicas));
+    }
+    RegisterPlugin(dataset,
+                   new plugins::ViaRoutePlugin<DataFacadeT>(
+                       facade, lib_config.max_locations_viaroute, route_result_cache.get()));
+    RegisterPlugin(dataset, new plugins::RoundTripPlugin<DataFacadeT>(
+                                facade, lib_config.max_locations_trip));
+    RegisterPlugin(dataset, new plugins::BatchRoutePlugin<DataFacadeT>(
+                                facade, lib_config.max_pairs_batch_route));
 }
 
-void OSRM::OSRM_impl::RegisterPlugin(plugins::BasePlugin *raw_plugin_ptr)
+void OSRM::OSRM_impl::RegisterPlugin(Dataset &dataset, plugins::BasePlugin *raw_plugin_ptr)
 {
     std::unique_ptr<plugins::BasePlugin> plugin_ptr(raw_plugin_ptr);
     util::SimpleLogger().Write() << "loaded plugin: " << plugin_ptr->GetDescriptor();
-    plugin_map[plugin_ptr->GetDescriptor()] = std::move(plugin_ptr);
+    dataset.plugin_map[plugin_ptr->GetDescriptor()] = std::move(plugin_ptr);
 }
 
 int OSRM::OSRM_impl::RunQuery(const RouteParameters &route_parameters,
                               util::json::Object &json_result)
 {
+    const auto dataset_iterator = datasets.find(route_parameters.dataset);
+    if (datasets.end() == dataset_iterator)
+    {
+        json_result.values["status_message"] = "Dataset not found";
+        return 400;
+    }
+
+    const auto &plugin_map = dataset_iterator->second.plugin_map;
     const auto &plugin_iterator = plugin_map.find(route_parameters.service);
 
     if (plugin_map.end() == plugin_iterator)
@@ -83,11 +232,80 @@ int OSRM::OSRM_impl::RunQuery(const RouteParameters &route_parameters,
     }
 
     increase_concurrent_query_count();
-    auto return_code = plugin_iterator->second->HandleRequest(route_parameters, json_result);
+    plugins::BasePlugin::Status return_code;
+    {
+        // temporary containers of the request are served from a per-thread arena that is
+        // released in one go when the scope ends
+        util::RequestArenaScope arena_scope;
+        return_code = plugin_iterator->second->HandleRequest(route_parameters, json_result);
+
+        const auto &statistics = arena_scope.GetArena().GetStatistics();
+        util::SimpleLogger().Write(logDEBUG)
+            << route_parameters.service << ": " << statistics.allocations
+            << " arena allocations (" << statistics.allocated_bytes << " bytes), "
+            << statistics.system_allocations << " system allocations";
+    }
     decrease_concurrent_query_count();
     return static_cast<int>(return_code);
 }
 
+// Counts as a query, so that osrm-datastore does not swap the shared memory regions while they
+// are paged in.
+std::size_t OSRM::OSRM_impl::WarmUp(const std::vector<std::string> &block_names)
+{
+    std::set<std::string> found_names;
+    const auto is_selected = [&](const std::string &name)
+    {
+        if (block_names.empty())
+        {
+            return true;
+        }
+        if (std::find(block_names.begin(), block_names.end(), name) == block_names.end())
+        {
+            return false;
+        }
+        found_names.insert(name);
+        return true;
+    };
+
+    increase_concurrent_query_count();
+    std::size_t paged_in = 0;
+    for (const auto &name_and_dataset : datasets)
+    {
+        const auto *facade = name_and_dataset.second.query_data_facade;
+        std::vector<util::MemoryBlock> blocks;
+        for (const auto &block : facade->GetMemoryBlocks())
+        {
+            if (is_selected(block.name))
+            {
+                blocks.push_back(block);
+            }
+        }
+        auto dataset_paged_in = util::PageIn(blocks);
+
+        const auto leaf_file_path = facade->GetLeafFilePath();
+        if (!leaf_file_path.empty() && is_selected("r-tree leaves"))
+        {
+            dataset_paged_in += util::PageInFile("r-tree leaves", leaf_file_path);
+        }
+        util::SimpleLogger().Write() << "paged in " << dataset_paged_in << " bytes of "
+                                     << (name_and_dataset.first.empty()
+                                             ? std::string("the default dataset")
+                                             : "dataset " + name_and_dataset.first);
+        paged_in += dataset_paged_in;
+    }
+    decrease_concurrent_query_count();
+
+    for (const auto &name : block_names)
+    {
+        if (found_names.count(name) == 0)
+        {
+            util::SimpleLogger().Write(logWARNING) << "no block named " << name << " to warm up";
+        }
+    }
+    return paged_in;
+}
+
 // decrease number of concurrent queries
 void OSRM::OSRM_impl::decrease_concurrent_query_count()
 {
@@ -132,8 +350,9 @@ void OSRM::OSRM_impl::increase_concurrent_query_count()
     // increment query count
     ++(barrier->number_of_queries);
 
+    // with shared memory there is only the default dataset
     (static_cast<datafacade::SharedDataFacade<contractor::QueryEdge::EdgeData> *>(
-         query_data_facade))
+         datasets.at("").query_data_facade))
         ->CheckAndReloadFacade();
 }
 
@@ -147,5 +366,10 @@ int OSRM::RunQuery(const RouteParameters &route_parameters, util::json::Object &
 {
     return OSRM_pimpl_->RunQuery(route_parameters, json_result);
 }
+
+std::size_t OSRM::WarmUp(const std::vector<std::string> &block_names)
+{
+    return OSRM_pimpl_->WarmUp(block_names);
+}
 }
 }
@@ -18,7 +18,8 @@ namespace engine
 RouteParameters::RouteParameters()
     : zoom_level(18), print_instructions(false), alternate_route(true), geometry(true),
       compression(true), deprecatedAPI(false), uturn_default(false), classify(false),
-      matching_beta(5), gps_precision(5), check_sum(-1), num_results(1)
+      close_session(false), durations(false), matching_beta(5), gps_precision(5), check_sum(-1),
+      num_results(1), number_of_alternatives(1)
 {
 }
 
@@ -40,6 +41,14 @@ void RouteParameters::SetNumberOfResults(const short number)
 
 void RouteParameters::SetAlternateRouteFlag(const bool flag) { alternate_route = flag; }
 
+void RouteParameters::SetNumberOfAlternatives(const short number)
+{
+    if (number > 0 && number <= 5)
+    {
+        number_of_alternatives = number;
+    }
+}
+
 void RouteParameters::SetUTurn(const bool flag)
 {
     // the API grammar should make sure this never happens
@@ -66,8 +75,14 @@ void RouteParameters::SetInstructionFlag(const bool flag) { print_instructions =
 
 void RouteParameters::SetService(const std::string &service_string) { service = service_string; }
 
+void RouteParameters::SetDataset(const std::string &dataset_string) { dataset = dataset_string; }
+
 void RouteParameters::SetClassify(const bool flag) { classify = flag; }
 
+void RouteParameters::SetSession(const std::string &id) { session_id = id; }
+
+void RouteParameters::SetCloseSession(const bool flag) { close_session = flag; }
+
 void RouteParameters::SetMatchingBeta(const double beta) { matching_beta = beta; }
 
 void RouteParameters::SetGPSPrecision(const double precision) { gps_precision = precision; }
@@ -97,6 +112,10 @@ void RouteParameters::AddTimestamp(const unsigned timestamp)
     }
 }
 
+void RouteParameters::AddTimeLimit(const unsigned seconds) { time_limits.push_back(seconds); }
+
+void RouteParameters::SetDurationsFlag(const bool flag) { durations = flag; }
+
 void RouteParameters::AddBearing(
     const boost::fusion::vector<int, boost::optional<int>> &received_bearing,
     boost::spirit::qi::unused_type /* unused */,
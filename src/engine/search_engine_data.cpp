@@ -2,72 +2,185 @@
 
 #include "util/binary_heap.hpp"
 
+#include <array>
+#include <atomic>
+
 namespace osrm
 {
 namespace engine
 {
 
-void SearchEngineData::InitializeOrClearFirstThreadLocalStorage(const unsigned number_of_nodes)
+namespace
 {
-    if (forward_heap_1.get())
-    {
-        forward_heap_1->Clear();
-    }
-    else
+enum Slot
+{
+    FIRST_HEAPS,
+    SECOND_HEAPS,
+    THIRD_HEAPS,
+    UNPACKING_BUFFERS,
+    HMM_STORAGE,
+    ONE_TO_ALL_WEIGHTS,
+    NUMBER_OF_SLOTS
+};
+
+const char *const SLOT_NAMES[NUMBER_OF_SLOTS] = {"first heaps",       "second heaps",
+                                                 "third heaps",       "unpacking buffers",
+                                                 "hmm storage",       "one-to-all weights"};
+
+// zero initialized before any thread starts
+std::array<std::atomic<std::size_t>, NUMBER_OF_SLOTS> slot_threads;
+std::array<std::atomic<std::size_t>, NUMBER_OF_SLOTS> slot_bytes;
+
+// What a thread last reported for its slots, taken back when the thread exits together with
+// the storage it describes.
+struct ThreadUsage
+{
+    std::array<bool, NUMBER_OF_SLOTS> used{};
+    std::array<std::size_t, NUMBER_OF_SLOTS> bytes{};
+
+    ~ThreadUsage()
     {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes));
+        for (std::size_t slot = 0; slot < NUMBER_OF_SLOTS; ++slot)
+        {
+            if (used[slot])
+            {
+                slot_threads[slot].fetch_sub(1, std::memory_order_relaxed);
+                slot_bytes[slot].fetch_sub(bytes[slot], std::memory_order_relaxed);
+            }
+        }
     }
+};
+
+boost::thread_specific_ptr<ThreadUsage> thread_usage;
 
-    if (reverse_heap_1.get())
+void ReportUsage(const Slot slot, const std::size_t bytes)
+{
+    if (!thread_usage.get())
     {
-        reverse_heap_1->Clear();
+        thread_usage.reset(new ThreadUsage());
     }
-    else
+    auto &usage = *thread_usage;
+    if (!usage.used[slot])
     {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes));
+        usage.used[slot] = true;
+        slot_threads[slot].fetch_add(1, std::memory_order_relaxed);
     }
+    // wraps around if the storage shrank, the sum stays right
+    slot_bytes[slot].fetch_add(bytes - usage.bytes[slot], std::memory_order_relaxed);
+    usage.bytes[slot] = bytes;
 }
 
-void SearchEngineData::InitializeOrClearSecondThreadLocalStorage(const unsigned number_of_nodes)
+void InitializeOrClearHeaps(const Slot slot,
+                            SearchEngineData::SearchEngineHeapPtr &forward_heap,
+                            SearchEngineData::SearchEngineHeapPtr &reverse_heap,
+                            const unsigned number_of_nodes)
 {
-    if (forward_heap_2.get())
+    // the heaps are reported before they are cleared, that is when they are largest
+    if (forward_heap.get() && reverse_heap.get())
     {
-        forward_heap_2->Clear();
+        ReportUsage(slot, forward_heap->GetMemoryUsage() + reverse_heap->GetMemoryUsage());
+    }
+
+    if (forward_heap.get())
+    {
+        forward_heap->Clear();
     }
     else
     {
-        forward_heap_2.reset(new QueryHeap(number_of_nodes));
+        forward_heap.reset(new SearchEngineData::QueryHeap(number_of_nodes));
     }
 
-    if (reverse_heap_2.get())
+    if (reverse_heap.get())
     {
-        reverse_heap_2->Clear();
+        reverse_heap->Clear();
     }
     else
     {
-        reverse_heap_2.reset(new QueryHeap(number_of_nodes));
+        reverse_heap.reset(new SearchEngineData::QueryHeap(number_of_nodes));
     }
 }
+}
 
-void SearchEngineData::InitializeOrClearThirdThreadLocalStorage(const unsigned number_of_nodes)
+SearchEngineData::SearchEngineHeapPtr SearchEngineData::forward_heap_1;
+SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_1;
+SearchEngineData::SearchEngineHeapPtr SearchEngineData::forward_heap_2;
+SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_2;
+SearchEngineData::SearchEngineHeapPtr SearchEngineData::forward_heap_3;
+SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_3;
+
+SearchEngineData::UnpackingBuffersPtr SearchEngineData::unpacking_buffers;
+
+SearchEngineData::UnpackingBuffers &SearchEngineData::GetThreadLocalUnpackingBuffers()
 {
-    if (forward_heap_3.get())
+    if (!unpacking_buffers.get())
     {
-        forward_heap_3->Clear();
+        unpacking_buffers.reset(new UnpackingBuffers());
     }
-    else
+    ReportUsage(UNPACKING_BUFFERS, unpacking_buffers->GetMemoryUsage());
+    return *unpacking_buffers;
+}
+
+SearchEngineData::HMMStoragePtr SearchEngineData::hmm_storage;
+
+map_matching::StateStorage &SearchEngineData::GetThreadLocalHMMStorage()
+{
+    if (!hmm_storage.get())
     {
-        forward_heap_3.reset(new QueryHeap(number_of_nodes));
+        hmm_storage.reset(new map_matching::StateStorage());
     }
+    ReportUsage(HMM_STORAGE, hmm_storage->GetMemoryUsage());
+    return *hmm_storage;
+}
+
+SearchEngineData::OneToAllWeightsPtr SearchEngineData::one_to_all_weights;
+
+constexpr std::size_t SearchEngineData::MAX_RETAINED_ONE_TO_ALL_BYTES;
 
-    if (reverse_heap_3.get())
+std::vector<EdgeWeight> &SearchEngineData::GetThreadLocalOneToAllWeights()
+{
+    if (!one_to_all_weights.get())
     {
-        reverse_heap_3->Clear();
+        one_to_all_weights.reset(new std::vector<EdgeWeight>());
     }
-    else
+    ReportUsage(ONE_TO_ALL_WEIGHTS, one_to_all_weights->capacity() * sizeof(EdgeWeight));
+    return *one_to_all_weights;
+}
+
+void SearchEngineData::ReleaseThreadLocalOneToAllWeights()
+{
+    if (!one_to_all_weights.get() ||
+        one_to_all_weights->capacity() * sizeof(EdgeWeight) <= MAX_RETAINED_ONE_TO_ALL_BYTES)
+    {
+        return;
+    }
+    std::vector<EdgeWeight>().swap(*one_to_all_weights);
+    ReportUsage(ONE_TO_ALL_WEIGHTS, 0);
+}
+
+void SearchEngineData::InitializeOrClearFirstThreadLocalStorage(const unsigned number_of_nodes)
+{
+    InitializeOrClearHeaps(FIRST_HEAPS, forward_heap_1, reverse_heap_1, number_of_nodes);
+}
+
+void SearchEngineData::InitializeOrClearSecondThreadLocalStorage(const unsigned number_of_nodes)
+{
+    InitializeOrClearHeaps(SECOND_HEAPS, forward_heap_2, reverse_heap_2, number_of_nodes);
+}
+
+void SearchEngineData::InitializeOrClearThirdThreadLocalStorage(const unsigned number_of_nodes)
+{
+    InitializeOrClearHeaps(THIRD_HEAPS, forward_heap_3, reverse_heap_3, number_of_nodes);
+}
+
+std::vector<SearchEngineData::SlotStatistics> SearchEngineData::GetSlotStatistics()
+{
+    std::vector<SlotStatistics> statistics;
+    for (std::size_t slot = 0; slot < NUMBER_OF_SLOTS; ++slot)
     {
-        reverse_heap_3.reset(new QueryHeap(number_of_nodes));
+        statistics.push_back({SLOT_NAMES[slot], slot_threads[slot].load(std::memory_order_relaxed),
+                              slot_bytes[slot].load(std::memory_order_relaxed)});
     }
+    return statistics;
 }
 }
 }
@@ -4,7 +4,10 @@
 #include "server/http/reply.hpp"
 #include "server/http/request.hpp"
 
+#include "engine/matching_session_store.hpp"
+
 #include "util/json_renderer.hpp"
+#include "util/numa.hpp"
 #include "util/simple_logger.hpp"
 #include "util/string_util.hpp"
 #include "util/xml_renderer.hpp"
@@ -25,7 +28,7 @@ namespace osrm
 namespace server
 {
 
-RequestHandler::RequestHandler() : routing_machine(nullptr) {}
+RequestHandler::RequestHandler() {}
 
 void RequestHandler::handle_request(const http::request &current_request,
                                     http::reply &current_reply)
@@ -75,7 +78,8 @@ void RequestHandler::handle_request(const http::request &current_request,
         if (result && api_iterator == request_string.end())
         {
             // parsing done, lets call the right plugin to handle the request
-            BOOST_ASSERT_MSG(routing_machine != nullptr, "pointer not init'ed");
+            BOOST_ASSERT_MSG(!routing_machines.empty(), "pointer not init'ed");
+            const auto routing_machine = routing_machines[GetReplica(route_parameters)];
 
             if (!route_parameters.jsonp_parameter.empty())
             { // prepend response with jsonp parameter
@@ -153,6 +157,22 @@ void RequestHandler::handle_request(const http::request &current_request,
     }
 }
 
-void RequestHandler::RegisterRoutingMachine(OSRM *osrm) { routing_machine = osrm; }
+std::size_t RequestHandler::GetReplica(const engine::RouteParameters &route_parameters) const
+{
+    // an open online map matching session only exists on the replica that created it
+    if (route_parameters.service == "matchstream" && !route_parameters.session_id.empty())
+    {
+        return engine::MatchingSessionStore::GetReplica(route_parameters.session_id,
+                                                        routing_machines.size());
+    }
+    return util::NUMATopology::GetThreadNode() % routing_machines.size();
+}
+
+void RequestHandler::RegisterRoutingMachine(OSRM *osrm) { routing_machines = {osrm}; }
+
+void RequestHandler::RegisterRoutingMachines(const std::vector<OSRM *> &osrms)
+{
+    routing_machines = osrms;
+}
 }
 }
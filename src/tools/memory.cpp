@@ -0,0 +1,143 @@
+#include "datastore/dataset_file.hpp"
+#include "datastore/shared_memory_factory.hpp"
+#include "engine/datafacade/shared_datatype.hpp"
+#include "util/osrm_exception.hpp"
+#include "util/residency.hpp"
+#include "util/simple_logger.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstdlib>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace tools
+{
+
+using engine::datafacade::SharedDataLayout;
+
+// Size and residency of every block of a dataset laid out as in shared memory.
+std::vector<util::MemoryStatistics> GetBlockStatistics(const SharedDataLayout &layout,
+                                                       const char *memory)
+{
+    std::vector<util::MemoryStatistics> statistics;
+    for (auto i = 0; i < SharedDataLayout::NUM_BLOCKS; ++i)
+    {
+        const auto bid = static_cast<SharedDataLayout::BlockID>(i);
+        statistics.push_back(util::MakeMemoryStatistics(SharedDataLayout::GetBlockName(bid),
+                                                        memory + layout.GetBlockOffset(bid),
+                                                        layout.GetBlockSize(bid)));
+    }
+    return statistics;
+}
+
+// Mapping the file does not read it, only the pages that are already in the page cache count.
+std::vector<util::MemoryStatistics> GetDatasetFileStatistics(const boost::filesystem::path &path)
+{
+    if (!boost::filesystem::is_regular_file(path) ||
+        boost::filesystem::file_size(path) < datastore::DATASET_DATA_OFFSET)
+    {
+        throw util::exception(path.string() + " is not a dataset");
+    }
+    boost::interprocess::file_mapping file(path.string().c_str(), boost::interprocess::read_only);
+    boost::interprocess::mapped_region region(file, boost::interprocess::read_only);
+    const char *memory = static_cast<const char *>(region.get_address());
+
+    const auto *header = reinterpret_cast<const datastore::DatasetFileHeader *>(memory);
+    if (!header->IsDataset())
+    {
+        throw util::exception(path.string() + " is not a dataset");
+    }
+    if (region.get_size() < datastore::DATASET_DATA_OFFSET + header->layout.GetSizeOfLayout())
+    {
+        throw util::exception(path.string() + " is truncated");
+    }
+    return GetBlockStatistics(header->layout, memory + datastore::DATASET_DATA_OFFSET);
+}
+
+// Attaches to the regions osrm-datastore loaded last, read only and without removing them.
+std::vector<util::MemoryStatistics> GetSharedMemoryStatistics()
+{
+    if (!datastore::SharedMemory::RegionExists(engine::datafacade::CURRENT_REGIONS))
+    {
+        throw util::exception("no shared memory regions found, is osrm-datastore running?");
+    }
+    std::unique_ptr<datastore::SharedMemory> timestamp_memory(
+        datastore::SharedMemoryFactory::Get(engine::datafacade::CURRENT_REGIONS));
+    const auto *timestamp =
+        static_cast<const engine::datafacade::SharedDataTimestamp *>(timestamp_memory->Ptr());
+
+    std::unique_ptr<datastore::SharedMemory> layout_memory(
+        datastore::SharedMemoryFactory::Get(timestamp->layout));
+    std::unique_ptr<datastore::SharedMemory> data_memory(
+        datastore::SharedMemoryFactory::Get(timestamp->data));
+    const auto *layout = static_cast<const SharedDataLayout *>(layout_memory->Ptr());
+    return GetBlockStatistics(*layout, static_cast<const char *>(data_memory->Ptr()));
+}
+
+// The files osrm-routed reads when it loads the dataset itself.
+std::vector<util::MemoryStatistics> GetBaseFileStatistics(const std::string &base_string)
+{
+    std::vector<util::MemoryStatistics> statistics;
+    for (const auto extension : {".hsgr", ".nodes", ".edges", ".geometry", ".ramIndex",
+                                 ".fileIndex", ".core", ".names", ".timestamp", ".order"})
+    {
+        statistics.push_back(util::MakeFileStatistics(extension, base_string + extension));
+    }
+    return statistics;
+}
+
+void PrintStatistics(const std::vector<util::MemoryStatistics> &statistics)
+{
+    std::size_t total_size = 0, total_resident = 0;
+    for (const auto &block : statistics)
+    {
+        std::string name = block.name;
+        name.resize(21, ' ');
+        util::SimpleLogger().Write() << name << ": " << block.resident << " of " << block.size
+                                     << " bytes resident";
+        total_size += block.size;
+        total_resident += block.resident;
+    }
+    util::SimpleLogger().Write() << "total: " << total_resident << " of " << total_size
+                                 << " bytes resident";
+}
+}
+}
+
+int main(int argc, char *argv[]) try
+{
+    osrm::util::LogPolicy::GetInstance().Unmute();
+    if (argc != 2)
+    {
+        osrm::util::SimpleLogger().Write(logWARNING)
+            << "usage: " << argv[0] << " <file.osrm.dataset> | <file.osrm> | --shared-memory";
+        return EXIT_FAILURE;
+    }
+
+    const std::string argument = argv[1];
+    if (argument == "--shared-memory" || argument == "-s")
+    {
+        osrm::tools::PrintStatistics(osrm::tools::GetSharedMemoryStatistics());
+    }
+    else if (boost::filesystem::extension(argument) == ".dataset")
+    {
+        osrm::tools::PrintStatistics(osrm::tools::GetDatasetFileStatistics(argument));
+    }
+    else
+    {
+        osrm::tools::PrintStatistics(osrm::tools::GetBaseFileStatistics(argument));
+    }
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    osrm::util::SimpleLogger().Write(logWARNING) << "[exception] " << e.what();
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,113 @@
+#include "datastore/dataset_file.hpp"
+#include "datastore/dataset_loader.hpp"
+#include "engine/datafacade/shared_datatype.hpp"
+#include "util/osrm_exception.hpp"
+#include "util/simple_logger.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstdlib>
+
+#include <fstream>
+#include <new>
+#include <string>
+
+namespace osrm
+{
+namespace tools
+{
+
+// the names of the paths are the ones used by osrm-datastore
+datastore::DatasetPaths GetDatasetPaths(const std::string &base_string)
+{
+    datastore::DatasetPaths paths;
+    paths["hsgrdata"] = base_string + ".hsgr";
+    paths["nodesdata"] = base_string + ".nodes";
+    paths["edgesdata"] = base_string + ".edges";
+    paths["geometry"] = base_string + ".geometry";
+    paths["ramindex"] = base_string + ".ramIndex";
+    paths["fileindex"] = base_string + ".fileIndex";
+    paths["core"] = base_string + ".core";
+    paths["namesdata"] = base_string + ".names";
+    paths["timestamp"] = base_string + ".timestamp";
+    paths["order"] = base_string + ".order";
+
+    for (const auto &name_and_path : paths)
+    {
+        if (name_and_path.first != "timestamp" && name_and_path.first != "order" &&
+            !boost::filesystem::is_regular_file(name_and_path.second))
+        {
+            throw util::exception(name_and_path.second.string() + " not found");
+        }
+    }
+    return paths;
+}
+
+// Writes all blocks into a temporary file next to the output, which replaces the output only
+// after it was written completely. Processes that still map an older version of the output
+// keep their pages.
+void WriteDataset(const datastore::DatasetPaths &paths, const boost::filesystem::path &output)
+{
+    datastore::CheckDatasetPaths(paths);
+    const auto layout = datastore::LoadDatasetLayout(paths, true);
+    const auto file_size = datastore::DATASET_DATA_OFFSET + layout.GetSizeOfLayout();
+
+    const boost::filesystem::path temporary_path = output.string() + ".tmp";
+    {
+        std::ofstream create_stream(temporary_path.string(), std::ios::binary | std::ios::trunc);
+        if (!create_stream)
+        {
+            throw util::exception("could not create " + temporary_path.string());
+        }
+    }
+    boost::filesystem::resize_file(temporary_path, file_size);
+
+    util::SimpleLogger().Write() << "writing dataset of " << file_size << " bytes";
+    {
+        boost::interprocess::file_mapping file(temporary_path.string().c_str(),
+                                               boost::interprocess::read_write);
+        boost::interprocess::mapped_region region(file, boost::interprocess::read_write);
+        char *memory = static_cast<char *>(region.get_address());
+
+        auto *header = new (memory) datastore::DatasetFileHeader(
+            datastore::DatasetFileHeader::Make(layout));
+        datastore::LoadDatasetData(paths, header->layout,
+                                   memory + datastore::DATASET_DATA_OFFSET);
+
+        if (!region.flush())
+        {
+            throw util::exception("could not write " + temporary_path.string());
+        }
+    }
+
+    boost::filesystem::rename(temporary_path, output);
+    layout.PrintInformation();
+}
+}
+}
+
+int main(int argc, char *argv[]) try
+{
+    osrm::util::LogPolicy::GetInstance().Unmute();
+    if (argc != 2 && argc != 3)
+    {
+        osrm::util::SimpleLogger().Write(logWARNING) << "usage: " << argv[0]
+                                                     << " <file.osrm> [<file.osrm.dataset>]";
+        return EXIT_FAILURE;
+    }
+
+    const std::string base_string = argv[1];
+    const boost::filesystem::path output_path =
+        argc == 3 ? std::string(argv[2]) : base_string + ".dataset";
+
+    osrm::tools::WriteDataset(osrm::tools::GetDatasetPaths(base_string), output_path);
+    osrm::util::SimpleLogger().Write() << "wrote " << output_path.string();
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    osrm::util::SimpleLogger().Write(logWARNING) << "[exception] " << e.what();
+    return EXIT_FAILURE;
+}
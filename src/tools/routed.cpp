@@ -1,10 +1,20 @@
+#include "server/api_grammar.hpp"
+#include "server/request_handler.hpp"
 #include "server/server.hpp"
 #include "util/ini_file.hpp"
+#include "util/make_unique.hpp"
+#include "util/numa.hpp"
 #include "util/routed_options.hpp"
 #include "util/simple_logger.hpp"
+#include "util/string_util.hpp"
 
+#include "osrm/json_container.hpp"
 #include "osrm/osrm.hpp"
 #include "osrm/libosrm_config.hpp"
+#include "osrm/route_parameters.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
 
 #ifdef __linux__
 #include <sys/mman.h>
@@ -14,11 +24,15 @@
 
 #include <signal.h>
 
+#include <atomic>
 #include <chrono>
 #include <future>
 #include <iostream>
+#include <memory>
 #include <new>
+#include <string>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
 boost::function0<void> console_ctrl_function;
@@ -41,20 +55,101 @@ BOOL WINAPI console_ctrl_handler(DWORD ctrl_type)
 
 using namespace osrm;
 
+namespace
+{
+// Replays request paths, e.g. sampled from an access log, on every routing machine. Unlike paging
+// in the blocks this also fills the caches of the engine and reads the pages the queries of real
+// traffic read. Returns the number of queries that failed.
+std::size_t ReplayQueries(const boost::filesystem::path &queries_path,
+                          const std::vector<OSRM *> &routing_machines,
+                          const unsigned number_of_threads)
+{
+    std::vector<std::string> queries;
+    boost::filesystem::ifstream queries_stream(queries_path);
+    std::string line;
+    while (std::getline(queries_stream, line))
+    {
+        if (!line.empty())
+        {
+            queries.push_back(line);
+        }
+    }
+    util::SimpleLogger().Write() << "replaying " << queries.size() << " warm-up queries";
+
+    const auto number_of_runs = queries.size() * routing_machines.size();
+    std::atomic<std::size_t> next_run(0);
+    std::atomic<std::size_t> failed_runs(0);
+    const auto replay = [&]
+    {
+        for (auto run = next_run++; run < number_of_runs; run = next_run++)
+        {
+            try
+            {
+                std::string request_string;
+                util::URIDecode(queries[run % queries.size()], request_string);
+
+                engine::RouteParameters route_parameters;
+                server::RequestHandler::APIGrammarParser api_parser(&route_parameters);
+                auto api_iterator = request_string.begin();
+                const bool parsed =
+                    boost::spirit::qi::parse(api_iterator, request_string.end(), api_parser);
+
+                if (!parsed || api_iterator != request_string.end())
+                {
+                    ++failed_runs;
+                    continue;
+                }
+
+                util::json::Object json_result;
+                auto *routing_machine = routing_machines[run / queries.size()];
+                if (routing_machine->RunQuery(route_parameters, json_result) / 100 != 2)
+                {
+                    ++failed_runs;
+                }
+            }
+            catch (const std::exception &)
+            {
+                ++failed_runs;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < number_of_threads; ++i)
+    {
+        threads.emplace_back(replay);
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    return failed_runs;
+}
+}
+
 int main(int argc, const char *argv[]) try
 {
     util::LogPolicy::GetInstance().Unmute();
 
     bool trial_run = false;
+    bool use_numa = false;
+    bool warm_up = false;
+    std::vector<std::string> warm_up_blocks;
+    boost::filesystem::path warm_up_queries;
     std::string ip_address;
     int ip_port, requested_thread_num;
 
     LibOSRMConfig lib_config;
     const unsigned init_result = util::GenerateServerProgramOptions(
-        argc, argv, lib_config.server_paths, ip_address, ip_port, requested_thread_num,
-        lib_config.use_shared_memory, trial_run, lib_config.max_locations_trip,
+        argc, argv, lib_config.server_paths, lib_config.named_datasets, ip_address, ip_port,
+        requested_thread_num, lib_config.use_shared_memory, lib_config.use_huge_pages,
+        lib_config.use_compact_graph, lib_config.lazy_loading, lib_config.table_only, use_numa,
+        trial_run, warm_up, warm_up_blocks, warm_up_queries, lib_config.max_locations_trip,
         lib_config.max_locations_viaroute, lib_config.max_locations_distance_table,
-        lib_config.max_locations_map_matching);
+        lib_config.max_locations_map_matching, lib_config.unpacking_cache_size,
+        lib_config.route_cache_size, lib_config.snapping_cache_size,
+        lib_config.max_matching_sessions, lib_config.matching_session_timeout,
+        lib_config.max_locations_isochrone, lib_config.max_pairs_batch_route);
     if (init_result == util::INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -102,10 +197,76 @@ int main(int argc, const char *argv[]) try
     pthread_sigmask(SIG_BLOCK, &new_mask, &old_mask);
 #endif
 
-    OSRM osrm_lib(lib_config);
-    auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num);
+    // Shared memory and mapped datasets exist only once, whichever node reads them, so only data
+    // that is loaded into the process can be replicated.
+    const auto &topology = util::NUMATopology::Get();
+    const bool replicate_data = use_numa && topology.IsNUMA() && !lib_config.use_shared_memory &&
+                                lib_config.server_paths["base"].extension() != ".dataset";
+    if (use_numa && !replicate_data)
+    {
+        util::SimpleLogger().Write(logWARNING)
+            << "NUMA mode needs more than one node and data that is loaded into the process, "
+               "using a single copy of the data";
+    }
+
+    std::vector<std::unique_ptr<OSRM>> osrm_libs;
+    if (replicate_data)
+    {
+        util::SimpleLogger().Write() << "loading a copy of the data on each of "
+                                     << topology.GetNumberOfNodes() << " NUMA nodes";
+        osrm_libs = topology.CreateReplicas<OSRM>([&lib_config, &topology]
+                                                  {
+                                                      // the configuration is adapted while loading
+                                                      auto node_config = lib_config;
+                                                      node_config.replica_index =
+                                                          util::NUMATopology::GetThreadNode();
+                                                      node_config.number_of_replicas =
+                                                          topology.GetNumberOfNodes();
+                                                      return util::make_unique<OSRM>(node_config);
+                                                  });
+    }
+    else
+    {
+        osrm_libs.push_back(util::make_unique<OSRM>(lib_config));
+    }
+
+    std::vector<OSRM *> routing_machines;
+    for (const auto &osrm_lib : osrm_libs)
+    {
+        routing_machines.push_back(osrm_lib.get());
+    }
+
+    // the port is only opened once the data is warm, load balancers send traffic only then
+    if (warm_up || !warm_up_queries.empty())
+    {
+        const auto warm_up_start = std::chrono::steady_clock::now();
+        if (warm_up)
+        {
+            std::size_t paged_in = 0;
+            for (auto *routing_machine : routing_machines)
+            {
+                paged_in += routing_machine->WarmUp(warm_up_blocks);
+            }
+            util::SimpleLogger().Write() << "paged in " << paged_in << " bytes";
+        }
+        if (!warm_up_queries.empty())
+        {
+            const auto failed_queries =
+                ReplayQueries(warm_up_queries, routing_machines, requested_thread_num);
+            if (failed_queries > 0)
+            {
+                util::SimpleLogger().Write(logWARNING) << failed_queries
+                                                       << " warm-up queries failed";
+            }
+        }
+        const auto warm_up_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - warm_up_start);
+        util::SimpleLogger().Write() << "warm-up took " << warm_up_time.count() << " ms";
+    }
 
-    routing_server->GetRequestHandlerPtr().RegisterRoutingMachine(&osrm_lib);
+    auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num,
+                                                       replicate_data);
+    routing_server->GetRequestHandlerPtr().RegisterRoutingMachines(routing_machines);
 
     if (trial_run)
     {
@@ -8,6 +8,7 @@
 #include "osrm/osrm.hpp"
 
 #include <string>
+#include <vector>
 
 int main(int argc, const char *argv[])
 {
@@ -17,12 +18,21 @@ int main(int argc, const char *argv[])
         std::string ip_address;
         int ip_port, requested_thread_num;
         bool trial_run = false;
+        bool use_numa = false;
+        bool warm_up = false;
+        std::vector<std::string> warm_up_blocks;
+        boost::filesystem::path warm_up_queries;
         osrm::LibOSRMConfig lib_config;
         const unsigned init_result = osrm::util::GenerateServerProgramOptions(
-            argc, argv, lib_config.server_paths, ip_address, ip_port, requested_thread_num,
-            lib_config.use_shared_memory, trial_run, lib_config.max_locations_trip,
+            argc, argv, lib_config.server_paths, lib_config.named_datasets, ip_address, ip_port,
+            requested_thread_num, lib_config.use_shared_memory, lib_config.use_huge_pages,
+            lib_config.use_compact_graph, lib_config.lazy_loading, lib_config.table_only, use_numa,
+            trial_run, warm_up, warm_up_blocks, warm_up_queries, lib_config.max_locations_trip,
             lib_config.max_locations_viaroute, lib_config.max_locations_distance_table,
-            lib_config.max_locations_map_matching);
+            lib_config.max_locations_map_matching, lib_config.unpacking_cache_size,
+            lib_config.route_cache_size, lib_config.snapping_cache_size,
+            lib_config.max_matching_sessions, lib_config.matching_session_timeout,
+            lib_config.max_locations_isochrone, lib_config.max_pairs_batch_route);
 
         if (init_result == osrm::util::INIT_OK_DO_NOT_START_ENGINE)
         {
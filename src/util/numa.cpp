@@ -0,0 +1,129 @@
+#include "util/numa.hpp"
+#include "util/simple_logger.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <algorithm>
+#include <thread>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace
+{
+// set by PinThreadToNode, threads that were not pinned use the first node
+boost::thread_specific_ptr<unsigned> thread_node;
+}
+
+const NUMATopology &NUMATopology::Get()
+{
+    static const NUMATopology topology;
+    return topology;
+}
+
+NUMATopology::NUMATopology()
+{
+#ifdef __linux__
+    const boost::filesystem::path nodes_path("/sys/devices/system/node");
+    for (unsigned node = 0;; ++node)
+    {
+        const auto cpu_list_path = nodes_path / ("node" + std::to_string(node)) / "cpulist";
+        if (!boost::filesystem::exists(cpu_list_path))
+        {
+            break;
+        }
+        boost::filesystem::ifstream cpu_list_stream(cpu_list_path);
+        std::string cpu_list;
+        std::getline(cpu_list_stream, cpu_list);
+        auto cpus = ParseCPUList(cpu_list);
+        // nodes with memory only do not run any threads
+        if (!cpus.empty())
+        {
+            node_cpus.push_back(std::move(cpus));
+        }
+    }
+#endif
+    if (node_cpus.empty())
+    {
+        const unsigned number_of_cpus = std::max(1u, std::thread::hardware_concurrency());
+        node_cpus.emplace_back();
+        for (unsigned cpu = 0; cpu < number_of_cpus; ++cpu)
+        {
+            node_cpus.back().push_back(cpu);
+        }
+    }
+}
+
+bool NUMATopology::PinThreadToNode(const unsigned node) const
+{
+    if (node >= node_cpus.size())
+    {
+        return false;
+    }
+    thread_node.reset(new unsigned(node));
+    if (!IsNUMA())
+    {
+        return true;
+    }
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (const auto cpu : node_cpus[node])
+    {
+        if (cpu < CPU_SETSIZE)
+        {
+            CPU_SET(cpu, &cpu_set);
+        }
+    }
+    if (0 != pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set))
+    {
+        SimpleLogger().Write(logWARNING) << "could not pin thread to NUMA node " << node;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+unsigned NUMATopology::GetThreadNode()
+{
+    const auto *node = thread_node.get();
+    return node ? *node : 0;
+}
+
+std::vector<unsigned> NUMATopology::ParseCPUList(const std::string &cpu_list)
+{
+    std::vector<unsigned> cpus;
+    std::vector<std::string> ranges;
+    boost::algorithm::split(ranges, cpu_list, boost::algorithm::is_any_of(","));
+    for (const auto &range : ranges)
+    {
+        if (range.empty())
+        {
+            continue;
+        }
+        const auto dash = range.find('-');
+        const unsigned first = std::stoul(range.substr(0, dash));
+        const unsigned last =
+            dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+        for (unsigned cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+}
+}
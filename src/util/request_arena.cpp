@@ -0,0 +1,58 @@
+#include "util/request_arena.hpp"
+
+#include <boost/thread/tss.hpp>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace
+{
+struct ThreadLocalArena
+{
+    RequestArena arena;
+    unsigned scope_depth = 0;
+};
+
+boost::thread_specific_ptr<ThreadLocalArena> thread_local_arena;
+
+ThreadLocalArena &GetThreadLocalArena()
+{
+    if (!thread_local_arena.get())
+    {
+        thread_local_arena.reset(new ThreadLocalArena());
+    }
+    return *thread_local_arena;
+}
+}
+
+constexpr std::size_t RequestArena::INITIAL_BLOCK_SIZE;
+
+RequestArena *RequestArena::Current()
+{
+    auto *local_arena = thread_local_arena.get();
+    if (local_arena && local_arena->scope_depth > 0)
+    {
+        return &local_arena->arena;
+    }
+    return nullptr;
+}
+
+RequestArenaScope::RequestArenaScope()
+    : arena(GetThreadLocalArena().arena), is_outermost(GetThreadLocalArena().scope_depth == 0)
+{
+    ++GetThreadLocalArena().scope_depth;
+}
+
+RequestArenaScope::~RequestArenaScope()
+{
+    auto &local_arena = GetThreadLocalArena();
+    --local_arena.scope_depth;
+    if (is_outermost)
+    {
+        arena.Release();
+    }
+}
+}
+}
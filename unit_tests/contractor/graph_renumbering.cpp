@@ -0,0 +1,365 @@
+#include "contractor/graph_renumbering.hpp"
+#include "extractor/edge_based_node.hpp"
+#include "extractor/original_edge_data.hpp"
+#include "util/integer_range.hpp"
+#include "util/static_rtree.hpp"
+
+#include "osrm/coordinate.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(graph_renumbering)
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+namespace
+{
+struct TemporaryFiles
+{
+    TemporaryFiles()
+        : permutation_path(MakePath()), leaf_path(MakePath()), edge_data_path(MakePath())
+    {
+        WriteFile(leaf_path, "leaves");
+        // the original edge data starts with the number of edges
+        const unsigned number_of_edges = 3;
+        WriteFile(edge_data_path, std::string((const char *)&number_of_edges, sizeof(unsigned)));
+    }
+
+    ~TemporaryFiles()
+    {
+        boost::filesystem::remove(permutation_path);
+        boost::filesystem::remove(leaf_path);
+        boost::filesystem::remove(edge_data_path);
+    }
+
+    static boost::filesystem::path MakePath()
+    {
+        return boost::filesystem::temp_directory_path() /
+               boost::filesystem::unique_path("osrm-renumbering-%%%%-%%%%");
+    }
+
+    static void WriteFile(const boost::filesystem::path &path, const std::string &content)
+    {
+        boost::filesystem::ofstream file(path, std::ios::binary);
+        file << content;
+    }
+
+    const boost::filesystem::path permutation_path;
+    const boost::filesystem::path leaf_path;
+    const boost::filesystem::path edge_data_path;
+};
+
+GraphPermutation MakePermutation()
+{
+    GraphPermutation permutation;
+    permutation.new_node_ids = {3, 1, 0, 2};
+    permutation.new_edge_ids = {2, 0, 1};
+    return permutation;
+}
+
+using EdgeTuple = std::tuple<NodeID, NodeID, NodeID, bool, int, bool, bool>;
+
+EdgeTuple MakeTuple(const QueryEdge &edge)
+{
+    return EdgeTuple{edge.source,       edge.target,        edge.data.id, edge.data.shortcut,
+                     edge.data.distance, edge.data.forward, edge.data.backward};
+}
+
+QueryEdge MakeEdge(const NodeID source,
+                   const NodeID target,
+                   const NodeID id,
+                   const bool shortcut,
+                   const int distance)
+{
+    QueryEdge::EdgeData data;
+    data.id = id;
+    data.shortcut = shortcut;
+    data.distance = distance;
+    data.forward = true;
+    data.backward = false;
+    return QueryEdge(source, target, data);
+}
+
+// Contracted graph of six nodes. Node 2 is in the core, original edge 5 was dropped during
+// contraction and shortcuts store the node they bypass.
+util::DeallocatingVector<QueryEdge> MakeContractedGraph()
+{
+    util::DeallocatingVector<QueryEdge> edges;
+    edges.push_back(MakeEdge(0, 3, 4, false, 5));
+    edges.push_back(MakeEdge(1, 3, 0, false, 2));
+    edges.push_back(MakeEdge(1, 4, 2, false, 7));
+    edges.push_back(MakeEdge(3, 4, 1, true, 9));
+    edges.push_back(MakeEdge(4, 5, 1, false, 3));
+    edges.push_back(MakeEdge(2, 5, 0, true, 11));
+    edges.push_back(MakeEdge(5, 2, 3, false, 4));
+    return edges;
+}
+
+// One segment per edge-based node, the name id is the index of the segment.
+std::vector<extractor::EdgeBasedNode> MakeSegments(const unsigned number_of_nodes)
+{
+    std::vector<extractor::EdgeBasedNode> segments;
+    for (const auto node : util::irange(0u, number_of_nodes))
+    {
+        const NodeID reverse_node = node % 2 == 0 ? SPECIAL_NODEID : node - 1;
+        segments.emplace_back(node, reverse_node, node, node + 1, node, 1, 1, 0, 0, node, false,
+                              0, 0, TRAVEL_MODE_DEFAULT, TRAVEL_MODE_DEFAULT);
+    }
+    return segments;
+}
+
+// Node ids stored in the leaves, indexed by the name id of the segment.
+std::vector<std::pair<NodeID, NodeID>> ReadLeafNodeIds(const boost::filesystem::path &leaf_path,
+                                                       const unsigned number_of_segments)
+{
+    std::vector<std::pair<NodeID, NodeID>> node_ids(number_of_segments);
+    util::StaticRTree<extractor::EdgeBasedNode>::VisitLeafObjects(
+        leaf_path, [&node_ids](const extractor::EdgeBasedNode &segment)
+        {
+            node_ids[segment.name_id] = {segment.forward_edge_based_node_id,
+                                         segment.reverse_edge_based_node_id};
+        });
+    return node_ids;
+}
+
+// The name id of the original edge data is the extraction id of the edge.
+std::vector<unsigned> ReadEdgeDataNames(const boost::filesystem::path &edge_data_path)
+{
+    const auto number_of_edges = ReadNumberOfOriginalEdges(edge_data_path);
+    std::vector<extractor::OriginalEdgeData> edge_data(number_of_edges);
+    boost::filesystem::ifstream edge_data_stream(edge_data_path, std::ios::binary);
+    edge_data_stream.seekg(sizeof(unsigned));
+    edge_data_stream.read((char *)edge_data.data(),
+                          sizeof(extractor::OriginalEdgeData) * number_of_edges);
+
+    std::vector<unsigned> names;
+    for (const auto &data : edge_data)
+    {
+        names.push_back(data.name_id);
+    }
+    return names;
+}
+}
+
+BOOST_AUTO_TEST_CASE(permutation_round_trip)
+{
+    TemporaryFiles files;
+    auto permutation = MakePermutation();
+    WriteGraphPermutation(files.permutation_path, files.leaf_path, files.edge_data_path, 4,
+                          permutation);
+
+    const auto read = ReadGraphPermutation(files.permutation_path, files.leaf_path,
+                                           files.edge_data_path, 4);
+    BOOST_CHECK_EQUAL_COLLECTIONS(read.new_node_ids.begin(), read.new_node_ids.end(),
+                                  permutation.new_node_ids.begin(),
+                                  permutation.new_node_ids.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(read.new_edge_ids.begin(), read.new_edge_ids.end(),
+                                  permutation.new_edge_ids.begin(),
+                                  permutation.new_edge_ids.end());
+    BOOST_CHECK_EQUAL(read.number_of_nodes, 4);
+    BOOST_CHECK_EQUAL(read.leaf_file_checksum, ComputeFileChecksum(files.leaf_path));
+}
+
+BOOST_AUTO_TEST_CASE(identity_removes_permutation)
+{
+    TemporaryFiles files;
+    auto permutation = MakePermutation();
+    WriteGraphPermutation(files.permutation_path, files.leaf_path, files.edge_data_path, 4,
+                          permutation);
+    GraphPermutation identity;
+    WriteGraphPermutation(files.permutation_path, files.leaf_path, files.edge_data_path, 4,
+                          identity);
+    BOOST_CHECK(!boost::filesystem::exists(files.permutation_path));
+    BOOST_CHECK(ReadGraphPermutation(files.permutation_path, files.leaf_path,
+                                     files.edge_data_path, 4)
+                    .IsIdentity());
+}
+
+BOOST_AUTO_TEST_CASE(stale_permutation)
+{
+    TemporaryFiles files;
+    auto permutation = MakePermutation();
+    WriteGraphPermutation(files.permutation_path, files.leaf_path, files.edge_data_path, 4,
+                          permutation);
+
+    // a different graph
+    BOOST_CHECK(ReadGraphPermutation(files.permutation_path, files.leaf_path,
+                                     files.edge_data_path, 5)
+                    .IsIdentity());
+
+    // same size but different contents, e.g. extracted again. The modification time is kept to
+    // make sure only the contents matter.
+    const auto write_time = boost::filesystem::last_write_time(files.leaf_path);
+    TemporaryFiles::WriteFile(files.leaf_path, "leafes");
+    boost::filesystem::last_write_time(files.leaf_path, write_time);
+    BOOST_CHECK(ReadGraphPermutation(files.permutation_path, files.leaf_path,
+                                     files.edge_data_path, 4)
+                    .IsIdentity());
+}
+
+BOOST_AUTO_TEST_CASE(copied_files_stay_valid)
+{
+    TemporaryFiles files;
+    auto permutation = MakePermutation();
+    WriteGraphPermutation(files.permutation_path, files.leaf_path, files.edge_data_path, 4,
+                          permutation);
+
+    // a copy changes the modification time but not the contents
+    boost::filesystem::last_write_time(files.leaf_path, 0);
+    boost::filesystem::last_write_time(files.edge_data_path, 0);
+    BOOST_CHECK(!ReadGraphPermutation(files.permutation_path, files.leaf_path,
+                                      files.edge_data_path, 4)
+                     .IsIdentity());
+}
+
+BOOST_AUTO_TEST_CASE(node_order_by_band_and_hilbert_value)
+{
+    // bands 0, 0, 1, 2, 2, 3 and node 2 is in the core
+    const std::vector<float> node_levels = {0, 0, 1, 3, 3, 7};
+    const std::vector<bool> is_core_node = {false, false, true, false, false, false};
+    const std::vector<std::uint64_t> hilbert_values = {50, 40, 30, 20, 10, 0};
+
+    const auto new_node_ids = ComputeNodeOrder(node_levels, is_core_node, hilbert_values);
+    const std::vector<NodeID> expected_node_ids = {5, 4, 0, 3, 2, 1};
+    BOOST_CHECK_EQUAL_COLLECTIONS(new_node_ids.begin(), new_node_ids.end(),
+                                  expected_node_ids.begin(), expected_node_ids.end());
+}
+
+BOOST_AUTO_TEST_CASE(renumbered_graph_maps_back_through_permutation)
+{
+    const unsigned number_of_nodes = 6;
+    const std::size_t number_of_original_edges = 6;
+    const std::vector<NodeID> new_node_ids = {5, 4, 0, 3, 2, 1};
+
+    const auto original_edges = MakeContractedGraph();
+    auto edges = MakeContractedGraph();
+    std::vector<bool> is_core_node = {false, false, true, false, false, false};
+    RenumberContractedGraph(new_node_ids, edges, is_core_node);
+    const auto new_edge_ids = RenumberOriginalEdges(number_of_original_edges, edges);
+
+    // every id is used exactly once
+    std::vector<EdgeID> sorted_edge_ids(new_edge_ids);
+    std::sort(sorted_edge_ids.begin(), sorted_edge_ids.end());
+    for (const auto id : util::irange<std::size_t>(0, number_of_original_edges))
+    {
+        BOOST_CHECK_EQUAL(sorted_edge_ids[id], id);
+    }
+    // the dropped edge comes last
+    BOOST_CHECK_EQUAL(new_edge_ids[5], 5);
+
+    // original edges are numbered by their first use in the sorted edge list
+    EdgeID next_edge_id = 0;
+    for (const auto &edge : edges)
+    {
+        if (!edge.data.shortcut && edge.data.id >= next_edge_id)
+        {
+            BOOST_CHECK_EQUAL(edge.data.id, next_edge_id);
+            ++next_edge_id;
+        }
+    }
+
+    // adjacency and edge data are the ones of the input graph translated to the new ids
+    std::vector<EdgeTuple> expected_edges;
+    for (const auto &edge : original_edges)
+    {
+        auto renumbered = edge;
+        renumbered.source = new_node_ids[edge.source];
+        renumbered.target = new_node_ids[edge.target];
+        renumbered.data.id =
+            edge.data.shortcut ? new_node_ids[edge.data.id] : new_edge_ids[edge.data.id];
+        expected_edges.push_back(MakeTuple(renumbered));
+    }
+    std::vector<EdgeTuple> renumbered_edges;
+    for (const auto &edge : edges)
+    {
+        renumbered_edges.push_back(MakeTuple(edge));
+    }
+    std::sort(expected_edges.begin(), expected_edges.end());
+    std::sort(renumbered_edges.begin(), renumbered_edges.end());
+    BOOST_CHECK(expected_edges == renumbered_edges);
+
+    for (const auto node : util::irange(0u, number_of_nodes))
+    {
+        BOOST_CHECK_EQUAL(is_core_node[new_node_ids[node]], node == 2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(renumbered_files_map_back_through_permutations)
+{
+    const unsigned number_of_nodes = 6;
+    const auto tree_path = TemporaryFiles::MakePath();
+    const auto leaf_path = TemporaryFiles::MakePath();
+    const auto edge_data_path = TemporaryFiles::MakePath();
+
+    std::vector<util::FixedPointCoordinate> coordinates;
+    for (const auto index : util::irange(0u, number_of_nodes + 1))
+    {
+        coordinates.emplace_back(52000000 + 1000 * index, 13000000 + 500 * index);
+    }
+    const auto segments = MakeSegments(number_of_nodes);
+    util::StaticRTree<extractor::EdgeBasedNode>(segments, tree_path.string(), leaf_path.string(),
+                                                coordinates);
+
+    const unsigned number_of_edges = 4;
+    {
+        std::vector<extractor::OriginalEdgeData> edge_data(number_of_edges);
+        for (const auto edge : util::irange(0u, number_of_edges))
+        {
+            edge_data[edge].name_id = edge;
+        }
+        boost::filesystem::ofstream edge_data_stream(edge_data_path, std::ios::binary);
+        edge_data_stream.write((char *)&number_of_edges, sizeof(unsigned));
+        edge_data_stream.write((char *)edge_data.data(),
+                               sizeof(extractor::OriginalEdgeData) * number_of_edges);
+    }
+
+    GraphPermutation first;
+    first.new_node_ids = {5, 4, 0, 3, 2, 1};
+    first.new_edge_ids = {2, 0, 3, 1};
+    GraphPermutation second;
+    second.new_node_ids = {1, 0, 3, 2, 5, 4};
+    second.new_edge_ids = {3, 2, 1, 0};
+
+    // extraction order to the first permutation, then from the first to the second one like a
+    // second run of osrm-prepare on the already renumbered files
+    GraphPermutation identity;
+    const GraphPermutation *previous = &identity;
+    for (const auto *permutation : {&first, &second})
+    {
+        RenumberRTreeLeaves(leaf_path, *previous, *permutation);
+        RenumberOriginalEdgeData(edge_data_path, *previous, *permutation);
+        previous = permutation;
+
+        const auto leaf_node_ids = ReadLeafNodeIds(leaf_path, number_of_nodes);
+        for (const auto node : util::irange(0u, number_of_nodes))
+        {
+            BOOST_CHECK_EQUAL(leaf_node_ids[node].first, permutation->new_node_ids[node]);
+            const auto reverse_node = segments[node].reverse_edge_based_node_id;
+            BOOST_CHECK_EQUAL(leaf_node_ids[node].second,
+                              SPECIAL_NODEID == reverse_node
+                                  ? SPECIAL_NODEID
+                                  : permutation->new_node_ids[reverse_node]);
+        }
+
+        const auto names = ReadEdgeDataNames(edge_data_path);
+        BOOST_REQUIRE_EQUAL(names.size(), number_of_edges);
+        for (const auto edge : util::irange(0u, number_of_edges))
+        {
+            BOOST_CHECK_EQUAL(names[permutation->new_edge_ids[edge]], edge);
+        }
+    }
+
+    boost::filesystem::remove(tree_path);
+    boost::filesystem::remove(leaf_path);
+    boost::filesystem::remove(edge_data_path);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,108 @@
+#include "contractor/sweep_order.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(sweep_order)
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+namespace
+{
+QueryEdge MakeEdge(const NodeID source, const NodeID target)
+{
+    QueryEdge::EdgeData data;
+    data.distance = 1;
+    data.forward = true;
+    data.backward = true;
+    return QueryEdge(source, target, data);
+}
+
+// index of the level of every node in the order
+std::vector<unsigned> GetLevels(const SweepOrder &order, const std::size_t number_of_nodes)
+{
+    std::vector<unsigned> levels(number_of_nodes, SPECIAL_NODEID);
+    for (const auto level : util::irange<std::size_t>(0, order.level_offsets.size() - 1))
+    {
+        for (const auto position :
+             util::irange(order.level_offsets[level], order.level_offsets[level + 1]))
+        {
+            BOOST_REQUIRE_LT(order.nodes[position], number_of_nodes);
+            // every node is listed once
+            BOOST_CHECK_EQUAL(levels[order.nodes[position]], SPECIAL_NODEID);
+            levels[order.nodes[position]] = level;
+        }
+    }
+    return levels;
+}
+}
+
+BOOST_AUTO_TEST_CASE(nodes_after_their_upper_neighbours)
+{
+    // edges lead from the lower to the higher node like in a contracted graph, here from the
+    // smaller to the larger id
+    const std::size_t number_of_nodes = 200;
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<NodeID> node_distribution(0, number_of_nodes - 1);
+    util::DeallocatingVector<QueryEdge> edges;
+    for (unsigned i = 0; i < 600; ++i)
+    {
+        const auto first = node_distribution(generator);
+        const auto second = node_distribution(generator);
+        if (first != second)
+        {
+            edges.push_back(MakeEdge(std::min(first, second), std::max(first, second)));
+        }
+    }
+
+    const auto order = ComputeSweepOrder(number_of_nodes, edges);
+    BOOST_REQUIRE_EQUAL(order.nodes.size(), number_of_nodes);
+    BOOST_REQUIRE_GT(order.level_offsets.size(), 1);
+    BOOST_CHECK_EQUAL(order.level_offsets.front(), 0);
+    BOOST_CHECK_EQUAL(order.level_offsets.back(), number_of_nodes);
+    for (const auto level : util::irange<std::size_t>(0, order.level_offsets.size() - 1))
+    {
+        BOOST_CHECK_LT(order.level_offsets[level], order.level_offsets[level + 1]);
+    }
+
+    const auto levels = GetLevels(order, number_of_nodes);
+    for (const auto &edge : edges)
+    {
+        BOOST_CHECK_LT(levels[edge.target], levels[edge.source]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(path_gives_one_level_per_node)
+{
+    util::DeallocatingVector<QueryEdge> edges;
+    edges.push_back(MakeEdge(2, 0));
+    edges.push_back(MakeEdge(0, 3));
+    edges.push_back(MakeEdge(3, 1));
+
+    const auto order = ComputeSweepOrder(4, edges);
+    BOOST_REQUIRE_EQUAL(order.level_offsets.size(), 5);
+    // from the top of the hierarchy down
+    const std::vector<NodeID> expected = {1, 3, 0, 2};
+    BOOST_CHECK_EQUAL_COLLECTIONS(order.nodes.begin(), order.nodes.end(), expected.begin(),
+                                  expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(core_has_no_order)
+{
+    util::DeallocatingVector<QueryEdge> edges;
+    edges.push_back(MakeEdge(0, 1));
+    edges.push_back(MakeEdge(1, 2));
+    edges.push_back(MakeEdge(2, 1));
+
+    const auto order = ComputeSweepOrder(3, edges);
+    BOOST_CHECK(order.nodes.empty());
+    BOOST_CHECK(order.level_offsets.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
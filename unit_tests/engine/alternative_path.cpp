@@ -0,0 +1,182 @@
+#include "engine/routing_algorithms/alternative_path.hpp"
+#include "engine/internal_route_result.hpp"
+#include "engine/search_engine_data.hpp"
+
+#include "mock_datafacade.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(alternative_path)
+
+using namespace osrm;
+using namespace osrm::engine;
+using namespace osrm::test;
+
+namespace
+{
+using Alternatives = routing_algorithms::AlternativeRouting<MockDataFacade>;
+
+const NodeID SOURCE = 0;
+const NodeID TARGET = 1;
+
+// One-way routes from SOURCE to TARGET built from chains of equally weighted edges, so that the
+// local optimality test of a via node only looks at the chain it is on.
+class RouteBuilder
+{
+  public:
+    RouteBuilder() : number_of_nodes(2) {}
+
+    // Returns the last node of the chain.
+    NodeID AddChain(const NodeID from,
+                    const NodeID to,
+                    const unsigned number_of_edges,
+                    const EdgeWeight edge_weight)
+    {
+        NodeID current = from;
+        for (const auto index : util::irange(0u, number_of_edges))
+        {
+            const NodeID next = index + 1 == number_of_edges ? to : number_of_nodes++;
+            edges.push_back({current, next, edge_weight});
+            current = next;
+        }
+        return current;
+    }
+
+    NodeID AddNode() { return number_of_nodes++; }
+
+    unsigned number_of_nodes;
+    std::vector<TestEdge> edges;
+};
+
+// Lengths of the routes with respect to the shortest route of length 1000:
+//   shortest:  1000
+//   first:     760 to the fork, 310 after it
+//   overlap:   the same 760 to the fork, 330 after it
+//   disjoint:  1080
+// All of them are less than 10% longer than the shortest route and share nothing with it. The
+// overlap shares 760 > 0.75 * 1000 with the first one though.
+RouteBuilder MakeRoutes(const bool with_first_route)
+{
+    RouteBuilder builder;
+    builder.AddChain(SOURCE, TARGET, 10, 100);
+
+    const auto fork = builder.AddChain(SOURCE, builder.AddNode(), 4, 190);
+    if (with_first_route)
+    {
+        builder.AddChain(fork, TARGET, 5, 62);
+    }
+    builder.AddChain(fork, TARGET, 5, 66);
+
+    builder.AddChain(SOURCE, TARGET, 10, 108);
+    return builder;
+}
+
+InternalRouteResult Route(const RouteBuilder &builder, const unsigned number_of_alternatives)
+{
+    MockDataFacade facade(builder.number_of_nodes, builder.edges);
+    SearchEngineData engine_working_data;
+    Alternatives alternatives(&facade, engine_working_data);
+
+    InternalRouteResult result;
+    alternatives({MakePhantomNode(SOURCE), MakePhantomNode(TARGET)}, result,
+                 number_of_alternatives);
+    return result;
+}
+
+// The input edges of an unpacked path, sorted.
+std::vector<unsigned> GetSortedEdges(const util::ArenaVector<PathData> &path)
+{
+    std::vector<unsigned> edges;
+    for (const auto &path_data : path)
+    {
+        edges.push_back(path_data.name_id);
+    }
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+
+EdgeWeight GetSharing(const RouteBuilder &builder,
+                      const util::ArenaVector<PathData> &lhs,
+                      const util::ArenaVector<PathData> &rhs)
+{
+    const auto lhs_edges = GetSortedEdges(lhs);
+    const auto rhs_edges = GetSortedEdges(rhs);
+    std::vector<unsigned> shared_edges;
+    std::set_intersection(lhs_edges.begin(), lhs_edges.end(), rhs_edges.begin(), rhs_edges.end(),
+                          std::back_inserter(shared_edges));
+
+    EdgeWeight sharing = 0;
+    for (const auto edge : shared_edges)
+    {
+        sharing += builder.edges[edge].weight;
+    }
+    return sharing;
+}
+}
+
+BOOST_AUTO_TEST_CASE(single_alternative)
+{
+    const auto builder = MakeRoutes(true);
+    const auto result = Route(builder, 1);
+
+    BOOST_REQUIRE(result.is_valid());
+    BOOST_CHECK_EQUAL(result.shortest_path_length, 1000);
+    BOOST_REQUIRE_EQUAL(result.alternative_path_lengths.size(), 1);
+    BOOST_REQUIRE_EQUAL(result.unpacked_alternatives.size(), 1);
+    BOOST_CHECK_EQUAL(result.alternative_path_lengths[0], 1070);
+}
+
+BOOST_AUTO_TEST_CASE(several_alternatives_reject_overlapping_routes)
+{
+    const auto builder = MakeRoutes(true);
+    const auto result = Route(builder, 3);
+
+    // the overlap shares too much with the first alternative, only two are left
+    BOOST_REQUIRE(result.is_valid());
+    BOOST_CHECK_EQUAL(result.shortest_path_length, 1000);
+    BOOST_REQUIRE_EQUAL(result.alternative_path_lengths.size(), 2);
+    BOOST_REQUIRE_EQUAL(result.unpacked_alternatives.size(), 2);
+    BOOST_CHECK_EQUAL(result.alt_source_traversed_in_reverse.size(), 2);
+    BOOST_CHECK_EQUAL(result.alt_target_traversed_in_reverse.size(), 2);
+    BOOST_CHECK_EQUAL(result.alternative_path_lengths[0], 1070);
+    BOOST_CHECK_EQUAL(result.alternative_path_lengths[1], 1080);
+
+    const auto &shortest_path = result.unpacked_path_segments.front();
+    const auto &first = result.unpacked_alternatives[0];
+    const auto &second = result.unpacked_alternatives[1];
+    BOOST_CHECK_EQUAL(shortest_path.back().node, TARGET);
+    BOOST_CHECK_EQUAL(first.back().node, TARGET);
+    BOOST_CHECK_EQUAL(second.back().node, TARGET);
+    BOOST_CHECK_EQUAL(GetSharing(builder, shortest_path, first), 0);
+    BOOST_CHECK_EQUAL(GetSharing(builder, shortest_path, second), 0);
+    BOOST_CHECK_EQUAL(GetSharing(builder, first, second), 0);
+}
+
+BOOST_AUTO_TEST_CASE(overlapping_route_alone_is_an_alternative)
+{
+    // without the first route the overlap does not share anything with the other routes
+    const auto builder = MakeRoutes(false);
+    const auto result = Route(builder, 3);
+
+    BOOST_REQUIRE(result.is_valid());
+    BOOST_REQUIRE_EQUAL(result.alternative_path_lengths.size(), 2);
+    BOOST_CHECK_EQUAL(result.alternative_path_lengths[0], 1080);
+    BOOST_CHECK_EQUAL(result.alternative_path_lengths[1], 1090);
+}
+
+BOOST_AUTO_TEST_CASE(no_alternative_without_other_routes)
+{
+    RouteBuilder builder;
+    builder.AddChain(SOURCE, TARGET, 10, 100);
+    const auto result = Route(builder, 3);
+
+    BOOST_REQUIRE(result.is_valid());
+    BOOST_CHECK_EQUAL(result.shortest_path_length, 1000);
+    BOOST_CHECK(!result.has_alternative());
+    BOOST_CHECK(result.unpacked_alternatives.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
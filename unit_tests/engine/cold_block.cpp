@@ -0,0 +1,120 @@
+#include "engine/datafacade/cold_block.hpp"
+#include "util/osrm_exception.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(cold_block)
+
+using namespace osrm;
+using namespace osrm::engine::datafacade;
+
+BOOST_AUTO_TEST_CASE(eager_loads_in_constructor)
+{
+    unsigned loads = 0;
+    ColdBlock block("test block", ColdDataLoading::Eager, [&loads]
+                    {
+                        ++loads;
+                    });
+    BOOST_CHECK_EQUAL(loads, 1);
+
+    block.Require();
+    BOOST_CHECK_EQUAL(loads, 1);
+    BOOST_CHECK(block.GetStatistics({}).loaded);
+}
+
+BOOST_AUTO_TEST_CASE(lazy_loads_once_on_first_use)
+{
+    std::atomic<unsigned> loads(0);
+    ColdBlock block("test block", ColdDataLoading::Lazy, [&loads]
+                    {
+                        ++loads;
+                    });
+    BOOST_CHECK_EQUAL(loads, 0);
+    BOOST_CHECK(!block.GetStatistics({}).loaded);
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&block]
+                             {
+                                 block.Require();
+                             });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    BOOST_CHECK_EQUAL(loads, 1);
+    BOOST_CHECK(block.GetStatistics({}).loaded);
+}
+
+BOOST_AUTO_TEST_CASE(skip_never_loads)
+{
+    unsigned loads = 0;
+    ColdBlock block("test block", ColdDataLoading::Skip, [&loads]
+                    {
+                        ++loads;
+                    });
+    BOOST_CHECK_THROW(block.Require(), util::exception);
+    BOOST_CHECK_EQUAL(loads, 0);
+    BOOST_CHECK(!block.GetStatistics({}).loaded);
+}
+
+BOOST_AUTO_TEST_CASE(statistics_sum_the_memory)
+{
+    ColdBlock block("test block", ColdDataLoading::Eager, []
+                    {
+                    });
+    // touched heap memory is resident
+    std::vector<char> first(10000, 1);
+    std::vector<char> second(300, 1);
+    const auto statistics = block.GetStatistics(
+        {std::make_pair(static_cast<const void *>(first.data()), first.size()),
+         std::make_pair(static_cast<const void *>(second.data()), second.size())});
+    BOOST_CHECK_EQUAL(statistics.name, "test block");
+    BOOST_CHECK_EQUAL(statistics.size, 10300);
+    BOOST_CHECK_EQUAL(statistics.resident, 10300);
+    BOOST_CHECK_EQUAL(statistics.load_time_ms, 0);
+}
+
+BOOST_AUTO_TEST_CASE(statistics_while_loading)
+{
+    std::atomic<bool> loading(false);
+    std::atomic<bool> finish(false);
+    ColdBlock block("test block", ColdDataLoading::Lazy, [&loading, &finish]
+                    {
+                        loading = true;
+                        while (!finish)
+                        {
+                            std::this_thread::yield();
+                        }
+                        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                    });
+
+    std::thread query([&block]
+                      {
+                          block.Require();
+                      });
+    while (!loading)
+    {
+        std::this_thread::yield();
+    }
+    // the load time is not reported before the block is loaded
+    const auto during_load = block.GetStatistics({});
+    BOOST_CHECK(!during_load.loaded);
+    BOOST_CHECK_EQUAL(during_load.load_time_ms, 0);
+
+    finish = true;
+    query.join();
+    const auto after_load = block.GetStatistics({});
+    BOOST_CHECK(after_load.loaded);
+    BOOST_CHECK_GT(after_load.load_time_ms, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,144 @@
+#include "engine/map_matching/hidden_markov_model.hpp"
+#include "engine/phantom_node.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(hidden_markov_model)
+
+using namespace osrm;
+using namespace osrm::engine;
+using namespace osrm::engine::map_matching;
+
+using CandidateLists = std::vector<std::vector<PhantomNodeWithDistance>>;
+using HMM = HiddenMarkovModel<CandidateLists>;
+
+namespace
+{
+CandidateLists MakeCandidates(const std::vector<std::vector<double>> &distances)
+{
+    CandidateLists candidates_list;
+    for (const auto &timestamp_distances : distances)
+    {
+        std::vector<PhantomNodeWithDistance> candidates;
+        for (const auto distance : timestamp_distances)
+        {
+            candidates.push_back(PhantomNodeWithDistance{PhantomNode(), distance});
+        }
+        candidates_list.push_back(candidates);
+    }
+    return candidates_list;
+}
+}
+
+BOOST_AUTO_TEST_CASE(flat_states)
+{
+    const auto candidates_list = MakeCandidates({{1., 2.}, {3.}, {4., 5., 6.}});
+    const EmissionLogProbability emission_log_probability(5.);
+    HMM model(candidates_list, emission_log_probability);
+
+    BOOST_CHECK_EQUAL(model.viterbi.size(), 3);
+    BOOST_CHECK_EQUAL(model.viterbi[0].size(), 2);
+    BOOST_CHECK_EQUAL(model.viterbi[1].size(), 1);
+    BOOST_CHECK_EQUAL(model.viterbi[2].size(), 3);
+
+    for (const auto t : util::irange<std::size_t>(0u, candidates_list.size()))
+    {
+        for (const auto s : util::irange<std::size_t>(0u, candidates_list[t].size()))
+        {
+            BOOST_CHECK_EQUAL(model.emission_log_probabilities[t][s],
+                              emission_log_probability(candidates_list[t][s].distance));
+            BOOST_CHECK_EQUAL(model.viterbi[t][s], IMPOSSIBLE_LOG_PROB);
+            BOOST_CHECK(model.pruned[t][s]);
+        }
+    }
+
+    BOOST_CHECK_EQUAL(model.initialize(0), 0);
+    BOOST_CHECK_EQUAL(model.viterbi[0][1], emission_log_probability(2.));
+    BOOST_CHECK(!model.pruned[0][1]);
+    BOOST_CHECK(!model.breakage[0]);
+    BOOST_CHECK(model.breakage[1]);
+}
+
+BOOST_AUTO_TEST_CASE(sliding_window)
+{
+    auto candidates_list = MakeCandidates({{1., 2.}, {3.}});
+    const EmissionLogProbability emission_log_probability(5.);
+    HMM model(candidates_list, emission_log_probability);
+    model.initialize_timestamp(0);
+    model.parents[1][0] = std::make_pair(0u, 1u);
+
+    candidates_list.push_back(candidates_list.front());
+    model.grow();
+    BOOST_CHECK_EQUAL(model.viterbi.size(), 3);
+    BOOST_CHECK_EQUAL(model.viterbi[2].size(), 2);
+    BOOST_CHECK_EQUAL(model.emission_log_probabilities[2][1], emission_log_probability(2.));
+    model.parents[2][1] = std::make_pair(1u, 0u);
+
+    candidates_list.erase(candidates_list.begin());
+    model.erase_front(1);
+    BOOST_CHECK_EQUAL(model.viterbi.size(), 2);
+    BOOST_CHECK_EQUAL(model.viterbi[0].size(), 1);
+    BOOST_CHECK_EQUAL(model.emission_log_probabilities[0][0], emission_log_probability(3.));
+    // the first timestamp lost its parent
+    BOOST_CHECK_EQUAL(model.parents[0][0].first, 0);
+    BOOST_CHECK_EQUAL(model.parents[1][1].first, 0);
+    BOOST_CHECK_EQUAL(model.parents[1][1].second, 0);
+
+    candidates_list.pop_back();
+    model.pop_back();
+    BOOST_CHECK_EQUAL(model.viterbi.size(), 1);
+    BOOST_CHECK_EQUAL(model.breakage.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(shared_storage)
+{
+    StateStorage storage;
+    const EmissionLogProbability emission_log_probability(5.);
+
+    const auto large_candidates_list = MakeCandidates({{1., 2., 3.}, {4., 5., 6.}});
+    {
+        HMM model(large_candidates_list, emission_log_probability, storage);
+        BOOST_CHECK_EQUAL(storage.viterbi.size(), 6);
+    }
+    const auto capacity = storage.viterbi.capacity();
+
+    const auto small_candidates_list = MakeCandidates({{1.}, {2.}});
+    HMM model(small_candidates_list, emission_log_probability, storage);
+    BOOST_CHECK_EQUAL(model.viterbi.size(), 2);
+    BOOST_CHECK_EQUAL(storage.viterbi.size(), 2);
+    BOOST_CHECK_EQUAL(storage.viterbi.capacity(), capacity);
+}
+
+// The lengths of a matching are summed up over all points, they keep the precision of the
+// network distances they are computed from.
+BOOST_AUTO_TEST_CASE(path_lengths_keep_precision)
+{
+    const auto candidates_list = MakeCandidates({{1.}, {1.}});
+    const EmissionLogProbability emission_log_probability(5.);
+    HMM model(candidates_list, emission_log_probability);
+
+    const double network_distance = 123456.789;
+    model.path_lengths[1][0] = network_distance;
+    BOOST_CHECK_EQUAL(model.path_lengths[1][0], network_distance);
+
+    // float would round every step of a long trace to about a centimeter
+    double length = 0.;
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        length += model.path_lengths[1][0];
+    }
+    BOOST_CHECK_CLOSE(length, network_distance * 1000, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(arg_max)
+{
+    const std::vector<double> values = {IMPOSSIBLE_LOG_PROB, -3., -1., -2., -1.};
+    BOOST_CHECK_EQUAL(ArgMax(values.begin(), values.end()), 2);
+
+    const std::vector<double> impossible = {IMPOSSIBLE_LOG_PROB, IMPOSSIBLE_LOG_PROB};
+    BOOST_CHECK_EQUAL(ArgMax(impossible.begin(), impossible.end()), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,184 @@
+#include "engine/routing_algorithms/many_to_many.hpp"
+#include "engine/routing_algorithms/routing_base.hpp"
+#include "engine/search_engine_data.hpp"
+
+#include "mock_datafacade.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(many_to_many)
+
+using namespace osrm;
+using namespace osrm::engine;
+using namespace osrm::test;
+
+namespace
+{
+using ManyToMany = routing_algorithms::ManyToManyRouting<MockDataFacade>;
+
+// Plain bidirectional search between two nodes, the search every leg of a route uses.
+class PointToPointSearch final
+    : public routing_algorithms::BasicRoutingInterface<MockDataFacade, PointToPointSearch>
+{
+    using super = routing_algorithms::BasicRoutingInterface<MockDataFacade, PointToPointSearch>;
+
+  public:
+    PointToPointSearch(MockDataFacade *facade, SearchEngineData &engine_working_data)
+        : super(facade), engine_working_data(engine_working_data)
+    {
+    }
+
+    EdgeWeight operator()(const NodeID source,
+                          const NodeID target,
+                          std::vector<NodeID> &packed_path) const
+    {
+        engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+            super::facade->GetNumberOfNodes());
+        auto &forward_heap = *engine_working_data.forward_heap_1;
+        auto &reverse_heap = *engine_working_data.reverse_heap_1;
+        forward_heap.Insert(source, 0, source);
+        reverse_heap.Insert(target, 0, target);
+
+        int weight = INVALID_EDGE_WEIGHT;
+        packed_path.clear();
+        super::Search(forward_heap, reverse_heap, weight, packed_path);
+        return weight;
+    }
+
+  private:
+    SearchEngineData &engine_working_data;
+};
+
+// Sum of the weights of the query graph edges between consecutive nodes of a packed path, or
+// INVALID_EDGE_WEIGHT if two consecutive nodes are not connected in the right direction.
+EdgeWeight GetPackedPathWeight(const MockDataFacade &facade,
+                               std::vector<NodeID>::const_iterator begin,
+                               const std::vector<NodeID>::const_iterator end)
+{
+    EdgeWeight weight = 0;
+    for (; begin != end && std::next(begin) != end; ++begin)
+    {
+        const auto from = *begin;
+        const auto to = *std::next(begin);
+        EdgeWeight edge_weight = INVALID_EDGE_WEIGHT;
+        for (const auto edge : facade.GetAdjacentEdgeRange(from))
+        {
+            const auto &data = facade.GetEdgeData(edge);
+            if (facade.GetTarget(edge) == to && data.forward)
+            {
+                edge_weight = std::min<EdgeWeight>(edge_weight, data.distance);
+            }
+        }
+        for (const auto edge : facade.GetAdjacentEdgeRange(to))
+        {
+            const auto &data = facade.GetEdgeData(edge);
+            if (facade.GetTarget(edge) == from && data.backward)
+            {
+                edge_weight = std::min<EdgeWeight>(edge_weight, data.distance);
+            }
+        }
+        if (edge_weight == INVALID_EDGE_WEIGHT)
+        {
+            return INVALID_EDGE_WEIGHT;
+        }
+        weight += edge_weight;
+    }
+    return weight;
+}
+}
+
+BOOST_AUTO_TEST_CASE(packed_paths_match_point_to_point_search)
+{
+    const unsigned width = 8;
+    const unsigned height = 6;
+    const unsigned number_of_nodes = width * height;
+    MockDataFacade facade(number_of_nodes,
+                          ShuffleNodes(number_of_nodes, MakeGridGraph(width, height, 7), 13));
+    SearchEngineData engine_working_data;
+
+    std::vector<PhantomNode> phantoms;
+    for (NodeID node = 0; node < number_of_nodes; node += 3)
+    {
+        phantoms.push_back(MakePhantomNode(node));
+    }
+
+    ManyToMany::PackedPathTable table;
+    ManyToMany many_to_many(&facade, engine_working_data);
+    many_to_many(phantoms, phantoms, table);
+    BOOST_REQUIRE_EQUAL(table.weights.size(), phantoms.size() * phantoms.size());
+    BOOST_REQUIRE_EQUAL(table.offsets.size(), table.weights.size() + 1);
+
+    const auto plain_table = many_to_many(phantoms, phantoms);
+    BOOST_CHECK_EQUAL_COLLECTIONS(plain_table->begin(), plain_table->end(),
+                                  table.weights.begin(), table.weights.end());
+
+    PointToPointSearch point_to_point(&facade, engine_working_data);
+    std::vector<NodeID> packed_path;
+    unsigned number_of_unreachable = 0;
+    for (const auto source : util::irange<std::size_t>(0, phantoms.size()))
+    {
+        const auto dijkstra_weights = facade.Dijkstra(phantoms[source].forward_node_id);
+        for (const auto target : util::irange<std::size_t>(0, phantoms.size()))
+        {
+            const auto entry = source * phantoms.size() + target;
+            const auto source_node = phantoms[source].forward_node_id;
+            const auto target_node = phantoms[target].forward_node_id;
+            const auto weight = point_to_point(source_node, target_node, packed_path);
+
+            if (dijkstra_weights[target_node] == INVALID_EDGE_WEIGHT)
+            {
+                ++number_of_unreachable;
+                BOOST_CHECK_EQUAL(table.weights[entry], std::numeric_limits<EdgeWeight>::max());
+                BOOST_CHECK(table.PathBegin(entry) == table.PathEnd(entry));
+                BOOST_CHECK_EQUAL(weight, INVALID_EDGE_WEIGHT);
+                continue;
+            }
+
+            BOOST_CHECK_EQUAL(table.weights[entry], dijkstra_weights[target_node]);
+            BOOST_CHECK_EQUAL(table.weights[entry], weight);
+
+            // the packed path is a valid path through the hierarchy with the same weight, it
+            // may only differ from the point to point search if there are several shortest paths
+            BOOST_REQUIRE(table.PathBegin(entry) != table.PathEnd(entry));
+            BOOST_CHECK_EQUAL(*table.PathBegin(entry), source_node);
+            BOOST_CHECK_EQUAL(*std::prev(table.PathEnd(entry)), target_node);
+            BOOST_CHECK_EQUAL(
+                GetPackedPathWeight(facade, table.PathBegin(entry), table.PathEnd(entry)),
+                table.weights[entry]);
+            BOOST_CHECK_EQUAL(GetPackedPathWeight(facade, packed_path.begin(), packed_path.end()),
+                              weight);
+        }
+    }
+    // the generated graph has a disconnected row
+    BOOST_CHECK_GT(number_of_unreachable, 0);
+}
+
+BOOST_AUTO_TEST_CASE(packed_paths_of_single_edge)
+{
+    MockDataFacade facade(2, {{0, 1, 5}});
+    SearchEngineData engine_working_data;
+    ManyToMany many_to_many(&facade, engine_working_data);
+
+    ManyToMany::PackedPathTable table;
+    many_to_many({MakePhantomNode(0), MakePhantomNode(1)}, {MakePhantomNode(0), MakePhantomNode(1)},
+                 table);
+    BOOST_REQUIRE_EQUAL(table.weights.size(), 4);
+    BOOST_CHECK_EQUAL(table.weights[0], 0);
+    BOOST_CHECK_EQUAL(table.weights[1], 5);
+    BOOST_CHECK_EQUAL(table.weights[2], std::numeric_limits<EdgeWeight>::max());
+    BOOST_CHECK_EQUAL(table.weights[3], 0);
+
+    BOOST_CHECK_EQUAL(std::distance(table.PathBegin(0), table.PathEnd(0)), 1);
+    const std::vector<NodeID> path(table.PathBegin(1), table.PathEnd(1));
+    BOOST_REQUIRE_EQUAL(path.size(), 2);
+    BOOST_CHECK_EQUAL(path[0], 0);
+    BOOST_CHECK_EQUAL(path[1], 1);
+    BOOST_CHECK(table.PathBegin(2) == table.PathEnd(2));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,114 @@
+#include "engine/routing_algorithms/many_to_many.hpp"
+#include "engine/routing_algorithms/many_to_many_sweep.hpp"
+#include "engine/search_engine_data.hpp"
+
+#include "mock_datafacade.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(many_to_many_sweep)
+
+using namespace osrm;
+using namespace osrm::engine;
+using namespace osrm::test;
+
+namespace
+{
+using ManyToMany = routing_algorithms::ManyToManyRouting<MockDataFacade>;
+using ManyToManySweep = routing_algorithms::ManyToManySweepRouting<MockDataFacade>;
+
+void CheckSameTable(MockDataFacade &facade,
+                    const std::vector<PhantomNode> &sources,
+                    const std::vector<PhantomNode> &targets)
+{
+    SearchEngineData engine_working_data;
+    ManyToMany many_to_many(&facade, engine_working_data);
+    ManyToManySweep many_to_many_sweep(&facade, engine_working_data);
+    BOOST_REQUIRE(many_to_many_sweep.IsAvailable());
+
+    const auto table = many_to_many(sources, targets);
+    const auto sweep_table = many_to_many_sweep(sources, targets);
+    BOOST_REQUIRE_EQUAL(sweep_table->size(), sources.size() * targets.size());
+    BOOST_CHECK_EQUAL_COLLECTIONS(sweep_table->begin(), sweep_table->end(), table->begin(),
+                                  table->end());
+}
+}
+
+BOOST_AUTO_TEST_CASE(matches_buckets_on_nodes)
+{
+    const unsigned width = 10;
+    const unsigned height = 8;
+    const unsigned number_of_nodes = width * height;
+    for (const unsigned seed : {1, 2, 3})
+    {
+        MockDataFacade facade(number_of_nodes, ShuffleNodes(number_of_nodes,
+                                                            MakeGridGraph(width, height, seed),
+                                                            seed + 100));
+        // more sources than one batch of the sweep
+        std::vector<PhantomNode> sources;
+        for (NodeID node = 0; node < number_of_nodes; node += 4)
+        {
+            sources.push_back(MakePhantomNode(node));
+        }
+        std::vector<PhantomNode> targets;
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            targets.push_back(MakePhantomNode(node));
+        }
+        CheckSameTable(facade, sources, targets);
+
+        // the disconnected row gives unreachable pairs, which are the maximum weight in both
+        // and not UNREACHED_WEIGHT plus an edge
+        const auto dijkstra_weights = facade.Dijkstra(sources.front().forward_node_id);
+        BOOST_CHECK(std::count(dijkstra_weights.begin(), dijkstra_weights.end(),
+                               INVALID_EDGE_WEIGHT) > 0);
+        SearchEngineData engine_working_data;
+        ManyToManySweep many_to_many_sweep(&facade, engine_working_data);
+        const auto sweep_table = many_to_many_sweep(sources, targets);
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            const auto expected = dijkstra_weights[node] == INVALID_EDGE_WEIGHT
+                                      ? std::numeric_limits<EdgeWeight>::max()
+                                      : dijkstra_weights[node];
+            BOOST_CHECK_EQUAL((*sweep_table)[node], expected);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(matches_buckets_on_segments)
+{
+    // phantom nodes with a forward and a reverse node and their weights. The sources start at
+    // their nodes: for a source behind a target on the same segment the bucket search and the
+    // sweep pick the loop from different search spaces, which a generated graph can not model.
+    const unsigned width = 8;
+    const unsigned height = 6;
+    const unsigned number_of_nodes = width * height;
+    MockDataFacade facade(number_of_nodes,
+                          ShuffleNodes(number_of_nodes, MakeGridGraph(width, height, 9), 21));
+
+    std::mt19937 generator(5);
+    std::uniform_int_distribution<NodeID> node_distribution(0, number_of_nodes - 1);
+    std::uniform_int_distribution<EdgeWeight> weight_distribution(0, 20);
+    std::vector<PhantomNode> sources;
+    std::vector<PhantomNode> targets;
+    for (unsigned i = 0; i < 20; ++i)
+    {
+        auto phantom = MakePhantomNode(node_distribution(generator));
+        phantom.reverse_node_id = node_distribution(generator);
+        phantom.reverse_weight = 0;
+        phantom.reverse_offset = 0;
+        sources.push_back(phantom);
+
+        phantom.forward_weight = weight_distribution(generator);
+        phantom.reverse_weight = weight_distribution(generator);
+        targets.push_back(phantom);
+    }
+    CheckSameTable(facade, sources, targets);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
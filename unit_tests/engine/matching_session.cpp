@@ -0,0 +1,135 @@
+#include "engine/map_matching/matching_session.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(matching_session)
+
+using namespace osrm;
+using namespace osrm::engine;
+using namespace osrm::engine::map_matching;
+
+namespace
+{
+void AppendPoint(MatchingSession &session, const std::size_t number_of_candidates)
+{
+    std::vector<PhantomNodeWithDistance> candidates(number_of_candidates);
+    for (auto &candidate : candidates)
+    {
+        candidate.distance = 1.;
+    }
+    session.Append(candidates, util::FixedPointCoordinate(52519930, 13438640),
+                   session.number_of_points, session.number_of_points);
+    ++session.number_of_points;
+}
+
+// lets both candidates of t descend from the given candidates of t - 1
+void Connect(MatchingSession &session,
+             const std::size_t t,
+             const std::size_t parent_0,
+             const std::size_t parent_1)
+{
+    session.model.viterbi[t][0] = -1.;
+    session.model.viterbi[t][1] = -2.;
+    session.model.parents[t][0] = std::make_pair(t - 1, parent_0);
+    session.model.parents[t][1] = std::make_pair(t - 1, parent_1);
+    session.model.pruned[t][0] = false;
+    session.model.pruned[t][1] = false;
+    session.model.breakage[t] = false;
+    session.last_unbroken = t;
+}
+}
+
+BOOST_AUTO_TEST_CASE(converges_on_common_ancestor)
+{
+    MatchingSession session(5., 5., 0);
+    AppendPoint(session, 2);
+    BOOST_CHECK(session.model.initialize_timestamp(0));
+    session.last_unbroken = 0;
+    BOOST_CHECK(session.FindConvergence().first == INVALID_STATE);
+
+    // both candidates of 1 descend from different candidates of 0
+    AppendPoint(session, 2);
+    Connect(session, 1, 0, 1);
+    BOOST_CHECK(session.FindConvergence().first == INVALID_STATE);
+
+    // both candidates of 2 descend from candidate 1 of 1
+    AppendPoint(session, 2);
+    Connect(session, 2, 1, 1);
+    const auto converged = session.FindConvergence();
+    BOOST_CHECK_EQUAL(converged.first, 1);
+    BOOST_CHECK_EQUAL(converged.second, 1);
+
+    const auto path = session.Backtrack(converged);
+    BOOST_REQUIRE_EQUAL(path.size(), 2);
+    BOOST_CHECK_EQUAL(path[0].first, 0);
+    BOOST_CHECK_EQUAL(path[0].second, 1);
+    BOOST_CHECK_EQUAL(path[1].first, 1);
+    BOOST_CHECK_EQUAL(path[1].second, 1);
+
+    // keep the final state as start of the window
+    session.EraseFront(converged.first);
+    session.number_of_final_states = 1;
+    BOOST_CHECK_EQUAL(session.candidates_list.size(), 2);
+    BOOST_CHECK_EQUAL(session.indices.front(), 1);
+    BOOST_CHECK_EQUAL(session.last_unbroken, 1);
+    BOOST_CHECK_EQUAL(session.model.parents[0][1].first, 0);
+    BOOST_CHECK_EQUAL(session.model.parents[1][0].first, 0);
+
+    // converging on the final state again reports nothing new
+    BOOST_CHECK(session.FindConvergence().first == INVALID_STATE);
+    BOOST_CHECK_EQUAL(session.Backtrack(session.GetMostLikelyState()).size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(decide_prunes_other_paths)
+{
+    MatchingSession session(5., 5., 0);
+    AppendPoint(session, 2);
+    BOOST_CHECK(session.model.initialize_timestamp(0));
+    AppendPoint(session, 2);
+    Connect(session, 1, 0, 1);
+    AppendPoint(session, 2);
+    Connect(session, 2, 1, 0);
+
+    session.Decide(std::make_pair(1u, 0u));
+    BOOST_CHECK(!session.model.pruned[1][0]);
+    BOOST_CHECK(session.model.pruned[1][1]);
+    BOOST_CHECK(session.model.pruned[2][0]);
+    BOOST_CHECK(!session.model.pruned[2][1]);
+
+    const auto converged = session.FindConvergence();
+    BOOST_CHECK_EQUAL(converged.first, 2);
+    BOOST_CHECK_EQUAL(converged.second, 1);
+}
+
+BOOST_AUTO_TEST_CASE(reset_drops_window)
+{
+    MatchingSession session(5., 5., 0);
+    AppendPoint(session, 2);
+    BOOST_CHECK(session.model.initialize_timestamp(0));
+    session.last_unbroken = 0;
+    session.continues_matching = true;
+
+    session.Reset();
+    BOOST_CHECK(session.candidates_list.empty());
+    BOOST_CHECK_EQUAL(session.model.viterbi.size(), 0);
+    BOOST_CHECK(session.last_unbroken == INVALID_STATE);
+    BOOST_CHECK(!session.continues_matching);
+    BOOST_CHECK_EQUAL(session.number_of_points, 1);
+}
+
+BOOST_AUTO_TEST_CASE(timestamps_in_order)
+{
+    MatchingSession session(5., 5., 0);
+    BOOST_CHECK(session.AreTimestampsInOrder({}));
+    BOOST_CHECK(session.AreTimestampsInOrder({0, 10, 10, 20}));
+    BOOST_CHECK(!session.AreTimestampsInOrder({10, 20, 15}));
+
+    // compared to the last pushed point, not only within the request
+    session.last_timestamp = 20;
+    BOOST_CHECK(session.AreTimestampsInOrder({20, 21}));
+    BOOST_CHECK(!session.AreTimestampsInOrder({19}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
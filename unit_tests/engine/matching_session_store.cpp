@@ -0,0 +1,47 @@
+#include "engine/matching_session_store.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(matching_session_store)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+MatchingSessionStore::SessionPtr MakeSession()
+{
+    return std::make_shared<map_matching::MatchingSession>(5., 5., 1);
+}
+}
+
+BOOST_AUTO_TEST_CASE(ids_tell_the_replica)
+{
+    const unsigned number_of_replicas = 3;
+    for (unsigned replica = 0; replica < number_of_replicas; ++replica)
+    {
+        MatchingSessionStore store(10, std::chrono::seconds(60), replica, number_of_replicas);
+        for (int i = 0; i < 20; ++i)
+        {
+            const auto id = store.Insert(MakeSession());
+            BOOST_CHECK_EQUAL(id.size(), 16);
+            BOOST_CHECK_EQUAL(MatchingSessionStore::GetReplica(id, number_of_replicas), replica);
+            BOOST_CHECK(store.Find(id));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(unknown_ids_go_to_first_replica)
+{
+    BOOST_CHECK_EQUAL(MatchingSessionStore::GetReplica("", 4), 0);
+    BOOST_CHECK_EQUAL(MatchingSessionStore::GetReplica("not a session", 4), 0);
+    BOOST_CHECK_EQUAL(MatchingSessionStore::GetReplica("00000000000000000000", 4), 0);
+    BOOST_CHECK_EQUAL(MatchingSessionStore::GetReplica("0000000000000007", 4), 3);
+    BOOST_CHECK_EQUAL(MatchingSessionStore::GetReplica("0000000000000007", 1), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
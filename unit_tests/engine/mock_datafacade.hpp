@@ -0,0 +1,333 @@
+#ifndef MOCK_DATAFACADE_HPP
+#define MOCK_DATAFACADE_HPP
+
+#include "contractor/query_edge.hpp"
+#include "engine/phantom_node.hpp"
+#include "extractor/travel_mode.hpp"
+#include "extractor/turn_instructions.hpp"
+#include "engine/shortcut_unpacking_cache.hpp"
+#include "util/integer_range.hpp"
+#include "util/static_graph.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace test
+{
+
+// Directed edge of the graph before contraction.
+struct TestEdge
+{
+    NodeID source;
+    NodeID target;
+    EdgeWeight weight;
+};
+
+// The part of the data facade the routing algorithms use, backed by a contraction hierarchy of
+// a small graph. Nodes are contracted in the order of their ids and every shortcut is added
+// without a witness search. That gives more shortcuts than osrm-prepare but a valid hierarchy
+// that can be checked against a plain Dijkstra on the input edges. The graph has no core and
+// provides the sweep order. Unpacked paths report the target of every input edge as their
+// node and the index of the input edge as their name.
+class MockDataFacade
+{
+  public:
+    using EdgeData = contractor::QueryEdge::EdgeData;
+    using QueryGraph = util::StaticGraph<EdgeData>;
+    using EdgeRange = QueryGraph::EdgeRange;
+
+    MockDataFacade(const unsigned number_of_nodes, std::vector<TestEdge> edges_)
+        : input_edges(std::move(edges_)), query_graph(Contract(number_of_nodes, input_edges)),
+          sweep_nodes(number_of_nodes), checksum(1)
+    {
+        ComputeSweepOrder();
+    }
+
+    unsigned GetNumberOfNodes() const { return query_graph.GetNumberOfNodes(); }
+    unsigned GetNumberOfEdges() const { return query_graph.GetNumberOfEdges(); }
+    NodeID GetTarget(const EdgeID edge) const { return query_graph.GetTarget(edge); }
+    const EdgeData &GetEdgeData(const EdgeID edge) const { return query_graph.GetEdgeData(edge); }
+    EdgeID BeginEdges(const NodeID node) const { return query_graph.BeginEdges(node); }
+    EdgeID EndEdges(const NodeID node) const { return query_graph.EndEdges(node); }
+    EdgeRange GetAdjacentEdgeRange(const NodeID node) const
+    {
+        return query_graph.GetAdjacentEdgeRange(node);
+    }
+    EdgeID FindEdge(const NodeID from, const NodeID to) const
+    {
+        return query_graph.FindEdge(from, to);
+    }
+    EdgeID FindEdgeInEitherDirection(const NodeID from, const NodeID to) const
+    {
+        return query_graph.FindEdgeInEitherDirection(from, to);
+    }
+
+    unsigned GetCheckSum() const { return checksum; }
+    bool IsCoreNode(const NodeID) const { return false; }
+    std::size_t GetCoreSize() const { return 0; }
+
+    unsigned GetNumberOfSweepLevels() const { return sweep_level_offsets.size() - 1; }
+    util::range<unsigned> GetSweepLevel(const unsigned level) const
+    {
+        return util::irange(sweep_level_offsets[level], sweep_level_offsets[level + 1]);
+    }
+    NodeID GetSweepNode(const unsigned position) const { return sweep_nodes[position]; }
+
+    engine::ShortcutUnpackingCache &GetShortcutUnpackingCache() const
+    {
+        return shortcut_unpacking_cache;
+    }
+
+    unsigned GetNameIndexFromEdgeID(const unsigned id) const { return id; }
+    extractor::TurnInstruction GetTurnInstructionForEdgeID(const unsigned) const
+    {
+        return extractor::TurnInstruction::NoTurn;
+    }
+    extractor::TravelMode GetTravelModeForEdgeID(const unsigned) const
+    {
+        return TRAVEL_MODE_DEFAULT;
+    }
+    bool EdgeIsCompressed(const unsigned) const { return false; }
+    unsigned GetGeometryIndexForEdgeID(const unsigned id) const { return input_edges[id].target; }
+    void GetUncompressedGeometry(const EdgeID, std::vector<NodeID> &result_nodes) const
+    {
+        result_nodes.clear();
+    }
+
+    const std::vector<TestEdge> &GetInputEdges() const { return input_edges; }
+
+    // weights of the shortest paths from source to all nodes in the input graph
+    std::vector<EdgeWeight> Dijkstra(const NodeID source) const
+    {
+        std::vector<std::vector<std::pair<NodeID, EdgeWeight>>> adjacency(GetNumberOfNodes());
+        for (const auto &edge : input_edges)
+        {
+            adjacency[edge.source].emplace_back(edge.target, edge.weight);
+        }
+
+        using QueueEntry = std::pair<EdgeWeight, NodeID>;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+        std::vector<EdgeWeight> weights(GetNumberOfNodes(), INVALID_EDGE_WEIGHT);
+        weights[source] = 0;
+        queue.emplace(0, source);
+        while (!queue.empty())
+        {
+            const auto entry = queue.top();
+            queue.pop();
+            if (entry.first > weights[entry.second])
+            {
+                continue;
+            }
+            for (const auto &next : adjacency[entry.second])
+            {
+                if (entry.first + next.second < weights[next.first])
+                {
+                    weights[next.first] = entry.first + next.second;
+                    queue.emplace(weights[next.first], next.first);
+                }
+            }
+        }
+        return weights;
+    }
+
+  private:
+    struct Arc
+    {
+        EdgeWeight weight;
+        // contracted node the shortcut bypasses, SPECIAL_NODEID for input edges
+        NodeID middle;
+        unsigned edge_index;
+    };
+
+    static QueryGraph Contract(const unsigned number_of_nodes, const std::vector<TestEdge> &edges)
+    {
+        // arcs between nodes that were not contracted yet
+        std::vector<std::map<NodeID, Arc>> outgoing(number_of_nodes);
+        std::vector<std::map<NodeID, Arc>> incoming(number_of_nodes);
+        const auto add_arc = [&](const NodeID source, const NodeID target, const Arc &arc)
+        {
+            const auto iter = outgoing[source].find(target);
+            if (iter == outgoing[source].end() || arc.weight < iter->second.weight)
+            {
+                outgoing[source][target] = arc;
+                incoming[target][source] = arc;
+            }
+        };
+        for (const auto index : util::irange<std::size_t>(0, edges.size()))
+        {
+            const auto &edge = edges[index];
+            BOOST_ASSERT(edge.source != edge.target && edge.weight > 0);
+            add_arc(edge.source, edge.target,
+                    Arc{edge.weight, SPECIAL_NODEID, static_cast<unsigned>(index)});
+        }
+
+        std::vector<QueryGraph::InputEdge> query_edges;
+        const auto add_query_edge = [&](const NodeID node, const NodeID other, const Arc &arc,
+                                        const bool forward)
+        {
+            EdgeData data;
+            data.distance = arc.weight;
+            data.shortcut = arc.middle != SPECIAL_NODEID;
+            data.id = data.shortcut ? arc.middle : arc.edge_index;
+            data.forward = forward;
+            data.backward = !forward;
+            query_edges.emplace_back(node, other, data);
+        };
+
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            // all remaining neighbours are higher in the hierarchy
+            for (const auto &out : outgoing[node])
+            {
+                add_query_edge(node, out.first, out.second, true);
+                incoming[out.first].erase(node);
+            }
+            for (const auto &in : incoming[node])
+            {
+                add_query_edge(node, in.first, in.second, false);
+                outgoing[in.first].erase(node);
+            }
+            for (const auto &in : incoming[node])
+            {
+                for (const auto &out : outgoing[node])
+                {
+                    if (in.first != out.first)
+                    {
+                        add_arc(in.first, out.first,
+                                Arc{in.second.weight + out.second.weight, node, 0});
+                    }
+                }
+            }
+            outgoing[node].clear();
+            incoming[node].clear();
+        }
+
+        std::sort(query_edges.begin(), query_edges.end());
+        return QueryGraph(number_of_nodes, query_edges);
+    }
+
+    // levels by the longest path down from the top of the hierarchy
+    void ComputeSweepOrder()
+    {
+        const auto number_of_nodes = GetNumberOfNodes();
+        std::vector<unsigned> depth(number_of_nodes, 0);
+        unsigned max_depth = 0;
+        for (NodeID node = number_of_nodes; node-- > 0;)
+        {
+            for (const auto edge : GetAdjacentEdgeRange(node))
+            {
+                depth[node] = std::max(depth[node], depth[GetTarget(edge)] + 1);
+            }
+            max_depth = std::max(max_depth, depth[node]);
+        }
+
+        sweep_level_offsets.assign(number_of_nodes > 0 ? max_depth + 2 : 1, 0);
+        for (const auto node_depth : depth)
+        {
+            ++sweep_level_offsets[node_depth + 1];
+        }
+        std::partial_sum(sweep_level_offsets.begin(), sweep_level_offsets.end(),
+                         sweep_level_offsets.begin());
+        std::vector<unsigned> position(sweep_level_offsets.begin(), sweep_level_offsets.end() - 1);
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            sweep_nodes[position[depth[node]]++] = node;
+        }
+    }
+
+    std::vector<TestEdge> input_edges;
+    QueryGraph query_graph;
+    std::vector<NodeID> sweep_nodes;
+    std::vector<unsigned> sweep_level_offsets;
+    unsigned checksum;
+    mutable engine::ShortcutUnpackingCache shortcut_unpacking_cache;
+};
+
+// Random road-like graph: a grid with some one-way streets, some missing streets and a few
+// nodes that can not be reached at all.
+inline std::vector<TestEdge> MakeGridGraph(const unsigned width,
+                                           const unsigned height,
+                                           const unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<EdgeWeight> weight_distribution(1, 100);
+    std::uniform_int_distribution<unsigned> kind_distribution(0, 9);
+
+    std::vector<TestEdge> edges;
+    const auto add_street = [&](const NodeID from, const NodeID to)
+    {
+        const auto kind = kind_distribution(generator);
+        const auto weight = weight_distribution(generator);
+        if (kind == 0)
+        {
+            return;
+        }
+        if (kind != 1)
+        {
+            edges.push_back({from, to, weight});
+        }
+        if (kind != 2)
+        {
+            edges.push_back({to, from, weight});
+        }
+    };
+
+    // the last row stays disconnected
+    for (const auto y : util::irange(0u, height - 1))
+    {
+        for (const auto x : util::irange(0u, width))
+        {
+            const NodeID node = y * width + x;
+            if (x + 1 < width)
+            {
+                add_street(node, node + 1);
+            }
+            if (y + 2 < height)
+            {
+                add_street(node, node + width);
+            }
+        }
+    }
+    return edges;
+}
+
+// Shuffles the node ids so that the contraction order does not follow the grid.
+inline std::vector<TestEdge> ShuffleNodes(const unsigned number_of_nodes,
+                                          std::vector<TestEdge> edges,
+                                          const unsigned seed)
+{
+    std::vector<NodeID> new_ids(number_of_nodes);
+    std::iota(new_ids.begin(), new_ids.end(), 0);
+    std::shuffle(new_ids.begin(), new_ids.end(), std::mt19937(seed));
+    for (auto &edge : edges)
+    {
+        edge.source = new_ids[edge.source];
+        edge.target = new_ids[edge.target];
+    }
+    return edges;
+}
+
+inline engine::PhantomNode MakePhantomNode(const NodeID node)
+{
+    engine::PhantomNode phantom;
+    phantom.forward_node_id = node;
+    phantom.forward_weight = 0;
+    phantom.forward_offset = 0;
+    return phantom;
+}
+}
+}
+
+#endif // MOCK_DATAFACADE_HPP
@@ -0,0 +1,131 @@
+#include "engine/routing_algorithms/many_to_many.hpp"
+#include "engine/routing_algorithms/one_to_all.hpp"
+#include "engine/search_engine_data.hpp"
+
+#include "mock_datafacade.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <limits>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(one_to_all)
+
+using namespace osrm;
+using namespace osrm::engine;
+using namespace osrm::test;
+
+namespace
+{
+using OneToAll = routing_algorithms::OneToAllRouting<MockDataFacade>;
+using ManyToMany = routing_algorithms::ManyToManyRouting<MockDataFacade>;
+
+const unsigned WIDTH = 9;
+const unsigned HEIGHT = 7;
+const unsigned NUMBER_OF_NODES = WIDTH * HEIGHT;
+
+std::vector<PhantomNode> MakeSources()
+{
+    std::vector<PhantomNode> sources;
+    for (NodeID node = 0; node < NUMBER_OF_NODES; node += 5)
+    {
+        sources.push_back(MakePhantomNode(node));
+    }
+    return sources;
+}
+}
+
+BOOST_AUTO_TEST_CASE(matches_dijkstra_and_many_to_many)
+{
+    MockDataFacade facade(NUMBER_OF_NODES,
+                          ShuffleNodes(NUMBER_OF_NODES, MakeGridGraph(WIDTH, HEIGHT, 3), 11));
+    SearchEngineData engine_working_data;
+    OneToAll one_to_all(&facade, engine_working_data);
+    BOOST_REQUIRE(one_to_all.IsAvailable());
+
+    const auto sources = MakeSources();
+    std::vector<EdgeWeight> weights;
+    one_to_all(sources, INVALID_EDGE_WEIGHT, weights);
+    BOOST_REQUIRE_EQUAL(weights.size(), NUMBER_OF_NODES * sources.size());
+
+    std::vector<PhantomNode> targets;
+    for (const auto node : util::irange<NodeID>(0, NUMBER_OF_NODES))
+    {
+        targets.push_back(MakePhantomNode(node));
+    }
+    ManyToMany many_to_many(&facade, engine_working_data);
+    const auto table = many_to_many(sources, targets);
+
+    unsigned number_of_unreachable = 0;
+    for (const auto source : util::irange<std::size_t>(0, sources.size()))
+    {
+        const auto dijkstra_weights = facade.Dijkstra(sources[source].forward_node_id);
+        for (const auto node : util::irange<NodeID>(0, NUMBER_OF_NODES))
+        {
+            const auto weight = weights[node * sources.size() + source];
+            BOOST_CHECK_EQUAL(weight, dijkstra_weights[node]);
+
+            const auto table_weight = (*table)[source * NUMBER_OF_NODES + node];
+            if (dijkstra_weights[node] == INVALID_EDGE_WEIGHT)
+            {
+                ++number_of_unreachable;
+                BOOST_CHECK_EQUAL(table_weight, std::numeric_limits<EdgeWeight>::max());
+            }
+            else
+            {
+                BOOST_CHECK_EQUAL(table_weight, weight);
+            }
+        }
+    }
+    // the generated graph has a disconnected row
+    BOOST_CHECK_GT(number_of_unreachable, 0);
+}
+
+BOOST_AUTO_TEST_CASE(pruned_by_max_weight)
+{
+    MockDataFacade facade(NUMBER_OF_NODES,
+                          ShuffleNodes(NUMBER_OF_NODES, MakeGridGraph(WIDTH, HEIGHT, 5), 17));
+    SearchEngineData engine_working_data;
+    OneToAll one_to_all(&facade, engine_working_data);
+
+    const auto sources = MakeSources();
+    const EdgeWeight max_weight = 150;
+    // the buffer is reused with old contents
+    std::vector<EdgeWeight> weights(NUMBER_OF_NODES * sources.size() * 2, 0);
+    one_to_all(sources, max_weight, weights);
+    BOOST_REQUIRE_EQUAL(weights.size(), NUMBER_OF_NODES * sources.size());
+
+    unsigned number_of_pruned = 0;
+    for (const auto source : util::irange<std::size_t>(0, sources.size()))
+    {
+        const auto dijkstra_weights = facade.Dijkstra(sources[source].forward_node_id);
+        for (const auto node : util::irange<NodeID>(0, NUMBER_OF_NODES))
+        {
+            const auto weight = weights[node * sources.size() + source];
+            if (dijkstra_weights[node] <= max_weight)
+            {
+                BOOST_CHECK_EQUAL(weight, dijkstra_weights[node]);
+            }
+            else
+            {
+                number_of_pruned += dijkstra_weights[node] != INVALID_EDGE_WEIGHT;
+                BOOST_CHECK_EQUAL(weight, INVALID_EDGE_WEIGHT);
+            }
+        }
+    }
+    BOOST_CHECK_GT(number_of_pruned, 0);
+}
+
+BOOST_AUTO_TEST_CASE(release_large_weights)
+{
+    auto &weights = SearchEngineData::GetThreadLocalOneToAllWeights();
+    weights.assign(1024, 0);
+    SearchEngineData::ReleaseThreadLocalOneToAllWeights();
+    BOOST_CHECK_EQUAL(SearchEngineData::GetThreadLocalOneToAllWeights().size(), 1024);
+
+    weights.assign(SearchEngineData::MAX_RETAINED_ONE_TO_ALL_BYTES / sizeof(EdgeWeight) + 1, 0);
+    SearchEngineData::ReleaseThreadLocalOneToAllWeights();
+    BOOST_CHECK_EQUAL(SearchEngineData::GetThreadLocalOneToAllWeights().capacity(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,116 @@
+#include "engine/datafacade/shared_datatype.hpp"
+#include "datastore/dataset_file.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+#include <set>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(shared_data_layout)
+
+using namespace osrm;
+using namespace osrm::engine::datafacade;
+
+namespace
+{
+SharedDataLayout MakeLayout()
+{
+    SharedDataLayout layout;
+    for (unsigned i = 0; i < SharedDataLayout::NUM_BLOCKS; ++i)
+    {
+        const auto bid = static_cast<SharedDataLayout::BlockID>(i);
+        // odd sizes, some blocks empty
+        if (i % 3 == 0)
+        {
+            layout.SetBlockSize<char>(bid, i * 7 + 1);
+        }
+        else if (i % 3 == 1)
+        {
+            layout.SetBlockSize<std::uint32_t>(bid, i * 13);
+        }
+        else
+        {
+            layout.SetBlockSize<std::uint64_t>(bid, 0);
+        }
+    }
+    return layout;
+}
+}
+
+BOOST_AUTO_TEST_CASE(blocks_are_aligned)
+{
+    const auto layout = MakeLayout();
+    for (unsigned i = 0; i < SharedDataLayout::NUM_BLOCKS; ++i)
+    {
+        const auto bid = static_cast<SharedDataLayout::BlockID>(i);
+        BOOST_CHECK_EQUAL(layout.GetBlockOffset(bid) % 64, 0);
+        if (i > 0)
+        {
+            const auto previous = static_cast<SharedDataLayout::BlockID>(i - 1);
+            // leaves room for the end canary of the previous block and the start canary
+            BOOST_CHECK_GE(layout.GetBlockOffset(bid), layout.GetBlockOffset(previous) +
+                                                           layout.GetBlockSize(previous) + 10);
+        }
+    }
+    BOOST_CHECK_GE(layout.GetSizeOfLayout(),
+                   layout.GetBlockOffset(SharedDataLayout::R_SEARCH_TREE_LEAVES) +
+                       layout.GetBlockSize(SharedDataLayout::R_SEARCH_TREE_LEAVES) + 5);
+}
+
+BOOST_AUTO_TEST_CASE(canaries_survive_writing_all_blocks)
+{
+    auto layout = MakeLayout();
+    std::vector<char> memory(layout.GetSizeOfLayout());
+
+    for (unsigned i = 0; i < SharedDataLayout::NUM_BLOCKS; ++i)
+    {
+        const auto bid = static_cast<SharedDataLayout::BlockID>(i);
+        char *block = layout.GetBlockPtr<char, true>(memory.data(), bid);
+        std::memset(block, 0xff, layout.GetBlockSize(bid));
+    }
+
+    for (unsigned i = 0; i < SharedDataLayout::NUM_BLOCKS; ++i)
+    {
+        const auto bid = static_cast<SharedDataLayout::BlockID>(i);
+        BOOST_CHECK_NO_THROW(layout.GetBlockPtr<char>(memory.data(), bid));
+    }
+
+    memory[layout.GetBlockOffset(SharedDataLayout::GRAPH_EDGE_LIST) - 5] = 'X';
+    BOOST_CHECK_THROW(layout.GetBlockPtr<char>(memory.data(), SharedDataLayout::GRAPH_EDGE_LIST),
+                      util::exception);
+}
+
+BOOST_AUTO_TEST_CASE(dataset_header)
+{
+    const auto layout = MakeLayout();
+    auto header = datastore::DatasetFileHeader::Make(layout);
+    BOOST_CHECK(header.IsDataset());
+    BOOST_CHECK(header.IsCompatible());
+    BOOST_CHECK_EQUAL(header.layout.GetSizeOfLayout(), layout.GetSizeOfLayout());
+
+    header.version += 1;
+    BOOST_CHECK(!header.IsCompatible());
+
+    header.magic[0] = 'X';
+    BOOST_CHECK(!header.IsDataset());
+}
+
+BOOST_AUTO_TEST_CASE(block_names)
+{
+    std::set<std::string> names;
+    for (unsigned i = 0; i < SharedDataLayout::NUM_BLOCKS; ++i)
+    {
+        const auto name = SharedDataLayout::GetBlockName(static_cast<SharedDataLayout::BlockID>(i));
+        BOOST_REQUIRE(name != nullptr);
+        names.insert(name);
+    }
+    BOOST_CHECK_EQUAL(names.size(), SharedDataLayout::NUM_BLOCKS);
+    BOOST_CHECK_EQUAL(SharedDataLayout::GetBlockName(SharedDataLayout::R_SEARCH_TREE_LEAVES),
+                      std::string("R_SEARCH_TREE_LEAVES"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
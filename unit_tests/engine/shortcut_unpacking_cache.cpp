@@ -0,0 +1,121 @@
+#include "engine/shortcut_unpacking_cache.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(shortcut_unpacking_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+const constexpr unsigned CHECKSUM = 42;
+
+ShortcutUnpackingCache::UnpackedEdges makeUnpackedEdges(const std::size_t number_of_edges)
+{
+    ShortcutUnpackingCache::UnpackedEdges unpacked_edges;
+    for (std::size_t i = 0; i < number_of_edges; ++i)
+    {
+        unpacked_edges.push_back({static_cast<NodeID>(i), static_cast<EdgeID>(10 * i)});
+    }
+    return unpacked_edges;
+}
+
+BOOST_AUTO_TEST_CASE(disabled_by_default)
+{
+    ShortcutUnpackingCache cache;
+    const auto edges = makeUnpackedEdges(ShortcutUnpackingCache::MIN_UNPACKED_EDGES);
+    cache.Insert(CHECKSUM, 1, 2, edges.begin(), edges.end());
+
+    BOOST_CHECK(!cache.IsEnabled());
+    BOOST_CHECK(cache.Find(CHECKSUM, 1, 2) == nullptr);
+    BOOST_CHECK_EQUAL(cache.GetUsedMemory(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(insert_and_find)
+{
+    ShortcutUnpackingCache cache;
+    cache.SetMemoryBudget(1024 * 1024);
+
+    const auto edges = makeUnpackedEdges(ShortcutUnpackingCache::MIN_UNPACKED_EDGES);
+    cache.Insert(CHECKSUM, 1, 2, edges.begin(), edges.end());
+
+    const auto cached_edges = cache.Find(CHECKSUM, 1, 2);
+    BOOST_REQUIRE(cached_edges != nullptr);
+    BOOST_REQUIRE_EQUAL(cached_edges->size(), edges.size());
+    for (std::size_t i = 0; i < edges.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(cached_edges->at(i).source, edges[i].source);
+        BOOST_CHECK_EQUAL(cached_edges->at(i).edge, edges[i].edge);
+    }
+
+    // direction matters
+    BOOST_CHECK(cache.Find(CHECKSUM, 2, 1) == nullptr);
+
+    cache.Clear();
+    BOOST_CHECK(cache.Find(CHECKSUM, 1, 2) == nullptr);
+    BOOST_CHECK_EQUAL(cache.GetUsedMemory(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(short_shortcuts_are_not_cached)
+{
+    ShortcutUnpackingCache cache;
+    cache.SetMemoryBudget(1024 * 1024);
+
+    const auto edges = makeUnpackedEdges(ShortcutUnpackingCache::MIN_UNPACKED_EDGES - 1);
+    cache.Insert(CHECKSUM, 1, 2, edges.begin(), edges.end());
+
+    BOOST_CHECK(cache.Find(CHECKSUM, 1, 2) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(respects_memory_budget)
+{
+    const auto edges = makeUnpackedEdges(ShortcutUnpackingCache::MIN_UNPACKED_EDGES);
+
+    ShortcutUnpackingCache cache;
+    cache.SetMemoryBudget(edges.size() * sizeof(ShortcutUnpackingCache::UnpackedEdge) * 3);
+
+    for (NodeID node = 0; node < 10; ++node)
+    {
+        cache.Insert(CHECKSUM, node, node + 1, edges.begin(), edges.end());
+    }
+
+    unsigned number_of_cached = 0;
+    for (NodeID node = 0; node < 10; ++node)
+    {
+        number_of_cached += cache.Find(CHECKSUM, node, node + 1) != nullptr;
+    }
+    BOOST_CHECK_GT(number_of_cached, 0);
+    BOOST_CHECK_LT(number_of_cached, 3);
+    BOOST_CHECK_LE(cache.GetUsedMemory(),
+                   edges.size() * sizeof(ShortcutUnpackingCache::UnpackedEdge) * 3);
+}
+
+BOOST_AUTO_TEST_CASE(bound_to_dataset)
+{
+    ShortcutUnpackingCache cache;
+    cache.SetMemoryBudget(1024 * 1024);
+
+    const auto edges = makeUnpackedEdges(ShortcutUnpackingCache::MIN_UNPACKED_EDGES);
+    cache.Insert(CHECKSUM, 1, 2, edges.begin(), edges.end());
+    const auto cached_edges = cache.Find(CHECKSUM, 1, 2);
+    BOOST_REQUIRE(cached_edges != nullptr);
+
+    // a query on a different dataset does not see the entries
+    BOOST_CHECK(cache.Find(CHECKSUM + 1, 1, 2) == nullptr);
+
+    // and drops them once it adds its own shortcuts
+    const auto other_edges = makeUnpackedEdges(ShortcutUnpackingCache::MIN_UNPACKED_EDGES + 1);
+    cache.Insert(CHECKSUM + 1, 1, 2, other_edges.begin(), other_edges.end());
+    BOOST_CHECK(cache.Find(CHECKSUM, 1, 2) == nullptr);
+    BOOST_REQUIRE(cache.Find(CHECKSUM + 1, 1, 2) != nullptr);
+    BOOST_CHECK_EQUAL(cache.Find(CHECKSUM + 1, 1, 2)->size(), other_edges.size());
+
+    // entries that a query on the previous dataset still holds stay valid
+    BOOST_REQUIRE_EQUAL(cached_edges->size(), edges.size());
+    BOOST_CHECK_EQUAL(cached_edges->back().edge, edges.back().edge);
+    cache.Clear();
+    BOOST_CHECK_EQUAL(cached_edges->front().source, edges.front().source);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
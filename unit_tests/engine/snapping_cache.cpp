@@ -0,0 +1,123 @@
+#include "engine/snapping_cache.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(snapping_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+using TestCache = SnappingCache<int>;
+
+BOOST_AUTO_TEST_CASE(disabled_by_default)
+{
+    TestCache cache;
+    BOOST_CHECK(!cache.IsEnabled());
+}
+
+BOOST_AUTO_TEST_CASE(key_includes_bearing)
+{
+    TestCache cache;
+    cache.SetCapacity(100);
+
+    const util::FixedPointCoordinate coordinate(52519930, 13438640);
+    BOOST_CHECK(!cache.Find(TestCache::MakeKey(1, coordinate, 0, 180)));
+    cache.Insert(TestCache::MakeKey(1, coordinate, 0, 180), std::make_pair(1, 2));
+
+    BOOST_REQUIRE(cache.Find(TestCache::MakeKey(1, coordinate, 0, 180)));
+    BOOST_CHECK_EQUAL(cache.Find(TestCache::MakeKey(1, coordinate, 0, 180))->first, 1);
+    BOOST_CHECK(!cache.Find(TestCache::MakeKey(1, coordinate, 90, 180)));
+    BOOST_CHECK(!cache.Find(TestCache::MakeKey(1, coordinate, 0, 10)));
+    BOOST_CHECK(!cache.Find(
+        TestCache::MakeKey(1, util::FixedPointCoordinate(52519931, 13438640), 0, 180)));
+
+    const auto statistics = cache.GetStatistics();
+    BOOST_CHECK_EQUAL(statistics.hits, 2);
+    BOOST_CHECK_EQUAL(statistics.misses, 4);
+}
+
+BOOST_AUTO_TEST_CASE(invalidated_by_checksum)
+{
+    TestCache cache;
+    cache.SetCapacity(100);
+
+    const util::FixedPointCoordinate coordinate(52519930, 13438640);
+    BOOST_CHECK(!cache.Find(TestCache::MakeKey(1, coordinate, 0, 180)));
+    cache.Insert(TestCache::MakeKey(1, coordinate, 0, 180), std::make_pair(1, 2));
+    BOOST_CHECK(cache.Find(TestCache::MakeKey(1, coordinate, 0, 180)));
+    BOOST_CHECK(!cache.Find(TestCache::MakeKey(2, coordinate, 0, 180)));
+    BOOST_CHECK_EQUAL(cache.GetStatistics().size, 0);
+}
+
+BOOST_AUTO_TEST_CASE(stale_inserts_after_reload)
+{
+    TestCache cache;
+    cache.SetCapacity(100);
+
+    const util::FixedPointCoordinate coordinate(52519930, 13438640);
+    const auto old_key = TestCache::MakeKey(1, coordinate, 0, 180);
+    const auto new_key = TestCache::MakeKey(2, coordinate, 0, 180);
+
+    BOOST_CHECK(!cache.Find(old_key));
+    cache.Insert(old_key, std::make_pair(1, 1));
+    BOOST_CHECK(cache.Find(old_key));
+
+    // the new dataset is queried, then a query on the old dataset finishes
+    BOOST_CHECK(!cache.Find(new_key));
+    cache.Insert(old_key, std::make_pair(1, 1));
+    BOOST_CHECK(!cache.Find(new_key));
+    BOOST_CHECK_EQUAL(cache.GetStatistics().size, 0);
+
+    cache.Insert(new_key, std::make_pair(2, 2));
+    cache.Insert(old_key, std::make_pair(1, 1));
+    BOOST_REQUIRE(cache.Find(new_key));
+    BOOST_CHECK_EQUAL(cache.Find(new_key)->first, 2);
+    BOOST_CHECK_EQUAL(cache.GetStatistics().size, 1);
+
+    // a lookup on the old dataset drops the entries but never returns the ones of the new one
+    BOOST_CHECK(!cache.Find(old_key));
+    BOOST_CHECK(!cache.Find(new_key));
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_datasets)
+{
+    TestCache cache;
+    cache.SetCapacity(64);
+
+    // every thread queries one dataset, the segments are the checksum of the dataset
+    std::atomic<unsigned> mismatches(0);
+    std::vector<std::thread> threads;
+    for (const unsigned dataset_checksum : {1u, 2u, 1u, 2u})
+    {
+        threads.emplace_back([&cache, &mismatches, dataset_checksum]()
+                             {
+                                 for (int i = 0; i < 20000; ++i)
+                                 {
+                                     const util::FixedPointCoordinate coordinate(i % 100, 0);
+                                     const auto key =
+                                         TestCache::MakeKey(dataset_checksum, coordinate, 0, 180);
+                                     const auto segments = cache.Find(key);
+                                     if (!segments)
+                                     {
+                                         cache.Insert(key, std::make_pair(dataset_checksum,
+                                                                          dataset_checksum));
+                                     }
+                                     else if (segments->first != static_cast<int>(dataset_checksum))
+                                     {
+                                         ++mismatches;
+                                     }
+                                 }
+                             });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    BOOST_CHECK_EQUAL(mismatches, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
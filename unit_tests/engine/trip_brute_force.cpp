@@ -0,0 +1,95 @@
+#include "engine/trip/trip_brute_force.hpp"
+#include "util/dist_table_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(trip_brute_force)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+EdgeWeight TripLength(const std::vector<NodeID> &trip,
+                      const util::DistTableWrapper<EdgeWeight> &dist_table)
+{
+    EdgeWeight length = 0;
+    for (std::size_t i = 0; i < trip.size(); ++i)
+    {
+        length += dist_table(trip[i], trip[(i + 1) % trip.size()]);
+    }
+    return length;
+}
+
+// the lexicographically largest of all shortest permutations
+std::vector<NodeID> EnumerateTrips(std::vector<NodeID> permutation,
+                                   const util::DistTableWrapper<EdgeWeight> &dist_table)
+{
+    std::sort(permutation.begin(), permutation.end());
+    std::vector<NodeID> route;
+    EdgeWeight min_length = INVALID_EDGE_WEIGHT;
+    do
+    {
+        const auto length = TripLength(permutation, dist_table);
+        if (length <= min_length)
+        {
+            min_length = length;
+            route = permutation;
+        }
+    } while (std::next_permutation(permutation.begin(), permutation.end()));
+    return route;
+}
+}
+
+BOOST_AUTO_TEST_CASE(matches_enumeration)
+{
+    std::mt19937 random_engine(13);
+    // few different weights to get many trips of the same length
+    std::uniform_int_distribution<EdgeWeight> weight(1, 4);
+    for (const std::size_t number_of_locations : {1, 2, 3, 5, 8})
+    {
+        for (int round = 0; round < 20; ++round)
+        {
+            std::vector<EdgeWeight> table(number_of_locations * number_of_locations, 0);
+            for (auto &entry : table)
+            {
+                entry = weight(random_engine);
+            }
+            const util::DistTableWrapper<EdgeWeight> dist_table(std::move(table),
+                                                                number_of_locations);
+            std::vector<NodeID> locations(number_of_locations);
+            std::iota(locations.begin(), locations.end(), 0);
+
+            const auto trip = trip::BruteForceTrip(locations.cbegin(), locations.cend(),
+                                                   number_of_locations, dist_table);
+            const auto expected = EnumerateTrips(locations, dist_table);
+            BOOST_CHECK_EQUAL_COLLECTIONS(trip.begin(), trip.end(), expected.begin(),
+                                          expected.end());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(subset_of_locations)
+{
+    // a square where the diagonals are longer than the sides
+    const std::vector<EdgeWeight> table = {0, 1, 9, 2, 1, //
+                                           1, 0, 1, 9, 2, //
+                                           9, 1, 0, 1, 9, //
+                                           2, 9, 1, 0, 9, //
+                                           1, 2, 9, 9, 0};
+    const util::DistTableWrapper<EdgeWeight> dist_table(table, 5);
+    const std::vector<NodeID> locations = {0, 1, 2, 3};
+
+    const auto trip =
+        trip::BruteForceTrip(locations.cbegin(), locations.cend(), 5, dist_table);
+    const std::vector<NodeID> expected = {3, 2, 1, 0};
+    BOOST_CHECK_EQUAL_COLLECTIONS(trip.begin(), trip.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,111 @@
+#include "engine/trip/trip_farthest_insertion.hpp"
+#include "engine/trip/trip_local_search.hpp"
+#include "util/dist_table_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(trip_local_search)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+EdgeWeight TripLength(const std::vector<NodeID> &trip,
+                      const util::DistTableWrapper<EdgeWeight> &dist_table)
+{
+    EdgeWeight length = 0;
+    for (std::size_t i = 0; i < trip.size(); ++i)
+    {
+        length += dist_table(trip[i], trip[(i + 1) % trip.size()]);
+    }
+    return length;
+}
+
+// distances between random points with a random detour in each direction
+util::DistTableWrapper<EdgeWeight> MakeTable(const std::size_t number_of_locations)
+{
+    std::mt19937 random_engine(42);
+    std::uniform_int_distribution<int> coordinate(0, 1000);
+    std::uniform_int_distribution<int> detour(0, 100);
+    std::vector<std::pair<int, int>> points(number_of_locations);
+    for (auto &point : points)
+    {
+        point = std::make_pair(coordinate(random_engine), coordinate(random_engine));
+    }
+    std::vector<EdgeWeight> table(number_of_locations * number_of_locations, 0);
+    for (std::size_t from = 0; from < number_of_locations; ++from)
+    {
+        for (std::size_t to = 0; to < number_of_locations; ++to)
+        {
+            if (from != to)
+            {
+                table[from * number_of_locations + to] =
+                    std::abs(points[from].first - points[to].first) +
+                    std::abs(points[from].second - points[to].second) + detour(random_engine);
+            }
+        }
+    }
+    return util::DistTableWrapper<EdgeWeight>(std::move(table), number_of_locations);
+}
+}
+
+BOOST_AUTO_TEST_CASE(improves_farthest_insertion)
+{
+    const std::size_t number_of_locations = 60;
+    const auto dist_table = MakeTable(number_of_locations);
+    std::vector<NodeID> locations(number_of_locations);
+    std::iota(locations.begin(), locations.end(), 0);
+
+    const auto initial_trip = trip::FarthestInsertionTrip(locations.cbegin(), locations.cend(),
+                                                          number_of_locations, dist_table);
+    const auto trip = trip::LocalSearchTrip(locations.cbegin(), locations.cend(),
+                                            number_of_locations, dist_table, initial_trip);
+
+    BOOST_CHECK_EQUAL(trip.size(), number_of_locations);
+    BOOST_CHECK_EQUAL(trip.front(), initial_trip.front());
+    BOOST_CHECK(std::is_permutation(trip.begin(), trip.end(), locations.begin()));
+    BOOST_CHECK_LE(TripLength(trip, dist_table), TripLength(initial_trip, dist_table));
+}
+
+BOOST_AUTO_TEST_CASE(same_trip_every_time)
+{
+    const std::size_t number_of_locations = 80;
+    const auto dist_table = MakeTable(number_of_locations);
+    std::vector<NodeID> locations(number_of_locations);
+    std::iota(locations.begin(), locations.end(), 0);
+
+    const auto initial_trip = trip::FarthestInsertionTrip(locations.cbegin(), locations.cend(),
+                                                          number_of_locations, dist_table);
+    const auto trip = trip::LocalSearchTrip(locations.cbegin(), locations.cend(),
+                                            number_of_locations, dist_table, initial_trip);
+    for (int i = 0; i < 3; ++i)
+    {
+        const auto other_trip = trip::LocalSearchTrip(locations.cbegin(), locations.cend(),
+                                                      number_of_locations, dist_table,
+                                                      initial_trip);
+        BOOST_CHECK_EQUAL_COLLECTIONS(trip.begin(), trip.end(), other_trip.begin(),
+                                      other_trip.end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(small_components_unchanged)
+{
+    const std::size_t number_of_locations = 3;
+    const auto dist_table = MakeTable(number_of_locations);
+    const std::vector<NodeID> locations = {0, 1, 2};
+    const std::vector<NodeID> initial_trip = {2, 0, 1};
+
+    const auto trip = trip::LocalSearchTrip(locations.cbegin(), locations.cend(),
+                                            number_of_locations, dist_table, initial_trip);
+    BOOST_CHECK_EQUAL_COLLECTIONS(trip.begin(), trip.end(), initial_trip.begin(),
+                                  initial_trip.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
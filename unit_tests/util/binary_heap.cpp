@@ -1,4 +1,5 @@
 #include "util/binary_heap.hpp"
+#include "util/integer_range.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/test/unit_test.hpp>
@@ -156,4 +157,48 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types, RandomData
     }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(insertion_index_test, T, storage_types, RandomDataFixture<10>)
+{
+    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(10);
+
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+    BOOST_CHECK_EQUAL(heap.NumberOfInsertedNodes(), 10);
+
+    // removing nodes keeps their index
+    heap.DeleteMin();
+    heap.DeleteMin();
+
+    const auto &const_heap = heap;
+    for (const auto i : util::irange<std::size_t>(0u, order.size()))
+    {
+        const auto id = ids[order[i]];
+        BOOST_CHECK_EQUAL(const_heap.GetInsertionIndex(id), i);
+        BOOST_CHECK_EQUAL(const_heap.GetKey(id), weights[order[i]]);
+    }
+    BOOST_CHECK_EQUAL(heap.NumberOfInsertedNodes(), 10);
+
+    heap.Clear();
+    BOOST_CHECK_EQUAL(heap.NumberOfInsertedNodes(), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(memory_usage_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+{
+    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+    const auto empty_usage = heap.GetMemoryUsage();
+
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+    const auto full_usage = heap.GetMemoryUsage();
+    BOOST_CHECK_GT(full_usage, empty_usage);
+
+    // the arrays of the heap keep their capacity
+    heap.Clear();
+    BOOST_CHECK_GT(heap.GetMemoryUsage(), empty_usage);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,47 @@
+#include "util/convex_hull.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(convex_hull_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(square_with_inner_points)
+{
+    // lat, lon
+    const std::vector<FixedPointCoordinate> coordinates = {
+        {0, 0}, {10, 10}, {5, 5}, {0, 10}, {10, 0}, {3, 7}, {0, 5}, {10, 0}};
+    const auto hull = ConvexHull(coordinates);
+
+    BOOST_REQUIRE_EQUAL(hull.size(), 4);
+    BOOST_CHECK_EQUAL(hull[0], FixedPointCoordinate(0, 0));
+    BOOST_CHECK_EQUAL(hull[1], FixedPointCoordinate(0, 10));
+    BOOST_CHECK_EQUAL(hull[2], FixedPointCoordinate(10, 10));
+    BOOST_CHECK_EQUAL(hull[3], FixedPointCoordinate(10, 0));
+}
+
+BOOST_AUTO_TEST_CASE(degenerate_input)
+{
+    BOOST_CHECK(ConvexHull({}).empty());
+    BOOST_CHECK_EQUAL(ConvexHull({{1, 1}, {1, 1}}).size(), 1);
+
+    // collinear coordinates collapse to the two extremes
+    const auto line = ConvexHull({{0, 0}, {1, 1}, {2, 2}, {3, 3}});
+    BOOST_REQUIRE_EQUAL(line.size(), 2);
+    BOOST_CHECK_EQUAL(line[0], FixedPointCoordinate(0, 0));
+    BOOST_CHECK_EQUAL(line[1], FixedPointCoordinate(3, 3));
+}
+
+BOOST_AUTO_TEST_CASE(large_coordinates)
+{
+    // differences of fixed point coordinates overflow 32 bit products
+    const std::vector<FixedPointCoordinate> coordinates = {
+        {-90000000, -180000000}, {90000000, -180000000}, {90000000, 180000000},
+        {-90000000, 180000000}, {0, 0}};
+    BOOST_CHECK_EQUAL(ConvexHull(coordinates).size(), 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
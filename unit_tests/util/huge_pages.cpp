@@ -0,0 +1,83 @@
+#include "util/huge_pages.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(huge_pages)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(disabled_by_default)
+{
+    BOOST_CHECK(!HugePages::IsEnabled());
+
+    std::vector<char> array(4 * HugePages::HUGE_PAGE_SIZE);
+    BOOST_CHECK(!HugePages::Advise(array.data(), array.size()));
+}
+
+BOOST_AUTO_TEST_CASE(resize_keeps_entries)
+{
+    HugePages::Enable(true);
+
+    std::vector<unsigned> array = {1, 2, 3};
+    HugePages::Resize(array, 3 * HugePages::HUGE_PAGE_SIZE / sizeof(unsigned));
+    BOOST_CHECK_EQUAL(array.size(), 3 * HugePages::HUGE_PAGE_SIZE / sizeof(unsigned));
+    BOOST_CHECK_EQUAL(array[0], 1);
+    BOOST_CHECK_EQUAL(array[2], 3);
+    BOOST_CHECK_EQUAL(array[3], 0);
+    BOOST_CHECK_EQUAL(array.back(), 0);
+
+    // smaller than a huge page, nothing to advise
+    std::vector<unsigned> small_array;
+    BOOST_CHECK(!HugePages::Resize(small_array, 16));
+    BOOST_CHECK_EQUAL(small_array.size(), 16);
+
+    HugePages::Enable(false);
+}
+
+BOOST_AUTO_TEST_CASE(backed_bytes_from_smaps)
+{
+    // an anonymous mapping with one huge page and a shared memory segment on hugetlb pages
+    std::istringstream smaps("00400000-00800000 rw-p 00000000 00:00 0\n"
+                             "Size:               4096 kB\n"
+                             "AnonHugePages:      2048 kB\n"
+                             "VmFlags: rd wr mr mw me ac hg\n"
+                             "7f0000000000-7f0000400000 rw-s 00000000 00:0f 42 /SYSV00000000\n"
+                             "Size:               4096 kB\n"
+                             "AnonHugePages:         0 kB\n"
+                             "Shared_Hugetlb:     4096 kB\n");
+    const std::size_t kilobyte = 1024;
+
+    BOOST_CHECK_EQUAL(HugePages::ParseBackedBytes(smaps, 0x400000, 4096 * kilobyte),
+                      2048 * kilobyte);
+
+    // only the overlapping part of a mapping is counted
+    smaps.clear();
+    smaps.seekg(0);
+    BOOST_CHECK_EQUAL(HugePages::ParseBackedBytes(smaps, 0x7f0000200000, 1024 * kilobyte),
+                      1024 * kilobyte);
+
+    // both mappings
+    smaps.clear();
+    smaps.seekg(0);
+    BOOST_CHECK_EQUAL(HugePages::ParseBackedBytes(smaps, 0x400000, 0x7f0000400000 - 0x400000),
+                      6144 * kilobyte);
+
+    // outside of all mappings
+    smaps.clear();
+    smaps.seekg(0);
+    BOOST_CHECK_EQUAL(HugePages::ParseBackedBytes(smaps, 0x1000000, 4096 * kilobyte), 0);
+}
+
+BOOST_AUTO_TEST_CASE(transparent_huge_page_mode)
+{
+    BOOST_CHECK_EQUAL(HugePages::ParseTransparentHugePageMode("always [madvise] never"),
+                      "madvise");
+    BOOST_CHECK_EQUAL(HugePages::ParseTransparentHugePageMode("always madvise [never]"), "never");
+    BOOST_CHECK_EQUAL(HugePages::ParseTransparentHugePageMode(""), "");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,91 @@
+#include "util/lru_cache.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(lru_cache)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(disabled_cache)
+{
+    ShardedLRUCache<int, std::string> cache(0);
+    cache.Insert(1, "one");
+
+    BOOST_CHECK(!cache.IsEnabled());
+    BOOST_CHECK(!cache.Find(1));
+    BOOST_CHECK_EQUAL(cache.GetStatistics().size, 0);
+}
+
+BOOST_AUTO_TEST_CASE(hits_and_misses)
+{
+    ShardedLRUCache<int, std::string> cache(10);
+    cache.Insert(1, "one");
+    cache.Insert(2, "two");
+
+    BOOST_REQUIRE(cache.Find(1));
+    BOOST_CHECK_EQUAL(*cache.Find(1), "one");
+    BOOST_CHECK(!cache.Find(3));
+
+    cache.Insert(1, "uno");
+    BOOST_CHECK_EQUAL(*cache.Find(1), "uno");
+
+    const auto statistics = cache.GetStatistics();
+    BOOST_CHECK_EQUAL(statistics.capacity, 10);
+    BOOST_CHECK_EQUAL(statistics.size, 2);
+    BOOST_CHECK_EQUAL(statistics.hits, 3);
+    BOOST_CHECK_EQUAL(statistics.misses, 1);
+    BOOST_CHECK_CLOSE(statistics.GetHitRate(), 0.75, 1e-6);
+
+    cache.Clear();
+    BOOST_CHECK(!cache.Find(1));
+    BOOST_CHECK_EQUAL(cache.GetStatistics().size, 0);
+}
+
+BOOST_AUTO_TEST_CASE(erase)
+{
+    ShardedLRUCache<int, int> cache(10);
+    cache.Insert(1, 1);
+    cache.Insert(2, 2);
+    cache.Erase(1);
+    cache.Erase(3);
+
+    BOOST_CHECK(!cache.Find(1));
+    BOOST_CHECK(cache.Find(2));
+    BOOST_CHECK_EQUAL(cache.GetStatistics().size, 1);
+}
+
+BOOST_AUTO_TEST_CASE(evicts_least_recently_used)
+{
+    // a single shard makes the eviction order deterministic
+    ShardedLRUCache<int, int> cache(3, 1);
+    cache.Insert(1, 1);
+    cache.Insert(2, 2);
+    cache.Insert(3, 3);
+
+    // 1 is now more recently used than 2
+    BOOST_CHECK(cache.Find(1));
+    cache.Insert(4, 4);
+
+    BOOST_CHECK(cache.Find(1));
+    BOOST_CHECK(!cache.Find(2));
+    BOOST_CHECK(cache.Find(3));
+    BOOST_CHECK(cache.Find(4));
+    BOOST_CHECK_EQUAL(cache.GetStatistics().evictions, 1);
+    BOOST_CHECK_EQUAL(cache.GetStatistics().size, 3);
+}
+
+BOOST_AUTO_TEST_CASE(sharded_capacity)
+{
+    ShardedLRUCache<int, int> cache(64);
+    for (int i = 0; i < 1000; ++i)
+    {
+        cache.Insert(i, i);
+    }
+    BOOST_CHECK_LE(cache.GetStatistics().size, 64);
+    BOOST_CHECK_GT(cache.GetStatistics().size, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
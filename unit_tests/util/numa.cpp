@@ -0,0 +1,48 @@
+#include "util/make_unique.hpp"
+#include "util/numa.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(numa)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(parse_cpu_list)
+{
+    BOOST_CHECK(NUMATopology::ParseCPUList("").empty());
+
+    const std::vector<unsigned> single = {3};
+    const auto parsed_single = NUMATopology::ParseCPUList("3");
+    BOOST_CHECK_EQUAL_COLLECTIONS(parsed_single.begin(), parsed_single.end(), single.begin(),
+                                  single.end());
+
+    const std::vector<unsigned> ranges = {0, 1, 2, 3, 8, 10, 11};
+    const auto parsed_ranges = NUMATopology::ParseCPUList("0-3,8,10-11");
+    BOOST_CHECK_EQUAL_COLLECTIONS(parsed_ranges.begin(), parsed_ranges.end(), ranges.begin(),
+                                  ranges.end());
+}
+
+BOOST_AUTO_TEST_CASE(replica_per_node)
+{
+    const auto &topology = NUMATopology::Get();
+    BOOST_REQUIRE_GE(topology.GetNumberOfNodes(), 1);
+    BOOST_CHECK_EQUAL(NUMATopology::GetThreadNode(), 0);
+
+    // every replica is created on a thread pinned to its node
+    const auto replicas = topology.CreateReplicas<unsigned>([]
+                                                            {
+                                                                return util::make_unique<unsigned>(
+                                                                    NUMATopology::GetThreadNode());
+                                                            });
+    BOOST_REQUIRE_EQUAL(replicas.size(), topology.GetNumberOfNodes());
+    for (unsigned node = 0; node < replicas.size(); ++node)
+    {
+        BOOST_CHECK_EQUAL(*replicas[node], node);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
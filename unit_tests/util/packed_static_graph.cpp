@@ -0,0 +1,232 @@
+#include "contractor/query_edge.hpp"
+#include "util/packed_static_graph.hpp"
+#include "util/static_graph.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(packed_static_graph)
+
+using namespace osrm;
+using namespace osrm::util;
+
+using EdgeData = contractor::QueryEdge::EdgeData;
+using TestStaticGraph = StaticGraph<EdgeData>;
+using TestPackedGraph = PackedStaticGraph<EdgeData>;
+using TestNodeArrayEntry = TestStaticGraph::NodeArrayEntry;
+using TestEdgeArrayEntry = TestStaticGraph::EdgeArrayEntry;
+
+// Chosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 15;
+
+struct RandomGraphFixture
+{
+    // the maximal values exercise fields that span two words
+    RandomGraphFixture(const unsigned num_nodes,
+                       const unsigned num_edges,
+                       const unsigned max_id,
+                       const int max_distance)
+    {
+        std::mt19937 g(RANDOM_SEED);
+        std::uniform_int_distribution<unsigned> source_udist(0, num_nodes - 1);
+        std::vector<unsigned> sources;
+        for (unsigned i = 0; i < num_edges; ++i)
+        {
+            sources.push_back(source_udist(g));
+        }
+        std::sort(sources.begin(), sources.end());
+
+        unsigned edge = 0;
+        for (unsigned node = 0; node <= num_nodes; ++node)
+        {
+            nodes.push_back(TestNodeArrayEntry{edge});
+            while (edge < num_edges && sources[edge] == node)
+            {
+                ++edge;
+            }
+        }
+
+        std::uniform_int_distribution<unsigned> target_udist(0, num_nodes - 1);
+        std::uniform_int_distribution<unsigned> id_udist(0, max_id);
+        std::uniform_int_distribution<int> distance_udist(1, max_distance);
+        std::bernoulli_distribution flag_dist(0.5);
+        for (unsigned i = 0; i < num_edges; ++i)
+        {
+            EdgeData data;
+            data.id = id_udist(g);
+            data.distance = distance_udist(g);
+            data.shortcut = flag_dist(g);
+            data.forward = flag_dist(g);
+            data.backward = flag_dist(g);
+            edges.push_back(TestEdgeArrayEntry{target_udist(g), data});
+        }
+        // the largest values have to round trip too
+        edges.front().data.id = max_id;
+        edges.back().data.distance = max_distance;
+    }
+
+    std::vector<TestNodeArrayEntry> nodes;
+    std::vector<TestEdgeArrayEntry> edges;
+};
+
+void CheckSameGraph(RandomGraphFixture fixture)
+{
+    auto nodes = fixture.nodes;
+    auto edges = fixture.edges;
+    TestStaticGraph graph(nodes, edges);
+    TestPackedGraph packed_graph(fixture.nodes, fixture.edges);
+
+    BOOST_CHECK(fixture.nodes.empty());
+    BOOST_CHECK(fixture.edges.empty());
+    BOOST_CHECK_EQUAL(packed_graph.GetNumberOfNodes(), graph.GetNumberOfNodes());
+    BOOST_CHECK_EQUAL(packed_graph.GetNumberOfEdges(), graph.GetNumberOfEdges());
+
+    for (const auto node : irange(0u, graph.GetNumberOfNodes()))
+    {
+        BOOST_CHECK_EQUAL(packed_graph.BeginEdges(node), graph.BeginEdges(node));
+        BOOST_CHECK_EQUAL(packed_graph.EndEdges(node), graph.EndEdges(node));
+        for (const auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            const auto &expected = graph.GetEdgeData(edge);
+            const auto data = packed_graph.GetEdgeData(edge);
+            BOOST_CHECK_EQUAL(packed_graph.GetTarget(edge), graph.GetTarget(edge));
+            BOOST_CHECK_EQUAL(data.id, expected.id);
+            BOOST_CHECK_EQUAL(data.distance, expected.distance);
+            BOOST_CHECK_EQUAL(data.shortcut, expected.shortcut);
+            BOOST_CHECK_EQUAL(data.forward, expected.forward);
+            BOOST_CHECK_EQUAL(data.backward, expected.backward);
+            BOOST_CHECK_EQUAL(packed_graph.FindEdge(node, graph.GetTarget(edge)),
+                              graph.FindEdge(node, graph.GetTarget(edge)));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(small_values_test) { CheckSameGraph(RandomGraphFixture(100, 500, 50, 100)); }
+
+BOOST_AUTO_TEST_CASE(large_values_test)
+{
+    CheckSameGraph(RandomGraphFixture(1000, 5000, (1u << 31) - 1, (1 << 29) - 1));
+}
+
+BOOST_AUTO_TEST_CASE(smaller_than_static_graph_test)
+{
+    RandomGraphFixture fixture(1000, 5000, 10000, 10000);
+    const auto number_of_edges = fixture.edges.size();
+    TestPackedGraph packed_graph(fixture.nodes, fixture.edges);
+    // 10 bits target, 14 bits id, 14 bits distance and 3 flags
+    BOOST_CHECK_EQUAL(packed_graph.GetRecordBits(), 41);
+    const auto graph_size =
+        1001 * sizeof(TestNodeArrayEntry) + number_of_edges * sizeof(TestEdgeArrayEntry);
+    BOOST_CHECK_LT(packed_graph.GetSizeInBytes(), graph_size);
+}
+
+BOOST_AUTO_TEST_CASE(fields_across_word_boundaries_test)
+{
+    // 32 bits target, 31 bits id, 29 bits distance and 3 flags, a record of 95 bits puts every
+    // field across a word boundary for some edges
+    const NodeID max_target = SPECIAL_NODEID - 1;
+    const unsigned max_id = (1u << 31) - 1;
+    const int max_distance = (1 << 29) - 1;
+    std::vector<TestNodeArrayEntry> nodes = {{0}, {64}};
+    std::vector<TestEdgeArrayEntry> edges;
+    for (unsigned i = 0; i < 64; ++i)
+    {
+        EdgeData data;
+        data.id = i % 2 == 0 ? max_id - i : i;
+        data.distance = i % 3 == 0 ? max_distance - i : i + 1;
+        data.shortcut = i % 2 == 0;
+        data.forward = i % 3 == 0;
+        data.backward = i % 5 == 0;
+        edges.push_back(TestEdgeArrayEntry{i % 2 == 0 ? max_target - i : i, data});
+    }
+    const auto expected_edges = edges;
+
+    TestPackedGraph packed_graph(nodes, edges);
+    BOOST_REQUIRE_EQUAL(packed_graph.GetRecordBits(), 95);
+
+    // offsets of target, id, distance and flags within a record
+    const unsigned field_offsets[] = {0, 32, 63, 92};
+    const unsigned field_bits[] = {32, 31, 29, 3};
+    unsigned crossing_fields[] = {0, 0, 0, 0};
+    for (unsigned edge = 0; edge < expected_edges.size(); ++edge)
+    {
+        for (unsigned field = 0; field < 4; ++field)
+        {
+            const auto begin = edge * 95 + field_offsets[field];
+            crossing_fields[field] += begin / 64 != (begin + field_bits[field] - 1) / 64;
+        }
+
+        const auto &expected = expected_edges[edge];
+        const auto data = packed_graph.GetEdgeData(edge);
+        BOOST_CHECK_EQUAL(packed_graph.GetTarget(edge), expected.target);
+        BOOST_CHECK_EQUAL(data.id, expected.data.id);
+        BOOST_CHECK_EQUAL(data.distance, expected.data.distance);
+        BOOST_CHECK_EQUAL(data.shortcut, expected.data.shortcut);
+        BOOST_CHECK_EQUAL(data.forward, expected.data.forward);
+        BOOST_CHECK_EQUAL(data.backward, expected.data.backward);
+    }
+    for (const auto crossings : crossing_fields)
+    {
+        BOOST_CHECK_GT(crossings, 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(find_edges_test)
+{
+    // parallel edges with different distances, in both directions between some nodes
+    const unsigned num_nodes = 20;
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<unsigned> target_udist(0, num_nodes - 1);
+    std::uniform_int_distribution<int> distance_udist(1, 1000);
+    std::uniform_int_distribution<unsigned> degree_udist(0, 8);
+    std::vector<TestNodeArrayEntry> nodes;
+    std::vector<TestEdgeArrayEntry> edges;
+    for (unsigned node = 0; node < num_nodes; ++node)
+    {
+        nodes.push_back(TestNodeArrayEntry{static_cast<unsigned>(edges.size())});
+        const auto degree = degree_udist(g);
+        for (unsigned i = 0; i < degree; ++i)
+        {
+            EdgeData data;
+            data.id = static_cast<unsigned>(edges.size());
+            data.distance = distance_udist(g);
+            data.forward = true;
+            edges.push_back(TestEdgeArrayEntry{target_udist(g), data});
+        }
+    }
+    nodes.push_back(TestNodeArrayEntry{static_cast<unsigned>(edges.size())});
+
+    auto static_nodes = nodes;
+    auto static_edges = edges;
+    TestStaticGraph graph(static_nodes, static_edges);
+    TestPackedGraph packed_graph(nodes, edges);
+
+    unsigned number_of_parallel_edges = 0;
+    for (unsigned from = 0; from < num_nodes; ++from)
+    {
+        for (unsigned to = 0; to < num_nodes; ++to)
+        {
+            BOOST_CHECK_EQUAL(packed_graph.FindEdge(from, to), graph.FindEdge(from, to));
+            BOOST_CHECK_EQUAL(packed_graph.FindSmallestEdge(from, to),
+                              graph.FindSmallestEdge(from, to));
+            BOOST_CHECK_EQUAL(packed_graph.FindEdgeInEitherDirection(from, to),
+                              graph.FindEdgeInEitherDirection(from, to));
+            bool reverse = false;
+            bool packed_reverse = false;
+            BOOST_CHECK_EQUAL(packed_graph.FindEdgeIndicateIfReverse(from, to, packed_reverse),
+                              graph.FindEdgeIndicateIfReverse(from, to, reverse));
+            BOOST_CHECK_EQUAL(packed_reverse, reverse);
+
+            number_of_parallel_edges += packed_graph.FindEdge(from, to) !=
+                                        packed_graph.FindSmallestEdge(from, to);
+        }
+    }
+    // the first edge is not always the smallest one
+    BOOST_CHECK_GT(number_of_parallel_edges, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,78 @@
+#include "util/request_arena.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(request_arena)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(no_current_arena_outside_of_scope)
+{
+    BOOST_CHECK(RequestArena::Current() == nullptr);
+    {
+        RequestArenaScope scope;
+        BOOST_CHECK(RequestArena::Current() == &scope.GetArena());
+        {
+            RequestArenaScope nested_scope;
+            BOOST_CHECK(&nested_scope.GetArena() == &scope.GetArena());
+        }
+        BOOST_CHECK(RequestArena::Current() == &scope.GetArena());
+    }
+    BOOST_CHECK(RequestArena::Current() == nullptr);
+
+    // falls back to the global allocator
+    ArenaVector<int> values(100, 1);
+    BOOST_CHECK_EQUAL(values.size(), 100);
+}
+
+BOOST_AUTO_TEST_CASE(allocations_are_aligned)
+{
+    RequestArena arena;
+    arena.Allocate(1, 1);
+    const auto pointer = reinterpret_cast<std::uintptr_t>(arena.Allocate(8, 8));
+    BOOST_CHECK_EQUAL(pointer % 8, 0);
+    arena.Allocate(3, 1);
+    const auto aligned_pointer = reinterpret_cast<std::uintptr_t>(arena.Allocate(16, 16));
+    BOOST_CHECK_EQUAL(aligned_pointer % 16, 0);
+}
+
+BOOST_AUTO_TEST_CASE(release_keeps_memory_for_next_request)
+{
+    RequestArenaScope scope;
+    auto &arena = scope.GetArena();
+
+    ArenaVector<std::uint64_t> values;
+    for (std::uint64_t i = 0; i < 100000; ++i)
+    {
+        values.push_back(i);
+    }
+    for (std::uint64_t i = 0; i < 100000; ++i)
+    {
+        BOOST_CHECK_EQUAL(values[i], i);
+    }
+    BOOST_CHECK_GT(arena.GetStatistics().allocations, 1);
+    BOOST_CHECK_GT(arena.GetStatistics().system_allocations, 1);
+
+    arena.Release();
+    BOOST_CHECK_EQUAL(arena.GetStatistics().allocations, 0);
+
+    // a request of the same size fits into the block that was kept
+    ArenaVector<std::uint64_t> more_values;
+    more_values.reserve(100000);
+    BOOST_CHECK_EQUAL(arena.GetStatistics().allocations, 1);
+    BOOST_CHECK_EQUAL(arena.GetStatistics().system_allocations, 0);
+}
+
+BOOST_AUTO_TEST_CASE(large_allocation)
+{
+    RequestArena arena;
+    auto *pointer = static_cast<char *>(arena.Allocate(4 * RequestArena::INITIAL_BLOCK_SIZE, 8));
+    pointer[4 * RequestArena::INITIAL_BLOCK_SIZE - 1] = 1;
+    BOOST_CHECK_EQUAL(arena.GetStatistics().system_allocations, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
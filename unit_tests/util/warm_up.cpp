@@ -0,0 +1,45 @@
+#include "util/residency.hpp"
+#include "util/warm_up.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(warm_up)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(page_in_blocks)
+{
+    // more than one chunk and a block that ends in the middle of a page
+    std::vector<char> large(40 * 1024 * 1024 + 123);
+    std::vector<char> small(10);
+    const auto paged_in = PageIn({{"large", large.data(), large.size()},
+                                  {"small", small.data(), small.size()},
+                                  {"empty", nullptr, 0}});
+    BOOST_CHECK_EQUAL(paged_in, large.size() + small.size());
+    BOOST_CHECK_EQUAL(PageIn({}), 0);
+}
+
+BOOST_AUTO_TEST_CASE(page_in_file)
+{
+    const auto path = boost::filesystem::temp_directory_path() /
+                      boost::filesystem::unique_path("osrm-warm-up-%%%%-%%%%");
+    {
+        boost::filesystem::ofstream file(path, std::ios::binary);
+        const std::string content(100000, 'x');
+        file << content;
+    }
+    BOOST_CHECK_EQUAL(PageInFile("test", path), 100000);
+    // the file stays in the page cache after it was unmapped
+    BOOST_CHECK_EQUAL(MakeFileStatistics("test", path).resident, 100000);
+    boost::filesystem::remove(path);
+
+    BOOST_CHECK_EQUAL(PageInFile("missing", path), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()